@@ -0,0 +1,128 @@
+#ifndef ASYNCQUERY_H
+#define ASYNCQUERY_H
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <future>
+#include <chrono>
+#include <functional>
+
+using namespace std;
+
+/// The kinds of query that can be run asynchronously
+enum AsyncQueryType { ASYNC_DISTANCE, ASYNC_PATH, ASYNC_MST };
+
+/// How an asynchronous query ended
+enum AsyncQueryStatus { ASYNC_OK, ASYNC_NO_PATH, ASYNC_TIMED_OUT, ASYNC_CANCELLED, ASYNC_REJECTED };
+
+/// The answer to an asynchronous query. The distance is only set when the status is ASYNC_OK and the
+/// path, from the source to the destination, only for path and minimum spanning tree queries
+struct AsyncQueryResult {
+    AsyncQueryStatus status;
+    double distance;
+    vector<unsigned int> path;
+};
+
+/// This class is the caller's handle on a query submitted to an AsyncQueryEngine. The answer arrives
+/// through a future, through a callback run on the worker thread that answered it, or both. The query
+/// can be cancelled at any time and gives up once its deadline has passed; a search that is already
+/// running notices either within a few hundred vertices and stops.
+///
+class AsyncQuery
+{
+    public:
+
+        /// \brief
+        /// Creates a query that has not been submitted yet
+        ///
+        /// \param type AsyncQueryType - the kind of query
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        /// \param destinationId unsigned int - the identifier of the destination vertex
+        /// \param priority int - queries with a higher priority are started first
+        /// \param timeoutSeconds double - how long from now the answer is still wanted, or zero for no deadline
+        /// \param callback function<void(const AsyncQueryResult&)> - run with the answer, or empty for none
+        ///
+        AsyncQuery(AsyncQueryType type, unsigned int sourceId, unsigned int destinationId, int priority,
+                   double timeoutSeconds, function<void(const AsyncQueryResult&)> callback);
+
+        /// \brief
+        /// There was no dynamically created items in this class so there is no need for a destructor method body
+        ///
+        ~AsyncQuery();
+
+        /// \brief
+        /// Asks for the query to stop. It ends with ASYNC_CANCELLED unless it has already been answered
+        ///
+        void cancel();
+
+        /// \brief
+        /// Returns whether or not the query should stop, because it was cancelled or its deadline has passed
+        ///
+        /// \return bool - true if no more work should be done on the query
+        ///
+        bool shouldStop();
+
+        /// \brief
+        /// Returns the status a query that has to stop ends with
+        ///
+        /// \return AsyncQueryStatus - ASYNC_CANCELLED if it was cancelled, otherwise ASYNC_TIMED_OUT
+        ///
+        AsyncQueryStatus getStopStatus();
+
+        /// \brief
+        /// Answers the query, fulfilling the future and running the callback. Only the first answer counts
+        ///
+        /// \param result const AsyncQueryResult& - the answer
+        ///
+        void complete(const AsyncQueryResult& result);
+
+        /// \brief
+        /// Returns a future for the answer, which may be waited on from any thread
+        ///
+        /// \return shared_future<AsyncQueryResult> - the future answer
+        ///
+        shared_future<AsyncQueryResult> getFuture();
+
+        /// \brief
+        /// Returns the kind of query
+        ///
+        /// \return AsyncQueryType - the kind of query
+        ///
+        AsyncQueryType getType();
+
+        /// \brief
+        /// Returns the identifier of the source vertex
+        ///
+        /// \return unsigned int - the identifier of the source vertex
+        ///
+        unsigned int getSourceId();
+
+        /// \brief
+        /// Returns the identifier of the destination vertex
+        ///
+        /// \return unsigned int - the identifier of the destination vertex
+        ///
+        unsigned int getDestinationId();
+
+        /// \brief
+        /// Returns the priority of the query, with higher priorities started first
+        ///
+        /// \return int - the priority of the query
+        ///
+        int getPriority();
+
+    private:
+        AsyncQueryType type;
+        unsigned int sourceId;
+        unsigned int destinationId;
+        int priority;
+        bool hasDeadline;
+        chrono::steady_clock::time_point deadline;
+        function<void(const AsyncQueryResult&)> callback;
+        atomic<bool> cancelled;
+        atomic<bool> completed;
+        promise<AsyncQueryResult> answer;
+        shared_future<AsyncQueryResult> future;
+};
+
+#endif // ASYNCQUERY_H
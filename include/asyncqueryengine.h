@@ -0,0 +1,140 @@
+#ifndef ASYNCQUERYENGINE_H
+#define ASYNCQUERYENGINE_H
+#include <vector>
+#include <queue>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "graph.h"
+#include "searchspace.h"
+#include "asyncquery.h"
+
+using namespace std;
+
+/// This class answers queries without blocking the caller. Submitted queries wait in a bounded queue
+/// ordered by priority and are answered by the engine's own worker threads, each with its own search
+/// state. A query is rejected straight away rather than queued when the queue is full, so a busy
+/// engine pushes back on its callers instead of growing without limit. Searches check every few hundred
+/// vertices whether their query has been cancelled or has run past its deadline, and stop if so.
+///
+/// Searches read the graph without locking, so edges must not be changed while queries are running.
+/// Minimum spanning tree queries find the tree first if the edges have changed since it was last found.
+///
+class AsyncQueryEngine
+{
+    public:
+
+        /// \brief
+        /// Starts the worker threads, using one per hardware thread when zero is given
+        ///
+        /// \param graph Graph* - the graph to answer queries on
+        /// \param numWorkers unsigned int - the number of worker threads to start
+        /// \param maxQueued unsigned int - the most queries that may wait to be started
+        ///
+        AsyncQueryEngine(Graph* graph, unsigned int numWorkers, unsigned int maxQueued);
+
+        /// \brief
+        /// Ends every query still waiting as cancelled, lets the running ones finish and joins the workers
+        ///
+        ~AsyncQueryEngine();
+
+        /// \brief
+        /// Queues a query to be answered. A query that cannot be queued is answered at once with ASYNC_REJECTED
+        ///
+        /// \param query shared_ptr<AsyncQuery> - the query, which the engine keeps alive until it is answered
+        /// \return bool - false if the queue was full or the query names a vertex not in the graph
+        ///
+        bool submit(shared_ptr<AsyncQuery> query);
+
+        /// \brief
+        /// Returns the number of queries waiting to be started
+        ///
+        /// \return unsigned int - the number of queued queries
+        ///
+        unsigned int getNumQueued();
+
+        /// \brief
+        /// Returns the counters kept by the engine as name=value pairs
+        ///
+        /// \return string - the engine statistics
+        ///
+        string getStats();
+
+    private:
+
+        /// A query waiting in the queue; queries of equal priority are started in the order submitted
+        struct QueuedQuery {
+            int priority;
+            unsigned long sequence;
+            shared_ptr<AsyncQuery> query;
+        };
+
+        /// Puts the highest priority and then the earliest submitted query at the top of the queue
+        struct QueuedQueryOrder {
+            bool operator()(const QueuedQuery& a, const QueuedQuery& b) const {
+                if (a.priority != b.priority) {
+                    return a.priority < b.priority;
+                }
+                return a.sequence > b.sequence;
+            }
+        };
+
+        /// The search state owned by one worker thread
+        struct WorkerState {
+            SearchSpace* space;
+            vector<double> treeDistances;
+            vector<unsigned int> treePredecessors;
+            vector<unsigned int> treeGeneration;
+            unsigned int generation;
+        };
+
+        Graph* graph;
+        unsigned int maxQueued;
+        vector<thread> workers;
+        priority_queue< QueuedQuery, vector<QueuedQuery>, QueuedQueryOrder > queued;
+        mutex queuedMutex;
+        condition_variable queryAvailable;
+        bool stopping;
+        unsigned long nextSequence;
+        atomic<unsigned long> numAnswered;
+        atomic<unsigned long> numTimedOut;
+        atomic<unsigned long> numCancelled;
+        atomic<unsigned long> numRejected;
+
+        /// \brief
+        /// Loop run by each worker thread taking the most urgent query until the engine is destroyed
+        ///
+        void run();
+
+        /// \brief
+        /// Answers a distance or path query with a search that stops once the destination is settled
+        ///
+        /// \param query AsyncQuery* - the query to be answered
+        /// \param state WorkerState* - the search state of the worker answering it
+        /// \param result AsyncQueryResult* - filled with the answer
+        ///
+        void answerShortestPath(AsyncQuery* query, WorkerState* state, AsyncQueryResult* result);
+
+        /// \brief
+        /// Answers a minimum spanning tree query by walking the tree from the source until the destination is found,
+        /// finding the tree first if it is not already known
+        ///
+        /// \param query AsyncQuery* - the query to be answered
+        /// \param state WorkerState* - the search state of the worker answering it
+        /// \param result AsyncQueryResult* - filled with the answer
+        ///
+        void answerMinimumSpanningTree(AsyncQuery* query, WorkerState* state, AsyncQueryResult* result);
+
+        /// \brief
+        /// Answers a query and counts how it ended
+        ///
+        /// \param query AsyncQuery* - the query to be answered
+        /// \param result const AsyncQueryResult& - the answer
+        ///
+        void finish(AsyncQuery* query, const AsyncQueryResult& result);
+};
+
+#endif // ASYNCQUERYENGINE_H
@@ -0,0 +1,159 @@
+#ifndef BATCHCOORDINATOR_H
+#define BATCHCOORDINATOR_H
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <sys/types.h>
+#include "batchworker.h"
+
+using namespace std;
+
+/// This class runs an all pairs job over an external graph file with several local worker processes.
+/// The sources are split into shards of consecutive sources, and each worker is a child process with its
+/// own mapping of the graph file and a stream to the coordinator, over which it is given one shard at a
+/// time. Shards already on disk from an earlier run of the same graph are checked and kept, a worker that
+/// dies has its shard given to a replacement process, and a shard that keeps failing stops the job. The
+/// finished shards can be merged into one file of the same layout covering every source.
+///
+class BatchCoordinator
+{
+    public:
+
+        /// \brief
+        /// Prepares a job over a graph file
+        ///
+        /// \param graphPath const string& - the path of the file written by ExternalGraphWriter
+        /// \param directory const string& - the directory the shard files are written to
+        /// \param numProcesses unsigned int - the number of worker processes run at once
+        /// \param shardSources unsigned int - the number of sources in each shard
+        ///
+        BatchCoordinator(const string& graphPath, const string& directory, unsigned int numProcesses, unsigned int shardSources);
+
+        /// \brief
+        /// Stops any worker processes still running
+        ///
+        ~BatchCoordinator();
+
+        /// \brief
+        /// Writes every shard that is not already on disk, restarting workers that die
+        ///
+        /// \param error string* - set to the reason when the job could not be finished
+        /// \return bool - true if every shard is on disk
+        ///
+        bool run(string* error);
+
+        /// \brief
+        /// Merges the shards into one file covering every source, written under a temporary name and renamed
+        ///
+        /// \param outputPath const string& - the path of the merged file
+        /// \param error string* - set to the reason when the shards could not be merged
+        /// \return bool - true if the merged file was written
+        ///
+        bool merge(const string& outputPath, string* error);
+
+        /// \brief
+        /// Returns the number of shards the sources are split into
+        ///
+        /// \return unsigned int - the number of shards
+        ///
+        unsigned int getNumShards();
+
+        /// \brief
+        /// Returns the number of shards found already on disk by the last run
+        ///
+        /// \return unsigned int - the number of shards kept
+        ///
+        unsigned int getNumKept();
+
+        /// \brief
+        /// Returns the number of shards given to another worker after their worker died or failed them
+        ///
+        /// \return unsigned int - the number of restarted shards
+        ///
+        unsigned int getNumRestarts();
+
+        /// \brief
+        /// Returns the number of worker processes started by the last run
+        ///
+        /// \return unsigned int - the number of processes
+        ///
+        unsigned int getNumProcessesStarted();
+
+        /// \brief
+        /// Returns the process ids of the workers running now. It may be called from another thread while run
+        /// is going, for example to watch the workers or to signal them
+        ///
+        /// \return vector<pid_t> - the process ids
+        ///
+        vector<pid_t> getWorkerPids();
+
+        /// \brief
+        /// Returns whether a file is a complete shard of a graph for the sources given
+        ///
+        /// \param path const string& - the path of the shard file
+        /// \param numVertices unsigned int - the number of vertices within the graph
+        /// \param graphChecksum unsigned long long - the checksum of the graph file
+        /// \param firstSource unsigned int - the identifier of the first source
+        /// \param numSources unsigned int - the number of consecutive sources
+        /// \return bool - true if the header matches and the checksum of the rows is correct
+        ///
+        static bool checkShard(const string& path, unsigned int numVertices, unsigned long long graphChecksum,
+                               unsigned int firstSource, unsigned int numSources);
+
+    private:
+
+        /// A range of sources and how many times it has been given to a worker
+        struct Shard {
+            unsigned int firstSource;
+            unsigned int numSources;
+            unsigned int attempts;
+        };
+
+        /// A worker process, the coordinator's end of its stream and the shard it is working on
+        struct Process {
+            pid_t pid;
+            int channel;
+            string received;
+            int shard;
+        };
+
+        string graphPath;
+        string directory;
+        unsigned int numProcesses;
+        unsigned int shardSources;
+        unsigned int numVertices;
+        unsigned long long graphChecksum;
+        vector<Shard> shards;
+        vector<Process> processes;
+        mutex processesMutex;
+        unsigned int numKept;
+        unsigned int numRestarts;
+        unsigned int numProcessesStarted;
+
+        /// \brief
+        /// Forks a worker process connected to the coordinator by a stream
+        ///
+        /// \param process Process* - filled with the new process
+        /// \return bool - false if the process could not be started
+        ///
+        bool startProcess(Process* process);
+
+        /// \brief
+        /// Gives a worker process the next shard waiting, if any
+        ///
+        /// \param process Process* - the idle process
+        /// \param pending deque<unsigned int>* - the shards waiting for a worker
+        /// \return bool - false if the request could not be sent
+        ///
+        bool assign(Process* process, deque<unsigned int>* pending);
+
+        /// \brief
+        /// Stops a worker process and waits for it to end
+        ///
+        /// \param process Process* - the process
+        ///
+        void stopProcess(Process* process);
+};
+
+#endif // BATCHCOORDINATOR_H
@@ -0,0 +1,116 @@
+#ifndef BATCHWORKER_H
+#define BATCHWORKER_H
+#include <string>
+#include <vector>
+#include "externalgraphwriter.h"
+
+using namespace std;
+
+/// The start of a shard file, followed by the distances from each of its sources to every vertex in
+/// source order. A merged file of every source has the same layout, starting from source zero.
+struct ShardHeader {
+    char magic[8];
+    unsigned int numVertices;
+    unsigned int firstSource;
+    unsigned int numSources;
+    unsigned int reserved;
+    unsigned long long graphChecksum;
+    unsigned long long checksum;
+};
+
+/// This class is one worker process of a sharded all pairs job. It maps an external graph file read only,
+/// so every worker on the machine shares the same pages of it, and answers requests from the coordinator
+/// over a stream: each request names a range of sources, whose distances to every vertex are written to
+/// a shard file under a temporary name and renamed into place once complete, so a worker that dies part
+/// way through never leaves a shard that looks finished.
+///
+class BatchWorker
+{
+    public:
+
+        /// \brief
+        /// Prepares a worker for the graph file and the directory its shards are written to
+        ///
+        /// \param graphPath const string& - the path of the file written by ExternalGraphWriter
+        /// \param directory const string& - the directory the shard files are written to
+        ///
+        BatchWorker(const string& graphPath, const string& directory);
+
+        /// \brief
+        /// Unmaps the graph file
+        ///
+        ~BatchWorker();
+
+        /// \brief
+        /// Maps the graph file and works out its checksum
+        ///
+        /// \return bool - false if the file could not be mapped or is not an external graph file
+        ///
+        bool open();
+
+        /// \brief
+        /// Returns the number of vertices within the graph
+        ///
+        /// \return unsigned int - the number of vertices
+        ///
+        unsigned int getNumVertices();
+
+        /// \brief
+        /// Returns the checksum of the whole graph file, recorded in every shard taken from it
+        ///
+        /// \return unsigned long long - the checksum
+        ///
+        unsigned long long getGraphChecksum();
+
+        /// \brief
+        /// Finds the distances from a range of sources to every vertex and writes them to their shard file
+        ///
+        /// \param firstSource unsigned int - the identifier of the first source
+        /// \param numSources unsigned int - the number of consecutive sources
+        /// \return bool - false if the shard could not be written
+        ///
+        bool writeShard(unsigned int firstSource, unsigned int numSources);
+
+        /// \brief
+        /// Answers requests from the coordinator until it asks the worker to stop or closes the stream.
+        /// Requests are lines of "SHARD index first count attempt" or "QUIT"; each shard is answered with
+        /// "DONE index" or "FAILED index"
+        ///
+        /// \param channel int - the descriptor of the stream to the coordinator
+        ///
+        void serve(int channel);
+
+        /// \brief
+        /// Returns the path of the shard file for a range of sources
+        ///
+        /// \param directory const string& - the directory the shard files are written to
+        /// \param firstSource unsigned int - the identifier of the first source
+        /// \param numSources unsigned int - the number of consecutive sources
+        /// \return string - the path of the shard file
+        ///
+        static string getShardPath(const string& directory, unsigned int firstSource, unsigned int numSources);
+
+        /// The bytes every shard file starts with
+        static const char MAGIC[8];
+
+    private:
+        string graphPath;
+        string directory;
+        void* mapping;
+        unsigned long mappingLength;
+        const ExternalGraphHeader* header;
+        const unsigned long long* offsets;
+        const ExternalEdge* edges;
+        unsigned long long graphChecksum;
+
+        /// \brief
+        /// Finds the shortest distance from a source to every vertex of the mapped graph
+        ///
+        /// \param sourceId unsigned int - the identifier of the source
+        /// \param distances vector<double>* - filled with the distance to each vertex, or
+        /// ShortestPathTree::UNREACHABLE if there is no path
+        ///
+        void search(unsigned int sourceId, vector<double>* distances);
+};
+
+#endif // BATCHWORKER_H
@@ -0,0 +1,265 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+#include <vector>
+#include <ostream>
+#include <chrono>
+#include "graph.h"
+#include "point.h"
+#include "workerpool.h"
+
+using namespace std;
+
+/// This class generates a road like graph, where every city is joined to its nearest neighbours, and
+/// reports how long the query engines take on it compared to plain searches
+///
+class Benchmark
+{
+    public:
+
+        /// \brief
+        /// Generates the graph the benchmarks are run on
+        ///
+        /// \param numCities unsigned int - the number of cities in the generated graph
+        /// \param numWorkers unsigned int - the number of worker threads, or zero for one per hardware thread
+        ///
+        Benchmark(unsigned int numCities, unsigned int numWorkers);
+
+        /// \brief
+        /// Deletes the generated graph, its cities and the worker pool
+        ///
+        ~Benchmark();
+
+        /// \brief
+        /// Runs every benchmark and writes a report of the timings
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void run(ostream& out);
+
+        /// \brief
+        /// Generates a graph of cities placed at random on the Cartesian plane, each joined to its nearest
+        /// neighbours by an edge weighted with the distance between them
+        ///
+        /// \param numCities unsigned int - the number of cities in the graph
+        /// \param seed unsigned int - the seed for the random placement, so the same graph can be generated again
+        /// \param cities vector<Point*>* - filled with the co-ordinates of each city
+        /// \return Graph* - the generated graph
+        ///
+        static Graph* generateRoadGraph(unsigned int numCities, unsigned int seed, vector<Point*>* cities);
+
+    private:
+        unsigned int numCities;
+        Graph* graph;
+        vector<Point*> cities;
+        WorkerPool* pool;
+
+        /// \brief
+        /// Compares the many to many distance table against one full search per source
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkDistanceTable(ostream& out);
+
+        /// \brief
+        /// Compares radius and nearest target searches that stop early against full searches from the same sources
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkNearestSearch(ostream& out);
+
+        /// \brief
+        /// Compares repairing a shortest path tree after traffic changes edge weights against searching again,
+        /// putting every weight back afterwards
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkDynamicShortestPathTree(ostream& out);
+
+        /// \brief
+        /// Reports the build time, label sizes and query latency of the hub labels, checking them against searches
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkHubLabels(ostream& out);
+
+        /// \brief
+        /// Reports the partition and customisation times of the customisable route planner and compares its
+        /// queries against point to point searches that stop at the destination
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkCustomizableRoutePlanner(ostream& out);
+
+        /// \brief
+        /// Compares breadth first searches from many sources at once, at each batch width, against one search per source
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkMultiSourceBfs(ostream& out);
+
+        /// \brief
+        /// Reports the throughput of the asynchronous query engine when callers wait for room in its queue,
+        /// and how quickly queries stop once their deadline passes or they are cancelled
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkAsyncQueryEngine(ostream& out);
+
+        /// \brief
+        /// Compares building the minimum spanning tree and hub labels against taking them from a snapshot, and
+        /// checks that a snapshot is refused for a graph with a different fingerprint
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkSnapshot(ostream& out);
+
+        /// \brief
+        /// Writes the graph to an external graph file and searches it with memory capped at a fraction of the
+        /// size of its edges, checking the distances and hops found against searches of the graph in memory
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkExternalGraph(ostream& out);
+
+        /// \brief
+        /// Compares searches of compact graphs stored with different weight and identifier types against
+        /// searches of the graph itself, reporting the memory each uses an edge and the largest error its
+        /// weights introduce
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkCompactGraph(ostream& out);
+
+        /// \brief
+        /// Compares the memory and search times of the compressed graph against the flat arrays of a compact
+        /// graph, and the error its quantised weights introduce
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkCompressedGraph(ostream& out);
+
+        /// \brief
+        /// Compares searches of compact graphs stored in the input order, along a Hilbert curve, in reverse
+        /// Cuthill-McKee order and in breadth first order, counting cache misses where the processor allows
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkVertexOrder(ostream& out);
+
+        /// \brief
+        /// Compares working out a large batch of edge lengths and every row of the distance matrix with the
+        /// point set's scalar and AVX2 kernels against calling Point::distanceTo one pair at a time
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkPointSet(ostream& out);
+
+        /// \brief
+        /// Builds a large compact graph from edges added by every worker at once, and checks that a sample of
+        /// the edges added can be found in it
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkGraphBuilder(ostream& out);
+
+        /// \brief
+        /// Labels the components of the graph, cuts it into strips so that it falls apart and joins it up again,
+        /// checking the index against a fresh labelling at each step. Point to point searches between random
+        /// cities of the cut graph are timed with and without the index answering the unreachable pairs
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkComponentIndex(ostream& out);
+
+        /// \brief
+        /// Builds spanners of the complete graph of the first cities for several stretch factors, reporting how
+        /// many edges each keeps and checking the stretch of its shortest paths and its minimum spanning tree
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkGeometricSpanner(ostream& out);
+
+        /// \brief
+        /// Builds approximate distance oracles with several numbers of levels, reporting their size, build time and
+        /// query latency, and measuring their stretch against full searches from a sample of sources
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkDistanceOracle(ostream& out);
+
+        /// \brief
+        /// Answers random queries with every engine the query planner could choose, first with searches alone and
+        /// then with hub labels, a route planner and an oracle to choose from as well, reporting how often the
+        /// planner chose the engine that was measured to be fastest and the time its choices took against always
+        /// using the fastest engine or always using Dijkstra
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkQueryPlanner(ostream& out);
+
+        /// \brief
+        /// Times point to point queries on a versioned graph while it is left alone and again while a writer thread
+        /// publishes a continuous stream of weight changes, checking every version a query saw was whole
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkVersionedGraph(ostream& out);
+
+        /// \brief
+        /// Runs an all pairs job over the graph with several worker processes, killing them part way through a
+        /// shard, checks the merged distances against full searches, then runs the job again after removing one
+        /// shard to show only that shard is redone
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkBatchCoordinator(ostream& out);
+
+        /// \brief
+        /// Compares the binary heap with Dial's buckets and a radix heap, first on their own with a monotone stream of
+        /// operations like a large search makes, then as the queue of full searches over copies of the graph whose
+        /// weights are rounded to a coarse and a fine quantum, reporting the rounding error against the exact graph
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkIntegerQueues(ostream& out);
+
+        /// \brief
+        /// Finds the k shortest simple paths between random pairs of vertices and compares the time taken with a point
+        /// to point search between the same pairs, checking every path found is simple, joins its endpoints along edges
+        /// of the graph with the length reported, and that the paths are distinct and shortest first
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkKShortestPaths(ostream& out);
+
+        /// \brief
+        /// Makes random what-if edits to the graph, adding shortcut roads, closing roads and doubling or halving
+        /// weights, while a dynamic spanning forest follows them, checking its cost and number of trees against the
+        /// forest built from scratch at intervals, then putting every edit back
+        ///
+        /// \param out ostream& - the output the report is written to
+        ///
+        void benchmarkDynamicSpanningForest(ostream& out);
+
+        /// \brief
+        /// Searches a compact graph with the given weight and identifier types from each source and reports the
+        /// time taken, the memory used an edge and the largest difference from the trees of the graph itself
+        ///
+        /// \param out ostream& - the output the report is written to
+        /// \param name const char* - the name the compact graph is reported under
+        /// \param sources const vector<unsigned int>& - the identifiers of the sources
+        /// \param trees vector<ShortestPathTree>* - the shortest path tree of the graph from each source
+        ///
+        template <typename Weight, typename Id>
+        void reportCompactGraph(ostream& out, const char* name, const vector<unsigned int>& sources, vector<ShortestPathTree>* trees);
+
+        /// \brief
+        /// Returns the number of seconds since a point in time
+        ///
+        /// \param start chrono::steady_clock::time_point - the point in time timing began
+        /// \return double - the number of seconds elapsed
+        ///
+        static double secondsSince(chrono::steady_clock::time_point start);
+};
+
+#endif // BENCHMARK_H
@@ -0,0 +1,45 @@
+#ifndef CACHEMISSCOUNTER_H
+#define CACHEMISSCOUNTER_H
+
+/// This class counts the cache misses of the calling thread through the hardware counters of the
+/// processor. Counters are often unavailable, in virtual machines or where the kernel forbids them, so
+/// callers check isAvailable and report timings alone when it is false.
+///
+class CacheMissCounter
+{
+    public:
+
+        /// \brief
+        /// Opens a counter of the last level cache misses of the calling thread
+        ///
+        CacheMissCounter();
+
+        /// \brief
+        /// Closes the counter
+        ///
+        ~CacheMissCounter();
+
+        /// \brief
+        /// Returns whether the counter could be opened
+        ///
+        /// \return bool - true if the processor's cache misses can be counted
+        ///
+        bool isAvailable();
+
+        /// \brief
+        /// Sets the count to zero and starts counting
+        ///
+        void start();
+
+        /// \brief
+        /// Stops counting and returns the number of cache misses since start was called
+        ///
+        /// \return unsigned long long - the number of cache misses, or zero if the counter is unavailable
+        ///
+        unsigned long long stop();
+
+    private:
+        int descriptor;
+};
+
+#endif // CACHEMISSCOUNTER_H
@@ -0,0 +1,508 @@
+#ifndef COMPACTGRAPH_H
+#define COMPACTGRAPH_H
+#include <vector>
+#include <queue>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <cmath>
+#include "graph.h"
+#include "disjointset.h"
+#include "vertexorder.h"
+
+using namespace std;
+
+/// This structure describes how a type of edge weight is stored and added up. Floating point weights
+/// are stored as they are and summed in double precision; unsigned int weights are fixed point numbers
+/// counting hundredths, summed exactly in 64 bits, which lets searches over them use a bucket queue.
+///
+template <typename Weight>
+struct WeightTraits;
+
+template <>
+struct WeightTraits<float> {
+    typedef double Distance;
+    static const bool INTEGRAL = false;
+    static float encode(double weight) { return (float) weight; }
+    static double decode(double distance) { return distance; }
+};
+
+template <>
+struct WeightTraits<double> {
+    typedef double Distance;
+    static const bool INTEGRAL = false;
+    static double encode(double weight) { return weight; }
+    static double decode(double distance) { return distance; }
+};
+
+template <>
+struct WeightTraits<unsigned int> {
+    typedef unsigned long long Distance;
+    static const bool INTEGRAL = true;
+    static unsigned int encode(double weight) { return (unsigned int) floor(weight * 100.0 + 0.5); }
+    static double decode(unsigned long long distance) { return distance / 100.0; }
+};
+
+/// This class is a read only copy of a graph laid out for searching, with the edges of each vertex held
+/// next to one another in a target array and a weight array indexed by an offset per vertex. It is a
+/// template over the type of the weights and of the vertex identifiers, so a graph stored with unsigned
+/// int identifiers and float weights costs 8 bytes an edge, while 64 bit identifiers allow graphs with
+/// more edges than an unsigned int can count. The search kernel is chosen when the template is compiled:
+/// integral weights are searched with a bucket queue indexed by distance and floating point weights with
+/// a binary heap.
+///
+/// The vertices may be stored in a different order from the graph's, such as one that keeps neighbours
+/// close together in memory. Callers still use the graph's identifiers and receive results indexed by
+/// them; the order is only applied inside.
+///
+template <typename Weight, typename Id>
+class CompactGraph
+{
+    public:
+        typedef typename WeightTraits<Weight>::Distance Distance;
+
+        /// \brief
+        /// Copies the edges of a graph, converting their weights to the weight type
+        ///
+        /// \param graph Graph* - the graph to be copied
+        ///
+        CompactGraph(Graph* graph);
+
+        /// \brief
+        /// Copies the edges of a graph, storing the vertices in the given order. The order must outlive
+        /// the compact graph
+        ///
+        /// \param graph Graph* - the graph to be copied
+        /// \param order VertexOrder* - the order the vertices are stored in, or NULL for the graph's own
+        ///
+        CompactGraph(Graph* graph, VertexOrder* order);
+
+        /// \brief
+        /// Takes over arrays of offsets, targets and weights that are already laid out, such as those made
+        /// by GraphBuilder. The arrays given are left empty
+        ///
+        /// \param offsets vector<Id>* - the index of the first edge of each vertex, followed by the number of edges
+        /// \param targets vector<Id>* - the other end of each edge
+        /// \param weights vector<Weight>* - the weight of each edge
+        ///
+        CompactGraph(vector<Id>* offsets, vector<Id>* targets, vector<Weight>* weights);
+
+        /// \brief
+        /// There was no dynamically created items in this class so there is no need for a destructor method body
+        ///
+        ~CompactGraph();
+
+        /// \brief
+        /// Returns the number of vertices within the graph
+        ///
+        /// \return Id - the number of vertices
+        ///
+        Id getNumVertices();
+
+        /// \brief
+        /// Returns the number of edges, counting each direction of an edge once
+        ///
+        /// \return Id - the number of stored edges
+        ///
+        Id getNumEdges();
+
+        /// \brief
+        /// Finds the shortest distance from a source to every vertex
+        ///
+        /// \param sourceId Id - the identifier of the source
+        /// \param distances vector<Distance>* - filled with the distance to each vertex, or UNREACHABLE
+        ///
+        void shortestDistances(Id sourceId, vector<Distance>* distances);
+
+        /// \brief
+        /// Finds the fewest edges from a source to every vertex
+        ///
+        /// \param sourceId Id - the identifier of the source
+        /// \param hops vector<Id>* - filled with the number of edges to each vertex, or UNREACHED
+        ///
+        void hopDistances(Id sourceId, vector<Id>* hops);
+
+        /// \brief
+        /// Uses Kruskals algorithm to find the cost of the minimum spanning forest of the graph
+        ///
+        /// \return double - the cost of the minimum spanning forest
+        ///
+        double minimumSpanningTreeCost();
+
+        /// \brief
+        /// Converts a distance to the units of the original graph
+        ///
+        /// \param distance Distance - the distance in the weight type's units
+        /// \return double - the distance in the original units
+        ///
+        static double toDouble(Distance distance);
+
+        /// \brief
+        /// Returns the number of bytes used by the offsets and edges
+        ///
+        /// \return unsigned long - the memory used in bytes
+        ///
+        unsigned long memoryUsage();
+
+        /// The distance given to a vertex that cannot be reached
+        static const Distance UNREACHABLE;
+
+        /// The number of hops given to a vertex that cannot be reached
+        static const Id UNREACHED;
+
+    private:
+        typedef pair<Distance, Id> QueueEntry;
+
+        vector<Id> offsets;
+        vector<Id> targets;
+        vector<Weight> weights;
+        Weight maxWeight;
+        VertexOrder* order;
+
+        /// \brief
+        /// Finds the fewest edges from a source to every vertex, in the order of storage
+        ///
+        /// \param sourceId Id - the identifier of the source within storage
+        /// \param hops vector<Id>* - filled with the number of edges to each vertex, or UNREACHED
+        ///
+        void breadthFirst(Id sourceId, vector<Id>* hops);
+
+        /// \brief
+        /// Finds the shortest distances with a circular array of buckets, one for every distance that can
+        /// be queued at once, which needs no comparisons between queued vertices
+        ///
+        /// \param sourceId Id - the identifier of the source
+        /// \param distances vector<Distance>* - filled with the distance to each vertex
+        ///
+        void shortestDistances(Id sourceId, vector<Distance>* distances, true_type);
+
+        /// \brief
+        /// Finds the shortest distances with a binary heap
+        ///
+        /// \param sourceId Id - the identifier of the source
+        /// \param distances vector<Distance>* - filled with the distance to each vertex
+        ///
+        void shortestDistances(Id sourceId, vector<Distance>* distances, false_type);
+};
+
+template <typename Weight, typename Id>
+const typename CompactGraph<Weight, Id>::Distance CompactGraph<Weight, Id>::UNREACHABLE = numeric_limits<Distance>::max();
+
+template <typename Weight, typename Id>
+const Id CompactGraph<Weight, Id>::UNREACHED = numeric_limits<Id>::max();
+
+/// \brief
+/// Copies the edges of a graph, converting their weights to the weight type
+///
+/// \param graph Graph* - the graph to be copied
+///
+template <typename Weight, typename Id>
+CompactGraph<Weight, Id>::CompactGraph(Graph* graph) : CompactGraph(graph, NULL) {
+}
+
+/// \brief
+/// Copies the edges of a graph, storing the vertices in the given order. The order must outlive
+/// the compact graph
+///
+/// \param graph Graph* - the graph to be copied
+/// \param order VertexOrder* - the order the vertices are stored in, or NULL for the graph's own
+///
+template <typename Weight, typename Id>
+CompactGraph<Weight, Id>::CompactGraph(Graph* graph, VertexOrder* order) {
+    unsigned int numVertices = graph->getNumVertices();
+    this->order = order;
+    this->offsets.assign(numVertices + 1, 0);
+    for (unsigned int i = 0; i < numVertices; i++) {
+        unsigned int uId = order != NULL ? order->toExternal(i) : i;
+        this->offsets[i + 1] = this->offsets[i] + graph->getNeighbours(uId)->size();
+    }
+
+    this->targets.resize(this->offsets[numVertices]);
+    this->weights.resize(this->offsets[numVertices]);
+    this->maxWeight = 0;
+    for (unsigned int i = 0; i < numVertices; i++) {
+        unsigned int uId = order != NULL ? order->toExternal(i) : i;
+        vector<unsigned int>* neighbours = graph->getNeighbours(uId);
+        for (unsigned int j = 0; j < neighbours->size(); j++) {
+            Id e = this->offsets[i] + j;
+            unsigned int vId = (*neighbours)[j];
+            this->targets[e] = order != NULL ? order->toInternal(vId) : vId;
+            this->weights[e] = WeightTraits<Weight>::encode(graph->getWeight(uId, vId));
+            this->maxWeight = max(this->maxWeight, this->weights[e]);
+        }
+    }
+}
+
+/// \brief
+/// Takes over arrays of offsets, targets and weights that are already laid out, such as those made
+/// by GraphBuilder. The arrays given are left empty
+///
+/// \param offsets vector<Id>* - the index of the first edge of each vertex, followed by the number of edges
+/// \param targets vector<Id>* - the other end of each edge
+/// \param weights vector<Weight>* - the weight of each edge
+///
+template <typename Weight, typename Id>
+CompactGraph<Weight, Id>::CompactGraph(vector<Id>* offsets, vector<Id>* targets, vector<Weight>* weights) {
+    this->order = NULL;
+    this->offsets.swap(*offsets);
+    this->targets.swap(*targets);
+    this->weights.swap(*weights);
+    this->maxWeight = 0;
+    for (Id e = 0; e < this->weights.size(); e++) {
+        this->maxWeight = max(this->maxWeight, this->weights[e]);
+    }
+}
+
+/// \brief
+/// There was no dynamically created items in this class so there is no need for a destructor method body
+///
+template <typename Weight, typename Id>
+CompactGraph<Weight, Id>::~CompactGraph() {
+}
+
+/// \brief
+/// Returns the number of vertices within the graph
+///
+/// \return Id - the number of vertices
+///
+template <typename Weight, typename Id>
+Id CompactGraph<Weight, Id>::getNumVertices() {
+    return this->offsets.size() - 1;
+}
+
+/// \brief
+/// Returns the number of edges, counting each direction of an edge once
+///
+/// \return Id - the number of stored edges
+///
+template <typename Weight, typename Id>
+Id CompactGraph<Weight, Id>::getNumEdges() {
+    return this->targets.size();
+}
+
+/// \brief
+/// Finds the shortest distance from a source to every vertex
+///
+/// \param sourceId Id - the identifier of the source
+/// \param distances vector<Distance>* - filled with the distance to each vertex, or UNREACHABLE
+///
+template <typename Weight, typename Id>
+void CompactGraph<Weight, Id>::shortestDistances(Id sourceId, vector<Distance>* distances) {
+    if (this->order == NULL) {
+        distances->assign(getNumVertices(), UNREACHABLE);
+        shortestDistances(sourceId, distances, integral_constant<bool, WeightTraits<Weight>::INTEGRAL>());
+        return;
+    }
+
+    // Search in the order of storage, then hand the distances back under the graph's identifiers
+    vector<Distance> stored(getNumVertices(), UNREACHABLE);
+    shortestDistances(this->order->toInternal(sourceId), &stored, integral_constant<bool, WeightTraits<Weight>::INTEGRAL>());
+    distances->resize(getNumVertices());
+    for (Id i = 0; i < getNumVertices(); i++) {
+        (*distances)[this->order->toExternal(i)] = stored[i];
+    }
+}
+
+/// \brief
+/// Finds the fewest edges from a source to every vertex
+///
+/// \param sourceId Id - the identifier of the source
+/// \param hops vector<Id>* - filled with the number of edges to each vertex, or UNREACHED
+///
+template <typename Weight, typename Id>
+void CompactGraph<Weight, Id>::hopDistances(Id sourceId, vector<Id>* hops) {
+    if (this->order == NULL) {
+        breadthFirst(sourceId, hops);
+        return;
+    }
+
+    vector<Id> stored;
+    breadthFirst(this->order->toInternal(sourceId), &stored);
+    hops->resize(getNumVertices());
+    for (Id i = 0; i < getNumVertices(); i++) {
+        (*hops)[this->order->toExternal(i)] = stored[i];
+    }
+}
+
+/// \brief
+/// Uses Kruskals algorithm to find the cost of the minimum spanning forest of the graph
+///
+/// \return double - the cost of the minimum spanning forest
+///
+template <typename Weight, typename Id>
+double CompactGraph<Weight, Id>::minimumSpanningTreeCost() {
+
+    // Each edge is stored in both directions, so only the direction from the smaller identifier is used
+    vector< pair<Weight, Id> > byWeight;
+    vector<Id> sources(getNumEdges());
+    for (Id uId = 0; uId < getNumVertices(); uId++) {
+        for (Id e = this->offsets[uId]; e < this->offsets[uId + 1]; e++) {
+            sources[e] = uId;
+            if (uId < this->targets[e]) {
+                byWeight.push_back(make_pair(this->weights[e], e));
+            }
+        }
+    }
+    sort(byWeight.begin(), byWeight.end());
+
+    BasicDisjointSet<Id> dSet(getNumVertices());
+    Distance cost = 0;
+    for (Id i = 0; i < byWeight.size(); i++) {
+        Id e = byWeight[i].second;
+        if (!dSet.sameComponent(sources[e], this->targets[e])) {
+            dSet.join(sources[e], this->targets[e]);
+            cost += byWeight[i].first;
+        }
+    }
+    return toDouble(cost);
+}
+
+/// \brief
+/// Converts a distance to the units of the original graph
+///
+/// \param distance Distance - the distance in the weight type's units
+/// \return double - the distance in the original units
+///
+template <typename Weight, typename Id>
+double CompactGraph<Weight, Id>::toDouble(Distance distance) {
+    return WeightTraits<Weight>::decode(distance);
+}
+
+/// \brief
+/// Returns the number of bytes used by the offsets and edges
+///
+/// \return unsigned long - the memory used in bytes
+///
+template <typename Weight, typename Id>
+unsigned long CompactGraph<Weight, Id>::memoryUsage() {
+    return this->offsets.size() * sizeof(Id) + this->targets.size() * sizeof(Id) + this->weights.size() * sizeof(Weight);
+}
+
+/// \brief
+/// Finds the fewest edges from a source to every vertex, in the order of storage
+///
+/// \param sourceId Id - the identifier of the source within storage
+/// \param hops vector<Id>* - filled with the number of edges to each vertex, or UNREACHED
+///
+template <typename Weight, typename Id>
+void CompactGraph<Weight, Id>::breadthFirst(Id sourceId, vector<Id>* hops) {
+    hops->assign(getNumVertices(), UNREACHED);
+    vector<Id> queue(1, sourceId);
+    (*hops)[sourceId] = 0;
+
+    // The queue only grows, so it is read from the front without removing anything
+    for (Id head = 0; head < queue.size(); head++) {
+        Id uId = queue[head];
+        for (Id e = this->offsets[uId]; e < this->offsets[uId + 1]; e++) {
+            if ((*hops)[this->targets[e]] == UNREACHED) {
+                (*hops)[this->targets[e]] = (*hops)[uId] + 1;
+                queue.push_back(this->targets[e]);
+            }
+        }
+    }
+}
+
+/// \brief
+/// Finds the shortest distances with a circular array of buckets, one for every distance that can
+/// be queued at once, which needs no comparisons between queued vertices
+///
+/// \param sourceId Id - the identifier of the source
+/// \param distances vector<Distance>* - filled with the distance to each vertex
+///
+template <typename Weight, typename Id>
+void CompactGraph<Weight, Id>::shortestDistances(Id sourceId, vector<Distance>* distances, true_type) {
+
+    // Every queued distance lies within the heaviest edge of the one being settled, so the buckets wrap
+    // around without two distances ever sharing a bucket. A bit for each bucket that holds vertices lets
+    // long runs of empty buckets be stepped over a word at a time
+    unsigned long numBuckets = (unsigned long) this->maxWeight + 1;
+    vector< vector<Id> > buckets(numBuckets);
+    vector<unsigned long long> occupied((numBuckets + 63) / 64, 0);
+    vector<Distance>& distance = *distances;
+    distance[sourceId] = 0;
+    buckets[0].push_back(sourceId);
+    Id numQueued = 1;
+    Distance current = 0;
+    unsigned long position = 0;
+
+    while (true) {
+        vector<Id>& bucket = buckets[position];
+
+        // Edges of weight zero add to the bucket being emptied, so it is read by index
+        for (Id i = 0; i < bucket.size(); i++) {
+            Id uId = bucket[i];
+            numQueued--;
+            if (distance[uId] != current) {
+                continue;
+            }
+
+            for (Id e = this->offsets[uId]; e < this->offsets[uId + 1]; e++) {
+                Distance through = current + this->weights[e];
+                if (through < distance[this->targets[e]]) {
+                    unsigned long into = through % numBuckets;
+                    distance[this->targets[e]] = through;
+                    buckets[into].push_back(this->targets[e]);
+                    occupied[into / 64] |= 1ULL << (into % 64);
+                    numQueued++;
+                }
+            }
+        }
+        bucket.clear();
+        occupied[position / 64] &= ~(1ULL << (position % 64));
+
+        if (numQueued == 0) {
+            break;
+        }
+
+        // Find the next bucket holding vertices, wrapping around the end of the array
+        unsigned long next = position + 1 == numBuckets ? 0 : position + 1;
+        while (true) {
+            unsigned long long word = occupied[next / 64] >> (next % 64);
+            if (word != 0) {
+                next += __builtin_ctzll(word);
+                break;
+            }
+            next = (next / 64 + 1) * 64;
+            if (next >= numBuckets) {
+                next = 0;
+            }
+        }
+        current += (next + numBuckets - position) % numBuckets;
+        position = next;
+    }
+}
+
+/// \brief
+/// Finds the shortest distances with a binary heap
+///
+/// \param sourceId Id - the identifier of the source
+/// \param distances vector<Distance>* - filled with the distance to each vertex
+///
+template <typename Weight, typename Id>
+void CompactGraph<Weight, Id>::shortestDistances(Id sourceId, vector<Distance>* distances, false_type) {
+    priority_queue< QueueEntry, vector<QueueEntry>, greater<QueueEntry> > unvisitedVerticesQueue;
+    vector<Distance>& distance = *distances;
+    distance[sourceId] = 0;
+    unvisitedVerticesQueue.push(QueueEntry(0, sourceId));
+
+    while (!unvisitedVerticesQueue.empty()) {
+        QueueEntry closest = unvisitedVerticesQueue.top();
+        unvisitedVerticesQueue.pop();
+
+        // Skip queue entries left behind when a shorter path was found
+        if (closest.first != distance[closest.second]) {
+            continue;
+        }
+
+        for (Id e = this->offsets[closest.second]; e < this->offsets[closest.second + 1]; e++) {
+            Distance through = closest.first + this->weights[e];
+            if (through < distance[this->targets[e]]) {
+                distance[this->targets[e]] = through;
+                unvisitedVerticesQueue.push(QueueEntry(through, this->targets[e]));
+            }
+        }
+    }
+}
+
+#endif // COMPACTGRAPH_H
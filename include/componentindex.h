@@ -0,0 +1,104 @@
+#ifndef COMPONENTINDEX_H
+#define COMPONENTINDEX_H
+#include <vector>
+#include "graph.h"
+#include "graphobserver.h"
+#include "workerpool.h"
+
+using namespace std;
+
+/// This class labels every vertex with the connected component it belongs to, so whether one vertex can
+/// reach another is known without searching. The labels are worked out once by the workers together and
+/// then kept up to date as edges are added or removed: a new edge between two components moves the
+/// smaller one into the larger, and a removed edge searches outwards from both of its ends at once until
+/// they meet or one side runs out, which then becomes a component of its own. The index attaches itself
+/// to the graph so every search of the graph can skip the vertices a source cannot reach.
+///
+class ComponentIndex : public GraphObserver
+{
+    public:
+
+        /// \brief
+        /// Labels the components of the graph and attaches the index to it
+        ///
+        /// \param graph Graph* - the graph the components are kept for
+        /// \param pool WorkerPool* - the workers the labelling is shared between
+        ///
+        ComponentIndex(Graph* graph, WorkerPool* pool);
+
+        /// \brief
+        /// Detaches the index from the graph
+        ///
+        ~ComponentIndex();
+
+        /// \brief
+        /// Returns the label of the component a vertex belongs to
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \return unsigned int - the component label, shared by every vertex of the component
+        ///
+        unsigned int getComponent(unsigned int identifier);
+
+        /// \brief
+        /// Returns whether there is a path between two vertices
+        ///
+        /// \param sourceId unsigned int - the identifier of the first vertex
+        /// \param destinationId unsigned int - the identifier of the second vertex
+        /// \return bool - true if both vertices are in the same component
+        ///
+        bool isReachable(unsigned int sourceId, unsigned int destinationId);
+
+        /// \brief
+        /// Returns the number of vertices in the component of a vertex
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \return unsigned int - the size of its component, including the vertex itself
+        ///
+        unsigned int getComponentSize(unsigned int identifier);
+
+        /// \brief
+        /// Returns the number of components within the graph
+        ///
+        /// \return unsigned int - the number of components
+        ///
+        unsigned int getNumComponents();
+
+        /// \brief
+        /// Joins or splits components when an edge is added or removed; weight changes leave them as they are
+        ///
+        /// \param sourceId unsigned int - the identifier of the first vertex of the edge
+        /// \param destinationId unsigned int - the identifier of the second vertex of the edge
+        /// \param oldWeight double - the weight before the change, or NO_EDGE if the edge is new
+        /// \param newWeight double - the weight after the change, or NO_EDGE if the edge was removed
+        ///
+        void edgeChanged(unsigned int sourceId, unsigned int destinationId, double oldWeight, double newWeight);
+
+    private:
+        Graph* graph;
+        vector<unsigned int> labels;
+        vector< vector<unsigned int> > members;
+        vector<unsigned int> positions;
+        vector<unsigned int> freeLabels;
+        unsigned int numComponents;
+        vector<unsigned int> seen[2];
+        unsigned int generation;
+
+        /// \brief
+        /// Moves the smaller of two components into the larger
+        ///
+        /// \param sourceId unsigned int - the identifier of a vertex of the first component
+        /// \param destinationId unsigned int - the identifier of a vertex of the second component
+        ///
+        void join(unsigned int sourceId, unsigned int destinationId);
+
+        /// \brief
+        /// Gives the vertices on one side of a removed edge a component of their own if the edge was the
+        /// only connection between them and the other side
+        ///
+        /// \param sourceId unsigned int - the identifier of the first vertex of the removed edge
+        /// \param destinationId unsigned int - the identifier of the second vertex of the removed edge
+        ///
+        void split(unsigned int sourceId, unsigned int destinationId);
+};
+
+#endif // COMPONENTINDEX_H
@@ -0,0 +1,108 @@
+#ifndef COMPRESSEDGRAPH_H
+#define COMPRESSEDGRAPH_H
+#include <vector>
+#include "graph.h"
+
+using namespace std;
+
+/// This class is a read only copy of a graph compressed for graphs too large to hold as flat arrays.
+/// The edges of each vertex are sorted by target and written to one byte stream as variable length
+/// integers: the number of edges, then each target as the gap from the one before it (the first as a
+/// signed gap from the vertex itself) followed by its weight rounded to a whole number of quanta.
+/// Small gaps and weights take a single byte, and searches decode each list as they scan it.
+///
+/// The start of each vertex's list is found from a 64 bit offset shared by a block of vertices and
+/// a 32 bit offset within the block, so the stream may grow beyond 4 GB.
+///
+class CompressedGraph
+{
+    public:
+
+        /// \brief
+        /// Compresses the edges of a graph
+        ///
+        /// \param graph Graph* - the graph to be compressed
+        /// \param quantum double - the weights are stored as whole multiples of this amount
+        ///
+        CompressedGraph(Graph* graph, double quantum);
+
+        /// \brief
+        /// There was no dynamically created items in this class so there is no need for a destructor method body
+        ///
+        ~CompressedGraph();
+
+        /// \brief
+        /// Returns the number of vertices within the graph
+        ///
+        /// \return unsigned int - the number of vertices
+        ///
+        unsigned int getNumVertices();
+
+        /// \brief
+        /// Returns the number of edges, counting each direction of an edge once
+        ///
+        /// \return unsigned long - the number of stored edges
+        ///
+        unsigned long getNumEdges();
+
+        /// \brief
+        /// Returns the amount the weights are stored as multiples of
+        ///
+        /// \return double - the quantum
+        ///
+        double getQuantum();
+
+        /// \brief
+        /// Decodes the edges leaving a vertex
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \param targets vector<unsigned int>* - filled with the other end of each edge, in ascending order
+        /// \param weights vector<double>* - filled with the quantised weight of each edge
+        ///
+        void getEdges(unsigned int identifier, vector<unsigned int>* targets, vector<double>* weights);
+
+        /// \brief
+        /// Finds the shortest distance from a source to every vertex, adding up the quantised weights exactly
+        ///
+        /// \param sourceId unsigned int - the identifier of the source
+        /// \param distances vector<double>* - filled with the distance to each vertex, or
+        /// ShortestPathTree::UNREACHABLE if there is no path
+        ///
+        void shortestDistances(unsigned int sourceId, vector<double>* distances);
+
+        /// \brief
+        /// Finds the fewest edges from a source to every vertex
+        ///
+        /// \param sourceId unsigned int - the identifier of the source
+        /// \param hops vector<unsigned int>* - filled with the number of edges to each vertex, or UNREACHED
+        ///
+        void hopDistances(unsigned int sourceId, vector<unsigned int>* hops);
+
+        /// \brief
+        /// Returns the number of bytes used by the stream and the offsets into it
+        ///
+        /// \return unsigned long - the memory used in bytes
+        ///
+        unsigned long memoryUsage();
+
+        /// The number of hops given to a vertex that cannot be reached
+        static const unsigned int UNREACHED;
+
+    private:
+        unsigned int numVertices;
+        unsigned long numEdges;
+        double quantum;
+        vector<unsigned char> stream;
+        vector<unsigned long long> blockOffsets;
+        vector<unsigned int> vertexOffsets;
+
+        /// \brief
+        /// Returns the start of a vertex's list within the stream
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \return const unsigned char* - a pointer to the number of edges that begins the list
+        ///
+        const unsigned char* listOf(unsigned int identifier);
+};
+
+#endif // COMPRESSEDGRAPH_H
@@ -0,0 +1,134 @@
+#ifndef CUSTOMIZABLEROUTEPLANNER_H
+#define CUSTOMIZABLEROUTEPLANNER_H
+#include <vector>
+#include <queue>
+#include <functional>
+#include "graph.h"
+#include "multilevelpartition.h"
+#include "workerpool.h"
+
+using namespace std;
+
+/// This class answers point to point distance queries over an overlay built on a multilevel partition.
+/// Finding the boundary vertices of each cell depends only on which edges exist and is done once. The
+/// distances across each cell between its boundary vertices depend on the weights and are found by
+/// customise, which can be run again in parallel whenever the weights change. Queries search the
+/// original edges near the source and target and jump across the cells in between.
+///
+class CustomizableRoutePlanner
+{
+    public:
+
+        /// \brief
+        /// Finds the boundary vertices of every cell. Edges added between cells afterwards need a new planner
+        ///
+        /// \param graph Graph* - the graph the weights are taken from
+        /// \param partition MultilevelPartition* - the cells of the graph, which must already be built
+        ///
+        CustomizableRoutePlanner(Graph* graph, MultilevelPartition* partition);
+
+        /// \brief
+        /// There was no dynamically created items in this class so there is no need for a destructor method body
+        ///
+        ~CustomizableRoutePlanner();
+
+        /// \brief
+        /// Computes the distances between the boundary vertices of every cell from the current weights of
+        /// the graph, a level at a time from the smallest cells up, sharing the cells of each level between the workers
+        ///
+        /// \param pool WorkerPool* - the workers the cells are shared between
+        ///
+        void customise(WorkerPool* pool);
+
+        /// \brief
+        /// Returns the shortest path distance between two vertices. Only one query may run at a time
+        ///
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        /// \param destinationId unsigned int - the identifier of the destination vertex
+        /// \return double - the distance, or ShortestPathTree::UNREACHABLE if there is no path
+        ///
+        double distance(unsigned int sourceId, unsigned int destinationId);
+
+        /// \brief
+        /// Returns the number of boundary vertices at a level
+        ///
+        /// \param level unsigned int - the level, with zero the smallest cells
+        /// \return unsigned int - the number of boundary vertices
+        ///
+        unsigned int getNumBoundaryVertices(unsigned int level);
+
+        /// \brief
+        /// Returns the number of seconds the last customisation took
+        ///
+        /// \return double - the customisation time in seconds
+        ///
+        double getCustomisationSeconds();
+
+        /// \brief
+        /// Returns the number of vertices settled by the last query
+        ///
+        /// \return unsigned int - the number of settled vertices
+        ///
+        unsigned int getNumSettled();
+
+    private:
+        typedef pair<double, unsigned int> QueueEntry;
+        typedef priority_queue< QueueEntry, vector<QueueEntry>, greater<QueueEntry> > OverlayQueue;
+
+        /// The working state of a search, reset by moving to a new generation
+        struct OverlaySearch {
+            vector<double> distances;
+            vector<unsigned int> reachedGeneration;
+            unsigned int generation;
+            OverlayQueue unvisitedVerticesQueue;
+        };
+
+        Graph* graph;
+        MultilevelPartition* partition;
+        unsigned int numLevels;
+        vector< vector< vector<unsigned int> > > cellBoundaries;
+        vector< vector<int> > boundaryIndices;
+        vector< vector< vector<double> > > cliques;
+        OverlaySearch querySearch;
+        double customisationSeconds;
+        unsigned int numSettled;
+
+        /// \brief
+        /// Computes the distances between the boundary vertices of one cell, searching inside the cell over the
+        /// original edges at level zero or over the cells of the level below otherwise
+        ///
+        /// \param level unsigned int - the level of the cell
+        /// \param cell unsigned int - the number of the cell
+        /// \param search OverlaySearch* - the working state used for the searches
+        ///
+        void customiseCell(unsigned int level, unsigned int cell, OverlaySearch* search);
+
+        /// \brief
+        /// Returns the highest level at which a vertex is in neither the source's nor the destination's cell
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        /// \param destinationId unsigned int - the identifier of the destination vertex
+        /// \return int - the level, or -1 if the vertex shares a cell with one of them at every level
+        ///
+        int queryLevel(unsigned int identifier, unsigned int sourceId, unsigned int destinationId);
+
+        /// \brief
+        /// Starts a new search from a vertex
+        ///
+        /// \param search OverlaySearch* - the working state of the search
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        ///
+        void startSearch(OverlaySearch* search, unsigned int sourceId);
+
+        /// \brief
+        /// Lowers the distance of a vertex if a shorter way to it has been found
+        ///
+        /// \param search OverlaySearch* - the working state of the search
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \param distance double - the length of the new way to the vertex
+        ///
+        void relax(OverlaySearch* search, unsigned int identifier, double distance);
+};
+
+#endif // CUSTOMIZABLEROUTEPLANNER_H
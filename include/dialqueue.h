@@ -0,0 +1,64 @@
+#ifndef DIALQUEUE_H
+#define DIALQUEUE_H
+#include <vector>
+
+using namespace std;
+
+/// This class is Dial's bucket queue for searches whose edge weights are whole numbers no greater than a
+/// known largest weight C. Every key still in the queue lies within C of the last key taken out, so a ring
+/// of C + 1 buckets holds each key in the bucket for its value modulo C + 1. Adding is a push onto a
+/// bucket and taking out scans forward to the next bucket in use, so the work is proportional to the
+/// entries plus the largest key, with no comparisons at all. Keys added must never be smaller than the
+/// last key taken out.
+///
+class DialQueue
+{
+    public:
+
+        /// \brief
+        /// Creates an empty queue for keys that never run more than the largest weight ahead of the smallest
+        ///
+        /// \param maximumWeight unsigned long long - the largest edge weight C
+        ///
+        DialQueue(unsigned long long maximumWeight);
+
+        /// \brief
+        /// There was no dynamically created items in this class so there is no need for a destructor method body
+        ///
+        ~DialQueue();
+
+        /// \brief
+        /// Adds a vertex with a key
+        ///
+        /// \param key unsigned long long - the key, at least the last key taken out and within C of it
+        /// \param identifier unsigned int - the identifier of the vertex
+        ///
+        void push(unsigned long long key, unsigned int identifier);
+
+        /// \brief
+        /// Takes out a vertex with the smallest key; the queue must not be empty
+        ///
+        /// \param key unsigned long long* - set to the key
+        /// \param identifier unsigned int* - set to the identifier of the vertex
+        ///
+        void pop(unsigned long long* key, unsigned int* identifier);
+
+        /// \brief
+        /// Returns whether the queue is empty
+        ///
+        /// \return bool - true if there are no entries
+        ///
+        bool empty();
+
+        /// \brief
+        /// Empties the queue so it can be used for another search
+        ///
+        void clear();
+
+    private:
+        vector< vector<unsigned int> > buckets;
+        unsigned long long current;
+        unsigned long size;
+};
+
+#endif // DIALQUEUE_H
@@ -1,54 +1,152 @@
 #ifndef DISJOINTSET_H
 #define DISJOINTSET_H
+#include <vector>
+
+using namespace std;
 
 /// This class is used to see which set an element is in and is called in the minimum spanning cost
 /// as a part of Kruskals algorithm
 ///
-class DisjointSet
+/// It is a template over the type of the identifiers so graphs with more vertices than an unsigned int
+/// can count use 64 bit identifiers, while the sets of ordinary graphs keep to 4 bytes an element.
+///
+template <typename Id>
+class BasicDisjointSet
 {
     public:
 
         /// \brief
         /// Creates a disjoint set by initializing two arrays; one for size and one for vertex identifiers
         ///
-        /// \param size int - the desired size of the disjoint set
+        /// \param size Id - the desired size of the disjoint set
         ///
-        DisjointSet(int);
+        BasicDisjointSet(Id size);
 
         /// \brief
-        /// Deletes the dynamically created arrays containing sizes and vertex identifiers
+        /// There was no dynamically created items in this class so there is no need for a destructor method body
         ///
-        ~DisjointSet();
+        ~BasicDisjointSet();
 
         /// \brief
         /// Searches through disjoint set to find vertex identifier i
         ///
-        /// \param i int - the vertex identifier being searched for
-        /// \return int - the identifier of the parent value of i
+        /// \param i Id - the vertex identifier being searched for
+        /// \return Id - the identifier of the parent value of i
         ///
-        int find(int);
+        Id find(Id i);
 
         /// \brief
         /// Joins the sets containing the two vertex identifiers
         ///
-        /// \param vertexOne int - the first vertex identifier
-        /// \param vertexTwo int - the second vertex identifier
+        /// \param vertexOne Id - the first vertex identifier
+        /// \param vertexTwo Id - the second vertex identifier
         ///
-        void join(int, int);
+        void join(Id vertexOne, Id vertexTwo);
 
         /// \brief
         /// Returns true if two identifiers are in the same set or not
         ///
-        /// \param vertexOne int - the first vertex identifier
-        /// \param vertexOne int - the first vertex identifier
+        /// \param vertexOne Id - the first vertex identifier
+        /// \param vertexTwo Id - the second vertex identifier
         /// \return bool - true if both identifiers are in the same set
         ///
-        bool sameComponent(int, int);
+        bool sameComponent(Id vertexOne, Id vertexTwo);
 
     private:
-        int* id;
-        int* sizes;
+        vector<Id> id;
+        vector<Id> sizes;
 
 };
 
+/// The disjoint set used by Graph, over its unsigned int vertex identifiers
+typedef BasicDisjointSet<unsigned int> DisjointSet;
+
+/// \brief
+/// Creates a disjoint set by initializing two arrays; one for size and one for vertex identifiers
+///
+/// \param size Id - the desired size of the disjoint set
+///
+template <typename Id>
+BasicDisjointSet<Id>::BasicDisjointSet(Id size)
+{
+    // Create arrays to hold sizes and identifiers of vertex
+    this->id.resize(size);
+    this->sizes.assign(size, 1);
+
+    // Traverse the id array and set item values to i
+    for (Id i = 0; i < size; i++) {
+        this->id[i] = i;
+    }
+}
+
+/// \brief
+/// There was no dynamically created items in this class so there is no need for a destructor method body
+///
+template <typename Id>
+BasicDisjointSet<Id>::~BasicDisjointSet() {
+}
+
+/// \brief
+/// Searches through disjoint set to find vertex identifier i
+///
+/// \param i Id - the vertex identifier being searched for
+/// \return Id - the identifier of the parent value of i
+///
+template <typename Id>
+Id BasicDisjointSet<Id>::find(Id i) {
+
+    // Checks that i is not equal to its parent vertex
+    while (i != this->id[i]) {
+
+        // Sets the parent vertex to the grandparent vertex's value
+        this->id[i] = this->id[this->id[i]];
+
+        // Sets the vertex to its parent vertex value
+        i = this->id[i];
+    }
+    return i;
+}
+
+/// \brief
+/// Joins the sets containing the two vertex identifiers
+///
+/// \param vertexOne Id - the first vertex identifier
+/// \param vertexTwo Id - the second vertex identifier
+///
+template <typename Id>
+void BasicDisjointSet<Id>::join(Id vertexOne, Id vertexTwo) {
+
+    Id i = find(vertexOne);
+    Id j = find(vertexTwo);
+
+    // Break out of method if the two vertex identifiers are the same
+    if (i == j) {
+        return;
+    }
+
+    // Sets the parent of the vertex with a smaller size value to the other vertex
+    if (this->sizes[i] < this->sizes[j]) {
+        this->id[i] = j;
+
+        // Increase larger size vertex by the size of the smaller vertex
+        this->sizes[j] += this->sizes[i];
+    }
+    else {
+        this->id[j] = i;
+        this->sizes[i] += this->sizes[j];
+    }
+}
+
+/// \brief
+/// Returns true if two identifiers are in the same set or not
+///
+/// \param vertexOne Id - the first vertex identifier
+/// \param vertexTwo Id - the second vertex identifier
+/// \return bool - true if both identifiers are in the same set
+///
+template <typename Id>
+bool BasicDisjointSet<Id>::sameComponent(Id vertexOne, Id vertexTwo) {
+    return find(vertexOne) == find(vertexTwo);
+}
+
 #endif // DISJOINTSET_H
@@ -0,0 +1,120 @@
+#ifndef DISTANCEORACLE_H
+#define DISTANCEORACLE_H
+#include <vector>
+#include "graph.h"
+#include "workerpool.h"
+
+using namespace std;
+
+/// This class is the approximate distance oracle of Thorup and Zwick. Vertices are sampled into k nested
+/// levels of centres, each level keeping about n^(-1/k) of the one below, and every vertex keeps its
+/// nearest centre of each level together with a bunch: the centres of each level that are closer to it
+/// than the nearest centre of the level above. A query hops between the two ends, moving up a level each
+/// time, until the nearest centre of one end is in the bunch of the other, and answers with the distance
+/// through that centre. Answers are never shorter than the true distance and at most 2k - 1 times longer,
+/// from about k n^(1 + 1/k) stored distances rather than n^2.
+///
+/// The bunches are found from the other side: each centre's cluster, the vertices that have it in their
+/// bunch, is a Dijkstra search from the centre that goes no further than where the level above is closer.
+/// The searches are shared between the workers. Each bunch is kept as a small open addressing table in one
+/// shared array, so a query looks up at most k centres in constant time each.
+///
+class DistanceOracle
+{
+    public:
+
+        /// \brief
+        /// Creates an empty oracle for the number of levels given
+        ///
+        /// \param numLevels unsigned int - the number of levels k, giving answers at most 2k - 1 times too long
+        ///
+        DistanceOracle(unsigned int numLevels);
+
+        /// \brief
+        /// There was no dynamically created items in this class so there is no need for a destructor method body
+        ///
+        ~DistanceOracle();
+
+        /// \brief
+        /// Samples the centres of every level and works out the nearest centres and bunches of every vertex
+        ///
+        /// \param graph Graph* - the graph the distances are measured on
+        /// \param pool WorkerPool* - the workers the searches are shared between
+        ///
+        void build(Graph* graph, WorkerPool* pool);
+
+        /// \brief
+        /// Returns an approximation of the shortest path distance between two vertices
+        ///
+        /// \param sourceId unsigned int - the identifier of the first vertex
+        /// \param destinationId unsigned int - the identifier of the second vertex
+        /// \return double - a distance between the true distance and 2k - 1 times it, or
+        /// ShortestPathTree::UNREACHABLE if there is no path
+        ///
+        double distance(unsigned int sourceId, unsigned int destinationId);
+
+        /// \brief
+        /// Returns the number of levels of centres
+        ///
+        /// \return unsigned int - the number of levels k
+        ///
+        unsigned int getNumLevels();
+
+        /// \brief
+        /// Returns the average number of centres in a bunch
+        ///
+        /// \return double - the average bunch size
+        ///
+        double getAverageBunchSize();
+
+        /// \brief
+        /// Returns the number of seconds the last build took
+        ///
+        /// \return double - the build time in seconds
+        ///
+        double getBuildSeconds();
+
+        /// \brief
+        /// Returns the number of bytes used by the nearest centres and bunches
+        ///
+        /// \return unsigned long - the memory used in bytes
+        ///
+        unsigned long memoryUsage();
+
+    private:
+
+        /// A centre of a bunch and its distance, or an empty slot of a bunch's table
+        struct BunchEntry {
+            unsigned int centre;
+            float distance;
+        };
+
+        unsigned int numLevels;
+        unsigned int numVertices;
+        vector<unsigned int> nearestCentres;
+        vector<double> centreDistances;
+        vector<unsigned long> bunchOffsets;
+        vector<BunchEntry> bunches;
+        unsigned long numBunchEntries;
+        double buildSeconds;
+
+        /// \brief
+        /// Finds the nearest centre of one level to every vertex with a single search from all of its centres
+        ///
+        /// \param graph Graph* - the graph the distances are measured on
+        /// \param levels vector<unsigned int>* - the highest level of every vertex
+        /// \param level unsigned int - the level whose centres are searched from
+        ///
+        void findNearestCentres(Graph* graph, vector<unsigned int>* levels, unsigned int level);
+
+        /// \brief
+        /// Returns the distance from a vertex to a centre in its bunch
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \param centre unsigned int - the identifier of the centre
+        /// \return float - the distance, or a negative value if the centre is not in the bunch
+        ///
+        float findInBunch(unsigned int identifier, unsigned int centre);
+};
+
+#endif // DISTANCEORACLE_H
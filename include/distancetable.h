@@ -0,0 +1,159 @@
+#ifndef DISTANCETABLE_H
+#define DISTANCETABLE_H
+#include <vector>
+#include <ostream>
+#include <queue>
+#include <functional>
+#include "graph.h"
+#include "workerpool.h"
+#include "hublabels.h"
+
+using namespace std;
+
+/// This class computes the table of shortest path distances from many sources to many targets in one go,
+/// keeping the distances in a single row major array of floats.
+///
+/// Without hub labels the sources are grouped into batches of eight that lie close to one another, and each
+/// batch is searched from by one sweep that holds a distance for every source of the batch at each vertex. A
+/// vertex is taken from the queue by the smallest distance it has yet to pass on, and passes on every distance
+/// of the batch that has improved since it was last taken, so nearby sources share their queue operations and
+/// edge scans instead of repeating them. The sweep stops once every target's distances are final. Batches are
+/// shared out between the workers, each reusing one set of search state for all of its batches.
+///
+/// With hub labels the table needs no search at all: the target labels are gathered into one bucket per hub,
+/// and each row is filled by running through the buckets of the hubs in its source's label.
+///
+class DistanceTable
+{
+    public:
+
+        /// \brief
+        /// Creates an empty table for the graph
+        ///
+        /// \param graph Graph* - the graph the distances are measured on
+        /// \param pool WorkerPool* - the workers the rows are shared between
+        ///
+        DistanceTable(Graph* graph, WorkerPool* pool);
+
+        /// \brief
+        /// There was no dynamically created items in this class so there is no need for a destructor method body
+        ///
+        ~DistanceTable();
+
+        /// \brief
+        /// Gives the table hub labels to fill rows from instead of searching
+        ///
+        /// \param hubLabels HubLabels* - a pointer to labels built for the graph, or NULL to go back to searching
+        ///
+        void setHubLabels(HubLabels* hubLabels);
+
+        /// \brief
+        /// Computes the distance from every source to every target
+        ///
+        /// \param sources vector<unsigned int>* - the identifiers of the source vertices, one per row
+        /// \param targets vector<unsigned int>* - the identifiers of the target vertices, one per column
+        ///
+        void compute(vector<unsigned int>* sources, vector<unsigned int>* targets);
+
+        /// \brief
+        /// Returns the number of rows, one per source
+        ///
+        /// \return unsigned int - the number of rows in the table
+        ///
+        unsigned int getNumRows();
+
+        /// \brief
+        /// Returns the number of columns, one per target
+        ///
+        /// \return unsigned int - the number of columns in the table
+        ///
+        unsigned int getNumColumns();
+
+        /// \brief
+        /// Returns the distance from a source to a target
+        ///
+        /// \param row unsigned int - the position of the source in the sources given to compute
+        /// \param column unsigned int - the position of the target in the targets given to compute
+        /// \return float - the distance, or infinity if the target cannot be reached
+        ///
+        float getDistance(unsigned int row, unsigned int column);
+
+        /// \brief
+        /// Returns the number of times a vertex passed on distances in the sweeps of the last compute, or the
+        /// number of bucket entries read when it used hub labels
+        ///
+        /// \return unsigned long - the number of vertex scans or bucket entries
+        ///
+        unsigned long getNumSettled();
+
+        /// \brief
+        /// Writes the table as text, one row per line with unreachable targets shown as -
+        ///
+        /// \param out ostream& - the output the table is written to
+        ///
+        void write(ostream& out);
+
+        /// \brief
+        /// Writes the number of rows and columns followed by the distances in row major order as raw binary
+        ///
+        /// \param out ostream& - the output the table is written to
+        ///
+        void writeBinary(ostream& out);
+
+    private:
+        typedef pair<double, unsigned int> QueueEntry;
+
+        /// The search state owned by one worker and reused for every batch it sweeps. Distances are held
+        /// lane by lane for each vertex, and vertices are marked with the generation of the batch that
+        /// touched them so nothing needs clearing between batches
+        struct SweepState {
+            vector<double> distances;
+            vector<unsigned char> improved;
+            vector<unsigned int> touchedGeneration;
+            unsigned int generation;
+            priority_queue< QueueEntry, vector<QueueEntry>, greater<QueueEntry> > queue;
+            unsigned long numScanned;
+        };
+
+        Graph* graph;
+        WorkerPool* pool;
+        HubLabels* hubLabels;
+        unsigned int numRows;
+        unsigned int numColumns;
+        vector<float> distances;
+        unsigned long numSettled;
+
+        /// \brief
+        /// Orders the rows so that every run of eight holds sources close to one another, taking the first source not
+        /// yet placed and then the other unplaced sources in the order a breadth first search from it reaches them
+        ///
+        /// \param sources vector<unsigned int>* - the identifiers of the source vertices, one per row
+        /// \param batchRows vector<unsigned int>* - filled with every row, eight to a batch
+        ///
+        void groupSources(vector<unsigned int>* sources, vector<unsigned int>* batchRows);
+
+        /// \brief
+        /// Fills the rows of a batch of sources with one sweep
+        ///
+        /// \param state SweepState* - the search state of the worker doing the sweep
+        /// \param sources vector<unsigned int>* - the identifiers of the source vertices, one per row
+        /// \param rows const unsigned int* - the rows of the sources of the batch, one per lane
+        /// \param numLanes unsigned int - the number of sources in the batch, no more than eight
+        /// \param targetIds vector<unsigned int>* - the identifiers of the distinct target vertices
+        /// \param firstColumn vector<int>* - the first column of each vertex, or -1 if it is not a target
+        /// \param nextColumn vector<int>* - the next column with the same target as each column, or -1
+        /// \param rowTargets vector<unsigned int>* - the number of distinct targets the source of each row can reach
+        ///
+        void sweep(SweepState* state, vector<unsigned int>* sources, const unsigned int* rows, unsigned int numLanes,
+                   vector<unsigned int>* targetIds, vector<int>* firstColumn, vector<int>* nextColumn, vector<unsigned int>* rowTargets);
+
+        /// \brief
+        /// Fills every row from the hub labels of the sources and the targets, gathered into buckets by hub
+        ///
+        /// \param sources vector<unsigned int>* - the identifiers of the source vertices, one per row
+        /// \param targets vector<unsigned int>* - the identifiers of the target vertices, one per column
+        ///
+        void computeFromLabels(vector<unsigned int>* sources, vector<unsigned int>* targets);
+};
+
+#endif // DISTANCETABLE_H
@@ -0,0 +1,92 @@
+#ifndef DYNAMICSHORTESTPATHTREE_H
+#define DYNAMICSHORTESTPATHTREE_H
+#include <vector>
+#include <queue>
+#include <functional>
+#include "graph.h"
+#include "graphobserver.h"
+#include "shortestpathtree.h"
+
+using namespace std;
+
+/// This class keeps the shortest path tree of a source up to date as edges of the graph are added, removed
+/// or change weight. Only the vertices whose distance can change are visited: a new or cheaper edge spreads
+/// shorter distances outwards from its ends, and a removed or dearer tree edge re-attaches the subtree
+/// below it using the distances of the vertices around it.
+///
+class DynamicShortestPathTree : public GraphObserver
+{
+    public:
+
+        /// \brief
+        /// Computes the tree for the source and starts observing the graph for changes
+        ///
+        /// \param graph Graph* - the graph the tree is kept for
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        ///
+        DynamicShortestPathTree(Graph* graph, unsigned int sourceId);
+
+        /// \brief
+        /// Stops observing the graph
+        ///
+        ~DynamicShortestPathTree();
+
+        /// \brief
+        /// Returns the tree, which is always up to date with the graph
+        ///
+        /// \return ShortestPathTree* - a pointer to the tree
+        ///
+        ShortestPathTree* getTree();
+
+        /// \brief
+        /// Returns the number of vertices whose distance was looked at by the last repair
+        ///
+        /// \return unsigned int - the number of vertices touched
+        ///
+        unsigned int getNumTouched();
+
+        /// \brief
+        /// Repairs the tree after an edge has been added, removed or had its weight changed
+        ///
+        /// \param sourceId unsigned int - the identifier of the first vertex of the edge
+        /// \param destinationId unsigned int - the identifier of the second vertex of the edge
+        /// \param oldWeight double - the weight before the change, or NO_EDGE if the edge is new
+        /// \param newWeight double - the weight after the change, or NO_EDGE if the edge was removed
+        ///
+        void edgeChanged(unsigned int sourceId, unsigned int destinationId, double oldWeight, double newWeight);
+
+    private:
+        typedef pair<double, unsigned int> QueueEntry;
+        typedef priority_queue< QueueEntry, vector<QueueEntry>, greater<QueueEntry> > RepairQueue;
+
+        Graph* graph;
+        ShortestPathTree tree;
+        vector< vector<unsigned int> > children;
+        unsigned int numTouched;
+
+        /// \brief
+        /// Changes the predecessor of a vertex, keeping the lists of children in step
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \param predecessorId unsigned int - the identifier of the new predecessor, or the vertex itself to detach it
+        ///
+        void setPredecessorId(unsigned int identifier, unsigned int predecessorId);
+
+        /// \brief
+        /// Lowers the distance of a vertex if the path through a neighbour is shorter, queueing it to spread further
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \param predecessorId unsigned int - the identifier of the neighbour
+        /// \param queue RepairQueue* - the queue of vertices whose distance has been lowered
+        ///
+        void relax(unsigned int identifier, unsigned int predecessorId, RepairQueue* queue);
+
+        /// \brief
+        /// Spreads lowered distances outwards in order of distance until nothing else improves
+        ///
+        /// \param queue RepairQueue* - the queue of vertices whose distance has been lowered
+        ///
+        void propagate(RepairQueue* queue);
+};
+
+#endif // DYNAMICSHORTESTPATHTREE_H
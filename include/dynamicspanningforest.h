@@ -0,0 +1,239 @@
+#ifndef DYNAMICSPANNINGFOREST_H
+#define DYNAMICSPANNINGFOREST_H
+#include <vector>
+#include <unordered_map>
+#include "graph.h"
+#include "graphobserver.h"
+
+using namespace std;
+
+/// This class keeps a minimum spanning forest of the graph and its cost up to date as edges are added,
+/// removed or change weight, with one tree for each connected part of the graph. The forest is held in a
+/// link-cut tree where every tree edge is a node of its own, so the heaviest edge on the path between any
+/// two vertices is found in amortised logarithmic time. A new or cheaper edge joins two trees, or replaces
+/// the heaviest edge on the path between its ends if it is lighter, without looking at any other edge.
+///
+/// Removing a tree edge, or making one dearer, splits its tree in two and needs the lightest edge joining the
+/// halves. The halves are walked together one vertex at a time until the smaller is finished, and only the
+/// edges of the smaller half are looked at, so the work is proportional to the smaller half rather than to
+/// the graph. Changes to edges outside the forest that do not make them cheaper need no work at all.
+///
+class DynamicSpanningForest : public GraphObserver
+{
+    public:
+
+        /// \brief
+        /// Computes the minimum spanning forest with Kruskal's algorithm and starts observing the graph for changes
+        ///
+        /// \param graph Graph* - the graph the forest is kept for
+        ///
+        DynamicSpanningForest(Graph* graph);
+
+        /// \brief
+        /// Stops observing the graph
+        ///
+        ~DynamicSpanningForest();
+
+        /// \brief
+        /// Returns the total weight of the edges of the forest
+        ///
+        /// \return double - the cost of the forest
+        ///
+        double getCost();
+
+        /// \brief
+        /// Returns the number of edges in the forest
+        ///
+        /// \return unsigned int - the number of tree edges
+        ///
+        unsigned int getNumTreeEdges();
+
+        /// \brief
+        /// Returns the number of trees in the forest, which is the number of connected parts of the graph
+        ///
+        /// \return unsigned int - the number of trees
+        ///
+        unsigned int getNumTrees();
+
+        /// \brief
+        /// Returns whether an edge is in the forest
+        ///
+        /// \param sourceId unsigned int - the identifier of the first vertex of the edge
+        /// \param destinationId unsigned int - the identifier of the second vertex of the edge
+        /// \return bool - true if the edge is a tree edge
+        ///
+        bool isTreeEdge(unsigned int sourceId, unsigned int destinationId);
+
+        /// \brief
+        /// Returns whether two vertices are in the same tree of the forest
+        ///
+        /// \param sourceId unsigned int - the identifier of the first vertex
+        /// \param destinationId unsigned int - the identifier of the second vertex
+        /// \return bool - true if a path joins the vertices
+        ///
+        bool connected(unsigned int sourceId, unsigned int destinationId);
+
+        /// \brief
+        /// Returns the number of vertices and edges looked at to find a replacement for a tree edge by the last change
+        ///
+        /// \return unsigned long - the number of vertices and edges looked at, zero if no replacement was needed
+        ///
+        unsigned long getNumScanned();
+
+        /// \brief
+        /// Updates the forest after an edge has been added, removed or had its weight changed
+        ///
+        /// \param sourceId unsigned int - the identifier of the first vertex of the edge
+        /// \param destinationId unsigned int - the identifier of the second vertex of the edge
+        /// \param oldWeight double - the weight before the change, or NO_EDGE if the edge is new
+        /// \param newWeight double - the weight after the change, or NO_EDGE if the edge was removed
+        ///
+        void edgeChanged(unsigned int sourceId, unsigned int destinationId, double oldWeight, double newWeight);
+
+    private:
+
+        /// A node of the link-cut tree, which is either a vertex of the graph or an edge of the forest. Each
+        /// node is in a splay tree of the preferred path it lies on, ordered from the root of its tree down
+        struct LinkCutNode {
+            unsigned int children[2];
+            unsigned int parent;
+            bool reversed;
+            double weight;
+            unsigned int heaviest;
+            unsigned int sourceId;
+            unsigned int destinationId;
+        };
+
+        static const unsigned int NO_NODE = 0xFFFFFFFF;
+
+        Graph* graph;
+        vector<LinkCutNode> nodes;
+        vector<unsigned int> freeNodes;
+        unordered_map<unsigned long long, unsigned int> treeEdges;
+        vector< vector<unsigned int> > treeNeighbours;
+        vector<unsigned int> visitedGeneration;
+        vector<unsigned char> visitedSide;
+        vector<unsigned int> splayPath;
+        unsigned int generation;
+        double cost;
+        unsigned long numScanned;
+
+        /// \brief
+        /// Returns the key a tree edge is found by, the same whichever way round its ends are given
+        ///
+        /// \param sourceId unsigned int - the identifier of the first vertex of the edge
+        /// \param destinationId unsigned int - the identifier of the second vertex of the edge
+        /// \return unsigned long long - the key of the edge
+        ///
+        unsigned long long edgeKey(unsigned int sourceId, unsigned int destinationId);
+
+        /// \brief
+        /// Adds an edge to the forest, joining two trees
+        ///
+        /// \param sourceId unsigned int - the identifier of the first vertex of the edge
+        /// \param destinationId unsigned int - the identifier of the second vertex of the edge
+        /// \param weight double - the weight of the edge
+        ///
+        void addTreeEdge(unsigned int sourceId, unsigned int destinationId, double weight);
+
+        /// \brief
+        /// Removes an edge from the forest, splitting its tree in two
+        ///
+        /// \param edgeNode unsigned int - the node of the edge
+        ///
+        void removeTreeEdge(unsigned int edgeNode);
+
+        /// \brief
+        /// Adds an edge to the forest if it joins two trees or is lighter than the heaviest edge on the path between its ends
+        ///
+        /// \param sourceId unsigned int - the identifier of the first vertex of the edge
+        /// \param destinationId unsigned int - the identifier of the second vertex of the edge
+        /// \param weight double - the weight of the edge
+        ///
+        void offerEdge(unsigned int sourceId, unsigned int destinationId, double weight);
+
+        /// \brief
+        /// Joins the two trees holding the ends of a removed tree edge with the lightest edge of the graph between them
+        ///
+        /// \param sourceId unsigned int - the identifier of the first vertex of the removed edge
+        /// \param destinationId unsigned int - the identifier of the second vertex of the removed edge
+        ///
+        void replaceTreeEdge(unsigned int sourceId, unsigned int destinationId);
+
+        /// \brief
+        /// Returns whether a node is the root of its splay tree
+        ///
+        /// \param node unsigned int - the node
+        /// \return bool - true if the node has no parent in its splay tree
+        ///
+        bool isSplayRoot(unsigned int node);
+
+        /// \brief
+        /// Recomputes the heaviest node of the splay subtree below a node from its children
+        ///
+        /// \param node unsigned int - the node
+        ///
+        void update(unsigned int node);
+
+        /// \brief
+        /// Passes a pending reversal of a splay subtree down to the children of its root
+        ///
+        /// \param node unsigned int - the root of the subtree
+        ///
+        void pushDown(unsigned int node);
+
+        /// \brief
+        /// Rotates a node above its parent in their splay tree
+        ///
+        /// \param node unsigned int - the node
+        ///
+        void rotate(unsigned int node);
+
+        /// \brief
+        /// Moves a node to the root of its splay tree
+        ///
+        /// \param node unsigned int - the node
+        ///
+        void splay(unsigned int node);
+
+        /// \brief
+        /// Makes the path from the root of a node's tree down to the node preferred, leaving the node at the root
+        /// of its splay tree with nothing below it on the path
+        ///
+        /// \param node unsigned int - the node
+        ///
+        void access(unsigned int node);
+
+        /// \brief
+        /// Makes a node the root of its tree
+        ///
+        /// \param node unsigned int - the node
+        ///
+        void makeRoot(unsigned int node);
+
+        /// \brief
+        /// Returns the root of the tree holding a node
+        ///
+        /// \param node unsigned int - the node
+        /// \return unsigned int - the root of its tree
+        ///
+        unsigned int findRoot(unsigned int node);
+
+        /// \brief
+        /// Joins two nodes of different trees with a link-cut tree edge
+        ///
+        /// \param child unsigned int - the node that becomes a child, made the root of its tree first
+        /// \param parent unsigned int - the node that becomes its parent
+        ///
+        void link(unsigned int child, unsigned int parent);
+
+        /// \brief
+        /// Removes the link-cut tree edge between two adjacent nodes
+        ///
+        /// \param nodeOne unsigned int - the first node
+        /// \param nodeTwo unsigned int - the second node
+        ///
+        void cut(unsigned int nodeOne, unsigned int nodeTwo);
+};
+
+#endif // DYNAMICSPANNINGFOREST_H
@@ -52,6 +52,13 @@ class Edge
         ///
         double getWeight();
 
+        /// \brief
+        /// Sets the edge's weight, which must not change once the edge has been added to a graph
+        ///
+        /// \param weight double - the new weight of the edge
+        ///
+        void setWeight(double weight);
+
         /// \brief
         /// Compares two edges and returns true if the first's weight
         ///
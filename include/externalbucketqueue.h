@@ -0,0 +1,88 @@
+#ifndef EXTERNALBUCKETQUEUE_H
+#define EXTERNALBUCKETQUEUE_H
+#include <vector>
+#include <map>
+#include <cstdio>
+
+using namespace std;
+
+/// This class is the frontier of a search too large to keep in memory. Vertices are kept in buckets of
+/// equal distance width and taken out a whole bucket at a time, closest first. When the buckets hold more
+/// entries than the memory allowed, the buckets furthest away are appended to temporary files in large
+/// sequential writes and read back in one pass when their turn comes.
+///
+class ExternalBucketQueue
+{
+    public:
+
+        /// \brief
+        /// Creates an empty queue
+        ///
+        /// \param bucketWidth double - the range of distances that share a bucket
+        /// \param memoryBytes unsigned long - the most memory the buckets may hold before spilling, in bytes
+        ///
+        ExternalBucketQueue(double bucketWidth, unsigned long memoryBytes);
+
+        /// \brief
+        /// Closes the files of any buckets that were spilled and never taken out
+        ///
+        ~ExternalBucketQueue();
+
+        /// \brief
+        /// Returns the bucket a distance falls in
+        ///
+        /// \param distance double - the distance
+        /// \return unsigned long - the number of the bucket
+        ///
+        unsigned long getBucket(double distance);
+
+        /// \brief
+        /// Adds a vertex to the bucket for its distance
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \param distance double - the tentative distance of the vertex
+        /// \return bool - false if a bucket could not be spilled to disk
+        ///
+        bool push(unsigned int identifier, double distance);
+
+        /// \brief
+        /// Takes every vertex out of the closest bucket. Vertices may appear more than once or have since
+        /// moved to a closer bucket, so callers check each against its current distance
+        ///
+        /// \param vertices vector<unsigned int>* - filled with the vertices of the bucket
+        /// \param bucket unsigned long* - set to the number of the bucket
+        /// \return bool - false if the queue is empty or a spilled bucket could not be read back
+        ///
+        bool popBucket(vector<unsigned int>* vertices, unsigned long* bucket);
+
+        /// \brief
+        /// Returns the number of entries written to disk so far
+        ///
+        /// \return unsigned long - the number of spilled entries
+        ///
+        unsigned long getNumSpilled();
+
+    private:
+
+        /// The entries of one bucket, some in memory and the rest in a temporary file
+        struct Bucket {
+            vector<unsigned int> entries;
+            FILE* spillFile;
+            unsigned long numSpilled;
+        };
+
+        double bucketWidth;
+        unsigned long maxEntries;
+        unsigned long numInMemory;
+        unsigned long totalSpilled;
+        map<unsigned long, Bucket> buckets;
+
+        /// \brief
+        /// Writes the buckets furthest away to disk until the entries in memory are back within bounds
+        ///
+        /// \return bool - false if a bucket could not be written
+        ///
+        bool spill();
+};
+
+#endif // EXTERNALBUCKETQUEUE_H
@@ -0,0 +1,130 @@
+#ifndef EXTERNALGRAPH_H
+#define EXTERNALGRAPH_H
+#include <string>
+#include <vector>
+#include <functional>
+#include "externalgraphwriter.h"
+#include "externalbucketqueue.h"
+
+using namespace std;
+
+/// This class searches a graph whose edges are too many to keep in memory. The edges stay in an external
+/// graph file, sorted by source, and only the offset and distance of each vertex are held in memory.
+/// Searches advance a bucketed frontier a whole bucket at a time: the vertices of the bucket are sorted
+/// and their edges read in a few large reads that cover neighbouring vertices together, so the file is
+/// swept forwards instead of being read one vertex at a time. Half of the memory allowed buffers the edges
+/// read and a quarter holds the frontier, which spills to disk when it grows beyond that.
+///
+class ExternalGraph
+{
+    public:
+
+        /// \brief
+        /// Creates a graph with no file open
+        ///
+        ExternalGraph();
+
+        /// \brief
+        /// Closes the file if one is open
+        ///
+        ~ExternalGraph();
+
+        /// \brief
+        /// Opens an external graph file and reads the offset of every vertex's edges
+        ///
+        /// \param path const string& - the path of the file written by ExternalGraphWriter
+        /// \param memoryBytes unsigned long - the most memory used for edges and the frontier, in bytes
+        /// \return bool - false if the file could not be read or is not an external graph file
+        ///
+        bool open(const string& path, unsigned long memoryBytes);
+
+        /// \brief
+        /// Returns the number of vertices within the graph
+        ///
+        /// \return unsigned int - the number of vertices
+        ///
+        unsigned int getNumVertices();
+
+        /// \brief
+        /// Returns the number of edges in the file, counting each direction of an edge once
+        ///
+        /// \return unsigned long long - the number of stored edges
+        ///
+        unsigned long long getNumEdges();
+
+        /// \brief
+        /// Finds the shortest distance from a source to every vertex
+        ///
+        /// \param sourceId unsigned int - the identifier of the source
+        /// \param distances vector<double>* - filled with the distance to each vertex, or
+        /// ShortestPathTree::UNREACHABLE if there is no path
+        /// \return bool - false if the source is not a vertex or the file or frontier could not be read
+        ///
+        bool shortestDistances(unsigned int sourceId, vector<double>* distances);
+
+        /// \brief
+        /// Finds the fewest edges from a source to every vertex
+        ///
+        /// \param sourceId unsigned int - the identifier of the source
+        /// \param hops vector<unsigned int>* - filled with the number of edges to each vertex, or UNREACHED
+        /// \return bool - false if the source is not a vertex or the file or frontier could not be read
+        ///
+        bool hopDistances(unsigned int sourceId, vector<unsigned int>* hops);
+
+        /// \brief
+        /// Returns the number of bytes of edges read from the file since it was opened
+        ///
+        /// \return unsigned long long - the number of bytes read
+        ///
+        unsigned long long getBytesRead();
+
+        /// \brief
+        /// Returns the number of reads made from the file since it was opened
+        ///
+        /// \return unsigned long - the number of reads
+        ///
+        unsigned long getNumReads();
+
+        /// \brief
+        /// Returns the number of frontier entries the searches have spilled to disk
+        ///
+        /// \return unsigned long - the number of spilled entries
+        ///
+        unsigned long getNumSpilled();
+
+        /// The number of hops given to a vertex that cannot be reached
+        static const unsigned int UNREACHED;
+
+    private:
+        int descriptor;
+        unsigned int numVertices;
+        unsigned long long numEdges;
+        double totalWeight;
+        unsigned long memoryBytes;
+        vector<unsigned long long> offsets;
+        vector<ExternalEdge> buffer;
+        unsigned long long bytesRead;
+        unsigned long numReads;
+        unsigned long numSpilled;
+
+        /// \brief
+        /// Reads a run of consecutive edges from the file
+        ///
+        /// \param first unsigned long long - the index of the first edge
+        /// \param count unsigned long - the number of edges
+        /// \return bool - false if the edges could not be read
+        ///
+        bool readEdges(unsigned long long first, unsigned long count);
+
+        /// \brief
+        /// Visits the edges of every vertex of a sorted frontier, reading vertices whose edges lie close
+        /// together in the file in a single read
+        ///
+        /// \param frontier const vector<unsigned int>& - the vertices whose edges are visited, sorted and unique
+        /// \param visit const function<void(unsigned int, const ExternalEdge&)>& - called with each vertex and edge
+        /// \return bool - false if the edges could not be read
+        ///
+        bool scanNeighbours(const vector<unsigned int>& frontier, const function<void(unsigned int, const ExternalEdge&)>& visit);
+};
+
+#endif // EXTERNALGRAPH_H
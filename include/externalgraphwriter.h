@@ -0,0 +1,104 @@
+#ifndef EXTERNALGRAPHWRITER_H
+#define EXTERNALGRAPHWRITER_H
+#include <string>
+#include <vector>
+#include <cstdio>
+
+using namespace std;
+
+/// An edge as it is stored in an external graph file, in the list of edges leaving its source
+struct ExternalEdge {
+    unsigned int target;
+    unsigned int reserved;
+    double weight;
+};
+
+/// The start of an external graph file, followed by the offset of every vertex's edges and then the edges
+struct ExternalGraphHeader {
+    char magic[8];
+    unsigned int numVertices;
+    unsigned int reserved;
+    unsigned long long numEdges;
+    double totalWeight;
+};
+
+/// This class writes a graph to an external graph file without ever holding all of its edges in memory.
+/// Edges are gathered in a buffer of bounded size, sorted by source and written out as a run whenever
+/// the buffer fills, then the runs are merged into the file in one sequential pass. Only the per vertex
+/// offsets are kept in memory for the whole graph.
+///
+class ExternalGraphWriter
+{
+    public:
+
+        /// \brief
+        /// Prepares to write a graph with the given number of vertices
+        ///
+        /// \param path const string& - the path of the file to be written
+        /// \param numVertices unsigned int - the number of vertices within the graph
+        /// \param memoryBytes unsigned long - the most memory used to buffer edges, in bytes
+        ///
+        ExternalGraphWriter(const string& path, unsigned int numVertices, unsigned long memoryBytes);
+
+        /// \brief
+        /// Closes any runs left behind if finish was not called
+        ///
+        ~ExternalGraphWriter();
+
+        /// \brief
+        /// Adds an undirected edge, which is stored once in each direction
+        ///
+        /// \param sourceId unsigned int - the identifier of one end of the edge
+        /// \param destinationId unsigned int - the identifier of the other end of the edge
+        /// \param weight double - the weight of the edge
+        /// \return bool - false if either end is not a vertex of the graph or a run could not be written
+        ///
+        bool addEdge(unsigned int sourceId, unsigned int destinationId, double weight);
+
+        /// \brief
+        /// Merges the sorted runs into the graph file
+        ///
+        /// \return bool - false if the file could not be written
+        ///
+        bool finish();
+
+        /// \brief
+        /// Returns the number of sorted runs the edges were split into
+        ///
+        /// \return unsigned int - the number of runs
+        ///
+        unsigned int getNumRuns();
+
+        /// The bytes every external graph file starts with
+        static const char MAGIC[8];
+
+    private:
+
+        /// An edge waiting to be sorted, with the source it leaves from
+        struct PendingEdge {
+            unsigned int source;
+            unsigned int target;
+            double weight;
+
+            bool operator<(const PendingEdge& other) const {
+                return source != other.source ? source < other.source : target < other.target;
+            }
+        };
+
+        string path;
+        unsigned int numVertices;
+        unsigned long bufferCapacity;
+        vector<PendingEdge> buffer;
+        vector<FILE*> runs;
+        unsigned int numRuns;
+        bool failed;
+
+        /// \brief
+        /// Sorts the buffered edges and writes them to a new run
+        ///
+        /// \return bool - false if the run could not be written
+        ///
+        bool writeRun();
+};
+
+#endif // EXTERNALGRAPHWRITER_H
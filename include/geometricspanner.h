@@ -0,0 +1,79 @@
+#ifndef GEOMETRICSPANNER_H
+#define GEOMETRICSPANNER_H
+#include <vector>
+#include "graph.h"
+
+using namespace std;
+
+/// This class thins out a graph whose edges are weighted by the distance between their ends, keeping
+/// only enough edges that every path is at most a stretch factor longer than before. It is the greedy
+/// spanner: the candidate edges are taken shortest first and an edge is only kept when the edges kept
+/// so far offer no path between its ends within the stretch factor of its length. Only edges of the
+/// given graph are ever kept, so roads that are not allowed stay out. Points spread over the plane keep
+/// a number of edges proportional to the number of vertices however many candidates there were, and the
+/// minimum spanning tree of the graph is always kept whole. Most candidates are turned down without a
+/// search by keeping an upper bound on the spanner distance between every pair of vertices, a float per
+/// pair, so building takes memory of the same order as the weights of the graph.
+///
+class GeometricSpanner
+{
+    public:
+
+        /// \brief
+        /// Creates a spanner builder for the stretch factor given
+        ///
+        /// \param stretch double - how many times longer than in the graph any path in the spanner may be
+        ///
+        GeometricSpanner(double stretch);
+
+        /// \brief
+        /// There was no dynamically created items in this class so there is no need for a destructor method body
+        ///
+        ~GeometricSpanner();
+
+        /// \brief
+        /// Builds the spanner of a graph as a new graph with vertices of its own
+        ///
+        /// \param graph Graph* - the graph whose edges are the candidates
+        /// \return Graph* - the spanner, which the caller must delete
+        ///
+        Graph* build(Graph* graph);
+
+        /// \brief
+        /// Returns the stretch factor the spanner is built for
+        ///
+        /// \return double - the stretch factor
+        ///
+        double getStretch();
+
+        /// \brief
+        /// Returns the number of edges of the graph the last spanner was built from
+        ///
+        /// \return unsigned long - the number of candidate edges
+        ///
+        unsigned long getNumCandidateEdges();
+
+        /// \brief
+        /// Returns the number of edges kept in the last spanner built
+        ///
+        /// \return unsigned long - the number of spanner edges
+        ///
+        unsigned long getNumEdges();
+
+        /// \brief
+        /// Returns the largest ratio between a path of the spanner and the candidate edge it replaced, measured
+        /// when the edge was left out. Paths only get shorter as later edges are kept, so no candidate edge is
+        /// stretched by more than this in the finished spanner, nor is any path of the graph
+        ///
+        /// \return double - the largest stretch seen, which is never more than the stretch factor
+        ///
+        double getMaxStretch();
+
+    private:
+        double stretch;
+        unsigned long numCandidateEdges;
+        unsigned long numEdges;
+        double maxStretch;
+};
+
+#endif // GEOMETRICSPANNER_H
@@ -2,11 +2,20 @@
 #define GRAPH_H
 #include <iostream>
 #include <queue>
+#include <mutex>
 #include "vertex.h"
 #include "edge.h"
+#include "shortestpathtree.h"
+#include "graphobserver.h"
+#include "snapshot.h"
 
 using namespace std;
 
+class ComponentIndex;
+
+/// The priority queues shortestPathTree can search with. The bucket queue and radix heap need the weights
+/// to be whole numbers of a quantum, so are only used once the graph has one
+enum SearchQueue { SEARCH_QUEUE_AUTOMATIC, SEARCH_QUEUE_BINARY_HEAP, SEARCH_QUEUE_DIAL, SEARCH_QUEUE_RADIX_HEAP };
 
 /// This class creates a graph containing all vertex and the edges connecting them
 ///
@@ -22,14 +31,15 @@ class Graph
         Graph(unsigned int numVertices);
 
         /// \brief
-        /// Deletes the weights in the 2 dimensional array
+        /// Deletes the weights in the 2 dimensional array and the vertices and edges added to the graph
         ///
         /// \param numVertices unsigned int - the number of vertices within the graph
         ///
         ~Graph();
 
         /// \brief
-        /// Adds a vertex to the vector containing all the vertices of the graph
+        /// Adds a vertex to the vector containing all the vertices of the graph. The graph takes ownership
+        /// of the vertex and deletes it when the graph is deleted
         ///
         /// \param vertex Vertex* - the vertex to add to the vector
         ///
@@ -44,19 +54,161 @@ class Graph
         Vertex* getVertex(int identifier);
 
         /// \brief
-        /// Adds an edge connecting two vertices to the graph
+        /// Returns the number of vertices within the graph
+        ///
+        /// \return unsigned int - the number of vertices within the graph
+        ///
+        unsigned int getNumVertices();
+
+        /// \brief
+        /// Returns whether or not two vertices are connected by an edge
+        ///
+        /// \param sourceId unsigned int - the identifier of the first vertex
+        /// \param destinationId unsigned int - the identifier of the second vertex
+        /// \return bool - true if an edge connects the two vertices
+        ///
+        bool hasEdge(unsigned int sourceId, unsigned int destinationId);
+
+        /// \brief
+        /// Returns the weight of the edge connecting two vertices
+        ///
+        /// \param sourceId unsigned int - the identifier of the first vertex
+        /// \param destinationId unsigned int - the identifier of the second vertex
+        /// \return double - the weight of the edge, only meaningful when hasEdge is true
+        ///
+        double getWeight(unsigned int sourceId, unsigned int destinationId);
+
+        /// \brief
+        /// Returns the identifiers of all vertices connected to a vertex by an edge
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \return vector<unsigned int>* - a pointer to the identifiers of the neighbouring vertices
+        ///
+        vector<unsigned int>* getNeighbours(unsigned int identifier);
+
+        /// \brief
+        /// Adds an edge connecting two vertices to the graph, replacing any edge already between them. The
+        /// graph takes ownership of the edge and deletes it when it is replaced or removed, or when the graph is deleted
         ///
         /// \param edge *Edge - a pointer to the edge object to be added
         ///
         void addEdge(Edge* edge);
 
+        /// \brief
+        /// Removes the edge connecting two vertices from the graph and deletes it
+        ///
+        /// \param sourceId unsigned int - the identifier of the first vertex
+        /// \param destinationId unsigned int - the identifier of the second vertex
+        ///
+        void removeEdge(unsigned int sourceId, unsigned int destinationId);
+
+        /// \brief
+        /// Registers an observer to be told about every change made to the edges of the graph
+        ///
+        /// \param observer GraphObserver* - a pointer to the observer to be told about changes
+        ///
+        void addObserver(GraphObserver* observer);
+
+        /// \brief
+        /// Stops an observer from being told about changes made to the edges of the graph
+        ///
+        /// \param observer GraphObserver* - a pointer to the observer to be removed
+        ///
+        void removeObserver(GraphObserver* observer);
+
+        /// \brief
+        /// Sets the component index searches use to skip the vertices a source cannot reach
+        ///
+        /// \param components ComponentIndex* - a pointer to the index, or NULL to search without one
+        ///
+        void setComponentIndex(ComponentIndex* components);
+
+        /// \brief
+        /// Returns the component index of the graph, so query engines can answer unreachable pairs at once
+        ///
+        /// \return ComponentIndex* - a pointer to the index, or NULL if there is none
+        ///
+        ComponentIndex* getComponentIndex();
+
+        /// \brief
+        /// Rounds the weight of every edge added from now on to a whole number of quanta, so searches can use
+        /// the integer queues. The rounding error of each edge is recorded
+        ///
+        /// \param quantum double - the amount weights are rounded to multiples of, such as a metre
+        /// \return bool - false if edges have already been added or the quantum is not positive
+        ///
+        bool setQuantum(double quantum);
+
+        /// \brief
+        /// Returns the amount weights are rounded to multiples of
+        ///
+        /// \return double - the quantum, or zero if weights are not quantised
+        ///
+        double getQuantum();
+
+        /// \brief
+        /// Returns the largest amount by which rounding changed the weight of an edge
+        ///
+        /// \return double - the largest absolute error, at most half a quantum
+        ///
+        double getMaxQuantisationError();
+
+        /// \brief
+        /// Returns the largest rounding error of an edge as a share of its weight
+        ///
+        /// \return double - the largest relative error
+        ///
+        double getMaxRelativeQuantisationError();
+
+        /// \brief
+        /// Chooses the priority queue shortestPathTree searches with
+        ///
+        /// \param queue SearchQueue - the queue, or SEARCH_QUEUE_AUTOMATIC to choose by the weights
+        ///
+        void setSearchQueue(SearchQueue queue);
+
+        /// \brief
+        /// Returns the priority queue shortestPathTree will search with: the binary heap when weights are not
+        /// quantised, otherwise Dial's buckets when the largest weight is small enough and a radix heap when not
+        ///
+        /// \return SearchQueue - the queue used
+        ///
+        SearchQueue getSearchQueue();
+
         /// \brief
         /// Uses Kruskals algorithm to find the minimum spanning tree of the graph
+        /// the first time it is called after the edges last changed; later calls return the cost found then.
+        /// Any number of threads may call it at once as long as the edges are not being changed
         ///
         /// \return double - the cost of the minimum spanning tree of the graph
         ///
         double minimumSpanningTreeCost();
 
+        /// \brief
+        /// Adds the minimum spanning tree to the sections of a snapshot, finding it again first if the edges
+        /// have changed since it was last found. The graph must outlive the writing of the snapshot
+        ///
+        /// \param types vector<SnapshotSectionType>* - the kind of each section, added to
+        /// \param contents vector< pair<const void*, unsigned long> >* - the address and length of each section, added to
+        ///
+        void saveMinimumSpanningTree(vector<SnapshotSectionType>* types, vector< pair<const void*, unsigned long> >* contents);
+
+        /// \brief
+        /// Takes the minimum spanning tree from a snapshot instead of running Kruskal's algorithm
+        ///
+        /// \param snapshot Snapshot* - an open snapshot taken from this graph
+        /// \return bool - false if the snapshot holds no valid minimum spanning tree
+        ///
+        bool loadMinimumSpanningTree(Snapshot* snapshot);
+
+        /// \brief
+        /// Returns a fingerprint of the vertices, edges and weights of the graph, so that precomputed
+        /// structures can be matched to the graph they were computed from
+        ///
+        /// \return unsigned long long - the fingerprint
+        ///
+        unsigned long long fingerprint();
+
         /// \brief
         /// Uses Dijkstra's algorithm to find the shortest path between the source vertex
         /// and all other vertices
@@ -73,6 +225,25 @@ class Graph
         ///
         void bfs(unsigned int);
 
+        /// \brief
+        /// Uses Dijkstra's algorithm to find the shortest path between the source vertex and all other
+        /// vertices without printing them or changing the vertices, so that several searches may run at once
+        ///
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        /// \param tree ShortestPathTree* - the tree to be filled with the distances and predecessors found
+        ///
+        void shortestPathTree(unsigned int sourceId, ShortestPathTree* tree);
+
+        /// \brief
+        /// Uses Breadth First Search algorithm to find the path between the source vertex and all other vertices
+        /// using only the edges of the minimum spanning tree, without printing them or changing the vertices.
+        /// The tree is found first if the edges have changed since it was last found
+        ///
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        /// \param tree ShortestPathTree* - the tree to be filled with the distances and predecessors found
+        ///
+        void minimumSpanningTreePathTree(unsigned int sourceId, ShortestPathTree* tree);
+
         /// \brief
         /// Returns output containing a string representation of the graph in a dimensional array of weights
         ///
@@ -84,8 +255,31 @@ class Graph
     private:
         unsigned int numVertices;
         double** weights;
-        priority_queue<Edge*, vector<Edge*>, Edge> edges;
         vector<Vertex*> vertices;
+        vector<Edge*> ownedEdges;
+        unsigned int** edgeSlots;
+        vector< vector<unsigned int> > neighbours;
+        vector<GraphObserver*> observers;
+        ComponentIndex* components;
+        bool hasSpanningTree;
+        double spanningTreeCost;
+        vector<unsigned int> spanningTreeEdges;
+        mutex spanningTreeMutex;
+        double quantum;
+        unsigned long long maxQuantisedWeight;
+        double maxQuantisationError;
+        double maxRelativeQuantisationError;
+        SearchQueue searchQueue;
+
+        /// \brief
+        /// Finds the shortest path tree with a monotone integer queue over the quantised weights
+        ///
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        /// \param tree ShortestPathTree* - the tree to be filled with the distances and predecessors found
+        /// \param queue Queue* - an empty queue with push, pop and empty
+        ///
+        template<class Queue>
+        void quantisedShortestPathTree(unsigned int sourceId, ShortestPathTree* tree, Queue* queue);
 
         /// \brief
         /// Generates string output for the user to be used when displaying paths found using
@@ -94,5 +288,10 @@ class Graph
         /// \param sourceId unsigned int - the indentifier of the source vertex
         ///
         void outputPaths(unsigned int sourceId);
+
+        /// \brief
+        /// Forgets the minimum spanning tree after an edge has changed, so that it is found again when next needed
+        ///
+        void forgetMinimumSpanningTree();
 };
 #endif // GRAPH_H
@@ -0,0 +1,238 @@
+#ifndef GRAPHBUILDER_H
+#define GRAPHBUILDER_H
+#include <vector>
+#include <algorithm>
+#include "compactgraph.h"
+#include "workerpool.h"
+
+using namespace std;
+
+/// This class builds a compact graph from a large number of edges added by many threads at once. Each
+/// thread adds to a buffer of its own, called a lane, so adding needs no locks. Building then runs in
+/// passes shared between the workers: the edges of every lane are counted and scattered into ranges of
+/// source vertices, each range is sorted and its repeated edges removed, and the ranges are copied into
+/// the offsets, targets and weights of the graph.
+///
+/// Every vertex and edge lives in a handful of large arrays rather than objects of their own, so the
+/// whole graph is freed by releasing those arrays.
+///
+template <typename Weight, typename Id>
+class GraphBuilder
+{
+    public:
+
+        /// \brief
+        /// Prepares to build a graph with the given number of vertices
+        ///
+        /// \param numVertices Id - the number of vertices within the graph
+        /// \param numLanes unsigned int - the number of threads that may add edges at the same time
+        ///
+        GraphBuilder(Id numVertices, unsigned int numLanes);
+
+        /// \brief
+        /// There was no dynamically created items in this class so there is no need for a destructor method body
+        ///
+        ~GraphBuilder();
+
+        /// \brief
+        /// Returns the number of lanes edges may be added through
+        ///
+        /// \return unsigned int - the number of lanes
+        ///
+        unsigned int getNumLanes();
+
+        /// \brief
+        /// Adds an undirected edge through a lane. Each lane must only be used by one thread at a time
+        ///
+        /// \param lane unsigned int - the lane of the calling thread
+        /// \param sourceId Id - the identifier of one end of the edge
+        /// \param destinationId Id - the identifier of the other end of the edge
+        /// \param weight double - the weight of the edge
+        /// \return bool - false if the lane does not exist, either end is not a vertex or both ends are the same
+        ///
+        bool addEdge(unsigned int lane, Id sourceId, Id destinationId, double weight);
+
+        /// \brief
+        /// Builds the graph from every edge added so far and empties the lanes. When the same two vertices
+        /// are joined more than once the lightest edge is kept
+        ///
+        /// \param pool WorkerPool* - the workers the passes are shared between
+        /// \return CompactGraph<Weight, Id>* - the graph, which the caller must delete
+        ///
+        CompactGraph<Weight, Id>* build(WorkerPool* pool);
+
+    private:
+
+        /// An edge waiting to be placed, in one direction
+        struct PendingEdge {
+            Id source;
+            Id target;
+            Weight weight;
+
+            bool operator<(const PendingEdge& other) const {
+                if (source != other.source) {
+                    return source < other.source;
+                }
+                return target != other.target ? target < other.target : weight < other.weight;
+            }
+        };
+
+        Id numVertices;
+        vector< vector<PendingEdge> > lanes;
+};
+
+/// \brief
+/// Prepares to build a graph with the given number of vertices
+///
+/// \param numVertices Id - the number of vertices within the graph
+/// \param numLanes unsigned int - the number of threads that may add edges at the same time
+///
+template <typename Weight, typename Id>
+GraphBuilder<Weight, Id>::GraphBuilder(Id numVertices, unsigned int numLanes) {
+    this->numVertices = numVertices;
+    this->lanes.resize(numLanes > 0 ? numLanes : 1);
+}
+
+/// \brief
+/// There was no dynamically created items in this class so there is no need for a destructor method body
+///
+template <typename Weight, typename Id>
+GraphBuilder<Weight, Id>::~GraphBuilder() {
+}
+
+/// \brief
+/// Returns the number of lanes edges may be added through
+///
+/// \return unsigned int - the number of lanes
+///
+template <typename Weight, typename Id>
+unsigned int GraphBuilder<Weight, Id>::getNumLanes() {
+    return this->lanes.size();
+}
+
+/// \brief
+/// Adds an undirected edge through a lane. Each lane must only be used by one thread at a time
+///
+/// \param lane unsigned int - the lane of the calling thread
+/// \param sourceId Id - the identifier of one end of the edge
+/// \param destinationId Id - the identifier of the other end of the edge
+/// \param weight double - the weight of the edge
+/// \return bool - false if the lane does not exist, either end is not a vertex or both ends are the same
+///
+template <typename Weight, typename Id>
+bool GraphBuilder<Weight, Id>::addEdge(unsigned int lane, Id sourceId, Id destinationId, double weight) {
+    if (lane >= this->lanes.size() || sourceId >= this->numVertices || destinationId >= this->numVertices
+        || sourceId == destinationId) {
+        return false;
+    }
+
+    // Stored once; both directions are made while building
+    PendingEdge edge = { sourceId, destinationId, WeightTraits<Weight>::encode(weight) };
+    this->lanes[lane].push_back(edge);
+    return true;
+}
+
+/// \brief
+/// Builds the graph from every edge added so far and empties the lanes. When the same two vertices
+/// are joined more than once the lightest edge is kept
+///
+/// \param pool WorkerPool* - the workers the passes are shared between
+/// \return CompactGraph<Weight, Id>* - the graph, which the caller must delete
+///
+template <typename Weight, typename Id>
+CompactGraph<Weight, Id>* GraphBuilder<Weight, Id>::build(WorkerPool* pool) {
+    unsigned int numLanes = this->lanes.size();
+    Id numVertices = this->numVertices;
+
+    // Several ranges a worker keeps them busy when some ranges hold more edges than others
+    unsigned int numRanges = pool->getNumWorkers() * 4;
+    numRanges = numVertices < numRanges ? (numVertices > 0 ? numVertices : 1) : numRanges;
+    vector<Id> rangeBegin(numRanges + 1);
+    for (unsigned int r = 0; r <= numRanges; r++) {
+        rangeBegin[r] = ((unsigned long long) r * numVertices + numRanges - 1) / numRanges;
+    }
+    auto rangeOf = [numVertices, numRanges](Id vertex) {
+        return (unsigned int) ((unsigned long long) vertex * numRanges / numVertices);
+    };
+
+    // Count the edges each lane puts in each range, in both directions
+    vector<Id> counts((unsigned long) numLanes * numRanges, 0);
+    pool->parallelFor(numLanes, [&](unsigned int lane) {
+        vector<PendingEdge>& edges = this->lanes[lane];
+        Id* laneCounts = &counts[(unsigned long) lane * numRanges];
+        for (Id i = 0; i < edges.size(); i++) {
+            laneCounts[rangeOf(edges[i].source)]++;
+            laneCounts[rangeOf(edges[i].target)]++;
+        }
+    });
+
+    // Each range takes a contiguous run, split in turn between the lanes
+    vector<Id> scratchBegin(numRanges + 1, 0);
+    vector<Id> positions((unsigned long) numLanes * numRanges);
+    Id total = 0;
+    for (unsigned int r = 0; r < numRanges; r++) {
+        scratchBegin[r] = total;
+        for (unsigned int lane = 0; lane < numLanes; lane++) {
+            positions[(unsigned long) lane * numRanges + r] = total;
+            total += counts[(unsigned long) lane * numRanges + r];
+        }
+    }
+    scratchBegin[numRanges] = total;
+
+    vector<PendingEdge> scratch(total);
+    pool->parallelFor(numLanes, [&](unsigned int lane) {
+        vector<PendingEdge>& edges = this->lanes[lane];
+        Id* lanePositions = &positions[(unsigned long) lane * numRanges];
+        for (Id i = 0; i < edges.size(); i++) {
+            PendingEdge backward = { edges[i].target, edges[i].source, edges[i].weight };
+            scratch[lanePositions[rangeOf(edges[i].source)]++] = edges[i];
+            scratch[lanePositions[rangeOf(edges[i].target)]++] = backward;
+        }
+        vector<PendingEdge>().swap(edges);
+    });
+
+    // Sort each range by source then target and keep the lightest of any repeated edge, counting the
+    // edges left to each vertex as it goes; ranges hold different vertices so nothing is shared
+    vector<Id> offsets(numVertices + 1, 0);
+    vector<Id> kept(numRanges, 0);
+    pool->parallelFor(numRanges, [&](unsigned int r) {
+        typename vector<PendingEdge>::iterator begin = scratch.begin() + scratchBegin[r];
+        typename vector<PendingEdge>::iterator end = scratch.begin() + scratchBegin[r + 1];
+        sort(begin, end);
+
+        Id numKept = 0;
+        for (typename vector<PendingEdge>::iterator it = begin; it != end; it++) {
+            if (numKept == 0 || it->source != begin[numKept - 1].source || it->target != begin[numKept - 1].target) {
+                begin[numKept++] = *it;
+                offsets[it->source + 1]++;
+            }
+        }
+        kept[r] = numKept;
+    });
+
+    // Turn the counts into offsets, a range at a time from where the ranges before it end
+    vector<Id> outBegin(numRanges + 1, 0);
+    for (unsigned int r = 0; r < numRanges; r++) {
+        outBegin[r + 1] = outBegin[r] + kept[r];
+    }
+
+    vector<Id> targets(outBegin[numRanges]);
+    vector<Weight> weights(outBegin[numRanges]);
+    pool->parallelFor(numRanges, [&](unsigned int r) {
+        Id running = outBegin[r];
+        for (Id v = rangeBegin[r]; v < rangeBegin[r + 1]; v++) {
+            Id degree = offsets[v + 1];
+            offsets[v + 1] = running + degree;
+            running += degree;
+        }
+        for (Id i = 0; i < kept[r]; i++) {
+            targets[outBegin[r] + i] = scratch[scratchBegin[r] + i].target;
+            weights[outBegin[r] + i] = scratch[scratchBegin[r] + i].weight;
+        }
+    });
+    offsets[0] = 0;
+
+    return new CompactGraph<Weight, Id>(&offsets, &targets, &weights);
+}
+
+#endif // GRAPHBUILDER_H
@@ -0,0 +1,30 @@
+#ifndef GRAPHOBSERVER_H
+#define GRAPHOBSERVER_H
+
+/// This class is implemented by anything holding results derived from a graph, so that the graph can
+/// tell it whenever the weight of an edge changes
+///
+class GraphObserver
+{
+    public:
+
+        /// \brief
+        /// Virtual so that observers are destroyed correctly through a base pointer
+        ///
+        virtual ~GraphObserver() {}
+
+        /// \brief
+        /// Called by the graph after an edge has been added, removed or had its weight changed
+        ///
+        /// \param sourceId unsigned int - the identifier of the first vertex of the edge
+        /// \param destinationId unsigned int - the identifier of the second vertex of the edge
+        /// \param oldWeight double - the weight before the change, or NO_EDGE if the edge is new
+        /// \param newWeight double - the weight after the change, or NO_EDGE if the edge was removed
+        ///
+        virtual void edgeChanged(unsigned int sourceId, unsigned int destinationId, double oldWeight, double newWeight) = 0;
+
+        /// The weight given for an edge that does not exist
+        static const double NO_EDGE;
+};
+
+#endif // GRAPHOBSERVER_H
@@ -0,0 +1,137 @@
+#ifndef HUBLABELS_H
+#define HUBLABELS_H
+#include <vector>
+#include "graph.h"
+#include "workerpool.h"
+#include "snapshot.h"
+
+using namespace std;
+
+/// This class is a distance oracle built with pruned landmark labelling. Every vertex is given a label of
+/// hubs and their distances such that any shortest path passes through a hub shared by the labels of its
+/// two ends, so a distance query is a merge of two short sorted lists and never searches the graph.
+///
+/// Hubs are stored by rank in one array and their distances in another, with every label ending in a
+/// sentinel rank larger than any real one, so the merge runs over plain integer arrays without bounds checks.
+/// The arrays are read through pointers so labels taken from a snapshot are used in place without copying.
+///
+class HubLabels
+{
+    public:
+
+        /// \brief
+        /// Creates an empty set of labels
+        ///
+        HubLabels();
+
+        /// \brief
+        /// There was no dynamically created items in this class so there is no need for a destructor method body
+        ///
+        ~HubLabels();
+
+        /// \brief
+        /// Builds the labels for every vertex of the graph. Vertices that lie on many shortest paths are
+        /// ranked first, then roots are searched in rank order in batches shared between the workers
+        ///
+        /// \param graph Graph* - the graph the labels are built for
+        /// \param pool WorkerPool* - the workers the searches are shared between
+        ///
+        void build(Graph* graph, WorkerPool* pool);
+
+        /// \brief
+        /// Adds the labels to the sections of a snapshot. The labels must outlive the writing of the snapshot
+        ///
+        /// \param types vector<SnapshotSectionType>* - the kind of each section, added to
+        /// \param contents vector< pair<const void*, unsigned long> >* - the address and length of each section, added to
+        ///
+        void save(vector<SnapshotSectionType>* types, vector< pair<const void*, unsigned long> >* contents);
+
+        /// \brief
+        /// Uses the labels held in a snapshot in place. The snapshot must stay open for as long as the labels are used
+        ///
+        /// \param snapshot Snapshot* - an open snapshot taken from the graph the labels are wanted for
+        /// \param numVertices unsigned int - the number of vertices within the graph
+        /// \return bool - false if the snapshot holds no valid labels for that many vertices
+        ///
+        bool load(Snapshot* snapshot, unsigned int numVertices);
+
+        /// \brief
+        /// Returns the shortest path distance between two vertices
+        ///
+        /// \param sourceId unsigned int - the identifier of the first vertex
+        /// \param destinationId unsigned int - the identifier of the second vertex
+        /// \return double - the distance, or ShortestPathTree::UNREACHABLE if there is no path
+        ///
+        double distance(unsigned int sourceId, unsigned int destinationId);
+
+        /// \brief
+        /// Returns the hubs of a vertex's label, sorted by rank, and their distances from the vertex
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \param hubs const unsigned int** - set to the ranks of the hubs, followed by the sentinel
+        /// \param distances const double** - set to the distances of the hubs
+        /// \return unsigned int - the number of hubs, not counting the sentinel
+        ///
+        unsigned int getLabel(unsigned int identifier, const unsigned int** hubs, const double** distances);
+
+        /// \brief
+        /// Returns the number of vertices labelled
+        ///
+        /// \return unsigned int - the number of vertices
+        ///
+        unsigned int getNumVertices();
+
+        /// \brief
+        /// Returns the average number of hubs in a label
+        ///
+        /// \return double - the average label size
+        ///
+        double getAverageLabelSize();
+
+        /// \brief
+        /// Returns the number of hubs in the largest label
+        ///
+        /// \return unsigned int - the largest label size
+        ///
+        unsigned int getMaximumLabelSize();
+
+        /// \brief
+        /// Returns the number of seconds the last build took
+        ///
+        /// \return double - the build time in seconds
+        ///
+        double getBuildSeconds();
+
+        /// \brief
+        /// Returns the number of bytes used by the labels
+        ///
+        /// \return unsigned long - the memory used in bytes
+        ///
+        unsigned long memoryUsage();
+
+        /// The rank that ends every label
+        static const unsigned int SENTINEL;
+
+    private:
+        unsigned int numVertices;
+        vector<unsigned long> offsets;
+        vector<unsigned int> hubs;
+        vector<double> distances;
+        const unsigned long* offsetData;
+        const unsigned int* hubData;
+        const double* distanceData;
+        unsigned long numEntries;
+        double buildSeconds;
+
+        /// \brief
+        /// Ranks the vertices so those covering the most shortest paths come first, judged by the size of
+        /// the subtrees below each vertex in shortest path trees from a sample of sources
+        ///
+        /// \param graph Graph* - the graph being labelled
+        /// \param pool WorkerPool* - the workers the sample searches are shared between
+        /// \param order vector<unsigned int>* - filled with the identifiers of the vertices, highest rank first
+        ///
+        void orderVertices(Graph* graph, WorkerPool* pool, vector<unsigned int>* order);
+};
+
+#endif // HUBLABELS_H
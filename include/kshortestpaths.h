@@ -0,0 +1,128 @@
+#ifndef KSHORTESTPATHS_H
+#define KSHORTESTPATHS_H
+#include <vector>
+#include <queue>
+#include "graph.h"
+#include "searchspace.h"
+#include "workerpool.h"
+
+using namespace std;
+
+/// This class finds the k shortest simple paths between two vertices with Yen's algorithm, for offering
+/// alternative routes. Each path found is deviated from at every vertex along it: the path up to that vertex
+/// is kept as a root, the root vertices and the next edge of every path found with the same root are removed,
+/// and the shortest spur from that vertex to the destination completes a candidate. The shortest candidate
+/// becomes the next path.
+///
+/// A search backwards from the destination, stopped once it settles the source, is shared by every spur. Its
+/// distances are lower bounds on the distance to the destination however many vertices and edges are removed,
+/// so spurs are searched with A* instead of Dijkstra, and a spur whose first step joins a path of the backwards
+/// search that avoids the root is complete without any search. Spurs whose lower bound cannot beat the
+/// candidates already held are not searched at all. The spurs of a path are independent of one another and
+/// are shared out between the worker pool, each lane having its own search state.
+///
+class KShortestPaths
+{
+    public:
+
+        /// \brief
+        /// Creates the working state for finding paths on the graph
+        ///
+        /// \param graph Graph* - the graph to be searched, which must not change while paths are being found
+        /// \param pool WorkerPool* - the worker threads spur searches are shared out between
+        ///
+        KShortestPaths(Graph* graph, WorkerPool* pool);
+
+        /// \brief
+        /// Deletes the backwards search
+        ///
+        ~KShortestPaths();
+
+        /// \brief
+        /// Finds up to k shortest simple paths from the source to the destination
+        ///
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        /// \param destinationId unsigned int - the identifier of the destination vertex
+        /// \param count unsigned int - the number of paths wanted
+        /// \param paths vector< pair<double, vector<unsigned int> > >* - filled with length and vertex list pairs,
+        ///        shortest first; fewer than k when the graph has fewer simple paths between the vertices
+        ///
+        void find(unsigned int sourceId, unsigned int destinationId, unsigned int count, vector< pair<double, vector<unsigned int> > >* paths);
+
+        /// \brief
+        /// Returns the number of vertices settled by the backwards search and the spur searches of the last call to find
+        ///
+        /// \return unsigned long - the number of settled vertices
+        ///
+        unsigned long getNumSettled();
+
+        /// \brief
+        /// Returns the number of spurs of the last call to find that were completed along the backwards search
+        /// without searching
+        ///
+        /// \return unsigned int - the number of spurs completed without searching
+        ///
+        unsigned int getNumShortcuts();
+
+        /// \brief
+        /// Returns the number of spurs of the last call to find that were skipped because they could not beat
+        /// the candidates already held
+        ///
+        /// \return unsigned int - the number of spurs skipped
+        ///
+        unsigned int getNumPruned();
+
+    private:
+        typedef pair<double, unsigned int> QueueEntry;
+
+        /// The spur search state owned by one lane; removed vertices and reached vertices are marked with
+        /// the generation of the spur so nothing needs clearing between spurs
+        struct SpurLane {
+            vector<double> distances;
+            vector<unsigned int> predecessors;
+            vector<unsigned int> reachedGeneration;
+            vector<unsigned int> removedGeneration;
+            unsigned int generation;
+            priority_queue< QueueEntry, vector<QueueEntry>, greater<QueueEntry> > queue;
+            unsigned long numSettled;
+            unsigned int numShortcuts;
+            unsigned int numPruned;
+        };
+
+        Graph* graph;
+        WorkerPool* pool;
+        SearchSpace* backwards;
+        unsigned int destinationId;
+        double sourceDistance;
+        vector<SpurLane> lanes;
+        unsigned long numSettled;
+        unsigned int numShortcuts;
+        unsigned int numPruned;
+
+        /// \brief
+        /// Returns a lower bound on the distance from a vertex to the destination, exact for vertices settled
+        /// by the backwards search and the distance of the source for the rest, which no unsettled vertex can beat
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \return double - the lower bound
+        ///
+        double remaining(unsigned int identifier);
+
+        /// \brief
+        /// Finds the shortest spur that leaves a vertex of a path, avoiding the root before it and the edges
+        /// already used by paths with the same root
+        ///
+        /// \param lane SpurLane* - the search state of the lane doing the search
+        /// \param path vector<unsigned int>* - the path being deviated from
+        /// \param rootLengths vector<double>* - the length of the path up to each of its vertices
+        /// \param spurIndex unsigned int - the position in the path of the vertex the spur leaves
+        /// \param found vector< vector<unsigned int> >* - every path found so far
+        /// \param bound double - the length a candidate must be shorter than to be of use
+        /// \param candidate pair<double, vector<unsigned int> >* - set to the root and spur when one is found
+        /// \return bool - true if a spur shorter than the bound was found
+        ///
+        bool spur(SpurLane* lane, vector<unsigned int>* path, vector<double>* rootLengths, unsigned int spurIndex,
+                  vector< vector<unsigned int> >* found, double bound, pair<double, vector<unsigned int> >* candidate);
+};
+
+#endif // KSHORTESTPATHS_H
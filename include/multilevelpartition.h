@@ -0,0 +1,111 @@
+#ifndef MULTILEVELPARTITION_H
+#define MULTILEVELPARTITION_H
+#include <vector>
+#include "graph.h"
+
+using namespace std;
+
+/// This class splits the vertices of a graph into nested cells over several levels, so that every cell
+/// at one level is made up of whole cells of the level below. Cells are found by repeatedly cutting a
+/// set of vertices in two along a breadth first order, which keeps each half close together on road graphs.
+///
+class MultilevelPartition
+{
+    public:
+
+        /// \brief
+        /// Creates an empty partition
+        ///
+        MultilevelPartition();
+
+        /// \brief
+        /// There was no dynamically created items in this class so there is no need for a destructor method body
+        ///
+        ~MultilevelPartition();
+
+        /// \brief
+        /// Partitions the vertices of the graph. Cells at level zero hold at most baseCellSize vertices and
+        /// each level up allows fanout times as many. A cell size or fanout of zero is taken as one, since no
+        /// vertex could fit in a cell of size zero
+        ///
+        /// \param graph Graph* - the graph to be partitioned
+        /// \param numLevels unsigned int - the number of levels of cells
+        /// \param baseCellSize unsigned int - the most vertices in a cell at level zero
+        /// \param fanout unsigned int - how many times larger cells may be at each level up
+        ///
+        void build(Graph* graph, unsigned int numLevels, unsigned int baseCellSize, unsigned int fanout);
+
+        /// \brief
+        /// Returns the number of levels of cells
+        ///
+        /// \return unsigned int - the number of levels
+        ///
+        unsigned int getNumLevels();
+
+        /// \brief
+        /// Returns the number of cells at a level
+        ///
+        /// \param level unsigned int - the level, with zero the smallest cells
+        /// \return unsigned int - the number of cells at the level
+        ///
+        unsigned int getNumCells(unsigned int level);
+
+        /// \brief
+        /// Returns the cell a vertex is in at a level
+        ///
+        /// \param level unsigned int - the level, with zero the smallest cells
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \return unsigned int - the number of the cell at that level
+        ///
+        unsigned int getCell(unsigned int level, unsigned int identifier);
+
+    private:
+        vector< vector<unsigned int> > cells;
+        vector<unsigned int> numCells;
+        vector<unsigned int> maxCellSizes;
+        vector<unsigned int> memberGeneration;
+        vector<unsigned int> visitedGeneration;
+        unsigned int generation;
+
+        /// \brief
+        /// Cuts a set of vertices into cells for a level and then partitions each of those cells for the levels below
+        ///
+        /// \param graph Graph* - the graph being partitioned
+        /// \param members vector<unsigned int>* - the identifiers of the vertices in the set
+        /// \param level unsigned int - the level the cells are being found for
+        ///
+        void partition(Graph* graph, vector<unsigned int>* members, unsigned int level);
+
+        /// \brief
+        /// Cuts a set of vertices in half repeatedly until every piece is small enough
+        ///
+        /// \param graph Graph* - the graph being partitioned
+        /// \param members vector<unsigned int>* - the identifiers of the vertices in the set
+        /// \param maxSize unsigned int - the most vertices allowed in a piece
+        /// \param pieces vector< vector<unsigned int> >* - the pieces found are added to this
+        ///
+        void split(Graph* graph, vector<unsigned int>* members, unsigned int maxSize, vector< vector<unsigned int> >* pieces);
+
+        /// \brief
+        /// Orders a set of vertices breadth first, using only edges inside the set, from the vertex furthest from
+        /// the first member so the order sweeps across the set
+        ///
+        /// \param graph Graph* - the graph being partitioned
+        /// \param members vector<unsigned int>* - the identifiers of the vertices in the set
+        /// \param order vector<unsigned int>* - filled with the members in breadth first order
+        ///
+        void sweepOrder(Graph* graph, vector<unsigned int>* members, vector<unsigned int>* order);
+
+        /// \brief
+        /// Visits the members of the set breadth first from a start vertex, restarting from unvisited members
+        /// so every member ends up in the order
+        ///
+        /// \param graph Graph* - the graph being partitioned
+        /// \param members vector<unsigned int>* - the identifiers of the vertices in the set
+        /// \param startId unsigned int - the identifier of the vertex to start from
+        /// \param order vector<unsigned int>* - filled with the members in the order visited
+        ///
+        void breadthFirstOrder(Graph* graph, vector<unsigned int>* members, unsigned int startId, vector<unsigned int>* order);
+};
+
+#endif // MULTILEVELPARTITION_H
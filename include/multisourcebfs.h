@@ -0,0 +1,88 @@
+#ifndef MULTISOURCEBFS_H
+#define MULTISOURCEBFS_H
+#include <vector>
+#include "graph.h"
+
+using namespace std;
+
+/// This class finds the number of hops from many sources to every vertex at once. Up to 512 sources are
+/// searched together with one bit per source in the visited and frontier sets of each vertex, so a vertex
+/// reached by several sources at the same depth has its edges followed once for all of them and the sets
+/// are combined a whole machine word (or vector register) at a time.
+///
+/// Hops are held in 16 bits to halve the memory the depths are written to, so they can be at most MAX_HOPS
+/// (65534). A search that reaches any vertex further than that from a source stops and reports failure
+/// rather than giving wrong hops.
+///
+class MultiSourceBfs
+{
+    public:
+
+        /// \brief
+        /// Copies the edges to be followed into flat arrays, finding the minimum spanning tree first if its edges
+        /// are to be followed and the graph has changed since it was last found
+        ///
+        /// \param graph Graph* - the graph to be searched
+        /// \param useMinimumSpanningTree bool - true to follow only the edges of the minimum spanning tree
+        ///
+        MultiSourceBfs(Graph* graph, bool useMinimumSpanningTree);
+
+        /// \brief
+        /// There was no dynamically created items in this class so there is no need for a destructor method body
+        ///
+        ~MultiSourceBfs();
+
+        /// \brief
+        /// Finds the hops from every source to every vertex, searching the sources in batches of batchWidth
+        ///
+        /// \param sources vector<unsigned int>* - the identifiers of the source vertices
+        /// \param batchWidth unsigned int - the number of sources searched together, from 1 to MAX_BATCH_WIDTH
+        /// \param hops vector<unsigned short>* - filled with one row per source holding the hops to each vertex,
+        ///                                       or UNREACHED if the vertex cannot be reached
+        /// \return bool - false if the batch width is out of range, or if a vertex is more than MAX_HOPS hops from
+        ///        a source, leaving the hops incomplete
+        ///
+        bool run(vector<unsigned int>* sources, unsigned int batchWidth, vector<unsigned short>* hops);
+
+        /// \brief
+        /// Finds the hops from a single source to every vertex with an ordinary breadth first search, for comparison
+        ///
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        /// \param hops unsigned short* - filled with the hops to each vertex, or UNREACHED
+        /// \return bool - false if a vertex is more than MAX_HOPS hops from the source, leaving the hops incomplete
+        ///
+        bool runSingle(unsigned int sourceId, unsigned short* hops);
+
+        /// The hop count given to vertices that cannot be reached
+        static const unsigned short UNREACHED;
+
+        /// The most hops a vertex can be from a source, one less than UNREACHED
+        static const unsigned short MAX_HOPS;
+
+        /// The most sources searched together, which fills the eight words of state kept per vertex
+        static const unsigned int MAX_BATCH_WIDTH;
+
+    private:
+        typedef unsigned long long Word;
+
+        unsigned int numVertices;
+        vector<unsigned int> offsets;
+        vector<unsigned int> targets;
+        vector<Word> seen;
+        vector<Word> visit;
+        vector<Word> visitNext;
+        vector<unsigned short> vertexHops;
+
+        /// \brief
+        /// Searches one batch of sources with WORDS 64 bit words of state per vertex
+        ///
+        /// \param sources const unsigned int* - the identifiers of the source vertices in the batch
+        /// \param numSources unsigned int - the number of sources in the batch, at most 64 times WORDS
+        /// \param hops unsigned short* - filled with one row per source of the batch
+        /// \return bool - false if a vertex is more than MAX_HOPS hops from a source of the batch
+        ///
+        template <unsigned int WORDS>
+        bool runBatch(const unsigned int* sources, unsigned int numSources, unsigned short* hops);
+};
+
+#endif // MULTISOURCEBFS_H
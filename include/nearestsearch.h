@@ -0,0 +1,63 @@
+#ifndef NEARESTSEARCH_H
+#define NEARESTSEARCH_H
+#include <vector>
+#include "graph.h"
+#include "searchspace.h"
+
+using namespace std;
+
+/// This class answers the queries that only need the part of the graph close to the source: every vertex
+/// within a distance, or the nearest few of a set of targets. The search stops as soon as the bound is
+/// reached so the work done is proportional to the region explored rather than the size of the graph.
+///
+class NearestSearch
+{
+    public:
+
+        /// \brief
+        /// Creates the working state for searches on the graph
+        ///
+        /// \param graph Graph* - the graph to be searched
+        ///
+        NearestSearch(Graph* graph);
+
+        /// \brief
+        /// Deletes the search space
+        ///
+        ~NearestSearch();
+
+        /// \brief
+        /// Finds every vertex whose distance from the source is no more than the radius
+        ///
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        /// \param radius double - the largest distance from the source to be included
+        /// \param results vector< pair<double, unsigned int> >* - filled with distance and identifier pairs, closest first
+        ///
+        void withinRadius(unsigned int sourceId, double radius, vector< pair<double, unsigned int> >* results);
+
+        /// \brief
+        /// Finds the targets closest to the source
+        ///
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        /// \param count unsigned int - the number of targets wanted
+        /// \param targets vector<unsigned int>* - the identifiers of the vertices that may be returned
+        /// \param results vector< pair<double, unsigned int> >* - filled with distance and identifier pairs, closest first
+        ///
+        void nearestTargets(unsigned int sourceId, unsigned int count, vector<unsigned int>* targets, vector< pair<double, unsigned int> >* results);
+
+        /// \brief
+        /// Returns the number of vertices settled by the last search
+        ///
+        /// \return unsigned int - the number of settled vertices
+        ///
+        unsigned int getNumSettled();
+
+    private:
+        Graph* graph;
+        SearchSpace* space;
+        unsigned int generation;
+        vector<unsigned int> targetGeneration;
+        unsigned int numSettled;
+};
+
+#endif // NEARESTSEARCH_H
@@ -31,6 +31,20 @@ class Point
         ///
         double distanceTo(Point*);
 
+        /// \brief
+        /// Returns the x coordinate of the point
+        ///
+        /// \return double - the x coordinate
+        ///
+        double getX();
+
+        /// \brief
+        /// Returns the y coordinate of the point
+        ///
+        /// \return double - the y coordinate
+        ///
+        double getY();
+
         /// \brief
         /// Returns output containing a string representation of the point class detailing its coordinates
         ///
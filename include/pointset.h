@@ -0,0 +1,106 @@
+#ifndef POINTSET_H
+#define POINTSET_H
+#include <vector>
+#include "point.h"
+
+using namespace std;
+
+/// This class holds the coordinates of many points as two arrays, one of x coordinates and one of y,
+/// rather than as separately allocated Point objects, and works out distances between them in bulk.
+/// Whole rows of distances and batches of edges are computed four at a time with AVX2 instructions
+/// when the processor has them, and one at a time otherwise; both give exactly the distances of
+/// Point::distanceTo.
+///
+class PointSet
+{
+    public:
+
+        /// \brief
+        /// Creates an empty set of points
+        ///
+        PointSet();
+
+        /// \brief
+        /// Copies the coordinates of a list of points
+        ///
+        /// \param points vector<Point*>* - the points to be copied
+        ///
+        PointSet(vector<Point*>* points);
+
+        /// \brief
+        /// There was no dynamically created items in this class so there is no need for a destructor method body
+        ///
+        ~PointSet();
+
+        /// \brief
+        /// Adds a point to the end of the set
+        ///
+        /// \param xCoord double - value of x coordinate
+        /// \param yCoord double - value of y coordinate
+        ///
+        void addPoint(double xCoord, double yCoord);
+
+        /// \brief
+        /// Returns the number of points within the set
+        ///
+        /// \return unsigned int - the number of points
+        ///
+        unsigned int size();
+
+        /// \brief
+        /// Returns the x coordinate of a point
+        ///
+        /// \param identifier unsigned int - the position of the point within the set
+        /// \return double - the x coordinate
+        ///
+        double getX(unsigned int identifier);
+
+        /// \brief
+        /// Returns the y coordinate of a point
+        ///
+        /// \param identifier unsigned int - the position of the point within the set
+        /// \return double - the y coordinate
+        ///
+        double getY(unsigned int identifier);
+
+        /// \brief
+        /// Works out the distances from one point to a run of consecutive points
+        ///
+        /// \param from unsigned int - the position of the point distances are measured from
+        /// \param first unsigned int - the position of the first point distances are measured to
+        /// \param count unsigned int - the number of points distances are measured to
+        /// \param distances double* - filled with count distances
+        ///
+        void distancesFrom(unsigned int from, unsigned int first, unsigned int count, double* distances);
+
+        /// \brief
+        /// Works out the length of a batch of edges between points
+        ///
+        /// \param sources const unsigned int* - the position of the first end of each edge
+        /// \param destinations const unsigned int* - the position of the second end of each edge
+        /// \param count unsigned long - the number of edges
+        /// \param distances double* - filled with the length of each edge
+        ///
+        void edgeLengths(const unsigned int* sources, const unsigned int* destinations, unsigned long count, double* distances);
+
+        /// \brief
+        /// Chooses whether the AVX2 kernels are used when the processor has them
+        ///
+        /// \param vectorised bool - false to always use the scalar kernels
+        ///
+        void setVectorised(bool vectorised);
+
+        /// \brief
+        /// Returns whether distances are being worked out with the AVX2 kernels
+        ///
+        /// \return bool - true if the processor has AVX2 and it has not been turned off
+        ///
+        bool isVectorised();
+
+    private:
+        vector<double> xCoords;
+        vector<double> yCoords;
+        bool vectorised;
+};
+
+#endif // POINTSET_H
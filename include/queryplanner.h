@@ -0,0 +1,211 @@
+#ifndef QUERYPLANNER_H
+#define QUERYPLANNER_H
+#include <vector>
+#include <string>
+#include "graph.h"
+#include "point.h"
+#include "pointset.h"
+#include "searchspace.h"
+#include "hublabels.h"
+#include "customizablerouteplanner.h"
+#include "distanceoracle.h"
+
+using namespace std;
+
+/// The engines a distance query can be answered with
+enum PlanEngine { PLAN_SAME_VERTEX, PLAN_NO_PATH, PLAN_HUB_LABELS, PLAN_DISTANCE_ORACLE, PLAN_ROUTE_PLANNER,
+                  PLAN_BREADTH_FIRST, PLAN_ASTAR, PLAN_DIJKSTRA };
+
+/// The number of engines a plan can choose between
+const unsigned int NUM_PLAN_ENGINES = 8;
+
+/// The engine chosen for a query, with the estimated cost of every engine that could have answered it.
+/// Costs are in edge relaxations, with a heap operation counted as the logarithm of the heap size, and
+/// are negative for engines that cannot answer the query
+struct QueryPlan {
+    PlanEngine engine;
+    double costs[NUM_PLAN_ENGINES];
+};
+
+/// The figures about a graph the planner chooses engines by, gathered once
+struct GraphStatistics {
+    unsigned int numVertices;
+    unsigned long numEdges;
+    double density;
+    unsigned int minimumDegree;
+    unsigned int maximumDegree;
+    double averageDegree;
+    double minimumWeight;
+    double maximumWeight;
+    bool uniformWeights;
+    bool integralWeights;
+    double geometricScale;
+};
+
+/// This class answers distance queries with whichever engine should be fastest for the graph and the pair
+/// asked about. Figures about the graph are gathered once: its size and density, the spread of degrees and
+/// weights, and, when coordinates are given, how closely the weights follow the straight line distance
+/// between the ends of each edge. Each query is then planned by estimating the cost of every engine that
+/// could answer it: the component index and the hub labels, route planner and oracle when they have been
+/// given, a breadth first search when every edge weighs the same, an A* search when the weights are never
+/// shorter than some fraction of the straight line, and a plain Dijkstra search that stops at the destination.
+/// Search costs start from estimates made from the figures and are replaced by the average work each engine
+/// has actually done as queries are answered. Only one query may run at a time.
+///
+class QueryPlanner
+{
+    public:
+
+        /// \brief
+        /// Gathers the figures about the graph used to plan queries on it
+        ///
+        /// \param graph Graph* - the graph the queries are answered on
+        ///
+        QueryPlanner(Graph* graph);
+
+        /// \brief
+        /// There was no dynamically created items in this class so there is no need for a destructor method body
+        ///
+        ~QueryPlanner();
+
+        /// \brief
+        /// Gathers the figures about the graph again, after its edges have changed
+        ///
+        void refreshStatistics();
+
+        /// \brief
+        /// Returns the figures gathered about the graph
+        ///
+        /// \return GraphStatistics - the graph statistics
+        ///
+        GraphStatistics getStatistics();
+
+        /// \brief
+        /// Gives the coordinates of the vertices, allowing A* searches guided by the straight line distance
+        ///
+        /// \param points vector<Point*>* - the coordinates of every vertex, in identifier order
+        ///
+        void setCoordinates(vector<Point*>* points);
+
+        /// \brief
+        /// Gives hub labels built for the graph, or NULL to stop using them
+        ///
+        /// \param hubLabels HubLabels* - a pointer to the labels
+        ///
+        void setHubLabels(HubLabels* hubLabels);
+
+        /// \brief
+        /// Gives a customised route planner for the graph, or NULL to stop using it
+        ///
+        /// \param routePlanner CustomizableRoutePlanner* - a pointer to the route planner
+        ///
+        void setRoutePlanner(CustomizableRoutePlanner* routePlanner);
+
+        /// \brief
+        /// Gives an approximate distance oracle for the graph, used only by queries that allow approximate
+        /// answers, or NULL to stop using it
+        ///
+        /// \param oracle DistanceOracle* - a pointer to the oracle
+        ///
+        void setDistanceOracle(DistanceOracle* oracle);
+
+        /// \brief
+        /// Chooses the engine with the lowest estimated cost for a query
+        ///
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        /// \param destinationId unsigned int - the identifier of the destination vertex
+        /// \param approximate bool - true if an answer up to the oracle's stretch longer is good enough
+        /// \return QueryPlan - the chosen engine and the estimated cost of every engine
+        ///
+        QueryPlan plan(unsigned int sourceId, unsigned int destinationId, bool approximate);
+
+        /// \brief
+        /// Answers a query with the engine a plan chose
+        ///
+        /// \param plan const QueryPlan& - the plan, whose engine must be able to answer the query
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        /// \param destinationId unsigned int - the identifier of the destination vertex
+        /// \return double - the distance, or ShortestPathTree::UNREACHABLE if there is no path
+        ///
+        double execute(const QueryPlan& plan, unsigned int sourceId, unsigned int destinationId);
+
+        /// \brief
+        /// Plans and answers a query
+        ///
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        /// \param destinationId unsigned int - the identifier of the destination vertex
+        /// \param approximate bool - true if an answer up to the oracle's stretch longer is good enough
+        /// \return double - the distance, or ShortestPathTree::UNREACHABLE if there is no path
+        ///
+        double distance(unsigned int sourceId, unsigned int destinationId, bool approximate);
+
+        /// \brief
+        /// Describes the plan for a query without answering it, as name=value pairs giving the chosen engine,
+        /// the estimated cost of every engine and the figures about the graph the costs came from
+        ///
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        /// \param destinationId unsigned int - the identifier of the destination vertex
+        /// \param approximate bool - true if an answer up to the oracle's stretch longer is good enough
+        /// \return string - the explanation
+        ///
+        string explain(unsigned int sourceId, unsigned int destinationId, bool approximate);
+
+        /// \brief
+        /// Returns the name of an engine as used in explanations
+        ///
+        /// \param engine PlanEngine - the engine
+        /// \return string - the name of the engine
+        ///
+        static string getEngineName(PlanEngine engine);
+
+    private:
+        Graph* graph;
+        GraphStatistics statistics;
+        PointSet coordinates;
+        HubLabels* hubLabels;
+        CustomizableRoutePlanner* routePlanner;
+        DistanceOracle* oracle;
+        SearchSpace space;
+        vector<double> distances;
+        vector<unsigned int> reachedGeneration;
+        unsigned int generation;
+        double totalWork[NUM_PLAN_ENGINES];
+        double totalEstimate[NUM_PLAN_ENGINES];
+
+        /// \brief
+        /// Returns the work a search engine is expected to do, in vertices settled, scaling its estimate from
+        /// the figures by how far off such estimates have been for the queries it has answered so far
+        ///
+        /// \param engine PlanEngine - the search engine
+        /// \param estimate double - the number of vertices the figures suggest it will settle
+        /// \return double - the expected number of vertices settled
+        ///
+        double expectedWork(PlanEngine engine, double estimate);
+
+        /// \brief
+        /// Moves on to a new search, so every vertex is unreached without visiting them
+        ///
+        void startSearch();
+
+        /// \brief
+        /// Finds the distance with a breadth first search, counting edges and multiplying by their weight
+        ///
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        /// \param destinationId unsigned int - the identifier of the destination vertex
+        /// \param numSettled unsigned long* - set to the number of vertices settled
+        /// \return double - the distance, or ShortestPathTree::UNREACHABLE if there is no path
+        ///
+        double breadthFirst(unsigned int sourceId, unsigned int destinationId, unsigned long* numSettled);
+
+        /// \brief
+        /// Finds the distance with an A* search, guided by the straight line distance to the destination
+        ///
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        /// \param destinationId unsigned int - the identifier of the destination vertex
+        /// \param numSettled unsigned long* - set to the number of vertices settled
+        /// \return double - the distance, or ShortestPathTree::UNREACHABLE if there is no path
+        ///
+        double aStar(unsigned int sourceId, unsigned int destinationId, unsigned long* numSettled);
+};
+
+#endif // QUERYPLANNER_H
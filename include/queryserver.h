@@ -0,0 +1,118 @@
+#ifndef QUERYSERVER_H
+#define QUERYSERVER_H
+#include <string>
+#include <vector>
+#include <atomic>
+#include "graph.h"
+#include "workerpool.h"
+#include "shortestpathtreecache.h"
+#include "nearestsearch.h"
+#include "hublabels.h"
+
+using namespace std;
+
+/// This class keeps a graph loaded and answers queries sent to it one per line, either over
+/// standard input and output or over a Unix domain socket. Requests are read in batches and the
+/// searches needed by a batch are shared out between a pool of worker threads, with one search
+/// per distinct source in the batch. Shortest path trees are kept in a cache so that popular sources
+/// are only searched again after an edge change affects them.
+///
+/// Requests and their responses:
+///   DIST source destination   ->  OK distance         (shortest path distance)
+///   PATH source destination   ->  OK distance v0 ... vn
+///   MST source destination    ->  OK distance         (distance using only minimum spanning tree edges)
+///   RADIUS source radius      ->  OK n v1:d1 ... vn:dn (every vertex within the radius, closest first)
+///   NEAREST source k t1 ... tm ->  OK n v1:d1 ... vn:dn (the k targets closest to the source, closest first)
+///   MSTCOST                   ->  OK cost
+///   STATS                     ->  OK name=value ...
+///   QUIT                      ->  closes the connection
+/// Unreachable destinations give NO PATH and malformed requests give ERROR followed by a reason.
+///
+struct Query;
+
+class QueryServer
+{
+    public:
+
+        /// \brief
+        /// Creates a server for the graph, computing its minimum spanning tree up front so the first batch does not wait for it
+        ///
+        /// \param graph Graph* - the graph to answer queries on, which must already hold all of its edges
+        /// \param numWorkers unsigned int - the number of worker threads, or zero for one per hardware thread
+        /// \param maxBatchSize unsigned int - the largest number of requests answered together
+        /// \param cacheBytes unsigned long - the most memory cached shortest path trees may use, in bytes
+        ///
+        QueryServer(Graph* graph, unsigned int numWorkers, unsigned int maxBatchSize, unsigned long cacheBytes);
+
+        /// \brief
+        /// Deletes the worker pool and the cache, which stops observing the graph
+        ///
+        ~QueryServer();
+
+        /// \brief
+        /// Answers requests read from one file descriptor, writing responses to another in the same order,
+        /// until QUIT is received or the input is closed
+        ///
+        /// \param inputDescriptor int - the file descriptor requests are read from
+        /// \param outputDescriptor int - the file descriptor responses are written to
+        ///
+        void serve(int inputDescriptor, int outputDescriptor);
+
+        /// \brief
+        /// Listens on a Unix domain socket and answers each connection on its own thread. Only returns
+        /// if the socket could not be set up
+        ///
+        /// \param socketPath const string& - the file system path of the socket
+        /// \return bool - false if the socket could not be created
+        ///
+        bool serveSocket(const string& socketPath);
+
+        /// \brief
+        /// Answers a batch of requests, running the searches they need on the worker pool. A QUIT in the batch
+        /// is answered with OK, since closing the connection is left to the caller
+        ///
+        /// \param requests vector<string>* - the request lines
+        /// \param responses vector<string>* - filled with one response line per request
+        ///
+        void answerBatch(vector<string>* requests, vector<string>* responses);
+
+        /// \brief
+        /// Answers distance requests from hub labels instead of searching. The labels must have been built
+        /// for the graph and are not updated when its edges change
+        ///
+        /// \param hubLabels HubLabels* - a pointer to the labels, or NULL to go back to searching
+        ///
+        void setHubLabels(HubLabels* hubLabels);
+
+        /// \brief
+        /// Returns the counters kept by the server as name=value pairs
+        ///
+        /// \return string - the server statistics
+        ///
+        string getStats();
+
+    private:
+        Graph* graph;
+        WorkerPool* pool;
+        ShortestPathTreeCache* cache;
+        HubLabels* hubLabels;
+        unsigned int maxBatchSize;
+        atomic<unsigned long> numQueries;
+        atomic<unsigned long> numBatches;
+        atomic<unsigned long> numSearches;
+        atomic<unsigned long> numErrors;
+        atomic<unsigned long> numLabelLookups;
+        atomic<unsigned long> numUnreachable;
+        vector<NearestSearch*> nearestSearches;
+        vector<NearestSearch*> idleNearestSearches;
+        mutex nearestSearchesMutex;
+
+        /// \brief
+        /// Answers a radius or nearest targets query with a search that stops once its bound is reached
+        ///
+        /// \param query Query* - the query to be answered, whose response is filled in
+        ///
+        void answerNearbyQuery(Query* query);
+};
+
+#endif // QUERYSERVER_H
@@ -0,0 +1,75 @@
+#ifndef RADIXHEAP_H
+#define RADIXHEAP_H
+#include <vector>
+
+using namespace std;
+
+/// This class is a radix heap, a monotone priority queue of whole number keys. Entries are kept in 65
+/// buckets by the highest bit in which their key differs from the last key taken out, so bucket zero
+/// holds keys equal to it and bucket i keys that first differ at bit i - 1. Taking out from an empty
+/// bucket zero finds the first bucket in use, makes its smallest key the last key and spreads its
+/// entries over the lower buckets. Each entry only ever moves down, at most 64 times, so the cost per
+/// entry is bounded by the width of the key rather than the logarithm of the queue size, and no
+/// comparisons between entries are needed. Keys added must never be smaller than the last key taken out.
+///
+class RadixHeap
+{
+    public:
+
+        /// \brief
+        /// Creates an empty heap
+        ///
+        RadixHeap();
+
+        /// \brief
+        /// There was no dynamically created items in this class so there is no need for a destructor method body
+        ///
+        ~RadixHeap();
+
+        /// \brief
+        /// Adds a vertex with a key
+        ///
+        /// \param key unsigned long long - the key, at least the last key taken out
+        /// \param identifier unsigned int - the identifier of the vertex
+        ///
+        void push(unsigned long long key, unsigned int identifier);
+
+        /// \brief
+        /// Takes out a vertex with the smallest key; the heap must not be empty
+        ///
+        /// \param key unsigned long long* - set to the key
+        /// \param identifier unsigned int* - set to the identifier of the vertex
+        ///
+        void pop(unsigned long long* key, unsigned int* identifier);
+
+        /// \brief
+        /// Returns whether the heap is empty
+        ///
+        /// \return bool - true if there are no entries
+        ///
+        bool empty();
+
+        /// \brief
+        /// Empties the heap so it can be used for another search
+        ///
+        void clear();
+
+    private:
+        typedef pair<unsigned long long, unsigned int> HeapEntry;
+
+        static const unsigned int NUM_BUCKETS = 65;
+
+        vector<HeapEntry> buckets[NUM_BUCKETS];
+        unsigned long long last;
+        unsigned long size;
+
+        /// \brief
+        /// Returns the bucket a key belongs in given the last key taken out
+        ///
+        /// \param key unsigned long long - the key
+        /// \return unsigned int - the bucket, zero when the key equals the last key
+        ///
+        unsigned int bucketOf(unsigned long long key);
+};
+
+#endif // RADIXHEAP_H
@@ -0,0 +1,96 @@
+#ifndef SEARCHSPACE_H
+#define SEARCHSPACE_H
+#include <vector>
+#include <queue>
+#include <functional>
+#include "graph.h"
+
+using namespace std;
+
+/// This class holds the working state of a Dijkstra search that is settled one vertex at a time, so that
+/// callers can stop as soon as they have what they need. It is meant to be reused for many searches;
+/// starting a new search only forgets the vertices touched by the last one rather than every vertex.
+///
+class SearchSpace
+{
+    public:
+
+        /// \brief
+        /// Creates the working state for searches over a graph with the given number of vertices
+        ///
+        /// \param numVertices unsigned int - the number of vertices within the graph
+        ///
+        SearchSpace(unsigned int numVertices);
+
+        /// \brief
+        /// There was no dynamically created items in this class so there is no need for a destructor method body
+        ///
+        ~SearchSpace();
+
+        /// \brief
+        /// Forgets the last search and starts a new one from the source vertex
+        ///
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        ///
+        void start(unsigned int sourceId);
+
+        /// \brief
+        /// Returns the distance of the next vertex to be settled, discarding queue entries that are out of date
+        ///
+        /// \return double - the distance of the next vertex, or ShortestPathTree::UNREACHABLE if the search is finished
+        ///
+        double nextDistance();
+
+        /// \brief
+        /// Settles the closest unsettled vertex and relaxes the edges leaving it
+        ///
+        /// \param graph Graph* - the graph being searched
+        /// \param identifier unsigned int* - set to the identifier of the settled vertex
+        /// \return bool - false if there are no vertices left to settle
+        ///
+        bool settleNext(Graph* graph, unsigned int* identifier);
+
+        /// \brief
+        /// Returns the tentative distance from the source to a vertex, which is final once it is settled
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \return double - the distance, or ShortestPathTree::UNREACHABLE if the vertex has not been reached
+        ///
+        double getDistance(unsigned int identifier);
+
+        /// \brief
+        /// Returns the predecessor of a reached vertex on its path back to the source
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \return unsigned int - the identifier of the predecessor vertex
+        ///
+        unsigned int getPredecessorId(unsigned int identifier);
+
+        /// \brief
+        /// Returns whether or not the search has settled a vertex
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \return bool - true if the distance to the vertex is final
+        ///
+        bool isSettled(unsigned int identifier);
+
+        /// \brief
+        /// Returns the vertices reached by the current search in the order they were first reached
+        ///
+        /// \return vector<unsigned int>* - a pointer to the identifiers of the reached vertices
+        ///
+        vector<unsigned int>* getTouched();
+
+    private:
+        typedef pair<double, unsigned int> QueueEntry;
+
+        unsigned int generation;
+        vector<unsigned int> reachedGeneration;
+        vector<unsigned int> settledGeneration;
+        vector<double> distances;
+        vector<unsigned int> predecessors;
+        vector<unsigned int> touched;
+        priority_queue< QueueEntry, vector<QueueEntry>, greater<QueueEntry> > unvisitedVerticesQueue;
+};
+
+#endif // SEARCHSPACE_H
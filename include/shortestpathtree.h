@@ -0,0 +1,112 @@
+#ifndef SHORTESTPATHTREE_H
+#define SHORTESTPATHTREE_H
+#include <vector>
+
+using namespace std;
+
+/// This class holds the result of a single source shortest path search; the distance from the source
+/// and the predecessor on the path back to the source for every vertex in the graph
+///
+class ShortestPathTree
+{
+    public:
+
+        /// \brief
+        /// Creates an empty tree that holds no vertices until reset is called
+        ///
+        ShortestPathTree();
+
+        /// \brief
+        /// There was no dynamically created items in this class so there is no need for a destructor method body
+        ///
+        ~ShortestPathTree();
+
+        /// \brief
+        /// Clears the tree so every vertex is unreachable and is its own predecessor, except for the source
+        /// which is given a distance of zero
+        ///
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        /// \param numVertices unsigned int - the number of vertices within the graph
+        ///
+        void reset(unsigned int sourceId, unsigned int numVertices);
+
+        /// \brief
+        /// Returns the identifier of the source vertex the tree was grown from
+        ///
+        /// \return unsigned int - the identifier of the source vertex
+        ///
+        unsigned int getSourceId();
+
+        /// \brief
+        /// Returns the number of vertices held in the tree
+        ///
+        /// \return unsigned int - the number of vertices held in the tree
+        ///
+        unsigned int getNumVertices();
+
+        /// \brief
+        /// Sets the distance from the source to a vertex
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \param distance double - the distance from the source to the vertex
+        ///
+        void setDistance(unsigned int identifier, double distance);
+
+        /// \brief
+        /// Returns the distance from the source to a vertex
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \return double - the distance from the source, or UNREACHABLE if there is no path
+        ///
+        double getDistance(unsigned int identifier);
+
+        /// \brief
+        /// Sets the predecessor of a vertex on its path back to the source
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \param predecessorId unsigned int - the identifier of the predecessor vertex
+        ///
+        void setPredecessorId(unsigned int identifier, unsigned int predecessorId);
+
+        /// \brief
+        /// Returns the predecessor of a vertex on its path back to the source
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \return unsigned int - the identifier of the predecessor vertex
+        ///
+        unsigned int getPredecessorId(unsigned int identifier);
+
+        /// \brief
+        /// Returns whether or not a vertex can be reached from the source
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \return bool - true if there is a path from the source to the vertex
+        ///
+        bool isReachable(unsigned int identifier);
+
+        /// \brief
+        /// Follows the predecessors back from a vertex to build the path from the source to that vertex
+        ///
+        /// \param destinationId unsigned int - the identifier of the vertex at the end of the path
+        /// \param path vector<unsigned int>* - filled with the identifiers on the path, starting with the source
+        /// \return bool - false if the destination cannot be reached from the source
+        ///
+        bool getPath(unsigned int destinationId, vector<unsigned int>* path);
+
+        /// \brief
+        /// Returns the number of bytes used to hold the distances and predecessors of the tree
+        ///
+        /// \return unsigned long - the memory used by the tree in bytes
+        ///
+        unsigned long memoryUsage();
+
+        /// The distance given to vertices that cannot be reached from the source
+        static const double UNREACHABLE;
+
+    private:
+        unsigned int sourceId;
+        vector<double> distances;
+        vector<unsigned int> predecessors;
+};
+
+#endif // SHORTESTPATHTREE_H
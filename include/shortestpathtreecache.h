@@ -0,0 +1,96 @@
+#ifndef SHORTESTPATHTREECACHE_H
+#define SHORTESTPATHTREECACHE_H
+#include <list>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include "shortestpathtree.h"
+#include "graphobserver.h"
+
+using namespace std;
+
+/// This class keeps the most recently used shortest path trees, keyed by their source, within a memory
+/// budget. When an edge of the graph changes only the trees that the change could make wrong are dropped.
+///
+class ShortestPathTreeCache : public GraphObserver
+{
+    public:
+
+        /// \brief
+        /// Creates an empty cache that holds trees up to the given total size
+        ///
+        /// \param maxBytes unsigned long - the most memory the cached trees may use, in bytes
+        ///
+        ShortestPathTreeCache(unsigned long maxBytes);
+
+        /// \brief
+        /// The cached trees are shared pointers so there is no need for a destructor method body
+        ///
+        ~ShortestPathTreeCache();
+
+        /// \brief
+        /// Returns the cached tree for a source and marks it as the most recently used
+        ///
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        /// \return shared_ptr<ShortestPathTree> - the cached tree, or an empty pointer if there is none
+        ///
+        shared_ptr<ShortestPathTree> find(unsigned int sourceId);
+
+        /// \brief
+        /// Adds a tree to the cache, dropping the least recently used trees until it fits within the budget
+        ///
+        /// \param tree shared_ptr<ShortestPathTree> - the completed tree to be cached
+        ///
+        void insert(shared_ptr<ShortestPathTree> tree);
+
+        /// \brief
+        /// Drops every cached tree
+        ///
+        void clear();
+
+        /// \brief
+        /// Drops the cached trees whose distances or paths may be changed by the edge change
+        ///
+        /// \param sourceId unsigned int - the identifier of the first vertex of the edge
+        /// \param destinationId unsigned int - the identifier of the second vertex of the edge
+        /// \param oldWeight double - the weight before the change, or NO_EDGE if the edge is new
+        /// \param newWeight double - the weight after the change, or NO_EDGE if the edge was removed
+        ///
+        void edgeChanged(unsigned int sourceId, unsigned int destinationId, double oldWeight, double newWeight);
+
+        /// \brief
+        /// Returns the counters kept by the cache as name=value pairs
+        ///
+        /// \return string - the cache statistics
+        ///
+        string getStats();
+
+    private:
+
+        /// A cached tree together with its place in the recently used list
+        struct Entry {
+            shared_ptr<ShortestPathTree> tree;
+            list<unsigned int>::iterator recentlyUsed;
+            unsigned long bytes;
+        };
+
+        unsigned long maxBytes;
+        unsigned long usedBytes;
+        map<unsigned int, Entry> entries;
+        list<unsigned int> recentlyUsed;
+        mutex cacheMutex;
+        unsigned long numHits;
+        unsigned long numMisses;
+        unsigned long numEvictions;
+        unsigned long numInvalidations;
+
+        /// \brief
+        /// Removes a cached tree and returns its memory to the budget
+        ///
+        /// \param entry map<unsigned int, Entry>::iterator - the cached tree to be removed
+        ///
+        void erase(map<unsigned int, Entry>::iterator entry);
+};
+
+#endif // SHORTESTPATHTREECACHE_H
@@ -0,0 +1,87 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/// The kinds of section a snapshot can hold
+enum SnapshotSectionType {
+    SNAPSHOT_MST_COST = 1,
+    SNAPSHOT_MST_EDGES = 2,
+    SNAPSHOT_HUB_OFFSETS = 3,
+    SNAPSHOT_HUB_HUBS = 4,
+    SNAPSHOT_HUB_DISTANCES = 5
+};
+
+/// This class maps a snapshot file of precomputed structures back into memory. A snapshot starts with a
+/// page holding a header and a table of sections, followed by each section starting on a page boundary
+/// so its contents can be used in place without being copied or decoded. Opening checks the version,
+/// the fingerprint of the graph the snapshot was taken from and the checksum of every section, so a
+/// snapshot of a different graph or a damaged file is refused rather than giving wrong answers.
+///
+class Snapshot
+{
+    public:
+
+        /// \brief
+        /// Creates a snapshot with no file mapped
+        ///
+        Snapshot();
+
+        /// \brief
+        /// Unmaps the file, after which pointers to its sections must no longer be used
+        ///
+        ~Snapshot();
+
+        /// \brief
+        /// Maps a snapshot file and checks that it belongs to the graph with the given fingerprint
+        ///
+        /// \param path const string& - the path of the snapshot file
+        /// \param fingerprint unsigned long long - the fingerprint of the graph the snapshot is wanted for
+        /// \param error string* - set to the reason when the snapshot cannot be used
+        /// \return bool - true if the snapshot was mapped and is valid
+        ///
+        bool open(const string& path, unsigned long long fingerprint, string* error);
+
+        /// \brief
+        /// Returns the contents of a section, which stay in place for as long as the snapshot is open
+        ///
+        /// \param type SnapshotSectionType - the kind of section
+        /// \param length unsigned long* - set to the length of the section in bytes
+        /// \return const void* - a pointer to the contents, or NULL if the snapshot has no such section
+        ///
+        const void* getSection(SnapshotSectionType type, unsigned long* length);
+
+        /// \brief
+        /// Writes the sections given to a new snapshot file. The file is written under a temporary name and
+        /// renamed into place, so a reader never sees a partly written snapshot
+        ///
+        /// \param path const string& - the path of the snapshot file
+        /// \param fingerprint unsigned long long - the fingerprint of the graph the sections were computed from
+        /// \param types const vector<SnapshotSectionType>& - the kind of each section
+        /// \param contents const vector< pair<const void*, unsigned long> >& - the address and length of each section
+        /// \return bool - false if the file could not be written
+        ///
+        static bool write(const string& path, unsigned long long fingerprint, const vector<SnapshotSectionType>& types,
+                          const vector< pair<const void*, unsigned long> >& contents);
+
+        /// \brief
+        /// Returns a 64 bit checksum of a block of memory
+        ///
+        /// \param data const void* - the start of the block
+        /// \param length unsigned long - the length of the block in bytes
+        /// \param seed unsigned long long - the checksum of any data before this block, or zero
+        /// \return unsigned long long - the checksum
+        ///
+        static unsigned long long checksum(const void* data, unsigned long length, unsigned long long seed);
+
+        /// The version of the file layout written, which must match for a snapshot to be opened
+        static const unsigned int VERSION;
+
+    private:
+        void* mapping;
+        unsigned long mappingLength;
+};
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,213 @@
+#ifndef VERSIONEDGRAPH_H
+#define VERSIONEDGRAPH_H
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include "graph.h"
+
+using namespace std;
+
+/// The neighbours of one vertex and the weight of the edge to each
+typedef vector< pair<unsigned int, double> > VersionRow;
+
+/// A run of consecutive rows, shared between the versions that did not change any of them
+struct VersionChunk {
+    vector<const VersionRow*> rows;
+};
+
+/// A change to apply to a versioned graph: the new weight of an edge, or NO_EDGE to remove it
+struct EdgeUpdate {
+    unsigned int sourceId;
+    unsigned int destinationId;
+    double weight;
+};
+
+/// This class is one published version of a versioned graph. It never changes once published, so any
+/// number of readers can search it while newer versions are being made.
+///
+class GraphVersion
+{
+    public:
+
+        /// \brief
+        /// Returns the number of the version, counting up from zero for the graph it was copied from
+        ///
+        /// \return unsigned long - the version number
+        ///
+        unsigned long getNumber() const;
+
+        /// \brief
+        /// Returns the number of vertices within the graph
+        ///
+        /// \return unsigned int - the number of vertices
+        ///
+        unsigned int getNumVertices() const;
+
+        /// \brief
+        /// Returns the neighbours of a vertex and the weight of the edge to each
+        ///
+        /// \param identifier unsigned int - the identifier of the vertex
+        /// \return const VersionRow& - the neighbours and weights
+        ///
+        const VersionRow& getNeighbours(unsigned int identifier) const;
+
+        /// \brief
+        /// Returns the weight of an edge
+        ///
+        /// \param sourceId unsigned int - the identifier of the first vertex
+        /// \param destinationId unsigned int - the identifier of the second vertex
+        /// \return double - the weight, or NO_EDGE if there is no such edge
+        ///
+        double getWeight(unsigned int sourceId, unsigned int destinationId) const;
+
+        /// \brief
+        /// Returns the sum of the weights of every edge, counting each edge once
+        ///
+        /// \return double - the total weight
+        ///
+        double getTotalWeight() const;
+
+        /// \brief
+        /// Returns the shortest path distance between two vertices with a Dijkstra search that stops at the destination
+        ///
+        /// \param sourceId unsigned int - the identifier of the source vertex
+        /// \param destinationId unsigned int - the identifier of the destination vertex
+        /// \param distances vector<double>* - working space for the distance of every vertex, reused between searches
+        /// \return double - the distance, or ShortestPathTree::UNREACHABLE if there is no path
+        ///
+        double distance(unsigned int sourceId, unsigned int destinationId, vector<double>* distances) const;
+
+    private:
+        friend class VersionedGraph;
+        unsigned long number;
+        unsigned int numVertices;
+        vector<VersionChunk*> chunks;
+        double totalWeight;
+};
+
+/// This class lets queries run while the graph is being updated. The graph is copied once into rows of
+/// neighbours grouped into chunks, and a version is a table of chunks. An update copies the table, the
+/// chunks it touches and the rows it changes, shares everything else with the version before it, and
+/// publishes the new version with a single atomic store, so a reader always searches a whole version and
+/// never waits for a writer.
+///
+/// Replaced versions, chunks and rows are freed by epoch: a reader announces the epoch it started in
+/// before picking up the current version, everything a writer replaces is tagged with the epoch it was
+/// replaced in, and it is freed once no reader announced an epoch that early. Writers are applied one
+/// at a time; readers each keep to their own slot.
+///
+class VersionedGraph
+{
+    public:
+
+        /// \brief
+        /// Copies the edges of a graph into the first version
+        ///
+        /// \param graph Graph* - the graph copied
+        /// \param maxReaders unsigned int - the number of reader slots
+        ///
+        VersionedGraph(Graph* graph, unsigned int maxReaders);
+
+        /// \brief
+        /// Frees every version, which no reader may still be using
+        ///
+        ~VersionedGraph();
+
+        /// \brief
+        /// Claims a reader slot, to be used by one thread at a time
+        ///
+        /// \return unsigned int - the slot, or maxReaders if every slot has been claimed
+        ///
+        unsigned int addReader();
+
+        /// \brief
+        /// Announces a reader and returns the current version, which stays valid until the reader releases it
+        ///
+        /// \param reader unsigned int - the reader's slot
+        /// \return const GraphVersion* - the current version
+        ///
+        const GraphVersion* acquire(unsigned int reader);
+
+        /// \brief
+        /// Tells the writers a reader has finished with the version it acquired
+        ///
+        /// \param reader unsigned int - the reader's slot
+        ///
+        void release(unsigned int reader);
+
+        /// \brief
+        /// Applies a batch of edge changes as one new version and frees what no reader can still see
+        ///
+        /// \param updates const vector<EdgeUpdate>& - the changes, applied in order
+        /// \return unsigned long - the number of the published version
+        ///
+        unsigned long apply(const vector<EdgeUpdate>& updates);
+
+        /// \brief
+        /// Returns the number of replaced versions not yet freed
+        ///
+        /// \return unsigned long - the number of retired versions
+        ///
+        unsigned long getNumRetired();
+
+        /// \brief
+        /// Returns the number of bytes used by the current version, counting shared rows and chunks once
+        ///
+        /// \return unsigned long - the memory used in bytes
+        ///
+        unsigned long memoryUsage();
+
+    private:
+
+        /// The epoch a reader started in, or IDLE, padded so readers do not share a cache line
+        struct ReaderSlot {
+            atomic<unsigned long> epoch;
+            char padding[64 - sizeof(atomic<unsigned long>)];
+        };
+
+        /// What one update replaced, tagged with the epoch it was replaced in
+        struct Retired {
+            unsigned long epoch;
+            GraphVersion* version;
+            vector<VersionChunk*> chunks;
+            vector<const VersionRow*> rows;
+        };
+
+        atomic<GraphVersion*> current;
+        atomic<unsigned long> epoch;
+        ReaderSlot* readers;
+        unsigned int maxReaders;
+        atomic<unsigned int> numReaders;
+        mutex writerMutex;
+        deque<Retired> retired;
+        vector<unsigned long> chunkStamps;
+        vector<unsigned long> rowStamps;
+
+        /// \brief
+        /// Sets the weight of an edge in one direction within a version being made, copying its chunk and
+        /// row the first time the update touches them
+        ///
+        /// \param version GraphVersion* - the version being made
+        /// \param sourceId unsigned int - the vertex whose row changes
+        /// \param destinationId unsigned int - the neighbour whose weight changes
+        /// \param weight double - the new weight, or NO_EDGE to remove the edge
+        /// \param replaced Retired* - collects the chunks and rows the update replaced
+        /// \return double - the old weight, or NO_EDGE if there was no such edge
+        ///
+        double setWeight(GraphVersion* version, unsigned int sourceId, unsigned int destinationId, double weight, Retired* replaced);
+
+        /// \brief
+        /// Frees everything replaced before the earliest epoch a reader is still in
+        ///
+        void reclaim();
+
+        /// \brief
+        /// Frees what an update replaced
+        ///
+        /// \param replaced Retired& - the replaced version, chunks and rows
+        ///
+        static void freeRetired(Retired& replaced);
+};
+
+#endif // VERSIONEDGRAPH_H
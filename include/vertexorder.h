@@ -0,0 +1,109 @@
+#ifndef VERTEXORDER_H
+#define VERTEXORDER_H
+#include <vector>
+#include "graph.h"
+#include "point.h"
+
+using namespace std;
+
+/// This class renumbers the vertices of a graph so that vertices close together in the graph are close
+/// together in memory. Storage built in the new order reads fewer cache lines per search, and the order
+/// maps identifiers between the numbering callers use and the numbering of the storage.
+///
+/// A Hilbert curve over the coordinates of the points puts nearby places next to each other, reverse
+/// Cuthill-McKee keeps the identifiers at each end of every edge close, and a breadth first order puts
+/// each vertex near the vertex it was reached from.
+///
+class VertexOrder
+{
+    public:
+
+        /// \brief
+        /// Creates an order that leaves every identifier as it is
+        ///
+        /// \param numVertices unsigned int - the number of vertices within the graph
+        ///
+        VertexOrder(unsigned int numVertices);
+
+        /// \brief
+        /// There was no dynamically created items in this class so there is no need for a destructor method body
+        ///
+        ~VertexOrder();
+
+        /// \brief
+        /// Orders the vertices along a Hilbert curve through the points they stand for
+        ///
+        /// \param points vector<Point*>* - the point of each vertex
+        ///
+        void byHilbertCurve(vector<Point*>* points);
+
+        /// \brief
+        /// Orders the vertices by reverse Cuthill-McKee: a breadth first search of each component from a
+        /// vertex of least degree that visits neighbours in order of degree, numbered backwards
+        ///
+        /// \param graph Graph* - the graph whose vertices are ordered
+        ///
+        void byReverseCuthillMcKee(Graph* graph);
+
+        /// \brief
+        /// Orders the vertices in the order a breadth first search of each component reaches them
+        ///
+        /// \param graph Graph* - the graph whose vertices are ordered
+        ///
+        void byBreadthFirst(Graph* graph);
+
+        /// \brief
+        /// Returns the number of vertices within the order
+        ///
+        /// \return unsigned int - the number of vertices
+        ///
+        unsigned int getNumVertices();
+
+        /// \brief
+        /// Returns the position in storage of the vertex with the given identifier
+        ///
+        /// \param identifier unsigned int - the identifier callers use for the vertex
+        /// \return unsigned int - the identifier of the vertex within storage
+        ///
+        unsigned int toInternal(unsigned int identifier);
+
+        /// \brief
+        /// Returns the identifier callers use for the vertex at a position in storage
+        ///
+        /// \param internalId unsigned int - the identifier of the vertex within storage
+        /// \return unsigned int - the identifier callers use for the vertex
+        ///
+        unsigned int toExternal(unsigned int internalId);
+
+        /// \brief
+        /// Returns the average distance in storage between the two ends of an edge, which is smaller the
+        /// more of a vertex's neighbours share its cache lines
+        ///
+        /// \param graph Graph* - the graph whose edges are measured
+        /// \return double - the average gap between the internal identifiers of the ends of each edge
+        ///
+        double averageEdgeGap(Graph* graph);
+
+    private:
+        vector<unsigned int> internalIds;
+        vector<unsigned int> externalIds;
+
+        /// \brief
+        /// Sets the order from the identifiers callers use, listed in storage order
+        ///
+        /// \param externalIds const vector<unsigned int>& - the identifier of the vertex at each position
+        ///
+        void setOrder(const vector<unsigned int>& externalIds);
+
+        /// \brief
+        /// Lists the vertices in the order breadth first searches of each component reach them
+        ///
+        /// \param graph Graph* - the graph whose vertices are listed
+        /// \param byDegree bool - whether each search starts from a vertex of least degree and visits
+        /// neighbours in order of degree, as Cuthill-McKee does
+        /// \param order vector<unsigned int>* - filled with the vertices in the order they are reached
+        ///
+        void breadthFirstOrder(Graph* graph, bool byDegree, vector<unsigned int>* order);
+};
+
+#endif // VERTEXORDER_H
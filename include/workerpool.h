@@ -0,0 +1,67 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+using namespace std;
+
+/// This class keeps a fixed number of worker threads alive so that queries can be run in parallel
+/// without paying the cost of starting a thread for each one
+///
+class WorkerPool
+{
+    public:
+
+        /// \brief
+        /// Starts the worker threads, using one per hardware thread when zero is given
+        ///
+        /// \param numWorkers unsigned int - the number of worker threads to start
+        ///
+        WorkerPool(unsigned int numWorkers);
+
+        /// \brief
+        /// Lets the workers finish the tasks already submitted and then joins them
+        ///
+        ~WorkerPool();
+
+        /// \brief
+        /// Returns the number of worker threads in the pool
+        ///
+        /// \return unsigned int - the number of worker threads
+        ///
+        unsigned int getNumWorkers();
+
+        /// \brief
+        /// Adds a task to the queue to be run by the next free worker
+        ///
+        /// \param task function<void()> - the task to be run
+        ///
+        void submit(function<void()> task);
+
+        /// \brief
+        /// Runs body for every index from zero up to count, sharing the indices between the workers and the
+        /// calling thread, and returns once every index has been run
+        ///
+        /// \param count unsigned int - the number of indices to run
+        /// \param body function<void(unsigned int)> - the work to run for a single index
+        ///
+        void parallelFor(unsigned int count, function<void(unsigned int)> body);
+
+    private:
+        vector<thread> workers;
+        queue< function<void()> > tasks;
+        mutex tasksMutex;
+        condition_variable taskAvailable;
+        bool stopping;
+
+        /// \brief
+        /// Loop run by each worker thread taking tasks from the queue until the pool is destroyed
+        ///
+        void run();
+};
+
+#endif // WORKERPOOL_H
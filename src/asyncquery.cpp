@@ -0,0 +1,124 @@
+#include "asyncquery.h"
+
+/// This class is the caller's handle on a query submitted to an AsyncQueryEngine. The answer arrives
+/// through a future, through a callback run on the worker thread that answered it, or both. The query
+/// can be cancelled at any time and gives up once its deadline has passed; a search that is already
+/// running notices either within a few hundred vertices and stops.
+///
+
+/// \brief
+/// Creates a query that has not been submitted yet
+///
+/// \param type AsyncQueryType - the kind of query
+/// \param sourceId unsigned int - the identifier of the source vertex
+/// \param destinationId unsigned int - the identifier of the destination vertex
+/// \param priority int - queries with a higher priority are started first
+/// \param timeoutSeconds double - how long from now the answer is still wanted, or zero for no deadline
+/// \param callback function<void(const AsyncQueryResult&)> - run with the answer, or empty for none
+///
+AsyncQuery::AsyncQuery(AsyncQueryType type, unsigned int sourceId, unsigned int destinationId, int priority,
+                       double timeoutSeconds, function<void(const AsyncQueryResult&)> callback) {
+    this->type = type;
+    this->sourceId = sourceId;
+    this->destinationId = destinationId;
+    this->priority = priority;
+    this->hasDeadline = timeoutSeconds > 0;
+    this->deadline = chrono::steady_clock::now()
+        + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(timeoutSeconds));
+    this->callback = callback;
+    this->cancelled = false;
+    this->completed = false;
+    this->future = this->answer.get_future().share();
+}
+
+/// \brief
+/// There was no dynamically created items in this class so there is no need for a destructor method body
+///
+AsyncQuery::~AsyncQuery() {}
+
+/// \brief
+/// Asks for the query to stop. It ends with ASYNC_CANCELLED unless it has already been answered
+///
+void AsyncQuery::cancel() {
+    this->cancelled = true;
+}
+
+/// \brief
+/// Returns whether or not the query should stop, because it was cancelled or its deadline has passed
+///
+/// \return bool - true if no more work should be done on the query
+///
+bool AsyncQuery::shouldStop() {
+    return this->cancelled || (this->hasDeadline && chrono::steady_clock::now() >= this->deadline);
+}
+
+/// \brief
+/// Returns the status a query that has to stop ends with
+///
+/// \return AsyncQueryStatus - ASYNC_CANCELLED if it was cancelled, otherwise ASYNC_TIMED_OUT
+///
+AsyncQueryStatus AsyncQuery::getStopStatus() {
+    return this->cancelled ? ASYNC_CANCELLED : ASYNC_TIMED_OUT;
+}
+
+/// \brief
+/// Answers the query, fulfilling the future and running the callback. Only the first answer counts
+///
+/// \param result const AsyncQueryResult& - the answer
+///
+void AsyncQuery::complete(const AsyncQueryResult& result) {
+    if (this->completed.exchange(true)) {
+        return;
+    }
+
+    // The callback runs first so that anyone woken by the future sees its effects
+    if (this->callback) {
+        this->callback(result);
+    }
+    this->answer.set_value(result);
+}
+
+/// \brief
+/// Returns a future for the answer, which may be waited on from any thread
+///
+/// \return shared_future<AsyncQueryResult> - the future answer
+///
+shared_future<AsyncQueryResult> AsyncQuery::getFuture() {
+    return this->future;
+}
+
+/// \brief
+/// Returns the kind of query
+///
+/// \return AsyncQueryType - the kind of query
+///
+AsyncQueryType AsyncQuery::getType() {
+    return this->type;
+}
+
+/// \brief
+/// Returns the identifier of the source vertex
+///
+/// \return unsigned int - the identifier of the source vertex
+///
+unsigned int AsyncQuery::getSourceId() {
+    return this->sourceId;
+}
+
+/// \brief
+/// Returns the identifier of the destination vertex
+///
+/// \return unsigned int - the identifier of the destination vertex
+///
+unsigned int AsyncQuery::getDestinationId() {
+    return this->destinationId;
+}
+
+/// \brief
+/// Returns the priority of the query, with higher priorities started first
+///
+/// \return int - the priority of the query
+///
+int AsyncQuery::getPriority() {
+    return this->priority;
+}
@@ -0,0 +1,311 @@
+#include <sstream>
+#include <set>
+#include <algorithm>
+#include "asyncqueryengine.h"
+#include "componentindex.h"
+
+/// This class answers queries without blocking the caller. Submitted queries wait in a bounded queue
+/// ordered by priority and are answered by the engine's own worker threads, each with its own search
+/// state. A query is rejected straight away rather than queued when the queue is full, so a busy
+/// engine pushes back on its callers instead of growing without limit. Searches check every few hundred
+/// vertices whether their query has been cancelled or has run past its deadline, and stop if so.
+///
+
+/// How many vertices a search settles between checks for cancellation and deadlines
+const unsigned int STOP_CHECK_INTERVAL = 256;
+
+/// \brief
+/// Starts the worker threads, using one per hardware thread when zero is given
+///
+/// \param graph Graph* - the graph to answer queries on
+/// \param numWorkers unsigned int - the number of worker threads to start
+/// \param maxQueued unsigned int - the most queries that may wait to be started
+///
+AsyncQueryEngine::AsyncQueryEngine(Graph* graph, unsigned int numWorkers, unsigned int maxQueued) {
+    this->graph = graph;
+    this->maxQueued = maxQueued > 0 ? maxQueued : 1;
+    this->stopping = false;
+    this->nextSequence = 0;
+    this->numAnswered = 0;
+    this->numTimedOut = 0;
+    this->numCancelled = 0;
+    this->numRejected = 0;
+
+    if (numWorkers == 0) {
+        numWorkers = thread::hardware_concurrency();
+    }
+    if (numWorkers == 0) {
+        numWorkers = 1;
+    }
+
+    for (unsigned int i = 0; i < numWorkers; i++) {
+        this->workers.push_back(thread(&AsyncQueryEngine::run, this));
+    }
+}
+
+/// \brief
+/// Ends every query still waiting as cancelled, lets the running ones finish and joins the workers
+///
+AsyncQueryEngine::~AsyncQueryEngine() {
+    vector< shared_ptr<AsyncQuery> > abandoned;
+    {
+        unique_lock<mutex> lock(this->queuedMutex);
+        this->stopping = true;
+        while (!this->queued.empty()) {
+            abandoned.push_back(this->queued.top().query);
+            this->queued.pop();
+        }
+    }
+    this->queryAvailable.notify_all();
+
+    // Callbacks are run outside the lock in case they submit again
+    AsyncQueryResult result;
+    result.status = ASYNC_CANCELLED;
+    result.distance = ShortestPathTree::UNREACHABLE;
+    for (unsigned int i = 0; i < abandoned.size(); i++) {
+        finish(abandoned[i].get(), result);
+    }
+
+    for (unsigned int i = 0; i < this->workers.size(); i++) {
+        this->workers[i].join();
+    }
+}
+
+/// \brief
+/// Queues a query to be answered. A query that cannot be queued is answered at once with ASYNC_REJECTED
+///
+/// \param query shared_ptr<AsyncQuery> - the query, which the engine keeps alive until it is answered
+/// \return bool - false if the queue was full or the query names a vertex not in the graph
+///
+bool AsyncQueryEngine::submit(shared_ptr<AsyncQuery> query) {
+    bool accepted = query->getSourceId() < this->graph->getNumVertices()
+        && query->getDestinationId() < this->graph->getNumVertices();
+
+    if (accepted) {
+        unique_lock<mutex> lock(this->queuedMutex);
+        if (this->stopping || this->queued.size() >= this->maxQueued) {
+            accepted = false;
+        }
+        else {
+            QueuedQuery entry;
+            entry.priority = query->getPriority();
+            entry.sequence = this->nextSequence++;
+            entry.query = query;
+            this->queued.push(entry);
+        }
+    }
+
+    if (!accepted) {
+        AsyncQueryResult result;
+        result.status = ASYNC_REJECTED;
+        result.distance = ShortestPathTree::UNREACHABLE;
+        finish(query.get(), result);
+        return false;
+    }
+
+    this->queryAvailable.notify_one();
+    return true;
+}
+
+/// \brief
+/// Returns the number of queries waiting to be started
+///
+/// \return unsigned int - the number of queued queries
+///
+unsigned int AsyncQueryEngine::getNumQueued() {
+    unique_lock<mutex> lock(this->queuedMutex);
+    return this->queued.size();
+}
+
+/// \brief
+/// Returns the counters kept by the engine as name=value pairs
+///
+/// \return string - the engine statistics
+///
+string AsyncQueryEngine::getStats() {
+    ostringstream out;
+    out << "answered=" << this->numAnswered << " timed_out=" << this->numTimedOut << " cancelled=" << this->numCancelled
+        << " rejected=" << this->numRejected << " queued=" << getNumQueued() << " workers=" << this->workers.size();
+    return out.str();
+}
+
+/// \brief
+/// Loop run by each worker thread taking the most urgent query until the engine is destroyed
+///
+void AsyncQueryEngine::run() {
+    unsigned int numVertices = this->graph->getNumVertices();
+    WorkerState state;
+    state.space = new SearchSpace(numVertices);
+    state.treeDistances.resize(numVertices);
+    state.treePredecessors.resize(numVertices);
+    state.treeGeneration.assign(numVertices, 0);
+    state.generation = 0;
+
+    while (true) {
+        shared_ptr<AsyncQuery> query;
+        {
+            unique_lock<mutex> lock(this->queuedMutex);
+            while (!this->stopping && this->queued.empty()) {
+                this->queryAvailable.wait(lock);
+            }
+            if (this->queued.empty()) {
+                break;
+            }
+            query = this->queued.top().query;
+            this->queued.pop();
+        }
+
+        AsyncQueryResult result;
+        result.distance = ShortestPathTree::UNREACHABLE;
+
+        // A query that waited past its deadline, or was cancelled while waiting, is never started
+        if (query->shouldStop()) {
+            result.status = query->getStopStatus();
+        }
+
+        // Vertices in different components have no path between them of any kind, so nothing is searched
+        else if (this->graph->getComponentIndex() != NULL
+                 && !this->graph->getComponentIndex()->isReachable(query->getSourceId(), query->getDestinationId())) {
+            result.status = ASYNC_NO_PATH;
+        }
+        else if (query->getType() == ASYNC_MST) {
+            answerMinimumSpanningTree(query.get(), &state, &result);
+        }
+        else {
+            answerShortestPath(query.get(), &state, &result);
+        }
+        finish(query.get(), result);
+    }
+
+    delete state.space;
+}
+
+/// \brief
+/// Answers a distance or path query with a search that stops once the destination is settled
+///
+/// \param query AsyncQuery* - the query to be answered
+/// \param state WorkerState* - the search state of the worker answering it
+/// \param result AsyncQueryResult* - filled with the answer
+///
+void AsyncQueryEngine::answerShortestPath(AsyncQuery* query, WorkerState* state, AsyncQueryResult* result) {
+    SearchSpace* space = state->space;
+    unsigned int destinationId = query->getDestinationId();
+    unsigned int numSettled = 0;
+    unsigned int uId;
+
+    result->status = ASYNC_NO_PATH;
+    space->start(query->getSourceId());
+
+    while (space->settleNext(this->graph, &uId)) {
+        if (uId == destinationId) {
+            result->status = ASYNC_OK;
+            break;
+        }
+
+        // Give up the processor as soon as the answer is no longer wanted
+        if (++numSettled % STOP_CHECK_INTERVAL == 0 && query->shouldStop()) {
+            result->status = query->getStopStatus();
+            return;
+        }
+    }
+
+    if (result->status != ASYNC_OK) {
+        return;
+    }
+    result->distance = space->getDistance(destinationId);
+
+    if (query->getType() == ASYNC_PATH) {
+        for (unsigned int vId = destinationId; vId != query->getSourceId(); vId = space->getPredecessorId(vId)) {
+            result->path.push_back(vId);
+        }
+        result->path.push_back(query->getSourceId());
+        reverse(result->path.begin(), result->path.end());
+    }
+}
+
+/// \brief
+/// Answers a minimum spanning tree query by walking the tree from the source until the destination is found,
+/// finding the tree first if it is not already known
+///
+/// \param query AsyncQuery* - the query to be answered
+/// \param state WorkerState* - the search state of the worker answering it
+/// \param result AsyncQueryResult* - filled with the answer
+///
+void AsyncQueryEngine::answerMinimumSpanningTree(AsyncQuery* query, WorkerState* state, AsyncQueryResult* result) {
+    unsigned int sourceId = query->getSourceId();
+    unsigned int destinationId = query->getDestinationId();
+    unsigned int numVisited = 0;
+    this->graph->minimumSpanningTreeCost();
+
+    // Moving to a new generation makes every vertex unreached without visiting them
+    state->generation++;
+    if (state->generation == 0) {
+        state->treeGeneration.assign(state->treeGeneration.size(), 0);
+        state->generation = 1;
+    }
+
+    queue<unsigned int> unvisitedVerticesQueue;
+    state->treeGeneration[sourceId] = state->generation;
+    state->treeDistances[sourceId] = 0;
+    state->treePredecessors[sourceId] = sourceId;
+    unvisitedVerticesQueue.push(sourceId);
+    result->status = ASYNC_NO_PATH;
+
+    // There is only one path through a tree so the first time the destination is reached is the answer
+    while (!unvisitedVerticesQueue.empty()) {
+        unsigned int uId = unvisitedVerticesQueue.front();
+        unvisitedVerticesQueue.pop();
+
+        if (uId == destinationId) {
+            result->status = ASYNC_OK;
+            break;
+        }
+        if (++numVisited % STOP_CHECK_INTERVAL == 0 && query->shouldStop()) {
+            result->status = query->getStopStatus();
+            return;
+        }
+
+        set<unsigned int>* adjSet = this->graph->getVertex(uId)->getAdjacencies();
+        for (set<unsigned int>::iterator it = adjSet->begin(); it != adjSet->end(); it++) {
+            if (state->treeGeneration[*it] != state->generation) {
+                state->treeGeneration[*it] = state->generation;
+                state->treeDistances[*it] = state->treeDistances[uId] + this->graph->getWeight(uId, *it);
+                state->treePredecessors[*it] = uId;
+                unvisitedVerticesQueue.push(*it);
+            }
+        }
+    }
+
+    if (result->status != ASYNC_OK) {
+        return;
+    }
+    result->distance = state->treeDistances[destinationId];
+
+    for (unsigned int vId = destinationId; vId != sourceId; vId = state->treePredecessors[vId]) {
+        result->path.push_back(vId);
+    }
+    result->path.push_back(sourceId);
+    reverse(result->path.begin(), result->path.end());
+}
+
+/// \brief
+/// Answers a query and counts how it ended
+///
+/// \param query AsyncQuery* - the query to be answered
+/// \param result const AsyncQueryResult& - the answer
+///
+void AsyncQueryEngine::finish(AsyncQuery* query, const AsyncQueryResult& result) {
+    if (result.status == ASYNC_TIMED_OUT) {
+        this->numTimedOut++;
+    }
+    else if (result.status == ASYNC_CANCELLED) {
+        this->numCancelled++;
+    }
+    else if (result.status == ASYNC_REJECTED) {
+        this->numRejected++;
+    }
+    else {
+        this->numAnswered++;
+    }
+    query->complete(result);
+}
@@ -0,0 +1,454 @@
+#include <cstring>
+#include <cstdio>
+#include <sstream>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include "batchcoordinator.h"
+#include "snapshot.h"
+
+/// This class runs an all pairs job over an external graph file with several local worker processes.
+/// The sources are split into shards of consecutive sources, and each worker is a child process with its
+/// own mapping of the graph file and a stream to the coordinator, over which it is given one shard at a
+/// time. Shards already on disk from an earlier run of the same graph are checked and kept, a worker that
+/// dies has its shard given to a replacement process, and a shard that keeps failing stops the job. The
+/// finished shards can be merged into one file of the same layout covering every source.
+///
+
+/// The number of times a shard is given to a worker before the job gives up on it
+const unsigned int MAX_SHARD_ATTEMPTS = 3;
+
+/// The number of rows read at a time when checking or merging shards
+const unsigned int SHARD_READ_ROWS = 16;
+
+/// \brief
+/// Prepares a job over a graph file
+///
+/// \param graphPath const string& - the path of the file written by ExternalGraphWriter
+/// \param directory const string& - the directory the shard files are written to
+/// \param numProcesses unsigned int - the number of worker processes run at once
+/// \param shardSources unsigned int - the number of sources in each shard
+///
+BatchCoordinator::BatchCoordinator(const string& graphPath, const string& directory, unsigned int numProcesses, unsigned int shardSources) {
+    this->graphPath = graphPath;
+    this->directory = directory;
+    this->numProcesses = numProcesses > 0 ? numProcesses : 1;
+    this->shardSources = shardSources > 0 ? shardSources : 1;
+    this->numVertices = 0;
+    this->graphChecksum = 0;
+    this->numKept = 0;
+    this->numRestarts = 0;
+    this->numProcessesStarted = 0;
+}
+
+/// \brief
+/// Stops any worker processes still running
+///
+BatchCoordinator::~BatchCoordinator() {
+    for (unsigned int i = 0; i < this->processes.size(); i++) {
+        stopProcess(&this->processes[i]);
+    }
+}
+
+/// \brief
+/// Writes every shard that is not already on disk, restarting workers that die
+///
+/// \param error string* - set to the reason when the job could not be finished
+/// \return bool - true if every shard is on disk
+///
+bool BatchCoordinator::run(string* error) {
+    error->clear();
+    BatchWorker graph(this->graphPath, this->directory);
+    if (!graph.open()) {
+        *error = "could not map " + this->graphPath;
+        return false;
+    }
+    this->numVertices = graph.getNumVertices();
+    this->graphChecksum = graph.getGraphChecksum();
+
+    // Shards left by an earlier run of the same graph are kept when they check out
+    this->shards.clear();
+    deque<unsigned int> pending;
+    this->numKept = 0;
+    this->numRestarts = 0;
+    this->numProcessesStarted = 0;
+    for (unsigned int first = 0; first < this->numVertices; first += this->shardSources) {
+        Shard shard;
+        shard.firstSource = first;
+        shard.numSources = this->numVertices - first < this->shardSources ? this->numVertices - first : this->shardSources;
+        shard.attempts = 0;
+        if (checkShard(BatchWorker::getShardPath(this->directory, first, shard.numSources), this->numVertices,
+                       this->graphChecksum, first, shard.numSources)) {
+            this->numKept++;
+        }
+        else {
+            pending.push_back(this->shards.size());
+        }
+        this->shards.push_back(shard);
+    }
+
+    unsigned int remaining = pending.size();
+    unsigned int numStarting = this->numProcesses < remaining ? this->numProcesses : remaining;
+    {
+        unique_lock<mutex> lock(this->processesMutex);
+        this->processes.resize(numStarting);
+    }
+    for (unsigned int i = 0; i < numStarting; i++) {
+        if (!startProcess(&this->processes[i])) {
+            *error = "could not start a worker process";
+        }
+    }
+
+    while (remaining > 0 && error->empty()) {
+
+        // Idle workers are given work first, so a replacement picks up the shard its predecessor dropped
+        vector<pollfd> descriptors;
+        vector<unsigned int> owners;
+        for (unsigned int i = 0; i < this->processes.size(); i++) {
+            Process& process = this->processes[i];
+            if (process.channel >= 0 && process.shard < 0 && !pending.empty() && !assign(&process, &pending)) {
+                stopProcess(&process);
+                startProcess(&process);
+                continue;
+            }
+            if (process.channel >= 0 && process.shard >= 0) {
+                pollfd descriptor = { process.channel, POLLIN, 0 };
+                descriptors.push_back(descriptor);
+                owners.push_back(i);
+            }
+        }
+        if (descriptors.empty()) {
+            *error = "no worker process is running";
+            break;
+        }
+        if (poll(&descriptors[0], descriptors.size(), -1) < 0) {
+            continue;
+        }
+
+        for (unsigned int d = 0; d < descriptors.size() && error->empty(); d++) {
+            if (descriptors[d].revents == 0) {
+                continue;
+            }
+            Process& process = this->processes[owners[d]];
+            char buffer[256];
+            ssize_t length = read(process.channel, buffer, sizeof(buffer));
+            vector<int> failed;
+
+            // A closed stream means the worker died, so its shard goes back to the front of the queue
+            if (length <= 0) {
+                failed.push_back(process.shard);
+                stopProcess(&process);
+                if (!startProcess(&process)) {
+                    *error = "could not restart a worker process";
+                }
+            }
+            else {
+                process.received.append(buffer, length);
+                size_t end;
+                while ((end = process.received.find('\n')) != string::npos) {
+                    istringstream reply(process.received.substr(0, end));
+                    process.received.erase(0, end + 1);
+                    string status;
+                    int index;
+                    if (!(reply >> status >> index) || index != process.shard) {
+                        continue;
+                    }
+                    process.shard = -1;
+
+                    // A shard only counts once it has been read back from the disk
+                    const Shard& shard = this->shards[index];
+                    if (status == "DONE" && checkShard(BatchWorker::getShardPath(this->directory, shard.firstSource, shard.numSources),
+                                                       this->numVertices, this->graphChecksum, shard.firstSource, shard.numSources)) {
+                        remaining--;
+                    }
+                    else {
+                        failed.push_back(index);
+                    }
+                }
+            }
+
+            for (unsigned int i = 0; i < failed.size(); i++) {
+                if (this->shards[failed[i]].attempts >= MAX_SHARD_ATTEMPTS) {
+                    ostringstream reason;
+                    reason << "shard " << failed[i] << " failed " << MAX_SHARD_ATTEMPTS << " times";
+                    *error = reason.str();
+                }
+                pending.push_front(failed[i]);
+                this->numRestarts++;
+            }
+        }
+    }
+
+    for (unsigned int i = 0; i < this->processes.size(); i++) {
+        stopProcess(&this->processes[i]);
+    }
+    unique_lock<mutex> lock(this->processesMutex);
+    this->processes.clear();
+    return error->empty();
+}
+
+/// \brief
+/// Merges the shards into one file covering every source, written under a temporary name and renamed.
+/// The shards must have been written by a successful run
+///
+/// \param outputPath const string& - the path of the merged file
+/// \param error string* - set to the reason when the shards could not be merged
+/// \return bool - true if the merged file was written
+///
+bool BatchCoordinator::merge(const string& outputPath, string* error) {
+    error->clear();
+    string temporaryPath = outputPath + ".tmp";
+    FILE* output = fopen(temporaryPath.c_str(), "wb");
+    if (output == NULL) {
+        *error = "could not create " + outputPath;
+        return false;
+    }
+
+    ShardHeader merged;
+    memset(&merged, 0, sizeof(merged));
+    memcpy(merged.magic, BatchWorker::MAGIC, sizeof(BatchWorker::MAGIC));
+    merged.numVertices = this->numVertices;
+    merged.firstSource = 0;
+    merged.numSources = this->numVertices;
+    merged.graphChecksum = this->graphChecksum;
+    bool written = fwrite(&merged, sizeof(merged), 1, output) == 1;
+
+    // Rows are copied across in source order, checking each shard's checksum on the way
+    vector<double> rows((unsigned long) SHARD_READ_ROWS * this->numVertices);
+    for (unsigned int s = 0; s < this->shards.size() && written && error->empty(); s++) {
+        const Shard& shard = this->shards[s];
+        string path = BatchWorker::getShardPath(this->directory, shard.firstSource, shard.numSources);
+        FILE* input = fopen(path.c_str(), "rb");
+        ShardHeader header;
+        if (input == NULL || fread(&header, sizeof(header), 1, input) != 1 || header.graphChecksum != this->graphChecksum
+            || header.firstSource != shard.firstSource || header.numSources != shard.numSources) {
+            *error = "shard " + path + " is missing or belongs to another job";
+        }
+
+        unsigned long long checksum = 0;
+        for (unsigned int done = 0; done < shard.numSources && error->empty() && written; done += SHARD_READ_ROWS) {
+            unsigned int count = shard.numSources - done < SHARD_READ_ROWS ? shard.numSources - done : SHARD_READ_ROWS;
+            unsigned long numValues = (unsigned long) count * this->numVertices;
+            if (fread(&rows[0], sizeof(double), numValues, input) != numValues) {
+                *error = "shard " + path + " is too short";
+                break;
+            }
+            for (unsigned int r = 0; r < count; r++) {
+                const double* row = &rows[(unsigned long) r * this->numVertices];
+                checksum = Snapshot::checksum(row, this->numVertices * sizeof(double), checksum);
+                merged.checksum = Snapshot::checksum(row, this->numVertices * sizeof(double), merged.checksum);
+            }
+            written = fwrite(&rows[0], sizeof(double), numValues, output) == numValues;
+        }
+        if (error->empty() && checksum != header.checksum) {
+            *error = "shard " + path + " is damaged";
+        }
+        if (input != NULL) {
+            fclose(input);
+        }
+    }
+
+    // The merged checksum chains every row in order, exactly as a single shard of every source would
+    written = written && error->empty();
+    written = written && fseek(output, 0, SEEK_SET) == 0 && fwrite(&merged, sizeof(merged), 1, output) == 1;
+    written = fflush(output) == 0 && fsync(fileno(output)) == 0 && written;
+    written = fclose(output) == 0 && written;
+    if (!written || rename(temporaryPath.c_str(), outputPath.c_str()) != 0) {
+        unlink(temporaryPath.c_str());
+        if (error->empty()) {
+            *error = "could not write " + outputPath;
+        }
+        return false;
+    }
+    return true;
+}
+
+/// \brief
+/// Returns the number of shards the sources are split into
+///
+/// \return unsigned int - the number of shards
+///
+unsigned int BatchCoordinator::getNumShards() {
+    return this->shards.size();
+}
+
+/// \brief
+/// Returns the number of shards found already on disk by the last run
+///
+/// \return unsigned int - the number of shards kept
+///
+unsigned int BatchCoordinator::getNumKept() {
+    return this->numKept;
+}
+
+/// \brief
+/// Returns the number of shards given to another worker after their worker died or failed them
+///
+/// \return unsigned int - the number of restarted shards
+///
+unsigned int BatchCoordinator::getNumRestarts() {
+    return this->numRestarts;
+}
+
+/// \brief
+/// Returns the number of worker processes started by the last run
+///
+/// \return unsigned int - the number of processes
+///
+unsigned int BatchCoordinator::getNumProcessesStarted() {
+    return this->numProcessesStarted;
+}
+
+/// \brief
+/// Returns the process ids of the workers running now. It may be called from another thread while run
+/// is going, for example to watch the workers or to signal them
+///
+/// \return vector<pid_t> - the process ids
+///
+vector<pid_t> BatchCoordinator::getWorkerPids() {
+    unique_lock<mutex> lock(this->processesMutex);
+    vector<pid_t> pids;
+    for (unsigned int i = 0; i < this->processes.size(); i++) {
+        if (this->processes[i].pid > 0) {
+            pids.push_back(this->processes[i].pid);
+        }
+    }
+    return pids;
+}
+
+/// \brief
+/// Returns whether a file is a complete shard of a graph for the sources given
+///
+/// \param path const string& - the path of the shard file
+/// \param numVertices unsigned int - the number of vertices within the graph
+/// \param graphChecksum unsigned long long - the checksum of the graph file
+/// \param firstSource unsigned int - the identifier of the first source
+/// \param numSources unsigned int - the number of consecutive sources
+/// \return bool - true if the header matches and the checksum of the rows is correct
+///
+bool BatchCoordinator::checkShard(const string& path, unsigned int numVertices, unsigned long long graphChecksum,
+                                  unsigned int firstSource, unsigned int numSources) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == NULL) {
+        return false;
+    }
+
+    ShardHeader header;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 && memcmp(header.magic, BatchWorker::MAGIC, sizeof(header.magic)) == 0
+        && header.numVertices == numVertices && header.graphChecksum == graphChecksum
+        && header.firstSource == firstSource && header.numSources == numSources;
+
+    vector<double> row(numVertices);
+    unsigned long long checksum = 0;
+    for (unsigned int i = 0; i < numSources && valid; i++) {
+        valid = fread(&row[0], sizeof(double), numVertices, file) == numVertices;
+        checksum = Snapshot::checksum(&row[0], numVertices * sizeof(double), checksum);
+    }
+    valid = valid && checksum == header.checksum && fgetc(file) == EOF;
+    fclose(file);
+    return valid;
+}
+
+/// \brief
+/// Forks a worker process connected to the coordinator by a stream
+///
+/// \param process Process* - filled with the new process
+/// \return bool - false if the process could not be started
+///
+bool BatchCoordinator::startProcess(Process* process) {
+    {
+        unique_lock<mutex> lock(this->processesMutex);
+        process->pid = -1;
+    }
+    process->channel = -1;
+    process->received.clear();
+    process->shard = -1;
+
+    int ends[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, ends) < 0) {
+        return false;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(ends[0]);
+        close(ends[1]);
+        return false;
+    }
+
+    // The child maps the graph itself and leaves through _exit, so none of the parent's objects are destroyed twice
+    if (pid == 0) {
+        close(ends[0]);
+        for (unsigned int i = 0; i < this->processes.size(); i++) {
+            if (this->processes[i].channel >= 0) {
+                close(this->processes[i].channel);
+            }
+        }
+        BatchWorker worker(this->graphPath, this->directory);
+        if (worker.open()) {
+            worker.serve(ends[1]);
+        }
+        _exit(0);
+    }
+
+    close(ends[1]);
+    {
+        unique_lock<mutex> lock(this->processesMutex);
+        process->pid = pid;
+    }
+    process->channel = ends[0];
+    this->numProcessesStarted++;
+    return true;
+}
+
+/// \brief
+/// Gives a worker process the next shard waiting, if any
+///
+/// \param process Process* - the idle process
+/// \param pending deque<unsigned int>* - the shards waiting for a worker
+/// \return bool - false if the request could not be sent
+///
+bool BatchCoordinator::assign(Process* process, deque<unsigned int>* pending) {
+    if (pending->empty()) {
+        return true;
+    }
+    unsigned int index = pending->front();
+    Shard& shard = this->shards[index];
+
+    ostringstream request;
+    request << "SHARD " << index << " " << shard.firstSource << " " << shard.numSources << " " << shard.attempts << "\n";
+    string line = request.str();
+    if (send(process->channel, line.c_str(), line.size(), MSG_NOSIGNAL) != (ssize_t) line.size()) {
+        return false;
+    }
+    pending->pop_front();
+    shard.attempts++;
+    process->shard = index;
+    return true;
+}
+
+/// \brief
+/// Stops a worker process and waits for it to end
+///
+/// \param process Process* - the process
+///
+void BatchCoordinator::stopProcess(Process* process) {
+    if (process->channel >= 0) {
+        send(process->channel, "QUIT\n", 5, MSG_NOSIGNAL);
+        close(process->channel);
+        process->channel = -1;
+    }
+
+    // The id is given up before the process is reaped, so it is never handed out after it could be reused
+    pid_t pid;
+    {
+        unique_lock<mutex> lock(this->processesMutex);
+        pid = process->pid;
+        process->pid = -1;
+    }
+    if (pid > 0) {
+        waitpid(pid, NULL, 0);
+    }
+    process->shard = -1;
+}
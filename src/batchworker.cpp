@@ -0,0 +1,248 @@
+#include <cstring>
+#include <cstdio>
+#include <queue>
+#include <sstream>
+#include <functional>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include "batchworker.h"
+#include "shortestpathtree.h"
+#include "snapshot.h"
+
+/// This class is one worker process of a sharded all pairs job. It maps an external graph file read only,
+/// so every worker on the machine shares the same pages of it, and answers requests from the coordinator
+/// over a stream: each request names a range of sources, whose distances to every vertex are written to
+/// a shard file under a temporary name and renamed into place once complete, so a worker that dies part
+/// way through never leaves a shard that looks finished.
+///
+
+const char BatchWorker::MAGIC[8] = { 'R', 'O', 'A', 'D', 'S', 'H', 'R', 'D' };
+
+/// \brief
+/// Prepares a worker for the graph file and the directory its shards are written to
+///
+/// \param graphPath const string& - the path of the file written by ExternalGraphWriter
+/// \param directory const string& - the directory the shard files are written to
+///
+BatchWorker::BatchWorker(const string& graphPath, const string& directory) {
+    this->graphPath = graphPath;
+    this->directory = directory;
+    this->mapping = NULL;
+    this->mappingLength = 0;
+    this->header = NULL;
+    this->offsets = NULL;
+    this->edges = NULL;
+    this->graphChecksum = 0;
+}
+
+/// \brief
+/// Unmaps the graph file
+///
+BatchWorker::~BatchWorker() {
+    if (this->mapping != NULL) {
+        munmap(this->mapping, this->mappingLength);
+    }
+}
+
+/// \brief
+/// Maps the graph file and works out its checksum
+///
+/// \return bool - false if the file could not be mapped or is not an external graph file
+///
+bool BatchWorker::open() {
+    int descriptor = ::open(this->graphPath.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(descriptor, &status) < 0 || (unsigned long) status.st_size < sizeof(ExternalGraphHeader)) {
+        ::close(descriptor);
+        return false;
+    }
+
+    // A shared read only mapping lets every worker use the same pages of the page cache
+    void* mapping = mmap(NULL, status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    const ExternalGraphHeader* header = (const ExternalGraphHeader*) mapping;
+    unsigned long long edgesStart = sizeof(ExternalGraphHeader) + ((unsigned long long) header->numVertices + 1) * sizeof(unsigned long long);
+    const unsigned long long* offsets = (const unsigned long long*) (header + 1);
+    if (memcmp(header->magic, ExternalGraphWriter::MAGIC, sizeof(header->magic)) != 0 || edgesStart > (unsigned long long) status.st_size
+        || offsets[header->numVertices] != header->numEdges
+        || edgesStart + header->numEdges * sizeof(ExternalEdge) > (unsigned long long) status.st_size) {
+        munmap(mapping, status.st_size);
+        return false;
+    }
+
+    if (this->mapping != NULL) {
+        munmap(this->mapping, this->mappingLength);
+    }
+    this->mapping = mapping;
+    this->mappingLength = status.st_size;
+    this->header = header;
+    this->offsets = offsets;
+    this->edges = (const ExternalEdge*) ((const char*) mapping + edgesStart);
+    this->graphChecksum = Snapshot::checksum(mapping, status.st_size, 0);
+    return true;
+}
+
+/// \brief
+/// Returns the number of vertices within the graph
+///
+/// \return unsigned int - the number of vertices
+///
+unsigned int BatchWorker::getNumVertices() {
+    return this->header != NULL ? this->header->numVertices : 0;
+}
+
+/// \brief
+/// Returns the checksum of the whole graph file, recorded in every shard taken from it
+///
+/// \return unsigned long long - the checksum
+///
+unsigned long long BatchWorker::getGraphChecksum() {
+    return this->graphChecksum;
+}
+
+/// \brief
+/// Finds the distances from a range of sources to every vertex and writes them to their shard file
+///
+/// \param firstSource unsigned int - the identifier of the first source
+/// \param numSources unsigned int - the number of consecutive sources
+/// \return bool - false if the shard could not be written
+///
+bool BatchWorker::writeShard(unsigned int firstSource, unsigned int numSources) {
+    unsigned int numVertices = getNumVertices();
+    if (this->header == NULL || firstSource > numVertices || numSources > numVertices - firstSource) {
+        return false;
+    }
+
+    string path = getShardPath(this->directory, firstSource, numSources);
+    string temporaryPath = path + ".tmp";
+    FILE* file = fopen(temporaryPath.c_str(), "wb");
+    if (file == NULL) {
+        return false;
+    }
+
+    // The header is written again at the end, once the checksum of the rows is known
+    ShardHeader shard;
+    memset(&shard, 0, sizeof(shard));
+    memcpy(shard.magic, MAGIC, sizeof(MAGIC));
+    shard.numVertices = numVertices;
+    shard.firstSource = firstSource;
+    shard.numSources = numSources;
+    shard.graphChecksum = this->graphChecksum;
+    bool written = fwrite(&shard, sizeof(shard), 1, file) == 1;
+
+    vector<double> distances;
+    for (unsigned int i = 0; i < numSources && written; i++) {
+        search(firstSource + i, &distances);
+        shard.checksum = Snapshot::checksum(&distances[0], numVertices * sizeof(double), shard.checksum);
+        written = fwrite(&distances[0], sizeof(double), numVertices, file) == numVertices;
+    }
+
+    // Make sure the rows reach the disk before the shard appears under its real name
+    written = written && fseek(file, 0, SEEK_SET) == 0 && fwrite(&shard, sizeof(shard), 1, file) == 1;
+    written = fflush(file) == 0 && fsync(fileno(file)) == 0 && written;
+    written = fclose(file) == 0 && written;
+    if (!written || rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        unlink(temporaryPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+/// \brief
+/// Answers requests from the coordinator until it asks the worker to stop or closes the stream.
+/// Requests are lines of "SHARD index first count attempt" or "QUIT"; each shard is answered with
+/// "DONE index" or "FAILED index"
+///
+/// \param channel int - the descriptor of the stream to the coordinator
+///
+void BatchWorker::serve(int channel) {
+    string received;
+    char buffer[256];
+    while (true) {
+        size_t end = received.find('\n');
+        if (end == string::npos) {
+            ssize_t length = read(channel, buffer, sizeof(buffer));
+            if (length <= 0) {
+                return;
+            }
+            received.append(buffer, length);
+            continue;
+        }
+
+        istringstream request(received.substr(0, end));
+        received.erase(0, end + 1);
+        string command;
+        unsigned int index, firstSource, numSources, attempt;
+        request >> command;
+        if (command == "QUIT") {
+            return;
+        }
+        if (command != "SHARD" || !(request >> index >> firstSource >> numSources >> attempt)) {
+            continue;
+        }
+
+        ostringstream reply;
+        reply << (writeShard(firstSource, numSources) ? "DONE " : "FAILED ") << index << "\n";
+        string line = reply.str();
+        if (send(channel, line.c_str(), line.size(), MSG_NOSIGNAL) != (ssize_t) line.size()) {
+            return;
+        }
+    }
+}
+
+/// \brief
+/// Returns the path of the shard file for a range of sources
+///
+/// \param directory const string& - the directory the shard files are written to
+/// \param firstSource unsigned int - the identifier of the first source
+/// \param numSources unsigned int - the number of consecutive sources
+/// \return string - the path of the shard file
+///
+string BatchWorker::getShardPath(const string& directory, unsigned int firstSource, unsigned int numSources) {
+    char name[64];
+    snprintf(name, sizeof(name), "/shard-%010u-%010u.bin", firstSource, numSources);
+    return directory + name;
+}
+
+/// \brief
+/// Finds the shortest distance from a source to every vertex of the mapped graph
+///
+/// \param sourceId unsigned int - the identifier of the source
+/// \param distances vector<double>* - filled with the distance to each vertex, or
+/// ShortestPathTree::UNREACHABLE if there is no path
+///
+void BatchWorker::search(unsigned int sourceId, vector<double>* distances) {
+    distances->assign(this->header->numVertices, ShortestPathTree::UNREACHABLE);
+    priority_queue< pair<double, unsigned int>, vector< pair<double, unsigned int> >,
+                    greater< pair<double, unsigned int> > > unvisitedVerticesQueue;
+    (*distances)[sourceId] = 0;
+    unvisitedVerticesQueue.push(make_pair(0.0, sourceId));
+
+    while (!unvisitedVerticesQueue.empty()) {
+        double distance = unvisitedVerticesQueue.top().first;
+        unsigned int uId = unvisitedVerticesQueue.top().second;
+        unvisitedVerticesQueue.pop();
+        if (distance > (*distances)[uId]) {
+            continue;
+        }
+
+        for (unsigned long long i = this->offsets[uId]; i < this->offsets[uId + 1]; i++) {
+            const ExternalEdge& edge = this->edges[i];
+            if (distance + edge.weight < (*distances)[edge.target]) {
+                (*distances)[edge.target] = distance + edge.weight;
+                unvisitedVerticesQueue.push(make_pair(distance + edge.weight, edge.target));
+            }
+        }
+    }
+}
@@ -0,0 +1,1964 @@
+#include <cstdlib>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <set>
+#include <unistd.h>
+#include <signal.h>
+#include <thread>
+#include "benchmark.h"
+#include "distancetable.h"
+#include "nearestsearch.h"
+#include "dynamicshortestpathtree.h"
+#include "hublabels.h"
+#include "searchspace.h"
+#include "multilevelpartition.h"
+#include "customizablerouteplanner.h"
+#include "multisourcebfs.h"
+#include "asyncqueryengine.h"
+#include "snapshot.h"
+#include "externalgraph.h"
+#include "compactgraph.h"
+#include "compressedgraph.h"
+#include "vertexorder.h"
+#include "cachemisscounter.h"
+#include "pointset.h"
+#include "graphbuilder.h"
+#include "componentindex.h"
+#include "disjointset.h"
+#include "geometricspanner.h"
+#include "distanceoracle.h"
+#include "queryplanner.h"
+#include "versionedgraph.h"
+#include "batchcoordinator.h"
+#include "dialqueue.h"
+#include "radixheap.h"
+#include "kshortestpaths.h"
+#include "dynamicspanningforest.h"
+
+/// This class generates a road like graph, where every city is joined to its nearest neighbours, and
+/// reports how long the query engines take on it compared to plain searches
+///
+
+const unsigned int BENCHMARK_SEED = 12345;
+const unsigned int NEAREST_NEIGHBOURS = 4;
+const int MAXIMUM_COORDINATE = 10000;
+const unsigned int TABLE_SOURCES = 50;
+const unsigned int TABLE_TARGETS = 200;
+const unsigned int NEARBY_QUERIES = 200;
+const double NEARBY_RADIUS = 500.0;
+const unsigned int NEAREST_COUNT = 5;
+const unsigned int WEIGHT_UPDATES = 500;
+const unsigned int LABEL_QUERIES = 1000000;
+const unsigned int LABEL_CHECK_SOURCES = 20;
+const unsigned int PARTITION_LEVELS = 3;
+const unsigned int PARTITION_BASE_CELL_SIZE = 32;
+const unsigned int PARTITION_FANOUT = 4;
+const unsigned int POINT_TO_POINT_QUERIES = 1000;
+const unsigned int BFS_SOURCES = 512;
+const unsigned int ASYNC_MAX_QUEUED = 64;
+const double ASYNC_SHORT_TIMEOUT = 0.0001;
+const unsigned int SNAPSHOT_CHECK_PAIRS = 100000;
+const unsigned int EXTERNAL_MEMORY_FRACTION = 4;
+const unsigned int COMPACT_SOURCES = 20;
+const double COMPRESSED_QUANTUM = 1.0;
+const unsigned long BULK_EDGES = 10000000;
+const unsigned int BUILDER_VERTICES = 2000000;
+const unsigned int BUILDER_EDGES = 20000000;
+const unsigned int BUILDER_CHECKS = 5;
+const unsigned int COMPONENT_STRIPS = 8;
+const unsigned int SPANNER_CITIES = 2000;
+const unsigned int SPANNER_SOURCES = 10;
+const double SPANNER_STRETCHES[] = { 1.1, 1.5, 2.0 };
+const unsigned int ORACLE_LEVELS[] = { 2, 3, 4 };
+const unsigned int PLANNER_ORACLE_LEVELS = 3;
+const unsigned int VERSION_UPDATE_BATCH = 4;
+const unsigned int VERSION_UPDATE_PAUSE_MICROSECONDS = 100;
+const unsigned int BATCH_PROCESSES = 4;
+const unsigned int BATCH_SHARD_SOURCES = 64;
+const unsigned int BATCH_CRASH_SHARD = 1;
+const unsigned int BATCH_CRASH_POLL_MICROSECONDS = 100;
+const double QUEUE_QUANTA[] = { 1.0, 0.001 };
+const unsigned long QUEUE_OPERATIONS = 10000000;
+const unsigned int QUEUE_LIVE_ENTRIES = 100000;
+const unsigned int QUEUE_MAXIMUM_STEP = 1000;
+const unsigned int ALTERNATIVE_QUERIES = 100;
+const unsigned int ALTERNATIVE_ROUTES = 10;
+const unsigned int FOREST_EDITS = 20000;
+const unsigned int FOREST_CHECKS = 10;
+
+/// \brief
+/// Generates the graph the benchmarks are run on
+///
+/// \param numCities unsigned int - the number of cities in the generated graph
+/// \param numWorkers unsigned int - the number of worker threads, or zero for one per hardware thread
+///
+Benchmark::Benchmark(unsigned int numCities, unsigned int numWorkers) {
+    this->numCities = numCities;
+    this->graph = generateRoadGraph(numCities, BENCHMARK_SEED, &this->cities);
+    this->pool = new WorkerPool(numWorkers);
+}
+
+/// \brief
+/// Deletes the generated graph, its cities and the worker pool
+///
+Benchmark::~Benchmark() {
+    for (unsigned int i = 0; i < this->cities.size(); i++) {
+        delete this->cities[i];
+    }
+    delete this->graph;
+    delete this->pool;
+}
+
+/// \brief
+/// Runs every benchmark and writes a report of the timings
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::run(ostream& out) {
+    out << "Benchmarks on " << this->numCities << " cities joined to their " << NEAREST_NEIGHBOURS
+        << " nearest neighbours using " << this->pool->getNumWorkers() << " workers" << endl;
+    out << "==================================================================" << endl;
+    out << fixed << setprecision(4);
+
+    benchmarkDistanceTable(out);
+    benchmarkNearestSearch(out);
+    benchmarkDynamicShortestPathTree(out);
+    benchmarkHubLabels(out);
+    benchmarkCustomizableRoutePlanner(out);
+    benchmarkMultiSourceBfs(out);
+    benchmarkAsyncQueryEngine(out);
+    benchmarkSnapshot(out);
+    benchmarkExternalGraph(out);
+    benchmarkCompactGraph(out);
+    benchmarkCompressedGraph(out);
+    benchmarkVertexOrder(out);
+    benchmarkPointSet(out);
+    benchmarkGraphBuilder(out);
+    benchmarkComponentIndex(out);
+    benchmarkGeometricSpanner(out);
+    benchmarkDistanceOracle(out);
+    benchmarkQueryPlanner(out);
+    benchmarkVersionedGraph(out);
+    benchmarkBatchCoordinator(out);
+    benchmarkIntegerQueues(out);
+    benchmarkKShortestPaths(out);
+    benchmarkDynamicSpanningForest(out);
+}
+
+/// \brief
+/// Generates a graph of cities placed at random on the Cartesian plane, each joined to its nearest
+/// neighbours by an edge weighted with the distance between them
+///
+/// \param numCities unsigned int - the number of cities in the graph
+/// \param seed unsigned int - the seed for the random placement, so the same graph can be generated again
+/// \param cities vector<Point*>* - filled with the co-ordinates of each city
+/// \return Graph* - the generated graph
+///
+Graph* Benchmark::generateRoadGraph(unsigned int numCities, unsigned int seed, vector<Point*>* cities) {
+    srand(seed);
+
+    Graph* graph = new Graph(numCities);
+    for (unsigned int i = 0; i < numCities; i++) {
+        cities->push_back(new Point(rand() % MAXIMUM_COORDINATE, rand() % MAXIMUM_COORDINATE));
+        graph->addVertex(new Vertex(i));
+    }
+
+    // Join every city to its nearest neighbours, working out each city's row of distances in one pass
+    PointSet points(cities);
+    vector<double> row(numCities);
+    vector< pair<double, unsigned int> > byDistance;
+    for (unsigned int i = 0; i < numCities; i++) {
+        points.distancesFrom(i, 0, numCities, &row[0]);
+        byDistance.clear();
+        for (unsigned int j = 0; j < numCities; j++) {
+            if (j != i) {
+                byDistance.push_back(make_pair(row[j], j));
+            }
+        }
+
+        unsigned int numNearest = NEAREST_NEIGHBOURS < byDistance.size() ? NEAREST_NEIGHBOURS : byDistance.size();
+        partial_sort(byDistance.begin(), byDistance.begin() + numNearest, byDistance.end());
+        for (unsigned int k = 0; k < numNearest; k++) {
+            unsigned int j = byDistance[k].second;
+            if (!graph->hasEdge(i, j)) {
+                graph->addEdge(new Edge(graph->getVertex(i), graph->getVertex(j), byDistance[k].first));
+            }
+        }
+    }
+    return graph;
+}
+
+/// \brief
+/// Compares the many to many distance table against one full search per source
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkDistanceTable(ostream& out) {
+    vector<unsigned int> sources;
+    vector<unsigned int> targets;
+    unsigned int numSources = TABLE_SOURCES < this->numCities ? TABLE_SOURCES : this->numCities;
+    unsigned int numTargets = TABLE_TARGETS < this->numCities ? TABLE_TARGETS : this->numCities;
+
+    // Depots and customers of one region, spread through the cities nearest the first city
+    vector< pair<double, unsigned int> > byDistance;
+    for (unsigned int i = 0; i < this->numCities; i++) {
+        byDistance.push_back(make_pair(this->cities[0]->distanceTo(this->cities[i]), i));
+    }
+    sort(byDistance.begin(), byDistance.end());
+
+    unsigned int regionSize = this->numCities / 4 > numSources + numTargets ? this->numCities / 4 : this->numCities;
+    for (unsigned int i = 0; i < numSources; i++) {
+        sources.push_back(byDistance[(unsigned long) i * regionSize / numSources].second);
+    }
+    for (unsigned int i = 0; i < numTargets; i++) {
+        targets.push_back(byDistance[(unsigned long) i * regionSize / numTargets].second);
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    DistanceTable table(this->graph, this->pool);
+    table.compute(&sources, &targets);
+    double tableSeconds = secondsSince(start);
+
+    // The same table from hub labels, timed without the build
+    HubLabels labels;
+    labels.build(this->graph, this->pool);
+    DistanceTable labelTable(this->graph, this->pool);
+    labelTable.setHubLabels(&labels);
+    start = chrono::steady_clock::now();
+    labelTable.compute(&sources, &targets);
+    double labelSeconds = secondsSince(start);
+
+    // One full search per source, as running dijkstra for each depot would do
+    start = chrono::steady_clock::now();
+    ShortestPathTree tree;
+    unsigned int mismatches = 0;
+    unsigned int labelMismatches = 0;
+    for (unsigned int row = 0; row < numSources; row++) {
+        this->graph->shortestPathTree(sources[row], &tree);
+        for (unsigned int column = 0; column < numTargets; column++) {
+            if ((float) tree.getDistance(targets[column]) != table.getDistance(row, column)) {
+                mismatches++;
+            }
+            if ((float) tree.getDistance(targets[column]) != labelTable.getDistance(row, column)) {
+                labelMismatches++;
+            }
+        }
+    }
+    double treeSeconds = secondsSince(start);
+
+    out << "Distance table " << numSources << " x " << numTargets << ": batched sweeps " << tableSeconds << " s, "
+        << table.getNumSettled() << " vertex scans; independent searches " << treeSeconds << " s ("
+        << setprecision(1) << treeSeconds / tableSeconds << "x), " << mismatches << " mismatches" << setprecision(4)
+        << "; from hub labels " << labelSeconds << " s (" << setprecision(1) << treeSeconds / labelSeconds << "x), "
+        << setprecision(4) << labelTable.getNumSettled() << " bucket entries read, labels built in " << labels.getBuildSeconds()
+        << " s, " << labelMismatches << " mismatches" << endl;
+}
+
+/// \brief
+/// Compares radius and nearest target searches that stop early against full searches from the same sources
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkNearestSearch(ostream& out) {
+    NearestSearch search(this->graph);
+    vector< pair<double, unsigned int> > results;
+    vector<unsigned int> depots;
+    unsigned long radiusSettled = 0;
+    unsigned long nearestSettled = 0;
+
+    // Every hundredth city is a depot
+    for (unsigned int i = 0; i < this->numCities; i += 100) {
+        depots.push_back(i);
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < NEARBY_QUERIES; i++) {
+        search.withinRadius((unsigned long) i * this->numCities / NEARBY_QUERIES, NEARBY_RADIUS, &results);
+        radiusSettled += search.getNumSettled();
+    }
+    double radiusSeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < NEARBY_QUERIES; i++) {
+        search.nearestTargets((unsigned long) i * this->numCities / NEARBY_QUERIES, NEAREST_COUNT, &depots, &results);
+        nearestSettled += search.getNumSettled();
+    }
+    double nearestSeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    ShortestPathTree tree;
+    for (unsigned int i = 0; i < NEARBY_QUERIES; i++) {
+        this->graph->shortestPathTree((unsigned long) i * this->numCities / NEARBY_QUERIES, &tree);
+    }
+    double treeSeconds = secondsSince(start);
+
+    out << "Radius " << (int) NEARBY_RADIUS << " x " << NEARBY_QUERIES << ": " << radiusSeconds << " s, "
+        << radiusSettled / NEARBY_QUERIES << " settled per query; nearest " << NEAREST_COUNT << " of " << depots.size()
+        << " depots: " << nearestSeconds << " s, " << nearestSettled / NEARBY_QUERIES << " settled per query; full searches "
+        << treeSeconds << " s" << endl;
+}
+
+/// \brief
+/// Compares repairing a shortest path tree after traffic changes edge weights against searching again,
+/// putting every weight back afterwards
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkDynamicShortestPathTree(ostream& out) {
+    DynamicShortestPathTree dynamicTree(this->graph, 0);
+    ShortestPathTree tree;
+    vector<unsigned int> changedSources;
+    vector<unsigned int> changedDestinations;
+    vector<double> originalWeights;
+    unsigned long touched = 0;
+    double recomputeSeconds = 0;
+    unsigned int mismatches = 0;
+
+    srand(BENCHMARK_SEED);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < WEIGHT_UPDATES; i++) {
+        unsigned int uId = rand() % this->numCities;
+        vector<unsigned int>* adjacent = this->graph->getNeighbours(uId);
+        if (adjacent->size() == 0) {
+            continue;
+        }
+        unsigned int vId = (*adjacent)[rand() % adjacent->size()];
+        double weight = this->graph->getWeight(uId, vId);
+
+        changedSources.push_back(uId);
+        changedDestinations.push_back(vId);
+        originalWeights.push_back(weight);
+
+        // Congestion doubles or halves the weight, or closes the road altogether
+        if (i % 3 == 0) {
+            this->graph->removeEdge(uId, vId);
+        }
+        else {
+            double factor = i % 3 == 1 ? 2.0 : 0.5;
+            this->graph->addEdge(new Edge(this->graph->getVertex(uId), this->graph->getVertex(vId), weight * factor));
+        }
+        touched += dynamicTree.getNumTouched();
+
+        // Time the full search the repair replaces
+        chrono::steady_clock::time_point recomputeStart = chrono::steady_clock::now();
+        this->graph->shortestPathTree(0, &tree);
+        recomputeSeconds += secondsSince(recomputeStart);
+    }
+    double repairSeconds = secondsSince(start) - recomputeSeconds;
+
+    for (unsigned int i = 0; i < this->numCities; i++) {
+        if (tree.getDistance(i) != dynamicTree.getTree()->getDistance(i)) {
+            mismatches++;
+        }
+    }
+
+    // Put the graph back the way it was, newest change first
+    for (unsigned int i = changedSources.size(); i > 0; i--) {
+        this->graph->addEdge(new Edge(this->graph->getVertex(changedSources[i - 1]),
+                                      this->graph->getVertex(changedDestinations[i - 1]), originalWeights[i - 1]));
+    }
+
+    out << "Dynamic tree " << changedSources.size() << " weight changes: repaired in " << repairSeconds << " s, "
+        << touched / (changedSources.size() > 0 ? changedSources.size() : 1) << " vertices touched per change; full searches "
+        << recomputeSeconds << " s, " << mismatches << " mismatches" << endl;
+}
+
+/// \brief
+/// Reports the build time, label sizes and query latency of the hub labels, checking them against searches
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkHubLabels(ostream& out) {
+    HubLabels labels;
+    labels.build(this->graph, this->pool);
+
+    // Random pairs are drawn up front so only the lookups are timed
+    vector<unsigned int> pairs(2 * LABEL_QUERIES);
+    srand(BENCHMARK_SEED);
+    for (unsigned int i = 0; i < pairs.size(); i++) {
+        pairs[i] = rand() % this->numCities;
+    }
+
+    unsigned int reachable = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < LABEL_QUERIES; i++) {
+        if (labels.distance(pairs[2 * i], pairs[2 * i + 1]) != ShortestPathTree::UNREACHABLE) {
+            reachable++;
+        }
+    }
+    double querySeconds = secondsSince(start);
+
+    ShortestPathTree tree;
+    unsigned int mismatches = 0;
+    for (unsigned int sample = 0; sample < LABEL_CHECK_SOURCES; sample++) {
+        unsigned int sourceId = (unsigned long) sample * this->numCities / LABEL_CHECK_SOURCES;
+        this->graph->shortestPathTree(sourceId, &tree);
+        for (unsigned int i = 0; i < this->numCities; i++) {
+            double difference = labels.distance(sourceId, i) - tree.getDistance(i);
+            if (tree.isReachable(i) ? (difference > 1e-6 || difference < -1e-6) : labels.distance(sourceId, i) != tree.getDistance(i)) {
+                mismatches++;
+            }
+        }
+    }
+
+    out << "Hub labels: built in " << labels.getBuildSeconds() << " s, " << setprecision(1) << labels.getAverageLabelSize()
+        << " hubs per vertex on average, " << labels.getMaximumLabelSize() << " at most, "
+        << labels.memoryUsage() / 1024 << " KB; query " << setprecision(3) << querySeconds * 1e9 / LABEL_QUERIES
+        << " ns on average (" << setprecision(1) << 100.0 * reachable / LABEL_QUERIES << "% reachable), "
+        << mismatches << " mismatches" << setprecision(4) << endl;
+}
+
+/// \brief
+/// Reports the partition and customisation times of the customisable route planner and compares its
+/// queries against point to point searches that stop at the destination
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkCustomizableRoutePlanner(ostream& out) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    MultilevelPartition partition;
+    partition.build(this->graph, PARTITION_LEVELS, PARTITION_BASE_CELL_SIZE, PARTITION_FANOUT);
+    CustomizableRoutePlanner planner(this->graph, &partition);
+    double partitionSeconds = secondsSince(start);
+
+    planner.customise(this->pool);
+
+    vector<unsigned int> pairs(2 * POINT_TO_POINT_QUERIES);
+    srand(BENCHMARK_SEED);
+    for (unsigned int i = 0; i < pairs.size(); i++) {
+        pairs[i] = rand() % this->numCities;
+    }
+
+    vector<double> plannerDistances(POINT_TO_POINT_QUERIES);
+    unsigned long plannerSettled = 0;
+    start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < POINT_TO_POINT_QUERIES; i++) {
+        plannerDistances[i] = planner.distance(pairs[2 * i], pairs[2 * i + 1]);
+        plannerSettled += planner.getNumSettled();
+    }
+    double plannerSeconds = secondsSince(start);
+
+    // Plain Dijkstra stopping as soon as the destination is settled
+    SearchSpace space(this->numCities);
+    unsigned long searchSettled = 0;
+    unsigned int mismatches = 0;
+    start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < POINT_TO_POINT_QUERIES; i++) {
+        unsigned int uId;
+        space.start(pairs[2 * i]);
+        while (space.settleNext(this->graph, &uId)) {
+            searchSettled++;
+            if (uId == pairs[2 * i + 1]) {
+                break;
+            }
+        }
+        double difference = space.getDistance(pairs[2 * i + 1]) - plannerDistances[i];
+        if (plannerDistances[i] == ShortestPathTree::UNREACHABLE ? space.isSettled(pairs[2 * i + 1]) : (difference > 1e-6 || difference < -1e-6)) {
+            mismatches++;
+        }
+    }
+    double searchSeconds = secondsSince(start);
+
+    out << "Customisable route planner: " << partition.getNumCells(0);
+    for (unsigned int level = 1; level < partition.getNumLevels(); level++) {
+        out << "/" << partition.getNumCells(level);
+    }
+    out << " cells, " << planner.getNumBoundaryVertices(0) << " boundary vertices at level 0, partitioned in "
+        << partitionSeconds << " s, customised in " << planner.getCustomisationSeconds() << " s; "
+        << POINT_TO_POINT_QUERIES << " queries " << plannerSeconds << " s (" << plannerSettled / POINT_TO_POINT_QUERIES
+        << " settled each), point to point searches " << searchSeconds << " s (" << searchSettled / POINT_TO_POINT_QUERIES
+        << " settled each), " << mismatches << " mismatches" << endl;
+}
+
+/// \brief
+/// Compares breadth first searches from many sources at once, at each batch width, against one search per source
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkMultiSourceBfs(ostream& out) {
+    MultiSourceBfs bfs(this->graph, false);
+    unsigned int numSources = BFS_SOURCES < this->numCities ? BFS_SOURCES : this->numCities;
+
+    // Depots packed into the cities nearest the first city, so their searches overlap from the start
+    vector< pair<double, unsigned int> > byDistance;
+    for (unsigned int i = 0; i < this->numCities; i++) {
+        byDistance.push_back(make_pair(this->cities[0]->distanceTo(this->cities[i]), i));
+    }
+    partial_sort(byDistance.begin(), byDistance.begin() + numSources, byDistance.end());
+
+    vector<unsigned int> sources(numSources);
+    for (unsigned int i = 0; i < numSources; i++) {
+        sources[i] = byDistance[i].second;
+    }
+
+    vector<unsigned short> singleHops((size_t) numSources * this->numCities);
+    bool searched = true;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < numSources; i++) {
+        searched = bfs.runSingle(sources[i], &singleHops[(size_t) i * this->numCities]) && searched;
+    }
+    double singleSeconds = secondsSince(start);
+
+    out << "Multi source BFS: " << numSources << " sources, one at a time " << setprecision(0)
+        << numSources / singleSeconds << " sources/s";
+
+    const unsigned int widths[] = { 64, 256, 512 };
+    vector<unsigned short> hops(singleHops.size());
+    for (unsigned int w = 0; w < 3; w++) {
+        start = chrono::steady_clock::now();
+        bool batchSearched = bfs.run(&sources, widths[w], &hops);
+        double batchSeconds = secondsSince(start);
+
+        // A search that passed the hop limit has no hops worth comparing, so every one counts as wrong
+        unsigned long mismatches = 0;
+        for (unsigned long i = 0; i < hops.size(); i++) {
+            if (!searched || !batchSearched || hops[i] != singleHops[i]) {
+                mismatches++;
+            }
+        }
+        out << ", " << widths[w] << " at once " << numSources / batchSeconds << " sources/s ("
+            << mismatches << " mismatches)";
+    }
+    out << setprecision(4) << endl;
+}
+
+/// \brief
+/// Reports the throughput of the asynchronous query engine when callers wait for room in its queue,
+/// and how quickly queries stop once their deadline passes or they are cancelled
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkAsyncQueryEngine(ostream& out) {
+    AsyncQueryEngine engine(this->graph, this->pool->getNumWorkers(), ASYNC_MAX_QUEUED);
+    atomic<unsigned int> numCallbacks(0);
+    function<void(const AsyncQueryResult&)> callback = [&numCallbacks](const AsyncQueryResult&) { numCallbacks++; };
+
+    vector<unsigned int> pairs(2 * POINT_TO_POINT_QUERIES);
+    srand(BENCHMARK_SEED);
+    for (unsigned int i = 0; i < pairs.size(); i++) {
+        pairs[i] = rand() % this->numCities;
+    }
+
+    // Without deadlines, waiting on the oldest query whenever the queue pushes back
+    vector< shared_ptr<AsyncQuery> > queries(POINT_TO_POINT_QUERIES);
+    unsigned int numRejected = 0;
+    unsigned int oldest = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < POINT_TO_POINT_QUERIES; i++) {
+        while (true) {
+            queries[i] = shared_ptr<AsyncQuery>(new AsyncQuery(ASYNC_DISTANCE, pairs[2 * i], pairs[2 * i + 1], 0, 0, callback));
+            if (engine.submit(queries[i])) {
+                break;
+            }
+            numRejected++;
+            queries[oldest++]->getFuture().wait();
+        }
+    }
+
+    for (unsigned int i = oldest; i < POINT_TO_POINT_QUERIES; i++) {
+        queries[i]->getFuture().wait();
+    }
+    double waitingSeconds = secondsSince(start);
+
+    SearchSpace space(this->numCities);
+    unsigned int mismatches = 0;
+    for (unsigned int i = 0; i < POINT_TO_POINT_QUERIES; i++) {
+        AsyncQueryResult result = queries[i]->getFuture().get();
+        unsigned int uId;
+        space.start(pairs[2 * i]);
+        while (space.settleNext(this->graph, &uId) && uId != pairs[2 * i + 1]) {}
+
+        if (result.status == ASYNC_OK ? space.getDistance(pairs[2 * i + 1]) != result.distance : space.isSettled(pairs[2 * i + 1])) {
+            mismatches++;
+        }
+    }
+
+    // With deadlines too short for most searches, every query must still end promptly
+    start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < ASYNC_MAX_QUEUED; i++) {
+        queries[i] = shared_ptr<AsyncQuery>(new AsyncQuery(ASYNC_PATH, pairs[2 * i], pairs[2 * i + 1], i % 4, ASYNC_SHORT_TIMEOUT, callback));
+        engine.submit(queries[i]);
+    }
+    unsigned int numTimedOut = 0;
+    for (unsigned int i = 0; i < ASYNC_MAX_QUEUED; i++) {
+        if (queries[i]->getFuture().get().status == ASYNC_TIMED_OUT) {
+            numTimedOut++;
+        }
+    }
+    double deadlineSeconds = secondsSince(start);
+
+    // Cancelled straight after submission
+    for (unsigned int i = 0; i < ASYNC_MAX_QUEUED; i++) {
+        queries[i] = shared_ptr<AsyncQuery>(new AsyncQuery(ASYNC_DISTANCE, pairs[2 * i], pairs[2 * i + 1], 0, 0, callback));
+        engine.submit(queries[i]);
+        queries[i]->cancel();
+    }
+    unsigned int numCancelled = 0;
+    for (unsigned int i = 0; i < ASYNC_MAX_QUEUED; i++) {
+        if (queries[i]->getFuture().get().status == ASYNC_CANCELLED) {
+            numCancelled++;
+        }
+    }
+
+    out << "Async queries: " << POINT_TO_POINT_QUERIES << " queries " << waitingSeconds << " s with " << numRejected
+        << " pushed back, " << mismatches << " mismatches; " << numTimedOut << " of " << ASYNC_MAX_QUEUED << " timed out after "
+        << ASYNC_SHORT_TIMEOUT * 1e3 << " ms, all ended in " << deadlineSeconds * 1e3 << " ms; " << numCancelled << " of "
+        << ASYNC_MAX_QUEUED << " cancelled; " << numCallbacks << " callbacks" << endl;
+}
+
+/// \brief
+/// Compares building the minimum spanning tree and hub labels against taking them from a snapshot, and
+/// checks that a snapshot is refused for a graph with a different fingerprint
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkSnapshot(ostream& out) {
+    ostringstream path;
+    path << "/tmp/roads-benchmark-" << getpid() << ".snapshot";
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    this->graph->minimumSpanningTreeCost();
+    HubLabels built;
+    built.build(this->graph, this->pool);
+    double buildSeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    vector<SnapshotSectionType> types;
+    vector< pair<const void*, unsigned long> > contents;
+    this->graph->saveMinimumSpanningTree(&types, &contents);
+    built.save(&types, &contents);
+    bool written = Snapshot::write(path.str(), this->graph->fingerprint(), types, contents);
+    double writeSeconds = secondsSince(start);
+
+    // What a restart does: fingerprint the graph, map and check the snapshot, then use it in place
+    start = chrono::steady_clock::now();
+    Snapshot snapshot;
+    HubLabels loaded;
+    string error;
+    bool opened = written && snapshot.open(path.str(), this->graph->fingerprint(), &error)
+        && this->graph->loadMinimumSpanningTree(&snapshot) && loaded.load(&snapshot, this->numCities);
+    double loadSeconds = secondsSince(start);
+
+    unsigned int mismatches = 0;
+    srand(BENCHMARK_SEED);
+    for (unsigned int i = 0; opened && i < SNAPSHOT_CHECK_PAIRS; i++) {
+        unsigned int sourceId = rand() % this->numCities;
+        unsigned int destinationId = rand() % this->numCities;
+        if (loaded.distance(sourceId, destinationId) != built.distance(sourceId, destinationId)) {
+            mismatches++;
+        }
+    }
+
+    Snapshot stale;
+    string staleError;
+    bool staleRefused = !stale.open(path.str(), this->graph->fingerprint() + 1, &staleError);
+    unlink(path.str().c_str());
+
+    if (!opened) {
+        out << "Snapshot: could not be used (" << (written ? error : "not written") << ")" << endl;
+        return;
+    }
+    out << "Snapshot: built in " << buildSeconds << " s, written in " << writeSeconds << " s, "
+        << loaded.memoryUsage() / 1024 << " KB of labels mapped and checked in " << loadSeconds << " s; "
+        << mismatches << " mismatches; snapshot of another graph " << (staleRefused ? "refused" : "accepted") << endl;
+}
+
+/// \brief
+/// Writes the graph to an external graph file and searches it with memory capped at a fraction of the
+/// size of its edges, checking the distances and hops found against searches of the graph in memory
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkExternalGraph(ostream& out) {
+    ostringstream path;
+    path << "/tmp/roads-benchmark-" << getpid() << ".edges";
+
+    unsigned long numEdges = 0;
+    for (unsigned int uId = 0; uId < this->numCities; uId++) {
+        numEdges += this->graph->getNeighbours(uId)->size();
+    }
+    unsigned long memoryBytes = numEdges * sizeof(ExternalEdge) / EXTERNAL_MEMORY_FRACTION;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    ExternalGraphWriter writer(path.str(), this->numCities, memoryBytes);
+    bool written = true;
+    for (unsigned int uId = 0; uId < this->numCities && written; uId++) {
+        vector<unsigned int>* neighbours = this->graph->getNeighbours(uId);
+        for (unsigned int i = 0; i < neighbours->size() && written; i++) {
+            if ((*neighbours)[i] > uId) {
+                written = writer.addEdge(uId, (*neighbours)[i], this->graph->getWeight(uId, (*neighbours)[i]));
+            }
+        }
+    }
+    written = written && writer.finish();
+    double writeSeconds = secondsSince(start);
+
+    ExternalGraph external;
+    if (!written || !external.open(path.str(), memoryBytes)) {
+        unlink(path.str().c_str());
+        out << "External graph: could not be written" << endl;
+        return;
+    }
+
+    start = chrono::steady_clock::now();
+    vector<double> distances;
+    bool searched = external.shortestDistances(0, &distances);
+    double distanceSeconds = secondsSince(start);
+    unsigned long long distanceBytes = external.getBytesRead();
+    unsigned long distanceReads = external.getNumReads();
+
+    start = chrono::steady_clock::now();
+    vector<unsigned int> hops;
+    searched = external.hopDistances(0, &hops) && searched;
+    double hopSeconds = secondsSince(start);
+    unlink(path.str().c_str());
+
+    ShortestPathTree tree;
+    this->graph->shortestPathTree(0, &tree);
+    MultiSourceBfs bfs(this->graph, false);
+    vector<unsigned short> inMemoryHops(this->numCities);
+    searched = bfs.runSingle(0, &inMemoryHops[0]) && searched;
+
+    unsigned int mismatches = 0;
+    for (unsigned int i = 0; searched && i < this->numCities; i++) {
+        bool hopsMatch = inMemoryHops[i] == MultiSourceBfs::UNREACHED ? hops[i] == ExternalGraph::UNREACHED : hops[i] == inMemoryHops[i];
+        if (fabs(distances[i] - tree.getDistance(i)) > 1e-9 || !hopsMatch) {
+            mismatches++;
+        }
+    }
+
+    out << "External graph: " << numEdges * sizeof(ExternalEdge) / 1024 << " KB of edges in " << writer.getNumRuns()
+        << " runs written in " << writeSeconds << " s, " << memoryBytes / 1024 << " KB memory cap; shortest distances "
+        << distanceSeconds << " s (" << distanceBytes / 1024 << " KB in " << distanceReads << " reads), hops " << hopSeconds
+        << " s, " << external.getNumSpilled() << " frontier entries spilled; " << (searched ? "" : "search failed, ")
+        << mismatches << " mismatches" << endl;
+}
+
+/// \brief
+/// Compares searches of compact graphs stored with different weight and identifier types against
+/// searches of the graph itself, reporting the memory each uses an edge and the largest error its
+/// weights introduce
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkCompactGraph(ostream& out) {
+    vector<unsigned int> sources(COMPACT_SOURCES);
+    srand(BENCHMARK_SEED);
+    for (unsigned int i = 0; i < COMPACT_SOURCES; i++) {
+        sources[i] = rand() % this->numCities;
+    }
+
+    vector<ShortestPathTree> trees(COMPACT_SOURCES);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < COMPACT_SOURCES; i++) {
+        this->graph->shortestPathTree(sources[i], &trees[i]);
+    }
+    double treeSeconds = secondsSince(start);
+
+    out << "Compact graph: " << COMPACT_SOURCES << " searches of the graph " << treeSeconds << " s";
+    reportCompactGraph<float, unsigned int>(out, "float/uint32", sources, &trees);
+    reportCompactGraph<double, unsigned int>(out, "double/uint32", sources, &trees);
+    reportCompactGraph<unsigned int, unsigned int>(out, "fixed/uint32", sources, &trees);
+    reportCompactGraph<float, unsigned long long>(out, "float/uint64", sources, &trees);
+    out << endl;
+}
+
+/// \brief
+/// Searches a compact graph with the given weight and identifier types from each source and reports the
+/// time taken, the memory used an edge and the largest difference from the trees of the graph itself
+///
+/// \param out ostream& - the output the report is written to
+/// \param name const char* - the name the compact graph is reported under
+/// \param sources const vector<unsigned int>& - the identifiers of the sources
+/// \param trees vector<ShortestPathTree>* - the shortest path tree of the graph from each source
+///
+template <typename Weight, typename Id>
+void Benchmark::reportCompactGraph(ostream& out, const char* name, const vector<unsigned int>& sources, vector<ShortestPathTree>* trees) {
+    CompactGraph<Weight, Id> compact(this->graph);
+    vector<typename CompactGraph<Weight, Id>::Distance> distances;
+    double largestError = 0;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < sources.size(); i++) {
+        compact.shortestDistances(sources[i], &distances);
+
+        for (unsigned int j = 0; j < this->numCities; j++) {
+            bool reachable = distances[j] != CompactGraph<Weight, Id>::UNREACHABLE;
+            if (reachable != (*trees)[i].isReachable(j)) {
+                largestError = ShortestPathTree::UNREACHABLE;
+            }
+            else if (reachable) {
+                largestError = max(largestError, fabs(CompactGraph<Weight, Id>::toDouble(distances[j]) - (*trees)[i].getDistance(j)));
+            }
+        }
+    }
+    double searchSeconds = secondsSince(start);
+
+    out << ", " << name << " " << searchSeconds << " s at " << setprecision(1)
+        << (double) compact.memoryUsage() / compact.getNumEdges() << " bytes/edge, largest error "
+        << setprecision(4) << largestError;
+}
+
+/// \brief
+/// Compares the memory and search times of the compressed graph against the flat arrays of a compact
+/// graph, and the error its quantised weights introduce
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkCompressedGraph(ostream& out) {
+    vector<unsigned int> sources(COMPACT_SOURCES);
+    srand(BENCHMARK_SEED);
+    for (unsigned int i = 0; i < COMPACT_SOURCES; i++) {
+        sources[i] = rand() % this->numCities;
+    }
+
+    CompactGraph<double, unsigned int> flat(this->graph);
+    CompressedGraph compressed(this->graph, COMPRESSED_QUANTUM);
+    vector<double> flatDistances;
+    vector<double> distances;
+    vector<unsigned int> flatHops;
+    vector<unsigned int> hops;
+    double flatSeconds = 0;
+    double compressedSeconds = 0;
+    double flatHopSeconds = 0;
+    double compressedHopSeconds = 0;
+    double largestError = 0;
+    unsigned int mismatches = 0;
+
+    for (unsigned int i = 0; i < COMPACT_SOURCES; i++) {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        flat.shortestDistances(sources[i], &flatDistances);
+        flatSeconds += secondsSince(start);
+
+        start = chrono::steady_clock::now();
+        compressed.shortestDistances(sources[i], &distances);
+        compressedSeconds += secondsSince(start);
+
+        start = chrono::steady_clock::now();
+        flat.hopDistances(sources[i], &flatHops);
+        flatHopSeconds += secondsSince(start);
+
+        start = chrono::steady_clock::now();
+        compressed.hopDistances(sources[i], &hops);
+        compressedHopSeconds += secondsSince(start);
+
+        for (unsigned int j = 0; j < this->numCities; j++) {
+            if (hops[j] != flatHops[j] || (distances[j] == ShortestPathTree::UNREACHABLE) != (flatDistances[j] == CompactGraph<double, unsigned int>::UNREACHABLE)) {
+                mismatches++;
+            }
+            else if (distances[j] != ShortestPathTree::UNREACHABLE) {
+                largestError = max(largestError, fabs(distances[j] - flatDistances[j]));
+            }
+        }
+    }
+
+    out << "Compressed graph: " << setprecision(2) << (double) compressed.memoryUsage() / compressed.getNumEdges()
+        << " bytes/edge against " << (double) flat.memoryUsage() / flat.getNumEdges() << " flat ("
+        << (double) flat.memoryUsage() / compressed.memoryUsage() << "x smaller)" << setprecision(4) << "; "
+        << COMPACT_SOURCES << " searches " << compressedSeconds << " s against " << flatSeconds << " s flat, BFS "
+        << compressedHopSeconds << " s against " << flatHopSeconds << " s flat; largest error " << largestError
+        << ", " << mismatches << " mismatches" << endl;
+}
+
+/// \brief
+/// Compares searches of compact graphs stored in the input order, along a Hilbert curve, in reverse
+/// Cuthill-McKee order and in breadth first order, counting cache misses where the processor allows
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkVertexOrder(ostream& out) {
+    vector<unsigned int> sources(COMPACT_SOURCES);
+    srand(BENCHMARK_SEED);
+    for (unsigned int i = 0; i < COMPACT_SOURCES; i++) {
+        sources[i] = rand() % this->numCities;
+    }
+
+    const char* names[] = { "input", "Hilbert", "RCM", "BFS" };
+    CacheMissCounter counter;
+    vector< vector<double> > inputDistances(COMPACT_SOURCES);
+    vector< vector<unsigned int> > inputHops(COMPACT_SOURCES);
+    out << "Vertex order: " << COMPACT_SOURCES << " searches and BFS"
+        << (counter.isAvailable() ? "" : " (cache miss counters unavailable)");
+
+    for (unsigned int o = 0; o < 4; o++) {
+        VertexOrder order(this->numCities);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        if (o == 1) {
+            order.byHilbertCurve(&this->cities);
+        }
+        else if (o == 2) {
+            order.byReverseCuthillMcKee(this->graph);
+        }
+        else if (o == 3) {
+            order.byBreadthFirst(this->graph);
+        }
+        CompactGraph<float, unsigned int> compact(this->graph, &order);
+        double buildSeconds = secondsSince(start);
+
+        vector<double> distances;
+        vector<unsigned int> hops;
+        unsigned int mismatches = 0;
+        double searchSeconds = 0;
+        double bfsSeconds = 0;
+        unsigned long long searchMisses = 0;
+        unsigned long long bfsMisses = 0;
+
+        for (unsigned int i = 0; i < COMPACT_SOURCES; i++) {
+            start = chrono::steady_clock::now();
+            counter.start();
+            compact.shortestDistances(sources[i], &distances);
+            searchMisses += counter.stop();
+            searchSeconds += secondsSince(start);
+
+            start = chrono::steady_clock::now();
+            counter.start();
+            compact.hopDistances(sources[i], &hops);
+            bfsMisses += counter.stop();
+            bfsSeconds += secondsSince(start);
+
+            // Every order must give the same answers under the graph's identifiers
+            if (o == 0) {
+                inputDistances[i] = distances;
+                inputHops[i] = hops;
+            }
+            else if (distances != inputDistances[i] || hops != inputHops[i]) {
+                mismatches++;
+            }
+        }
+
+        out << "; " << names[o] << " (edge gap " << setprecision(0) << order.averageEdgeGap(this->graph) << setprecision(4)
+            << ", built " << buildSeconds << " s) " << searchSeconds << " s";
+        if (counter.isAvailable()) {
+            out << " " << searchMisses / COMPACT_SOURCES << " misses";
+        }
+        out << ", BFS " << bfsSeconds << " s";
+        if (counter.isAvailable()) {
+            out << " " << bfsMisses / COMPACT_SOURCES << " misses";
+        }
+        out << ", " << mismatches << " mismatches";
+    }
+    out << endl;
+}
+
+/// \brief
+/// Compares working out a large batch of edge lengths and every row of the distance matrix with the
+/// point set's scalar and AVX2 kernels against calling Point::distanceTo one pair at a time
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkPointSet(ostream& out) {
+    PointSet points(&this->cities);
+    vector<unsigned int> sources(BULK_EDGES);
+    vector<unsigned int> destinations(BULK_EDGES);
+    srand(BENCHMARK_SEED);
+    for (unsigned long i = 0; i < BULK_EDGES; i++) {
+        sources[i] = rand() % this->numCities;
+        destinations[i] = rand() % this->numCities;
+    }
+
+    vector<double> expected(BULK_EDGES);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned long i = 0; i < BULK_EDGES; i++) {
+        expected[i] = this->cities[sources[i]]->distanceTo(this->cities[destinations[i]]);
+    }
+    double pointSeconds = secondsSince(start);
+
+    out << "Point set: " << BULK_EDGES / 1000000 << "M edges, one pair at a time " << setprecision(0)
+        << BULK_EDGES / pointSeconds / 1e6 << "M/s";
+
+    vector<double> lengths(BULK_EDGES);
+    vector<double> row(this->numCities);
+    for (unsigned int v = 0; v < 2; v++) {
+        points.setVectorised(v == 1);
+        if (v == 1 && !points.isVectorised()) {
+            out << ", AVX2 unavailable";
+            break;
+        }
+
+        start = chrono::steady_clock::now();
+        points.edgeLengths(&sources[0], &destinations[0], BULK_EDGES, &lengths[0]);
+        double batchSeconds = secondsSince(start);
+        unsigned long mismatches = 0;
+        for (unsigned long i = 0; i < BULK_EDGES; i++) {
+            if (lengths[i] != expected[i]) {
+                mismatches++;
+            }
+        }
+
+        // Every row of the distance matrix, as graph construction needs
+        start = chrono::steady_clock::now();
+        for (unsigned int i = 0; i < this->numCities; i++) {
+            points.distancesFrom(i, 0, this->numCities, &row[0]);
+        }
+        double rowSeconds = secondsSince(start);
+        for (unsigned int j = 0; j < this->numCities; j++) {
+            if (row[j] != this->cities[this->numCities - 1]->distanceTo(this->cities[j])) {
+                mismatches++;
+            }
+        }
+
+        out << "; " << (v == 1 ? "AVX2" : "scalar") << " batch " << BULK_EDGES / batchSeconds / 1e6 << "M/s ("
+            << setprecision(1) << BULK_EDGES * 16.0 / batchSeconds / 1e9 << " GB/s of indices and lengths), rows "
+            << setprecision(0) << (double) this->numCities * this->numCities / rowSeconds / 1e6 << "M/s, "
+            << mismatches << " mismatches";
+    }
+    out << setprecision(4) << endl;
+}
+
+/// \brief
+/// Builds a large compact graph from edges added by every worker at once, and checks that a sample of
+/// the edges added can be found in it
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkGraphBuilder(ostream& out) {
+    unsigned int numLanes = this->pool->getNumWorkers();
+    GraphBuilder<float, unsigned int> builder(BUILDER_VERTICES, numLanes);
+    vector<unsigned int> checks(2 * BUILDER_CHECKS);
+
+    // Each lane adds its share of edges between vertices with nearby identifiers, as road data tends to
+    // give, using a random sequence of its own
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    this->pool->parallelFor(numLanes, [&](unsigned int lane) {
+        unsigned long long state = BENCHMARK_SEED + lane;
+        unsigned int share = BUILDER_EDGES / numLanes + (lane < BUILDER_EDGES % numLanes ? 1 : 0);
+        for (unsigned int i = 0; i < share; i++) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            unsigned int sourceId = (state >> 33) % BUILDER_VERTICES;
+            unsigned int destinationId = (sourceId + 1 + (state >> 20) % 1000) % BUILDER_VERTICES;
+            builder.addEdge(lane, sourceId, destinationId, 1 + (state >> 10) % 100);
+            if (lane == 0 && i < BUILDER_CHECKS) {
+                checks[2 * i] = sourceId;
+                checks[2 * i + 1] = destinationId;
+            }
+        }
+    });
+    double addSeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    CompactGraph<float, unsigned int>* built = builder.build(this->pool);
+    double buildSeconds = secondsSince(start);
+
+    unsigned int found = 0;
+    vector<unsigned int> hops;
+    for (unsigned int i = 0; i < BUILDER_CHECKS; i++) {
+        built->hopDistances(checks[2 * i], &hops);
+        if (hops[checks[2 * i + 1]] == 1) {
+            found++;
+        }
+    }
+
+    out << "Graph builder: " << BUILDER_EDGES / 1000000 << "M edges over " << BUILDER_VERTICES / 1000000 << "M vertices added by "
+        << numLanes << " lanes in " << addSeconds << " s, built in " << buildSeconds << " s ("
+        << setprecision(1) << BUILDER_EDGES / buildSeconds / 1e6 << "M edges/s), " << built->getNumEdges() / 1000000.0
+        << "M directed edges in " << built->memoryUsage() / 1048576.0 << " MB" << setprecision(4) << "; "
+        << found << " of " << BUILDER_CHECKS << " sampled edges found" << endl;
+    delete built;
+}
+
+/// \brief
+/// Labels the components of the graph, cuts it into strips so that it falls apart and joins it up again,
+/// checking the index against a fresh labelling at each step. Point to point searches between random
+/// cities of the cut graph are timed with and without the index answering the unreachable pairs
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkComponentIndex(ostream& out) {
+    unsigned int mismatches = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    ComponentIndex* components = new ComponentIndex(this->graph, this->pool);
+    double labelSeconds = secondsSince(start);
+    unsigned int numComponents = components->getNumComponents();
+
+    // Counts the vertices whose label disagrees with a union find over the edges the graph has now
+    function<void()> check = [&]() {
+        DisjointSet expected(this->numCities);
+        for (unsigned int uId = 0; uId < this->numCities; uId++) {
+            vector<unsigned int>* adjacent = this->graph->getNeighbours(uId);
+            for (unsigned int i = 0; i < adjacent->size(); i++) {
+                expected.join(uId, (*adjacent)[i]);
+            }
+        }
+        vector<int> rootOfLabel(this->numCities, -1);
+        vector<int> labelOfRoot(this->numCities, -1);
+        for (unsigned int uId = 0; uId < this->numCities; uId++) {
+            int root = expected.find(uId);
+            int label = components->getComponent(uId);
+            if (rootOfLabel[label] == -1 && labelOfRoot[root] == -1) {
+                rootOfLabel[label] = root;
+                labelOfRoot[root] = label;
+            }
+            else if (rootOfLabel[label] != root || labelOfRoot[root] != label) {
+                mismatches++;
+            }
+        }
+    };
+    check();
+
+    // Close every road crossing the edges of the strips, splitting components as the index goes
+    vector<unsigned int> cutSources;
+    vector<unsigned int> cutDestinations;
+    vector<double> cutWeights;
+    int stripWidth = MAXIMUM_COORDINATE / COMPONENT_STRIPS;
+    for (unsigned int uId = 0; uId < this->numCities; uId++) {
+        vector<unsigned int>* adjacent = this->graph->getNeighbours(uId);
+        for (unsigned int i = 0; i < adjacent->size(); i++) {
+            unsigned int vId = (*adjacent)[i];
+            if (uId < vId && (int) this->cities[uId]->getX() / stripWidth != (int) this->cities[vId]->getX() / stripWidth) {
+                cutSources.push_back(uId);
+                cutDestinations.push_back(vId);
+                cutWeights.push_back(this->graph->getWeight(uId, vId));
+            }
+        }
+    }
+    start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < cutSources.size(); i++) {
+        this->graph->removeEdge(cutSources[i], cutDestinations[i]);
+    }
+    double cutSeconds = secondsSince(start);
+    unsigned int numFragments = components->getNumComponents();
+    check();
+
+    // The same random pairs searched to the end without the index, and only when reachable with it
+    srand(BENCHMARK_SEED);
+    vector<unsigned int> pairs(2 * POINT_TO_POINT_QUERIES);
+    for (unsigned int i = 0; i < pairs.size(); i++) {
+        pairs[i] = rand() % this->numCities;
+    }
+    SearchSpace space(this->numCities);
+    vector<bool> found(POINT_TO_POINT_QUERIES, false);
+    unsigned int uId;
+    start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < POINT_TO_POINT_QUERIES; i++) {
+        space.start(pairs[2 * i]);
+        while (space.settleNext(this->graph, &uId)) {
+            if (uId == pairs[2 * i + 1]) {
+                found[i] = true;
+                break;
+            }
+        }
+    }
+    double searchSeconds = secondsSince(start);
+
+    unsigned int numUnreachable = 0;
+    start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < POINT_TO_POINT_QUERIES; i++) {
+        if (!components->isReachable(pairs[2 * i], pairs[2 * i + 1])) {
+            numUnreachable++;
+            mismatches += found[i] ? 1 : 0;
+            continue;
+        }
+        space.start(pairs[2 * i]);
+        bool reached = false;
+        while (space.settleNext(this->graph, &uId)) {
+            if (uId == pairs[2 * i + 1]) {
+                reached = true;
+                break;
+            }
+        }
+        mismatches += reached != found[i] ? 1 : 0;
+    }
+    double indexedSeconds = secondsSince(start);
+
+    // Open the roads again, joining the strips back together
+    start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < cutSources.size(); i++) {
+        this->graph->addEdge(new Edge(this->graph->getVertex(cutSources[i]), this->graph->getVertex(cutDestinations[i]), cutWeights[i]));
+    }
+    double joinSeconds = secondsSince(start);
+    mismatches += components->getNumComponents() != numComponents ? 1 : 0;
+    check();
+    delete components;
+
+    out << "Component index: labelled " << numComponents << " components in " << labelSeconds << " s; "
+        << cutSources.size() << " roads closed in " << cutSeconds << " s leaving " << numFragments << " components, reopened in "
+        << joinSeconds << " s; " << POINT_TO_POINT_QUERIES << " point to point queries, " << numUnreachable
+        << " unreachable, " << searchSeconds << " s searched against " << indexedSeconds << " s with the index; "
+        << mismatches << " mismatches" << endl;
+}
+
+/// \brief
+/// Builds spanners of the complete graph of the first cities for several stretch factors, reporting how
+/// many edges each keeps and checking the stretch of its shortest paths and its minimum spanning tree
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkGeometricSpanner(ostream& out) {
+    unsigned int numCities = SPANNER_CITIES < this->numCities ? SPANNER_CITIES : this->numCities;
+    unsigned int numSources = SPANNER_SOURCES < numCities ? SPANNER_SOURCES : numCities;
+
+    // Every pair of cities is a candidate road
+    Graph* complete = new Graph(numCities);
+    for (unsigned int i = 0; i < numCities; i++) {
+        complete->addVertex(new Vertex(i));
+    }
+    vector<Point*> cities(this->cities.begin(), this->cities.begin() + numCities);
+    PointSet points(&cities);
+    vector<double> row(numCities);
+    for (unsigned int i = 0; i + 1 < numCities; i++) {
+        points.distancesFrom(i, i + 1, numCities - i - 1, &row[0]);
+        for (unsigned int j = i + 1; j < numCities; j++) {
+            complete->addEdge(new Edge(complete->getVertex(i), complete->getVertex(j), row[j - i - 1]));
+        }
+    }
+
+    vector<ShortestPathTree> trees(numSources);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < numSources; i++) {
+        complete->shortestPathTree(i, &trees[i]);
+    }
+    double completeSeconds = secondsSince(start);
+    double completeCost = complete->minimumSpanningTreeCost();
+
+    out << "Geometric spanner of " << numCities << " cities: " << numSources << " searches of all "
+        << (unsigned long) numCities * (numCities - 1) / 2 << " edges " << completeSeconds << " s";
+    for (unsigned int k = 0; k < sizeof(SPANNER_STRETCHES) / sizeof(SPANNER_STRETCHES[0]); k++) {
+        GeometricSpanner spanner(SPANNER_STRETCHES[k]);
+        start = chrono::steady_clock::now();
+        Graph* sparse = spanner.build(complete);
+        double buildSeconds = secondsSince(start);
+
+        // The largest stretch of any shortest path from the sources, which the bound must cover
+        double measuredStretch = 1.0;
+        ShortestPathTree tree;
+        start = chrono::steady_clock::now();
+        for (unsigned int i = 0; i < numSources; i++) {
+            sparse->shortestPathTree(i, &tree);
+            for (unsigned int j = 0; j < numCities; j++) {
+                if (j != i && tree.getDistance(j) / trees[i].getDistance(j) > measuredStretch) {
+                    measuredStretch = tree.getDistance(j) / trees[i].getDistance(j);
+                }
+            }
+        }
+        double sparseSeconds = secondsSince(start);
+
+        out << "; t=" << setprecision(1) << spanner.getStretch() << " kept " << spanner.getNumEdges() << " edges ("
+            << spanner.getNumEdges() / (double) numCities << " per city, " << setprecision(4)
+            << spanner.getNumCandidateEdges() / (double) spanner.getNumEdges() << "x fewer) in " << buildSeconds
+            << " s, searches " << sparseSeconds << " s, largest stretch " << spanner.getMaxStretch() << " built, "
+            << measuredStretch << " measured, MST cost difference " << fabs(sparse->minimumSpanningTreeCost() - completeCost);
+        delete sparse;
+    }
+    out << endl;
+    delete complete;
+}
+
+/// \brief
+/// Builds approximate distance oracles with several numbers of levels, reporting their size, build time and
+/// query latency, and measuring their stretch against full searches from a sample of sources
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkDistanceOracle(ostream& out) {
+    unsigned int numSources = LABEL_CHECK_SOURCES < this->numCities ? LABEL_CHECK_SOURCES : this->numCities;
+    vector<ShortestPathTree> trees(numSources);
+    for (unsigned int i = 0; i < numSources; i++) {
+        this->graph->shortestPathTree(i * (this->numCities / numSources), &trees[i]);
+    }
+
+    // Random pairs are drawn up front so only the lookups are timed
+    vector<unsigned int> pairs(2 * LABEL_QUERIES);
+    srand(BENCHMARK_SEED);
+    for (unsigned int i = 0; i < pairs.size(); i++) {
+        pairs[i] = rand() % this->numCities;
+    }
+
+    out << "Distance oracle (" << this->numCities << " vertices, " << (unsigned long) this->numCities * this->numCities * sizeof(double) / 1048576.0
+        << " MB as a full table)";
+    for (unsigned int k = 0; k < sizeof(ORACLE_LEVELS) / sizeof(ORACLE_LEVELS[0]); k++) {
+        DistanceOracle oracle(ORACLE_LEVELS[k]);
+        oracle.build(this->graph, this->pool);
+
+        unsigned int reachable = 0;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (unsigned int i = 0; i < LABEL_QUERIES; i++) {
+            if (oracle.distance(pairs[2 * i], pairs[2 * i + 1]) != ShortestPathTree::UNREACHABLE) {
+                reachable++;
+            }
+        }
+        double querySeconds = secondsSince(start);
+
+        // Every answer must lie between the true distance and 2k - 1 times it
+        unsigned int numLevels = oracle.getNumLevels();
+        double largestStretch = 1.0;
+        double totalStretch = 0;
+        unsigned long numChecked = 0;
+        unsigned int outOfBounds = 0;
+        for (unsigned int i = 0; i < numSources; i++) {
+            unsigned int sourceId = i * (this->numCities / numSources);
+            for (unsigned int j = 0; j < this->numCities; j++) {
+                double exact = trees[i].getDistance(j);
+                double approximate = oracle.distance(sourceId, j);
+                if (j == sourceId || !trees[i].isReachable(j)) {
+                    outOfBounds += approximate != (j == sourceId ? 0 : ShortestPathTree::UNREACHABLE) ? 1 : 0;
+                    continue;
+                }
+                double stretch = approximate / exact;
+                if (stretch < 1 - 1e-6 || stretch > 2 * numLevels - 1 + 1e-6) {
+                    outOfBounds++;
+                }
+                largestStretch = stretch > largestStretch ? stretch : largestStretch;
+                totalStretch += stretch;
+                numChecked++;
+            }
+        }
+
+        out << "; k=" << numLevels << " (bound " << 2 * numLevels - 1 << "): built in " << oracle.getBuildSeconds() << " s, "
+            << oracle.memoryUsage() / 1048576.0 << " MB, " << oracle.getAverageBunchSize() << " bunch entries per vertex, "
+            << querySeconds / LABEL_QUERIES * 1e9 << " ns per query (" << reachable << " reachable), stretch " << (numChecked > 0 ? totalStretch / numChecked : 1.0)
+            << " average " << largestStretch << " largest, " << outOfBounds << " out of bounds";
+    }
+    out << endl;
+}
+
+/// \brief
+/// Answers random queries with every engine the query planner could choose, first with searches alone and
+/// then with hub labels, a route planner and an oracle to choose from as well, reporting how often the
+/// planner chose the engine that was measured to be fastest and the time its choices took against always
+/// using the fastest engine or always using Dijkstra
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkQueryPlanner(ostream& out) {
+    ComponentIndex components(this->graph, this->pool);
+    QueryPlanner planner(this->graph);
+    planner.setCoordinates(&this->cities);
+
+    vector<unsigned int> pairs(2 * POINT_TO_POINT_QUERIES);
+    srand(BENCHMARK_SEED);
+    for (unsigned int i = 0; i < pairs.size(); i++) {
+        pairs[i] = rand() % this->numCities;
+    }
+
+    HubLabels hubLabels;
+    MultilevelPartition partition;
+    partition.build(this->graph, PARTITION_LEVELS, PARTITION_BASE_CELL_SIZE, PARTITION_FANOUT);
+    CustomizableRoutePlanner routePlanner(this->graph, &partition);
+    DistanceOracle oracle(PLANNER_ORACLE_LEVELS);
+
+    out << "Query planner:";
+    for (unsigned int configuration = 0; configuration < 2; configuration++) {
+        if (configuration == 1) {
+            hubLabels.build(this->graph, this->pool);
+            routePlanner.customise(this->pool);
+            oracle.build(this->graph, this->pool);
+            planner.setHubLabels(&hubLabels);
+            planner.setRoutePlanner(&routePlanner);
+            planner.setDistanceOracle(&oracle);
+        }
+
+        // Each query is planned before any engine has answered it, then answered by every engine that could
+        unsigned int picks[NUM_PLAN_ENGINES] = { 0 };
+        unsigned int agreements = 0;
+        unsigned int mismatches = 0;
+        double plannedSeconds = 0;
+        double fastestSeconds = 0;
+        double dijkstraSeconds = 0;
+        for (unsigned int i = 0; i < POINT_TO_POINT_QUERIES; i++) {
+            unsigned int sourceId = pairs[2 * i];
+            unsigned int destinationId = pairs[2 * i + 1];
+            QueryPlan chosen = planner.plan(sourceId, destinationId, false);
+            picks[chosen.engine]++;
+
+            QueryPlan forced = chosen;
+            double seconds[NUM_PLAN_ENGINES];
+            double answers[NUM_PLAN_ENGINES];
+            unsigned int fastest = NUM_PLAN_ENGINES;
+            for (unsigned int e = 0; e < NUM_PLAN_ENGINES; e++) {
+                if (chosen.costs[e] < 0) {
+                    continue;
+                }
+                forced.engine = (PlanEngine) e;
+                chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                answers[e] = planner.execute(forced, sourceId, destinationId);
+                seconds[e] = secondsSince(start);
+                if (fastest == NUM_PLAN_ENGINES || seconds[e] < seconds[fastest]) {
+                    fastest = e;
+                }
+            }
+
+            // Every exact engine must agree with the search that stops at the destination
+            for (unsigned int e = 0; e < NUM_PLAN_ENGINES; e++) {
+                double difference = answers[e] - answers[PLAN_DIJKSTRA];
+                if (chosen.costs[e] >= 0 && e != PLAN_DISTANCE_ORACLE && answers[e] != answers[PLAN_DIJKSTRA]
+                    && (difference > 1e-6 || difference < -1e-6)) {
+                    mismatches++;
+                }
+            }
+            agreements += fastest == (unsigned int) chosen.engine ? 1 : 0;
+            plannedSeconds += seconds[chosen.engine];
+            fastestSeconds += seconds[fastest];
+            dijkstraSeconds += seconds[PLAN_DIJKSTRA];
+        }
+
+        out << (configuration == 0 ? " searches only" : "; with indexes") << " chose";
+        for (unsigned int e = 0; e < NUM_PLAN_ENGINES; e++) {
+            if (picks[e] > 0) {
+                out << " " << QueryPlanner::getEngineName((PlanEngine) e) << "=" << picks[e];
+            }
+        }
+        out << ", fastest engine chosen " << agreements << "/" << POINT_TO_POINT_QUERIES << ", chosen engines "
+            << plannedSeconds << " s against " << fastestSeconds << " s fastest and " << dijkstraSeconds << " s Dijkstra, "
+            << mismatches << " mismatches";
+    }
+    out << endl << "  explain " << pairs[0] << " -> " << pairs[1] << " approximate: " << planner.explain(pairs[0], pairs[1], true) << endl;
+}
+
+/// \brief
+/// Times point to point queries on a versioned graph while it is left alone and again while a writer thread
+/// publishes a continuous stream of weight changes, checking every version a query saw was whole
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkVersionedGraph(ostream& out) {
+    VersionedGraph versions(this->graph, 2);
+    unsigned int reader = versions.addReader();
+    unsigned int writerReader = versions.addReader();
+    const GraphVersion* first = versions.acquire(reader);
+    double totalWeight = first->getTotalWeight();
+    unsigned long firstBytes = versions.memoryUsage();
+    versions.release(reader);
+
+    vector< pair<unsigned int, unsigned int> > edges;
+    for (unsigned int uId = 0; uId < this->numCities; uId++) {
+        vector<unsigned int>* adjacent = this->graph->getNeighbours(uId);
+        for (unsigned int i = 0; i < adjacent->size(); i++) {
+            if ((*adjacent)[i] > uId) {
+                edges.push_back(make_pair(uId, (*adjacent)[i]));
+            }
+        }
+    }
+
+    vector<unsigned int> pairs(2 * POINT_TO_POINT_QUERIES);
+    srand(BENCHMARK_SEED);
+    for (unsigned int i = 0; i < pairs.size(); i++) {
+        pairs[i] = rand() % this->numCities;
+    }
+
+    // Each batch moves weight from one edge to another, so every whole version has the same total weight
+    atomic<bool> stop(false);
+    unsigned long numBatches = 0;
+    unsigned long lastVersion = 0;
+    double publishSeconds = 0;
+    auto writer = [&]() {
+        unsigned int seed = BENCHMARK_SEED;
+        vector<EdgeUpdate> updates(2 * VERSION_UPDATE_BATCH);
+        while (!stop.load()) {
+            const GraphVersion* version = versions.acquire(writerReader);
+            for (unsigned int i = 0; i < VERSION_UPDATE_BATCH; i++) {
+                pair<unsigned int, unsigned int> from = edges[rand_r(&seed) % edges.size()];
+                pair<unsigned int, unsigned int> to = edges[rand_r(&seed) % edges.size()];
+                while (to == from) {
+                    to = edges[rand_r(&seed) % edges.size()];
+                }
+                double fromWeight = version->getWeight(from.first, from.second);
+                double moved = fromWeight / 2;
+                EdgeUpdate decrease = { from.first, from.second, fromWeight - moved };
+                EdgeUpdate increase = { to.first, to.second, version->getWeight(to.first, to.second) + moved };
+                updates[2 * i] = decrease;
+                updates[2 * i + 1] = increase;
+            }
+            versions.release(writerReader);
+
+            // An edge chosen twice in a batch would be read before its first change, so only one change to
+            // each edge is kept per batch
+            vector<EdgeUpdate> batch;
+            for (unsigned int i = 0; i < updates.size(); i += 2) {
+                bool clash = false;
+                for (unsigned int j = 0; j < batch.size(); j++) {
+                    for (unsigned int k = i; k < i + 2; k++) {
+                        clash = clash || (batch[j].sourceId == updates[k].sourceId && batch[j].destinationId == updates[k].destinationId);
+                    }
+                }
+                if (!clash) {
+                    batch.push_back(updates[i]);
+                    batch.push_back(updates[i + 1]);
+                }
+            }
+
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            lastVersion = versions.apply(batch);
+            publishSeconds += secondsSince(start);
+            numBatches++;
+            this_thread::sleep_for(chrono::microseconds(VERSION_UPDATE_PAUSE_MICROSECONDS));
+        }
+    };
+
+    out << "Versioned graph (" << firstBytes / 1048576.0 << " MB per full copy)";
+    vector<double> distances;
+    vector<double> answers(POINT_TO_POINT_QUERIES);
+    for (unsigned int phase = 0; phase < 2; phase++) {
+        thread writerThread;
+        stop.store(false);
+        if (phase == 1) {
+            writerThread = thread(writer);
+        }
+
+        vector<double> latencies(POINT_TO_POINT_QUERIES);
+        unsigned int torn = 0;
+        unsigned long oldest = 0;
+        unsigned long newest = 0;
+        for (unsigned int i = 0; i < POINT_TO_POINT_QUERIES; i++) {
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            const GraphVersion* version = versions.acquire(reader);
+            answers[i] = version->distance(pairs[2 * i], pairs[2 * i + 1], &distances);
+            latencies[i] = secondsSince(start);
+
+            // Summing every row of the version the query used must give the same total as the first version
+            double sum = 0;
+            for (unsigned int uId = 0; uId < version->getNumVertices(); uId++) {
+                const VersionRow& row = version->getNeighbours(uId);
+                for (unsigned int j = 0; j < row.size(); j++) {
+                    sum += row[j].first > uId ? row[j].second : 0;
+                }
+            }
+            torn += fabs(sum - totalWeight) > 1e-6 * totalWeight ? 1 : 0;
+            oldest = i == 0 ? version->getNumber() : oldest;
+            newest = version->getNumber();
+            versions.release(reader);
+        }
+
+        stop.store(true);
+        if (phase == 1) {
+            writerThread.join();
+        }
+        sort(latencies.begin(), latencies.end());
+        out << (phase == 0 ? " without updates" : "; with updates") << ": " << POINT_TO_POINT_QUERIES << " queries, latency "
+            << latencies[latencies.size() / 2] * 1e6 << " us median " << latencies[latencies.size() * 99 / 100] * 1e6 << " us p99 "
+            << latencies.back() * 1e6 << " us max, versions " << oldest << ".." << newest << " seen, " << torn << " torn";
+    }
+
+    // A search of the last version must agree with a search of a graph rebuilt from it
+    const GraphVersion* last = versions.acquire(reader);
+    Graph rebuilt(this->numCities);
+    for (unsigned int i = 0; i < this->numCities; i++) {
+        rebuilt.addVertex(new Vertex(i));
+    }
+    for (unsigned int i = 0; i < edges.size(); i++) {
+        rebuilt.addEdge(new Edge(rebuilt.getVertex(edges[i].first), rebuilt.getVertex(edges[i].second),
+                                 last->getWeight(edges[i].first, edges[i].second)));
+    }
+    SearchSpace space(this->numCities);
+    unsigned int mismatches = 0;
+    for (unsigned int i = 0; i < LABEL_CHECK_SOURCES; i++) {
+        unsigned int uId;
+        space.start(pairs[2 * i]);
+        while (space.settleNext(&rebuilt, &uId) && uId != pairs[2 * i + 1]) {
+        }
+        double difference = space.getDistance(pairs[2 * i + 1]) - last->distance(pairs[2 * i], pairs[2 * i + 1], &distances);
+        mismatches += difference > 1e-6 || difference < -1e-6 ? 1 : 0;
+    }
+    versions.release(reader);
+
+    out << "; " << numBatches << " batches of " << 2 * VERSION_UPDATE_BATCH << " changes published to version " << lastVersion
+        << ", " << (numBatches > 0 ? publishSeconds / numBatches * 1e6 : 0) << " us each, " << versions.getNumRetired()
+        << " retired versions left, " << mismatches << " mismatches against a rebuilt graph" << endl;
+}
+
+/// \brief
+/// Runs an all pairs job over the graph with several worker processes, killing them part way through a
+/// shard, checks the merged distances against full searches, then runs the job again after removing one
+/// shard to show only that shard is redone
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkBatchCoordinator(ostream& out) {
+    char directoryTemplate[] = "/tmp/roads-batch-XXXXXX";
+    if (mkdtemp(directoryTemplate) == NULL) {
+        out << "Batch coordinator: could not create a directory" << endl;
+        return;
+    }
+    string directory = directoryTemplate;
+    string graphPath = directory + "/graph.edges";
+    string mergedPath = directory + "/all-pairs.bin";
+
+    unsigned long numEdges = 0;
+    for (unsigned int uId = 0; uId < this->numCities; uId++) {
+        numEdges += this->graph->getNeighbours(uId)->size();
+    }
+    ExternalGraphWriter writer(graphPath, this->numCities, numEdges * sizeof(ExternalEdge));
+    bool written = true;
+    for (unsigned int uId = 0; uId < this->numCities && written; uId++) {
+        vector<unsigned int>* neighbours = this->graph->getNeighbours(uId);
+        for (unsigned int i = 0; i < neighbours->size() && written; i++) {
+            if ((*neighbours)[i] > uId) {
+                written = writer.addEdge(uId, (*neighbours)[i], this->graph->getWeight(uId, (*neighbours)[i]));
+            }
+        }
+    }
+    written = written && writer.finish();
+
+    BatchCoordinator coordinator(graphPath, directory, BATCH_PROCESSES, BATCH_SHARD_SOURCES);
+    string error;
+    bool finished = false;
+    atomic<bool> running(true);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    thread runner([&]() {
+        finished = written && coordinator.run(&error);
+        running = false;
+    });
+
+    // Kill the workers as soon as one is part way through writing the chosen shard, which leaves its
+    // temporary file behind just as a crash would
+    unsigned int crashFirst = BATCH_CRASH_SHARD * BATCH_SHARD_SOURCES < this->numCities ? BATCH_CRASH_SHARD * BATCH_SHARD_SOURCES : 0;
+    unsigned int crashSources = this->numCities - crashFirst < BATCH_SHARD_SOURCES ? this->numCities - crashFirst : BATCH_SHARD_SOURCES;
+    string crashPath = BatchWorker::getShardPath(directory, crashFirst, crashSources) + ".tmp";
+    unsigned int numKilled = 0;
+    while (running && numKilled == 0) {
+        if (access(crashPath.c_str(), F_OK) == 0) {
+            vector<pid_t> pids = coordinator.getWorkerPids();
+            for (unsigned int i = 0; i < pids.size(); i++) {
+                numKilled += kill(pids[i], SIGKILL) == 0 ? 1 : 0;
+            }
+        }
+        this_thread::sleep_for(chrono::microseconds(BATCH_CRASH_POLL_MICROSECONDS));
+    }
+    runner.join();
+    double runSeconds = secondsSince(start);
+    start = chrono::steady_clock::now();
+    finished = finished && coordinator.merge(mergedPath, &error);
+    double mergeSeconds = secondsSince(start);
+    unsigned int numStarted = coordinator.getNumProcessesStarted();
+    unsigned int numRestarts = coordinator.getNumRestarts();
+
+    // Rows of the merged file must match full searches of the graph in memory
+    unsigned int mismatches = 0;
+    unsigned int numSources = LABEL_CHECK_SOURCES < this->numCities ? LABEL_CHECK_SOURCES : this->numCities;
+    FILE* merged = finished ? fopen(mergedPath.c_str(), "rb") : NULL;
+    vector<double> row(this->numCities);
+    for (unsigned int i = 0; i < numSources && merged != NULL; i++) {
+        unsigned int sourceId = i * (this->numCities / numSources);
+        ShortestPathTree tree;
+        this->graph->shortestPathTree(sourceId, &tree);
+        fseek(merged, sizeof(ShardHeader) + (long) sourceId * this->numCities * sizeof(double), SEEK_SET);
+        if (fread(&row[0], sizeof(double), this->numCities, merged) != this->numCities) {
+            mismatches++;
+            continue;
+        }
+        for (unsigned int j = 0; j < this->numCities; j++) {
+            double difference = row[j] - tree.getDistance(j);
+            mismatches += row[j] != tree.getDistance(j) && (difference > 1e-6 || difference < -1e-6) ? 1 : 0;
+        }
+    }
+    if (merged != NULL) {
+        fclose(merged);
+    }
+
+    // Running again after losing one shard redoes only that shard
+    unsigned int lostSources = this->numCities < BATCH_SHARD_SOURCES ? this->numCities : BATCH_SHARD_SOURCES;
+    unlink(BatchWorker::getShardPath(directory, 0, lostSources).c_str());
+    start = chrono::steady_clock::now();
+    bool resumed = finished && coordinator.run(&error);
+    double resumeSeconds = secondsSince(start);
+
+    if (!finished || !resumed) {
+        out << "Batch coordinator: " << (error.empty() ? "graph file could not be written" : error) << endl;
+    }
+    else {
+        out << "Batch coordinator: all pairs of " << this->numCities << " vertices in " << coordinator.getNumShards() << " shards by "
+            << BATCH_PROCESSES << " processes in " << runSeconds << " s (" << numKilled << " workers killed, " << numStarted
+            << " processes started, " << numRestarts << " shards restarted), merged in " << mergeSeconds << " s, " << mismatches << " mismatches in "
+            << numSources << " rows checked; rerun after losing a shard kept " << coordinator.getNumKept() << " and took "
+            << resumeSeconds << " s" << endl;
+    }
+
+    for (unsigned int first = 0; first < this->numCities; first += BATCH_SHARD_SOURCES) {
+        unsigned int count = this->numCities - first < BATCH_SHARD_SOURCES ? this->numCities - first : BATCH_SHARD_SOURCES;
+        unlink(BatchWorker::getShardPath(directory, first, count).c_str());
+        unlink((BatchWorker::getShardPath(directory, first, count) + ".tmp").c_str());
+    }
+    unlink(mergedPath.c_str());
+    unlink(graphPath.c_str());
+    rmdir(directory.c_str());
+}
+
+/// \brief
+/// Compares the binary heap with Dial's buckets and a radix heap, first on their own with a monotone stream of
+/// operations like a large search makes, then as the queue of full searches over copies of the graph whose
+/// weights are rounded to a coarse and a fine quantum, reporting the rounding error against the exact graph
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkIntegerQueues(ostream& out) {
+
+    // Each step takes out the closest entry and adds one a random step further on, keeping the queue full
+    double queueSeconds[3];
+    unsigned long long checksums[3];
+    for (unsigned int kind = 0; kind < 3; kind++) {
+        priority_queue< pair<unsigned long long, unsigned int>, vector< pair<unsigned long long, unsigned int> >,
+                        greater< pair<unsigned long long, unsigned int> > > binaryHeap;
+        DialQueue buckets(QUEUE_MAXIMUM_STEP);
+        RadixHeap radixHeap;
+        unsigned int seed = BENCHMARK_SEED;
+        checksums[kind] = 0;
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (unsigned int i = 0; i < QUEUE_LIVE_ENTRIES; i++) {
+            unsigned long long key = rand_r(&seed) % QUEUE_MAXIMUM_STEP;
+            kind == 0 ? binaryHeap.push(make_pair(key, i)) : kind == 1 ? buckets.push(key, i) : radixHeap.push(key, i);
+        }
+        for (unsigned long i = 0; i < QUEUE_OPERATIONS; i++) {
+            unsigned long long key;
+            unsigned int identifier;
+            if (kind == 0) {
+                key = binaryHeap.top().first;
+                identifier = binaryHeap.top().second;
+                binaryHeap.pop();
+            }
+            else if (kind == 1) {
+                buckets.pop(&key, &identifier);
+            }
+            else {
+                radixHeap.pop(&key, &identifier);
+            }
+            checksums[kind] += key;
+            key += rand_r(&seed) % QUEUE_MAXIMUM_STEP;
+            kind == 0 ? binaryHeap.push(make_pair(key, identifier)) : kind == 1 ? buckets.push(key, identifier) : radixHeap.push(key, identifier);
+        }
+        queueSeconds[kind] = secondsSince(start);
+    }
+
+    out << "Integer queues: " << QUEUE_OPERATIONS << " pop and push pairs on " << QUEUE_LIVE_ENTRIES << " entries, binary heap "
+        << queueSeconds[0] / QUEUE_OPERATIONS * 1e9 << " ns, Dial " << queueSeconds[1] / QUEUE_OPERATIONS * 1e9 << " ns, radix heap "
+        << queueSeconds[2] / QUEUE_OPERATIONS * 1e9 << " ns per pair (" << (checksums[0] == checksums[1] && checksums[0] == checksums[2] ? "same" : "different")
+        << " keys taken out)";
+
+    unsigned int numSources = LABEL_CHECK_SOURCES < this->numCities ? LABEL_CHECK_SOURCES : this->numCities;
+    vector<ShortestPathTree> exact(numSources);
+    for (unsigned int i = 0; i < numSources; i++) {
+        this->graph->shortestPathTree(i * (this->numCities / numSources), &exact[i]);
+    }
+
+    for (unsigned int q = 0; q < sizeof(QUEUE_QUANTA) / sizeof(QUEUE_QUANTA[0]); q++) {
+        Graph quantised(this->numCities);
+        quantised.setQuantum(QUEUE_QUANTA[q]);
+        for (unsigned int i = 0; i < this->numCities; i++) {
+            quantised.addVertex(new Vertex(i));
+        }
+        for (unsigned int uId = 0; uId < this->numCities; uId++) {
+            vector<unsigned int>* neighbours = this->graph->getNeighbours(uId);
+            for (unsigned int i = 0; i < neighbours->size(); i++) {
+                if ((*neighbours)[i] > uId) {
+                    quantised.addEdge(new Edge(quantised.getVertex(uId), quantised.getVertex((*neighbours)[i]),
+                                               this->graph->getWeight(uId, (*neighbours)[i])));
+                }
+            }
+        }
+        SearchQueue automatic = quantised.getSearchQueue();
+
+        // The same searches with each queue must find the same distances over the rounded weights
+        const SearchQueue queues[3] = { SEARCH_QUEUE_BINARY_HEAP, SEARCH_QUEUE_DIAL, SEARCH_QUEUE_RADIX_HEAP };
+        double searchSeconds[3];
+        unsigned int mismatches = 0;
+        double largestError = 0;
+        vector<ShortestPathTree> heapTrees(numSources);
+        for (unsigned int kind = 0; kind < 3; kind++) {
+            quantised.setSearchQueue(queues[kind]);
+            ShortestPathTree tree;
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            for (unsigned int i = 0; i < numSources; i++) {
+                quantised.shortestPathTree(i * (this->numCities / numSources), kind == 0 ? &heapTrees[i] : &tree);
+                if (kind == 0) {
+                    continue;
+                }
+                for (unsigned int j = 0; j < this->numCities; j++) {
+                    double difference = tree.getDistance(j) - heapTrees[i].getDistance(j);
+                    mismatches += tree.isReachable(j) != heapTrees[i].isReachable(j) || (tree.isReachable(j) && (difference > 1e-6 || difference < -1e-6)) ? 1 : 0;
+                }
+            }
+            searchSeconds[kind] = secondsSince(start);
+        }
+        for (unsigned int i = 0; i < numSources; i++) {
+            for (unsigned int j = 0; j < this->numCities; j++) {
+                if (exact[i].isReachable(j)) {
+                    double error = fabs(heapTrees[i].getDistance(j) - exact[i].getDistance(j));
+                    largestError = error > largestError ? error : largestError;
+                }
+            }
+        }
+        quantised.setSearchQueue(SEARCH_QUEUE_AUTOMATIC);
+
+        const char* names[4] = { "automatic", "binary heap", "Dial", "radix heap" };
+        out << "; quantum " << QUEUE_QUANTA[q] << " (" << names[automatic] << " chosen): edge error " << quantised.getMaxQuantisationError()
+            << " largest, " << quantised.getMaxRelativeQuantisationError() * 100 << "% relative, path error " << largestError
+            << " largest; " << numSources << " full searches binary heap " << searchSeconds[0] << " s, Dial " << searchSeconds[1]
+            << " s, radix heap " << searchSeconds[2] << " s, " << mismatches << " mismatches";
+    }
+    out << endl;
+}
+
+/// \brief
+/// Finds the k shortest simple paths between random pairs of vertices and compares the time taken with a point
+/// to point search between the same pairs, checking every path found is simple, joins its endpoints along edges
+/// of the graph with the length reported, and that the paths are distinct and shortest first
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkKShortestPaths(ostream& out) {
+    vector<unsigned int> pairs(2 * ALTERNATIVE_QUERIES);
+    srand(BENCHMARK_SEED);
+    for (unsigned int i = 0; i < pairs.size(); i++) {
+        pairs[i] = rand() % this->numCities;
+    }
+
+    SearchSpace space(this->numCities);
+    vector<double> distances(ALTERNATIVE_QUERIES);
+    unsigned long searchSettled = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < ALTERNATIVE_QUERIES; i++) {
+        unsigned int uId;
+        space.start(pairs[2 * i]);
+        while (space.settleNext(this->graph, &uId)) {
+            searchSettled++;
+            if (uId == pairs[2 * i + 1]) {
+                break;
+            }
+        }
+        distances[i] = space.isSettled(pairs[2 * i + 1]) ? space.getDistance(pairs[2 * i + 1]) : ShortestPathTree::UNREACHABLE;
+    }
+    double searchSeconds = secondsSince(start);
+
+    KShortestPaths alternatives(this->graph, this->pool);
+    vector< vector< pair<double, vector<unsigned int> > > > routes(ALTERNATIVE_QUERIES);
+    unsigned long routesSettled = 0;
+    unsigned long numShortcuts = 0;
+    unsigned long numPruned = 0;
+    start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < ALTERNATIVE_QUERIES; i++) {
+        alternatives.find(pairs[2 * i], pairs[2 * i + 1], ALTERNATIVE_ROUTES, &routes[i]);
+        routesSettled += alternatives.getNumSettled();
+        numShortcuts += alternatives.getNumShortcuts();
+        numPruned += alternatives.getNumPruned();
+    }
+    double routesSeconds = secondsSince(start);
+
+    unsigned long numRoutes = 0;
+    unsigned int mismatches = 0;
+    vector<unsigned int> visited(this->numCities, 0);
+    unsigned int visit = 0;
+    for (unsigned int i = 0; i < ALTERNATIVE_QUERIES; i++) {
+        numRoutes += routes[i].size();
+        if (routes[i].empty() ? distances[i] != ShortestPathTree::UNREACHABLE
+                              : fabs(routes[i][0].first - distances[i]) > 1e-6) {
+            mismatches++;
+        }
+        set< vector<unsigned int> > distinct;
+        for (unsigned int j = 0; j < routes[i].size(); j++) {
+            vector<unsigned int>& route = routes[i][j].second;
+            bool valid = route.front() == pairs[2 * i] && route.back() == pairs[2 * i + 1] && distinct.insert(route).second
+                         && (j == 0 || routes[i][j].first >= routes[i][j - 1].first - 1e-9);
+            double length = 0;
+            visit++;
+            for (unsigned int v = 0; v < route.size() && valid; v++) {
+                valid = visited[route[v]] != visit && (v == 0 || this->graph->hasEdge(route[v - 1], route[v]));
+                visited[route[v]] = visit;
+                length += v > 0 && valid ? this->graph->getWeight(route[v - 1], route[v]) : 0;
+            }
+            mismatches += !valid || fabs(length - routes[i][j].first) > 1e-6 ? 1 : 0;
+        }
+    }
+
+    out << "K shortest paths: " << ALTERNATIVE_QUERIES << " queries for " << ALTERNATIVE_ROUTES << " routes on " << this->pool->getNumWorkers()
+        << " workers, point to point searches " << searchSeconds << " s (" << searchSettled / ALTERNATIVE_QUERIES << " settled each), k shortest "
+        << routesSeconds << " s (" << routesSettled / ALTERNATIVE_QUERIES << " settled each, " << (double) numRoutes / ALTERNATIVE_QUERIES
+        << " routes, " << numShortcuts / ALTERNATIVE_QUERIES << " spurs completed and " << numPruned / ALTERNATIVE_QUERIES
+        << " pruned without searching each), " << routesSeconds / searchSeconds << " times a point to point search, " << mismatches << " mismatches" << endl;
+}
+
+/// \brief
+/// Makes random what-if edits to the graph, adding shortcut roads, closing roads and doubling or halving
+/// weights, while a dynamic spanning forest follows them, checking its cost and number of trees against the
+/// forest built from scratch at intervals, then putting every edit back
+///
+/// \param out ostream& - the output the report is written to
+///
+void Benchmark::benchmarkDynamicSpanningForest(ostream& out) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    DynamicSpanningForest forest(this->graph);
+    double buildSeconds = secondsSince(start);
+
+    vector<unsigned int> changedSources;
+    vector<unsigned int> changedDestinations;
+    vector<double> originalWeights;
+    unsigned long scanned = 0;
+    unsigned int numReplacements = 0;
+    unsigned int mismatches = 0;
+    double updateSeconds = 0;
+
+    srand(BENCHMARK_SEED);
+    for (unsigned int i = 0; i < FOREST_EDITS; i++) {
+        unsigned int uId = rand() % this->numCities;
+        vector<unsigned int>* adjacent = this->graph->getNeighbours(uId);
+        if (adjacent->size() == 0) {
+            continue;
+        }
+        unsigned int vId = (*adjacent)[rand() % adjacent->size()];
+        double weight = this->graph->getWeight(uId, vId);
+
+        // A shortcut joins a vertex to a neighbour of its neighbour a little more cheaply than going round
+        if (i % 4 == 0) {
+            vector<unsigned int>* further = this->graph->getNeighbours(vId);
+            unsigned int wId = (*further)[rand() % further->size()];
+            if (wId == uId || this->graph->hasEdge(uId, wId)) {
+                continue;
+            }
+            weight = 0.9 * (weight + this->graph->getWeight(vId, wId));
+            vId = wId;
+        }
+        changedSources.push_back(uId);
+        changedDestinations.push_back(vId);
+        originalWeights.push_back(i % 4 == 0 ? GraphObserver::NO_EDGE : weight);
+
+        chrono::steady_clock::time_point updateStart = chrono::steady_clock::now();
+        if (i % 4 == 1) {
+            this->graph->removeEdge(uId, vId);
+        }
+        else {
+            double changed = i % 4 == 0 ? weight : i % 4 == 2 ? weight * 2.0 : weight * 0.5;
+            this->graph->addEdge(new Edge(this->graph->getVertex(uId), this->graph->getVertex(vId), changed));
+        }
+        updateSeconds += secondsSince(updateStart);
+        scanned += forest.getNumScanned();
+        numReplacements += forest.getNumScanned() > 0 ? 1 : 0;
+
+        if ((i + 1) % (FOREST_EDITS / FOREST_CHECKS) == 0) {
+            DynamicSpanningForest rebuilt(this->graph);
+            if (fabs(rebuilt.getCost() - forest.getCost()) > 1e-9 * rebuilt.getCost() || rebuilt.getNumTrees() != forest.getNumTrees()) {
+                mismatches++;
+            }
+        }
+    }
+
+    // Put the graph back the way it was, newest edit first
+    unsigned int numTrees = forest.getNumTrees();
+    for (unsigned int i = changedSources.size(); i > 0; i--) {
+        if (originalWeights[i - 1] == GraphObserver::NO_EDGE) {
+            this->graph->removeEdge(changedSources[i - 1], changedDestinations[i - 1]);
+        }
+        else {
+            this->graph->addEdge(new Edge(this->graph->getVertex(changedSources[i - 1]),
+                                          this->graph->getVertex(changedDestinations[i - 1]), originalWeights[i - 1]));
+        }
+    }
+    DynamicSpanningForest restored(this->graph);
+    if (fabs(restored.getCost() - forest.getCost()) > 1e-9 * restored.getCost() || restored.getNumTrees() != forest.getNumTrees()) {
+        mismatches++;
+    }
+
+    out << "Dynamic spanning forest: built from scratch in " << buildSeconds << " s; " << changedSources.size() << " edits in " << updateSeconds
+        << " s (" << changedSources.size() / (updateSeconds > 0 ? updateSeconds : 1e-9) << " per second), " << numReplacements
+        << " needed a replacement edge, " << scanned / (numReplacements > 0 ? numReplacements : 1) << " vertices and edges scanned each, "
+        << numTrees << " trees after the edits, " << mismatches << " mismatches" << endl;
+}
+
+/// \brief
+/// Returns the number of seconds since a point in time
+///
+/// \param start chrono::steady_clock::time_point - the point in time timing began
+/// \return double - the number of seconds elapsed
+///
+double Benchmark::secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,72 @@
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "cachemisscounter.h"
+
+/// This class counts the cache misses of the calling thread through the hardware counters of the
+/// processor. Counters are often unavailable, in virtual machines or where the kernel forbids them, so
+/// callers check isAvailable and report timings alone when it is false.
+///
+
+/// \brief
+/// Opens a counter of the last level cache misses of the calling thread
+///
+CacheMissCounter::CacheMissCounter() {
+    struct perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.size = sizeof(attributes);
+    attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+
+    // There is no library wrapper for this system call
+    this->descriptor = syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0);
+}
+
+/// \brief
+/// Closes the counter
+///
+CacheMissCounter::~CacheMissCounter() {
+    if (this->descriptor >= 0) {
+        close(this->descriptor);
+    }
+}
+
+/// \brief
+/// Returns whether the counter could be opened
+///
+/// \return bool - true if the processor's cache misses can be counted
+///
+bool CacheMissCounter::isAvailable() {
+    return this->descriptor >= 0;
+}
+
+/// \brief
+/// Sets the count to zero and starts counting
+///
+void CacheMissCounter::start() {
+    if (this->descriptor >= 0) {
+        ioctl(this->descriptor, PERF_EVENT_IOC_RESET, 0);
+        ioctl(this->descriptor, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+/// \brief
+/// Stops counting and returns the number of cache misses since start was called
+///
+/// \return unsigned long long - the number of cache misses, or zero if the counter is unavailable
+///
+unsigned long long CacheMissCounter::stop() {
+    unsigned long long count = 0;
+    if (this->descriptor >= 0) {
+        ioctl(this->descriptor, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(this->descriptor, &count, sizeof(count)) != sizeof(count)) {
+            count = 0;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,309 @@
+#include <atomic>
+#include <algorithm>
+#include "componentindex.h"
+
+/// This class labels every vertex with the connected component it belongs to, so whether one vertex can
+/// reach another is known without searching. The labels are worked out once by the workers together and
+/// then kept up to date as edges are added or removed: a new edge between two components moves the
+/// smaller one into the larger, and a removed edge searches outwards from both of its ends at once until
+/// they meet or one side runs out, which then becomes a component of its own. The index attaches itself
+/// to the graph so every search of the graph can skip the vertices a source cannot reach.
+///
+
+const unsigned int RANGES_PER_WORKER = 4;
+
+/// \brief
+/// Returns the root of the tree a vertex is in while other threads may be linking roots, pointing
+/// each vertex passed at its grandparent on the way
+///
+/// \param parents vector< atomic<unsigned int> >& - the parent of every vertex
+/// \param identifier unsigned int - the identifier of the vertex
+/// \return unsigned int - the identifier of the root
+///
+static unsigned int findRoot(vector< atomic<unsigned int> >& parents, unsigned int identifier) {
+    unsigned int parent = parents[identifier].load();
+    while (parent != identifier) {
+        unsigned int grandparent = parents[parent].load();
+
+        // Losing the race only means another thread shortened the path first
+        parents[identifier].compare_exchange_weak(parent, grandparent);
+        identifier = grandparent;
+        parent = parents[identifier].load();
+    }
+    return identifier;
+}
+
+/// \brief
+/// Puts two vertices in the same tree. Roots are only ever linked below a root with a smaller
+/// identifier, so threads linking at the same time can never make a cycle
+///
+/// \param parents vector< atomic<unsigned int> >& - the parent of every vertex
+/// \param sourceId unsigned int - the identifier of the first vertex
+/// \param destinationId unsigned int - the identifier of the second vertex
+///
+static void linkRoots(vector< atomic<unsigned int> >& parents, unsigned int sourceId, unsigned int destinationId) {
+    while (true) {
+        unsigned int i = findRoot(parents, sourceId);
+        unsigned int j = findRoot(parents, destinationId);
+        if (i == j) {
+            return;
+        }
+        if (i < j) {
+            swap(i, j);
+        }
+
+        // Fails if another thread gave i a parent since it was found, in which case try again from the new roots
+        unsigned int expected = i;
+        if (parents[i].compare_exchange_strong(expected, j)) {
+            return;
+        }
+    }
+}
+
+/// \brief
+/// Labels the components of the graph and attaches the index to it
+///
+/// \param graph Graph* - the graph the components are kept for
+/// \param pool WorkerPool* - the workers the labelling is shared between
+///
+ComponentIndex::ComponentIndex(Graph* graph, WorkerPool* pool) {
+    this->graph = graph;
+    this->generation = 0;
+    unsigned int numVertices = graph->getNumVertices();
+
+    unsigned int numRanges = pool->getNumWorkers() * RANGES_PER_WORKER;
+    if (numRanges > numVertices) {
+        numRanges = numVertices;
+    }
+
+    // Every vertex starts as a tree of its own, then each range links the ends of its vertices' edges
+    vector< atomic<unsigned int> > parents(numVertices);
+    pool->parallelFor(numRanges, [&](unsigned int range) {
+        unsigned int first = (unsigned long) range * numVertices / numRanges;
+        unsigned int last = (unsigned long) (range + 1) * numVertices / numRanges;
+        for (unsigned int uId = first; uId < last; uId++) {
+            parents[uId].store(uId);
+        }
+    });
+    pool->parallelFor(numRanges, [&](unsigned int range) {
+        unsigned int first = (unsigned long) range * numVertices / numRanges;
+        unsigned int last = (unsigned long) (range + 1) * numVertices / numRanges;
+        for (unsigned int uId = first; uId < last; uId++) {
+            vector<unsigned int>* adjacent = graph->getNeighbours(uId);
+            for (unsigned int i = 0; i < adjacent->size(); i++) {
+                if ((*adjacent)[i] > uId) {
+                    linkRoots(parents, uId, (*adjacent)[i]);
+                }
+            }
+        }
+    });
+
+    // Number the roots in order so the labels run from zero, then label every vertex with its root's number
+    this->labels.resize(numVertices);
+    this->numComponents = 0;
+    for (unsigned int uId = 0; uId < numVertices; uId++) {
+        if (parents[uId].load() == uId) {
+            this->labels[uId] = this->numComponents++;
+        }
+    }
+    pool->parallelFor(numRanges, [&](unsigned int range) {
+        unsigned int first = (unsigned long) range * numVertices / numRanges;
+        unsigned int last = (unsigned long) (range + 1) * numVertices / numRanges;
+        for (unsigned int uId = first; uId < last; uId++) {
+            unsigned int root = findRoot(parents, uId);
+            if (root != uId) {
+                this->labels[uId] = this->labels[root];
+            }
+        }
+    });
+
+    this->members.resize(this->numComponents);
+    this->positions.resize(numVertices);
+    for (unsigned int uId = 0; uId < numVertices; uId++) {
+        this->positions[uId] = this->members[this->labels[uId]].size();
+        this->members[this->labels[uId]].push_back(uId);
+    }
+
+    graph->addObserver(this);
+    graph->setComponentIndex(this);
+}
+
+/// \brief
+/// Detaches the index from the graph
+///
+ComponentIndex::~ComponentIndex() {
+    this->graph->removeObserver(this);
+    if (this->graph->getComponentIndex() == this) {
+        this->graph->setComponentIndex(NULL);
+    }
+}
+
+/// \brief
+/// Returns the label of the component a vertex belongs to
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \return unsigned int - the component label, shared by every vertex of the component
+///
+unsigned int ComponentIndex::getComponent(unsigned int identifier) {
+    return this->labels[identifier];
+}
+
+/// \brief
+/// Returns whether there is a path between two vertices
+///
+/// \param sourceId unsigned int - the identifier of the first vertex
+/// \param destinationId unsigned int - the identifier of the second vertex
+/// \return bool - true if both vertices are in the same component
+///
+bool ComponentIndex::isReachable(unsigned int sourceId, unsigned int destinationId) {
+    return this->labels[sourceId] == this->labels[destinationId];
+}
+
+/// \brief
+/// Returns the number of vertices in the component of a vertex
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \return unsigned int - the size of its component, including the vertex itself
+///
+unsigned int ComponentIndex::getComponentSize(unsigned int identifier) {
+    return this->members[this->labels[identifier]].size();
+}
+
+/// \brief
+/// Returns the number of components within the graph
+///
+/// \return unsigned int - the number of components
+///
+unsigned int ComponentIndex::getNumComponents() {
+    return this->numComponents;
+}
+
+/// \brief
+/// Joins or splits components when an edge is added or removed; weight changes leave them as they are
+///
+/// \param sourceId unsigned int - the identifier of the first vertex of the edge
+/// \param destinationId unsigned int - the identifier of the second vertex of the edge
+/// \param oldWeight double - the weight before the change, or NO_EDGE if the edge is new
+/// \param newWeight double - the weight after the change, or NO_EDGE if the edge was removed
+///
+void ComponentIndex::edgeChanged(unsigned int sourceId, unsigned int destinationId, double oldWeight, double newWeight) {
+    if (oldWeight == NO_EDGE && newWeight != NO_EDGE) {
+        join(sourceId, destinationId);
+    }
+    else if (oldWeight != NO_EDGE && newWeight == NO_EDGE) {
+        split(sourceId, destinationId);
+    }
+}
+
+/// \brief
+/// Moves the smaller of two components into the larger
+///
+/// \param sourceId unsigned int - the identifier of a vertex of the first component
+/// \param destinationId unsigned int - the identifier of a vertex of the second component
+///
+void ComponentIndex::join(unsigned int sourceId, unsigned int destinationId) {
+    unsigned int kept = this->labels[sourceId];
+    unsigned int moved = this->labels[destinationId];
+    if (kept == moved) {
+        return;
+    }
+    if (this->members[kept].size() < this->members[moved].size()) {
+        swap(kept, moved);
+    }
+
+    // Each vertex moves at most log n times, as the component it moves into is always at least twice as big
+    vector<unsigned int>& from = this->members[moved];
+    for (unsigned int i = 0; i < from.size(); i++) {
+        this->labels[from[i]] = kept;
+        this->positions[from[i]] = this->members[kept].size();
+        this->members[kept].push_back(from[i]);
+    }
+    vector<unsigned int>().swap(from);
+    this->freeLabels.push_back(moved);
+    this->numComponents--;
+}
+
+/// \brief
+/// Gives the vertices on one side of a removed edge a component of their own if the edge was the
+/// only connection between them and the other side
+///
+/// \param sourceId unsigned int - the identifier of the first vertex of the removed edge
+/// \param destinationId unsigned int - the identifier of the second vertex of the removed edge
+///
+void ComponentIndex::split(unsigned int sourceId, unsigned int destinationId) {
+    if (sourceId == destinationId) {
+        return;
+    }
+
+    // Moving to a new generation makes every vertex unseen without visiting them
+    if (this->seen[0].size() != this->labels.size()) {
+        this->seen[0].assign(this->labels.size(), 0);
+        this->seen[1].assign(this->labels.size(), 0);
+    }
+    this->generation++;
+    if (this->generation == 0) {
+        this->seen[0].assign(this->labels.size(), 0);
+        this->seen[1].assign(this->labels.size(), 0);
+        this->generation = 1;
+    }
+
+    // Search from both ends a vertex at a time, so the work done is bounded by the smaller side
+    vector<unsigned int> reached[2];
+    unsigned int next[2] = { 0, 0 };
+    reached[0].push_back(sourceId);
+    reached[1].push_back(destinationId);
+    this->seen[0][sourceId] = this->generation;
+    this->seen[1][destinationId] = this->generation;
+
+    int separated = -1;
+    while (separated == -1) {
+        for (unsigned int side = 0; side < 2 && separated == -1; side++) {
+            if (next[side] == reached[side].size()) {
+                separated = side;
+                break;
+            }
+
+            vector<unsigned int>* adjacent = this->graph->getNeighbours(reached[side][next[side]++]);
+            for (unsigned int i = 0; i < adjacent->size(); i++) {
+                unsigned int vId = (*adjacent)[i];
+
+                // The two searches have met so the ends are still connected
+                if (this->seen[1 - side][vId] == this->generation) {
+                    return;
+                }
+                if (this->seen[side][vId] != this->generation) {
+                    this->seen[side][vId] = this->generation;
+                    reached[side].push_back(vId);
+                }
+            }
+        }
+    }
+
+    // The side that ran out is everything still connected to its end
+    unsigned int oldLabel = this->labels[sourceId];
+    unsigned int newLabel;
+    if (this->freeLabels.empty()) {
+        newLabel = this->members.size();
+        this->members.push_back(vector<unsigned int>());
+    }
+    else {
+        newLabel = this->freeLabels.back();
+        this->freeLabels.pop_back();
+    }
+
+    // Only the vertices that move are taken out of the old members, each by moving the last member into
+    // its place, so the larger side is never looked at
+    vector<unsigned int>& remaining = this->members[oldLabel];
+    for (unsigned int i = 0; i < reached[separated].size(); i++) {
+        unsigned int vId = reached[separated][i];
+        unsigned int last = remaining.back();
+        remaining[this->positions[vId]] = last;
+        this->positions[last] = this->positions[vId];
+        remaining.pop_back();
+
+        this->labels[vId] = newLabel;
+        this->positions[vId] = i;
+    }
+    this->members[newLabel].swap(reached[separated]);
+    this->numComponents++;
+}
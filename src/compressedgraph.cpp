@@ -0,0 +1,274 @@
+#include <cmath>
+#include <queue>
+#include <algorithm>
+#include <functional>
+#include "compressedgraph.h"
+
+/// This class is a read only copy of a graph compressed for graphs too large to hold as flat arrays.
+/// The edges of each vertex are sorted by target and written to one byte stream as variable length
+/// integers: the number of edges, then each target as the gap from the one before it (the first as a
+/// signed gap from the vertex itself) followed by its weight rounded to a whole number of quanta.
+/// Small gaps and weights take a single byte, and searches decode each list as they scan it.
+///
+/// The start of each vertex's list is found from a 64 bit offset shared by a block of vertices and
+/// a 32 bit offset within the block, so the stream may grow beyond 4 GB.
+///
+
+const unsigned int CompressedGraph::UNREACHED = 0xFFFFFFFF;
+
+/// The number of vertices that share a 64 bit offset into the stream
+const unsigned int COMPRESSED_BLOCK_SIZE = 64;
+
+/// \brief
+/// Appends an integer to a stream seven bits at a time, lowest first, with the top bit of each byte
+/// set when more bytes follow
+///
+/// \param value unsigned long long - the integer to be written
+/// \param stream vector<unsigned char>* - the stream it is appended to
+///
+static void writeVarint(unsigned long long value, vector<unsigned char>* stream) {
+    while (value >= 0x80) {
+        stream->push_back((unsigned char) (value | 0x80));
+        value >>= 7;
+    }
+    stream->push_back((unsigned char) value);
+}
+
+/// \brief
+/// Reads an integer written by writeVarint and moves past it. Most gaps and weights fit in one or two
+/// bytes, so those are decoded before falling into the general loop
+///
+/// \param position const unsigned char*& - the start of the integer, moved to the byte after it
+/// \return unsigned long long - the integer
+///
+static inline unsigned long long readVarint(const unsigned char*& position) {
+    unsigned long long value = position[0];
+    if (value < 0x80) {
+        position++;
+        return value;
+    }
+    value = (value & 0x7F) | ((unsigned long long) (position[1] & 0x7F) << 7);
+    if (position[1] < 0x80) {
+        position += 2;
+        return value;
+    }
+
+    unsigned int shift = 14;
+    position += 2;
+    while (true) {
+        unsigned char byte = *position++;
+        value |= (unsigned long long) (byte & 0x7F) << shift;
+        if (byte < 0x80) {
+            return value;
+        }
+        shift += 7;
+    }
+}
+
+/// \brief
+/// Compresses the edges of a graph
+///
+/// \param graph Graph* - the graph to be compressed
+/// \param quantum double - the weights are stored as whole multiples of this amount
+///
+CompressedGraph::CompressedGraph(Graph* graph, double quantum) {
+    this->numVertices = graph->getNumVertices();
+    this->numEdges = 0;
+    this->quantum = quantum;
+    this->vertexOffsets.resize(this->numVertices);
+    this->blockOffsets.resize((this->numVertices + COMPRESSED_BLOCK_SIZE - 1) / COMPRESSED_BLOCK_SIZE);
+
+    vector<unsigned int> targets;
+    for (unsigned int uId = 0; uId < this->numVertices; uId++) {
+        if (uId % COMPRESSED_BLOCK_SIZE == 0) {
+            this->blockOffsets[uId / COMPRESSED_BLOCK_SIZE] = this->stream.size();
+        }
+        this->vertexOffsets[uId] = this->stream.size() - this->blockOffsets[uId / COMPRESSED_BLOCK_SIZE];
+
+        // Sorted targets leave only small positive gaps between them
+        targets = *graph->getNeighbours(uId);
+        sort(targets.begin(), targets.end());
+        writeVarint(targets.size(), &this->stream);
+        this->numEdges += targets.size();
+
+        for (unsigned int i = 0; i < targets.size(); i++) {
+            if (i == 0) {
+
+                // The first target may lie either side of the vertex, so its sign goes in the lowest bit
+                long long gap = (long long) targets[0] - uId;
+                writeVarint(gap < 0 ? ((unsigned long long) -gap << 1) - 1 : (unsigned long long) gap << 1, &this->stream);
+            }
+            else {
+                writeVarint(targets[i] - targets[i - 1], &this->stream);
+            }
+            writeVarint((unsigned long long) floor(graph->getWeight(uId, targets[i]) / quantum + 0.5), &this->stream);
+        }
+    }
+
+    vector<unsigned char>(this->stream).swap(this->stream);
+}
+
+/// \brief
+/// There was no dynamically created items in this class so there is no need for a destructor method body
+///
+CompressedGraph::~CompressedGraph() {
+}
+
+/// \brief
+/// Returns the number of vertices within the graph
+///
+/// \return unsigned int - the number of vertices
+///
+unsigned int CompressedGraph::getNumVertices() {
+    return this->numVertices;
+}
+
+/// \brief
+/// Returns the number of edges, counting each direction of an edge once
+///
+/// \return unsigned long - the number of stored edges
+///
+unsigned long CompressedGraph::getNumEdges() {
+    return this->numEdges;
+}
+
+/// \brief
+/// Returns the amount the weights are stored as multiples of
+///
+/// \return double - the quantum
+///
+double CompressedGraph::getQuantum() {
+    return this->quantum;
+}
+
+/// \brief
+/// Decodes the edges leaving a vertex
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \param targets vector<unsigned int>* - filled with the other end of each edge, in ascending order
+/// \param weights vector<double>* - filled with the quantised weight of each edge
+///
+void CompressedGraph::getEdges(unsigned int identifier, vector<unsigned int>* targets, vector<double>* weights) {
+    const unsigned char* position = listOf(identifier);
+    unsigned long long degree = readVarint(position);
+    targets->resize(degree);
+    weights->resize(degree);
+
+    unsigned long long first = degree > 0 ? readVarint(position) : 0;
+    unsigned int target = (first & 1) ? identifier - (unsigned int) ((first + 1) >> 1) : identifier + (unsigned int) (first >> 1);
+    for (unsigned long long i = 0; i < degree; i++) {
+        if (i > 0) {
+            target += readVarint(position);
+        }
+        (*targets)[i] = target;
+        (*weights)[i] = readVarint(position) * this->quantum;
+    }
+}
+
+/// \brief
+/// Finds the shortest distance from a source to every vertex, adding up the quantised weights exactly
+///
+/// \param sourceId unsigned int - the identifier of the source
+/// \param distances vector<double>* - filled with the distance to each vertex, or
+/// ShortestPathTree::UNREACHABLE if there is no path
+///
+void CompressedGraph::shortestDistances(unsigned int sourceId, vector<double>* distances) {
+    typedef pair<unsigned long long, unsigned int> QueueEntry;
+    const unsigned long long UNREACHED_QUANTA = ~0ULL;
+
+    // Distances are counted in whole quanta, so sums are exact and comparisons cheap
+    vector<unsigned long long> quanta(this->numVertices, UNREACHED_QUANTA);
+    priority_queue< QueueEntry, vector<QueueEntry>, greater<QueueEntry> > unvisitedVerticesQueue;
+    quanta[sourceId] = 0;
+    unvisitedVerticesQueue.push(QueueEntry(0, sourceId));
+
+    while (!unvisitedVerticesQueue.empty()) {
+        QueueEntry closest = unvisitedVerticesQueue.top();
+        unvisitedVerticesQueue.pop();
+        unsigned int uId = closest.second;
+        if (closest.first != quanta[uId]) {
+            continue;
+        }
+
+        const unsigned char* position = listOf(uId);
+        unsigned long long degree = readVarint(position);
+        if (degree == 0) {
+            continue;
+        }
+        unsigned long long first = readVarint(position);
+        unsigned int target = (first & 1) ? uId - (unsigned int) ((first + 1) >> 1) : uId + (unsigned int) (first >> 1);
+
+        for (unsigned long long i = 0; i < degree; i++) {
+            if (i > 0) {
+                target += readVarint(position);
+            }
+            unsigned long long through = closest.first + readVarint(position);
+            if (through < quanta[target]) {
+                quanta[target] = through;
+                unvisitedVerticesQueue.push(QueueEntry(through, target));
+            }
+        }
+    }
+
+    distances->resize(this->numVertices);
+    for (unsigned int i = 0; i < this->numVertices; i++) {
+        (*distances)[i] = quanta[i] == UNREACHED_QUANTA ? ShortestPathTree::UNREACHABLE : quanta[i] * this->quantum;
+    }
+}
+
+/// \brief
+/// Finds the fewest edges from a source to every vertex
+///
+/// \param sourceId unsigned int - the identifier of the source
+/// \param hops vector<unsigned int>* - filled with the number of edges to each vertex, or UNREACHED
+///
+void CompressedGraph::hopDistances(unsigned int sourceId, vector<unsigned int>* hops) {
+    hops->assign(this->numVertices, UNREACHED);
+    vector<unsigned int> queue(1, sourceId);
+    (*hops)[sourceId] = 0;
+
+    // The queue only grows, so it is read from the front without removing anything
+    for (unsigned int head = 0; head < queue.size(); head++) {
+        unsigned int uId = queue[head];
+        const unsigned char* position = listOf(uId);
+        unsigned long long degree = readVarint(position);
+        if (degree == 0) {
+            continue;
+        }
+        unsigned long long first = readVarint(position);
+        unsigned int target = (first & 1) ? uId - (unsigned int) ((first + 1) >> 1) : uId + (unsigned int) (first >> 1);
+
+        for (unsigned long long i = 0; i < degree; i++) {
+            if (i > 0) {
+                target += readVarint(position);
+            }
+
+            // The weight is not needed, only stepped over
+            readVarint(position);
+            if ((*hops)[target] == UNREACHED) {
+                (*hops)[target] = (*hops)[uId] + 1;
+                queue.push_back(target);
+            }
+        }
+    }
+}
+
+/// \brief
+/// Returns the number of bytes used by the stream and the offsets into it
+///
+/// \return unsigned long - the memory used in bytes
+///
+unsigned long CompressedGraph::memoryUsage() {
+    return this->stream.size() + this->blockOffsets.size() * sizeof(unsigned long long)
+        + this->vertexOffsets.size() * sizeof(unsigned int);
+}
+
+/// \brief
+/// Returns the start of a vertex's list within the stream
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \return const unsigned char* - a pointer to the number of edges that begins the list
+///
+const unsigned char* CompressedGraph::listOf(unsigned int identifier) {
+    return &this->stream[this->blockOffsets[identifier / COMPRESSED_BLOCK_SIZE] + this->vertexOffsets[identifier]];
+}
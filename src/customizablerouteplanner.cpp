@@ -0,0 +1,298 @@
+#include <chrono>
+#include "customizablerouteplanner.h"
+#include "componentindex.h"
+
+/// This class answers point to point distance queries over an overlay built on a multilevel partition.
+/// Finding the boundary vertices of each cell depends only on which edges exist and is done once. The
+/// distances across each cell between its boundary vertices depend on the weights and are found by
+/// customise, which can be run again in parallel whenever the weights change. Queries search the
+/// original edges near the source and target and jump across the cells in between.
+///
+
+/// \brief
+/// Finds the boundary vertices of every cell. Edges added between cells afterwards need a new planner
+///
+/// \param graph Graph* - the graph the weights are taken from
+/// \param partition MultilevelPartition* - the cells of the graph, which must already be built
+///
+CustomizableRoutePlanner::CustomizableRoutePlanner(Graph* graph, MultilevelPartition* partition) {
+    unsigned int numVertices = graph->getNumVertices();
+
+    this->graph = graph;
+    this->partition = partition;
+    this->numLevels = partition->getNumLevels();
+    this->customisationSeconds = 0;
+    this->numSettled = 0;
+
+    this->cellBoundaries.resize(this->numLevels);
+    this->boundaryIndices.assign(this->numLevels, vector<int>(numVertices, -1));
+    this->cliques.resize(this->numLevels);
+
+    // A vertex is on the boundary of its cell at a level if it has an edge into another cell at that level
+    for (unsigned int level = 0; level < this->numLevels; level++) {
+        this->cellBoundaries[level].resize(partition->getNumCells(level));
+        this->cliques[level].resize(partition->getNumCells(level));
+
+        for (unsigned int uId = 0; uId < numVertices; uId++) {
+            unsigned int cell = partition->getCell(level, uId);
+            vector<unsigned int>* adjacent = graph->getNeighbours(uId);
+
+            for (unsigned int i = 0; i < adjacent->size(); i++) {
+                if (partition->getCell(level, (*adjacent)[i]) != cell) {
+                    this->boundaryIndices[level][uId] = this->cellBoundaries[level][cell].size();
+                    this->cellBoundaries[level][cell].push_back(uId);
+                    break;
+                }
+            }
+        }
+    }
+
+    this->querySearch.distances.resize(numVertices);
+    this->querySearch.reachedGeneration.assign(numVertices, 0);
+    this->querySearch.generation = 0;
+}
+
+/// \brief
+/// There was no dynamically created items in this class so there is no need for a destructor method body
+///
+CustomizableRoutePlanner::~CustomizableRoutePlanner() {}
+
+/// \brief
+/// Computes the distances between the boundary vertices of every cell from the current weights of
+/// the graph, a level at a time from the smallest cells up, sharing the cells of each level between the workers
+///
+/// \param pool WorkerPool* - the workers the cells are shared between
+///
+void CustomizableRoutePlanner::customise(WorkerPool* pool) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    unsigned int numLanes = pool->getNumWorkers() + 1;
+    vector<OverlaySearch> searches(numLanes);
+
+    for (unsigned int lane = 0; lane < numLanes; lane++) {
+        searches[lane].distances.resize(this->graph->getNumVertices());
+        searches[lane].reachedGeneration.assign(this->graph->getNumVertices(), 0);
+        searches[lane].generation = 0;
+    }
+
+    // Each level is built from the cliques of the level below so the levels are done in order
+    for (unsigned int level = 0; level < this->numLevels; level++) {
+        unsigned int numCells = this->partition->getNumCells(level);
+
+        pool->parallelFor(numLanes, [this, level, numCells, numLanes, &searches](unsigned int lane) {
+            for (unsigned int cell = lane; cell < numCells; cell += numLanes) {
+                customiseCell(level, cell, &searches[lane]);
+            }
+        });
+    }
+
+    this->customisationSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/// \brief
+/// Returns the shortest path distance between two vertices. Only one query may run at a time
+///
+/// \param sourceId unsigned int - the identifier of the source vertex
+/// \param destinationId unsigned int - the identifier of the destination vertex
+/// \return double - the distance, or ShortestPathTree::UNREACHABLE if there is no path
+///
+double CustomizableRoutePlanner::distance(unsigned int sourceId, unsigned int destinationId) {
+    OverlaySearch* search = &this->querySearch;
+    this->numSettled = 0;
+
+    ComponentIndex* components = this->graph->getComponentIndex();
+    if (components != NULL && !components->isReachable(sourceId, destinationId)) {
+        return ShortestPathTree::UNREACHABLE;
+    }
+    startSearch(search, sourceId);
+
+    while (!search->unvisitedVerticesQueue.empty()) {
+        QueueEntry entry = search->unvisitedVerticesQueue.top();
+        search->unvisitedVerticesQueue.pop();
+        unsigned int uId = entry.second;
+
+        if (entry.first > search->distances[uId]) {
+            continue;
+        }
+        this->numSettled++;
+        if (uId == destinationId) {
+            return entry.first;
+        }
+
+        int level = queryLevel(uId, sourceId, destinationId);
+        vector<unsigned int>* adjacent = this->graph->getNeighbours(uId);
+
+        // Near the source and destination every original edge is used
+        if (level < 0 || this->boundaryIndices[level][uId] < 0) {
+            for (unsigned int i = 0; i < adjacent->size(); i++) {
+                relax(search, (*adjacent)[i], entry.first + this->graph->getWeight(uId, (*adjacent)[i]));
+            }
+            continue;
+        }
+
+        // Elsewhere jump across the vertex's cell to its other boundary vertices
+        unsigned int cell = this->partition->getCell(level, uId);
+        vector<unsigned int>& boundaries = this->cellBoundaries[level][cell];
+        double* row = &this->cliques[level][cell][this->boundaryIndices[level][uId] * boundaries.size()];
+        for (unsigned int i = 0; i < boundaries.size(); i++) {
+            relax(search, boundaries[i], entry.first + row[i]);
+        }
+
+        // and follow the edges leaving the cell
+        for (unsigned int i = 0; i < adjacent->size(); i++) {
+            if (this->partition->getCell(level, (*adjacent)[i]) != cell) {
+                relax(search, (*adjacent)[i], entry.first + this->graph->getWeight(uId, (*adjacent)[i]));
+            }
+        }
+    }
+    return ShortestPathTree::UNREACHABLE;
+}
+
+/// \brief
+/// Returns the number of boundary vertices at a level
+///
+/// \param level unsigned int - the level, with zero the smallest cells
+/// \return unsigned int - the number of boundary vertices
+///
+unsigned int CustomizableRoutePlanner::getNumBoundaryVertices(unsigned int level) {
+    unsigned int total = 0;
+    for (unsigned int cell = 0; cell < this->cellBoundaries[level].size(); cell++) {
+        total += this->cellBoundaries[level][cell].size();
+    }
+    return total;
+}
+
+/// \brief
+/// Returns the number of seconds the last customisation took
+///
+/// \return double - the customisation time in seconds
+///
+double CustomizableRoutePlanner::getCustomisationSeconds() {
+    return this->customisationSeconds;
+}
+
+/// \brief
+/// Returns the number of vertices settled by the last query
+///
+/// \return unsigned int - the number of settled vertices
+///
+unsigned int CustomizableRoutePlanner::getNumSettled() {
+    return this->numSettled;
+}
+
+/// \brief
+/// Computes the distances between the boundary vertices of one cell, searching inside the cell over the
+/// original edges at level zero or over the cells of the level below otherwise
+///
+/// \param level unsigned int - the level of the cell
+/// \param cell unsigned int - the number of the cell
+/// \param search OverlaySearch* - the working state used for the searches
+///
+void CustomizableRoutePlanner::customiseCell(unsigned int level, unsigned int cell, OverlaySearch* search) {
+    vector<unsigned int>& boundaries = this->cellBoundaries[level][cell];
+    vector<double>& clique = this->cliques[level][cell];
+    unsigned int numBoundaries = boundaries.size();
+
+    clique.assign(numBoundaries * numBoundaries, ShortestPathTree::UNREACHABLE);
+
+    for (unsigned int from = 0; from < numBoundaries; from++) {
+        startSearch(search, boundaries[from]);
+
+        while (!search->unvisitedVerticesQueue.empty()) {
+            QueueEntry entry = search->unvisitedVerticesQueue.top();
+            search->unvisitedVerticesQueue.pop();
+            unsigned int uId = entry.second;
+
+            if (entry.first > search->distances[uId]) {
+                continue;
+            }
+            vector<unsigned int>* adjacent = this->graph->getNeighbours(uId);
+
+            // The smallest cells are searched over their own edges
+            if (level == 0) {
+                for (unsigned int i = 0; i < adjacent->size(); i++) {
+                    if (this->partition->getCell(0, (*adjacent)[i]) == cell) {
+                        relax(search, (*adjacent)[i], entry.first + this->graph->getWeight(uId, (*adjacent)[i]));
+                    }
+                }
+                continue;
+            }
+
+            // Larger cells are searched over the cliques of the cells inside them and the edges between those cells
+            unsigned int subcell = this->partition->getCell(level - 1, uId);
+            vector<unsigned int>& subBoundaries = this->cellBoundaries[level - 1][subcell];
+            double* row = &this->cliques[level - 1][subcell][this->boundaryIndices[level - 1][uId] * subBoundaries.size()];
+            for (unsigned int i = 0; i < subBoundaries.size(); i++) {
+                relax(search, subBoundaries[i], entry.first + row[i]);
+            }
+
+            for (unsigned int i = 0; i < adjacent->size(); i++) {
+                unsigned int vId = (*adjacent)[i];
+                if (this->partition->getCell(level - 1, vId) != subcell && this->partition->getCell(level, vId) == cell) {
+                    relax(search, vId, entry.first + this->graph->getWeight(uId, vId));
+                }
+            }
+        }
+
+        // Record the distance to every other boundary vertex of the cell
+        for (unsigned int to = 0; to < numBoundaries; to++) {
+            if (search->reachedGeneration[boundaries[to]] == search->generation) {
+                clique[from * numBoundaries + to] = search->distances[boundaries[to]];
+            }
+        }
+    }
+}
+
+/// \brief
+/// Returns the highest level at which a vertex is in neither the source's nor the destination's cell
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \param sourceId unsigned int - the identifier of the source vertex
+/// \param destinationId unsigned int - the identifier of the destination vertex
+/// \return int - the level, or -1 if the vertex shares a cell with one of them at every level
+///
+int CustomizableRoutePlanner::queryLevel(unsigned int identifier, unsigned int sourceId, unsigned int destinationId) {
+    for (int level = this->numLevels - 1; level >= 0; level--) {
+        unsigned int cell = this->partition->getCell(level, identifier);
+        if (cell != this->partition->getCell(level, sourceId) && cell != this->partition->getCell(level, destinationId)) {
+            return level;
+        }
+    }
+    return -1;
+}
+
+/// \brief
+/// Starts a new search from a vertex
+///
+/// \param search OverlaySearch* - the working state of the search
+/// \param sourceId unsigned int - the identifier of the source vertex
+///
+void CustomizableRoutePlanner::startSearch(OverlaySearch* search, unsigned int sourceId) {
+    search->generation++;
+    while (!search->unvisitedVerticesQueue.empty()) {
+        search->unvisitedVerticesQueue.pop();
+    }
+    search->reachedGeneration[sourceId] = search->generation;
+    search->distances[sourceId] = 0;
+    search->unvisitedVerticesQueue.push(QueueEntry(0.0, sourceId));
+}
+
+/// \brief
+/// Lowers the distance of a vertex if a shorter way to it has been found
+///
+/// \param search OverlaySearch* - the working state of the search
+/// \param identifier unsigned int - the identifier of the vertex
+/// \param distance double - the length of the new way to the vertex
+///
+void CustomizableRoutePlanner::relax(OverlaySearch* search, unsigned int identifier, double distance) {
+
+    // Boundary vertices a cell cannot connect have no distance to offer
+    if (distance == ShortestPathTree::UNREACHABLE) {
+        return;
+    }
+
+    if (search->reachedGeneration[identifier] != search->generation || distance < search->distances[identifier]) {
+        search->reachedGeneration[identifier] = search->generation;
+        search->distances[identifier] = distance;
+        search->unvisitedVerticesQueue.push(QueueEntry(distance, identifier));
+    }
+}
@@ -0,0 +1,76 @@
+#include "dialqueue.h"
+
+/// This class is Dial's bucket queue for searches whose edge weights are whole numbers no greater than a
+/// known largest weight C. Every key still in the queue lies within C of the last key taken out, so a ring
+/// of C + 1 buckets holds each key in the bucket for its value modulo C + 1. Adding is a push onto a
+/// bucket and taking out scans forward to the next bucket in use, so the work is proportional to the
+/// entries plus the largest key, with no comparisons at all. Keys added must never be smaller than the
+/// last key taken out.
+///
+
+/// \brief
+/// Creates an empty queue for keys that never run more than the largest weight ahead of the smallest
+///
+/// \param maximumWeight unsigned long long - the largest edge weight C
+///
+DialQueue::DialQueue(unsigned long long maximumWeight) {
+    this->buckets.resize(maximumWeight + 1);
+    this->current = 0;
+    this->size = 0;
+}
+
+/// \brief
+/// There was no dynamically created items in this class so there is no need for a destructor method body
+///
+DialQueue::~DialQueue() {}
+
+/// \brief
+/// Adds a vertex with a key
+///
+/// \param key unsigned long long - the key, at least the last key taken out and within C of it
+/// \param identifier unsigned int - the identifier of the vertex
+///
+void DialQueue::push(unsigned long long key, unsigned int identifier) {
+    this->buckets[key % this->buckets.size()].push_back(identifier);
+    this->size++;
+}
+
+/// \brief
+/// Takes out a vertex with the smallest key; the queue must not be empty
+///
+/// \param key unsigned long long* - set to the key
+/// \param identifier unsigned int* - set to the identifier of the vertex
+///
+void DialQueue::pop(unsigned long long* key, unsigned int* identifier) {
+
+    // Every key in the ring is within C of the current one, so the bucket for the current key holds only it
+    vector<unsigned int>* bucket = &this->buckets[this->current % this->buckets.size()];
+    while (bucket->empty()) {
+        this->current++;
+        bucket = &this->buckets[this->current % this->buckets.size()];
+    }
+    *key = this->current;
+    *identifier = bucket->back();
+    bucket->pop_back();
+    this->size--;
+}
+
+/// \brief
+/// Returns whether the queue is empty
+///
+/// \return bool - true if there are no entries
+///
+bool DialQueue::empty() {
+    return this->size == 0;
+}
+
+/// \brief
+/// Empties the queue so it can be used for another search
+///
+void DialQueue::clear() {
+    for (unsigned long i = 0; i < this->buckets.size() && this->size > 0; i++) {
+        this->size -= this->buckets[i].size();
+        this->buckets[i].clear();
+    }
+    this->current = 0;
+}
@@ -0,0 +1,334 @@
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include "distanceoracle.h"
+
+/// This class is the approximate distance oracle of Thorup and Zwick. Vertices are sampled into k nested
+/// levels of centres, each level keeping about n^(-1/k) of the one below, and every vertex keeps its
+/// nearest centre of each level together with a bunch: the centres of each level that are closer to it
+/// than the nearest centre of the level above. A query hops between the two ends, moving up a level each
+/// time, until the nearest centre of one end is in the bunch of the other, and answers with the distance
+/// through that centre. Answers are never shorter than the true distance and at most 2k - 1 times longer,
+/// from about k n^(1 + 1/k) stored distances rather than n^2.
+///
+/// The bunches are found from the other side: each centre's cluster, the vertices that have it in their
+/// bunch, is a Dijkstra search from the centre that goes no further than where the level above is closer.
+/// The searches are shared between the workers. Each bunch is kept as a small open addressing table in one
+/// shared array, so a query looks up at most k centres in constant time each.
+///
+
+const unsigned long long ORACLE_SEED = 12345;
+const unsigned int NO_CENTRE = numeric_limits<unsigned int>::max();
+
+/// A vertex found in the cluster of a centre, and so with the centre in its bunch
+struct ClusterEntry {
+    unsigned int identifier;
+    unsigned int centre;
+    float distance;
+};
+
+/// The working state of one worker's cluster searches, allocated once per build
+struct ClusterSearch {
+    vector<double> distances;
+    vector<unsigned int> reachedGeneration;
+    unsigned int generation;
+    priority_queue< pair<double, unsigned int>, vector< pair<double, unsigned int> >,
+                    greater< pair<double, unsigned int> > > unvisitedVerticesQueue;
+    vector<ClusterEntry> found;
+};
+
+/// \brief
+/// Returns the slot of a bunch's table a centre is looked for first
+///
+/// \param centre unsigned int - the identifier of the centre
+/// \param mask unsigned long - one less than the number of slots in the table, a power of two
+/// \return unsigned long - the first slot to look in
+///
+static unsigned long firstSlot(unsigned int centre, unsigned long mask) {
+    return (centre * 2654435761u) & mask;
+}
+
+/// \brief
+/// Creates an empty oracle for the number of levels given
+///
+/// \param numLevels unsigned int - the number of levels k, giving answers at most 2k - 1 times too long
+///
+DistanceOracle::DistanceOracle(unsigned int numLevels) {
+    this->numLevels = numLevels > 0 ? numLevels : 1;
+    this->numVertices = 0;
+    this->numBunchEntries = 0;
+    this->buildSeconds = 0;
+}
+
+/// \brief
+/// There was no dynamically created items in this class so there is no need for a destructor method body
+///
+DistanceOracle::~DistanceOracle() {}
+
+/// \brief
+/// Samples the centres of every level and works out the nearest centres and bunches of every vertex
+///
+/// \param graph Graph* - the graph the distances are measured on
+/// \param pool WorkerPool* - the workers the searches are shared between
+///
+void DistanceOracle::build(Graph* graph, WorkerPool* pool) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    unsigned int numVertices = graph->getNumVertices();
+    unsigned int numLevels = this->numLevels;
+    this->numVertices = numVertices;
+
+    // Each level keeps every vertex of the level below with the same chance, and never ends up empty
+    vector<unsigned int> levels(numVertices, 0);
+    double chance = pow((double) numVertices, -1.0 / numLevels);
+    unsigned long long state = ORACLE_SEED;
+    for (unsigned int level = 1; level < numLevels; level++) {
+        unsigned int numKept = 0;
+        unsigned int lastBelow = NO_CENTRE;
+        for (unsigned int i = 0; i < numVertices; i++) {
+            if (levels[i] == level - 1) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                lastBelow = i;
+                if ((state >> 11) * (1.0 / 9007199254740992.0) < chance) {
+                    levels[i] = level;
+                    numKept++;
+                }
+            }
+        }
+        if (numKept == 0 && lastBelow != NO_CENTRE) {
+            levels[lastBelow] = level;
+        }
+    }
+
+    // Every vertex is its own nearest centre of the bottom level; the other levels are searched at once
+    this->nearestCentres.assign((size_t) numLevels * numVertices, NO_CENTRE);
+    this->centreDistances.assign((size_t) numLevels * numVertices, ShortestPathTree::UNREACHABLE);
+    for (unsigned int i = 0; i < numVertices; i++) {
+        this->nearestCentres[i] = i;
+        this->centreDistances[i] = 0;
+    }
+    pool->parallelFor(numLevels - 1, [&](unsigned int level) {
+        findNearestCentres(graph, &levels, level + 1);
+    });
+
+    // Where a level's nearest centre is no closer than the level above's, use the one above, so the nearest
+    // centre of every level a query uses is always in the vertex's own bunch
+    for (unsigned int level = numLevels - 1; level > 0; level--) {
+        for (unsigned int i = 0; i < numVertices; i++) {
+            size_t below = (size_t) (level - 1) * numVertices + i;
+            size_t above = (size_t) level * numVertices + i;
+            if (this->centreDistances[below] == this->centreDistances[above]) {
+                this->nearestCentres[below] = this->nearestCentres[above];
+            }
+        }
+    }
+
+    // Grow the cluster of every centre, going no further than where the level above is closer
+    unsigned int numLanes = pool->getNumWorkers();
+    vector<ClusterSearch> searches(numLanes);
+    pool->parallelFor(numLanes, [&](unsigned int lane) {
+        ClusterSearch& search = searches[lane];
+        search.distances.resize(numVertices);
+        search.reachedGeneration.assign(numVertices, 0);
+        search.generation = 0;
+
+        for (unsigned int centre = lane; centre < numVertices; centre += numLanes) {
+            const double* limits = levels[centre] + 1 < numLevels
+                ? &this->centreDistances[(size_t) (levels[centre] + 1) * numVertices] : NULL;
+            search.generation++;
+            search.distances[centre] = 0;
+            search.reachedGeneration[centre] = search.generation;
+            search.unvisitedVerticesQueue.push(make_pair(0.0, centre));
+
+            while (!search.unvisitedVerticesQueue.empty()) {
+                double distance = search.unvisitedVerticesQueue.top().first;
+                unsigned int uId = search.unvisitedVerticesQueue.top().second;
+                search.unvisitedVerticesQueue.pop();
+                if (distance > search.distances[uId]) {
+                    continue;
+                }
+
+                ClusterEntry entry = { uId, centre, (float) distance };
+                search.found.push_back(entry);
+
+                vector<unsigned int>* adjacent = graph->getNeighbours(uId);
+                for (unsigned int i = 0; i < adjacent->size(); i++) {
+                    unsigned int vId = (*adjacent)[i];
+                    double next = distance + graph->getWeight(uId, vId);
+                    if ((limits == NULL || next < limits[vId])
+                        && (search.reachedGeneration[vId] != search.generation || next < search.distances[vId])) {
+                        search.reachedGeneration[vId] = search.generation;
+                        search.distances[vId] = next;
+                        search.unvisitedVerticesQueue.push(make_pair(next, vId));
+                    }
+                }
+            }
+        }
+    });
+
+    // Give every bunch a table at least twice its size, so lookups rarely probe more than once or twice
+    vector<unsigned int> bunchSizes(numVertices, 0);
+    this->numBunchEntries = 0;
+    for (unsigned int lane = 0; lane < numLanes; lane++) {
+        for (unsigned long i = 0; i < searches[lane].found.size(); i++) {
+            bunchSizes[searches[lane].found[i].identifier]++;
+        }
+        this->numBunchEntries += searches[lane].found.size();
+    }
+    this->bunchOffsets.assign(numVertices + 1, 0);
+    for (unsigned int i = 0; i < numVertices; i++) {
+        unsigned long slots = 2;
+        while (slots < 2 * (unsigned long) bunchSizes[i]) {
+            slots *= 2;
+        }
+        this->bunchOffsets[i + 1] = this->bunchOffsets[i] + slots;
+    }
+
+    BunchEntry empty = { NO_CENTRE, 0 };
+    this->bunches.assign(this->bunchOffsets[numVertices], empty);
+    for (unsigned int lane = 0; lane < numLanes; lane++) {
+        vector<ClusterEntry>& found = searches[lane].found;
+        for (unsigned long i = 0; i < found.size(); i++) {
+            BunchEntry* table = &this->bunches[this->bunchOffsets[found[i].identifier]];
+            unsigned long mask = this->bunchOffsets[found[i].identifier + 1] - this->bunchOffsets[found[i].identifier] - 1;
+            unsigned long slot = firstSlot(found[i].centre, mask);
+            while (table[slot].centre != NO_CENTRE) {
+                slot = (slot + 1) & mask;
+            }
+            table[slot].centre = found[i].centre;
+            table[slot].distance = found[i].distance;
+        }
+        vector<ClusterEntry>().swap(found);
+    }
+
+    this->buildSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/// \brief
+/// Returns an approximation of the shortest path distance between two vertices
+///
+/// \param sourceId unsigned int - the identifier of the first vertex
+/// \param destinationId unsigned int - the identifier of the second vertex
+/// \return double - a distance between the true distance and 2k - 1 times it, or
+/// ShortestPathTree::UNREACHABLE if there is no path
+///
+double DistanceOracle::distance(unsigned int sourceId, unsigned int destinationId) {
+    unsigned int level = 0;
+    unsigned int centre = sourceId;
+    float through;
+
+    // Each step up a level adds at most the distance between the two ends to the distance through the centre
+    while ((through = findInBunch(destinationId, centre)) < 0) {
+        level++;
+        if (level == this->numLevels) {
+            return ShortestPathTree::UNREACHABLE;
+        }
+        swap(sourceId, destinationId);
+        centre = this->nearestCentres[(size_t) level * this->numVertices + sourceId];
+        if (centre == NO_CENTRE) {
+            return ShortestPathTree::UNREACHABLE;
+        }
+    }
+    return this->centreDistances[(size_t) level * this->numVertices + sourceId] + through;
+}
+
+/// \brief
+/// Returns the number of levels of centres
+///
+/// \return unsigned int - the number of levels k
+///
+unsigned int DistanceOracle::getNumLevels() {
+    return this->numLevels;
+}
+
+/// \brief
+/// Returns the average number of centres in a bunch
+///
+/// \return double - the average bunch size
+///
+double DistanceOracle::getAverageBunchSize() {
+    return this->numVertices > 0 ? (double) this->numBunchEntries / this->numVertices : 0;
+}
+
+/// \brief
+/// Returns the number of seconds the last build took
+///
+/// \return double - the build time in seconds
+///
+double DistanceOracle::getBuildSeconds() {
+    return this->buildSeconds;
+}
+
+/// \brief
+/// Returns the number of bytes used by the nearest centres and bunches
+///
+/// \return unsigned long - the memory used in bytes
+///
+unsigned long DistanceOracle::memoryUsage() {
+    return this->nearestCentres.size() * sizeof(unsigned int) + this->centreDistances.size() * sizeof(double)
+        + this->bunchOffsets.size() * sizeof(unsigned long) + this->bunches.size() * sizeof(BunchEntry);
+}
+
+/// \brief
+/// Finds the nearest centre of one level to every vertex with a single search from all of its centres
+///
+/// \param graph Graph* - the graph the distances are measured on
+/// \param levels vector<unsigned int>* - the highest level of every vertex
+/// \param level unsigned int - the level whose centres are searched from
+///
+void DistanceOracle::findNearestCentres(Graph* graph, vector<unsigned int>* levels, unsigned int level) {
+    unsigned int* centres = &this->nearestCentres[(size_t) level * this->numVertices];
+    double* distances = &this->centreDistances[(size_t) level * this->numVertices];
+
+    priority_queue< pair<double, unsigned int>, vector< pair<double, unsigned int> >,
+                    greater< pair<double, unsigned int> > > unvisitedVerticesQueue;
+    for (unsigned int i = 0; i < this->numVertices; i++) {
+        if ((*levels)[i] >= level) {
+            centres[i] = i;
+            distances[i] = 0;
+            unvisitedVerticesQueue.push(make_pair(0.0, i));
+        }
+    }
+
+    while (!unvisitedVerticesQueue.empty()) {
+        double distance = unvisitedVerticesQueue.top().first;
+        unsigned int uId = unvisitedVerticesQueue.top().second;
+        unvisitedVerticesQueue.pop();
+        if (distance > distances[uId]) {
+            continue;
+        }
+
+        vector<unsigned int>* adjacent = graph->getNeighbours(uId);
+        for (unsigned int i = 0; i < adjacent->size(); i++) {
+            unsigned int vId = (*adjacent)[i];
+            double next = distance + graph->getWeight(uId, vId);
+            if (next < distances[vId]) {
+                distances[vId] = next;
+                centres[vId] = centres[uId];
+                unvisitedVerticesQueue.push(make_pair(next, vId));
+            }
+        }
+    }
+}
+
+/// \brief
+/// Returns the distance from a vertex to a centre in its bunch
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \param centre unsigned int - the identifier of the centre
+/// \return float - the distance, or a negative value if the centre is not in the bunch
+///
+float DistanceOracle::findInBunch(unsigned int identifier, unsigned int centre) {
+    const BunchEntry* table = &this->bunches[this->bunchOffsets[identifier]];
+    unsigned long mask = this->bunchOffsets[identifier + 1] - this->bunchOffsets[identifier] - 1;
+
+    // Tables are never more than half full so the probing always reaches an empty slot
+    for (unsigned long slot = firstSlot(centre, mask); table[slot].centre != NO_CENTRE; slot = (slot + 1) & mask) {
+        if (table[slot].centre == centre) {
+            return table[slot].distance;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,458 @@
+#include <limits>
+#include <iomanip>
+#include <atomic>
+#include <map>
+#include <algorithm>
+#include "distancetable.h"
+#include "componentindex.h"
+
+/// This class computes the table of shortest path distances from many sources to many targets in one go,
+/// keeping the distances in a single row major array of floats.
+///
+/// Without hub labels the sources are grouped into batches of eight that lie close to one another, and each
+/// batch is searched from by one sweep that holds a distance for every source of the batch at each vertex. A
+/// vertex is taken from the queue by the smallest distance it has yet to pass on, and passes on every distance
+/// of the batch that has improved since it was last taken, so nearby sources share their queue operations and
+/// edge scans instead of repeating them. The sweep stops once every target's distances are final. Batches are
+/// shared out between the workers, each reusing one set of search state for all of its batches.
+///
+/// With hub labels the table needs no search at all: the target labels are gathered into one bucket per hub,
+/// and each row is filled by running through the buckets of the hubs in its source's label.
+///
+
+const unsigned int CHUNKS_PER_WORKER = 4;
+const unsigned int BATCH_SOURCES = 8;
+
+/// \brief
+/// Creates an empty table for the graph
+///
+/// \param graph Graph* - the graph the distances are measured on
+/// \param pool WorkerPool* - the workers the rows are shared between
+///
+DistanceTable::DistanceTable(Graph* graph, WorkerPool* pool) {
+    this->graph = graph;
+    this->pool = pool;
+    this->hubLabels = NULL;
+    this->numRows = 0;
+    this->numColumns = 0;
+    this->numSettled = 0;
+}
+
+/// \brief
+/// There was no dynamically created items in this class so there is no need for a destructor method body
+///
+DistanceTable::~DistanceTable() {}
+
+/// \brief
+/// Gives the table hub labels to fill rows from instead of searching
+///
+/// \param hubLabels HubLabels* - a pointer to labels built for the graph, or NULL to go back to searching
+///
+void DistanceTable::setHubLabels(HubLabels* hubLabels) {
+    this->hubLabels = hubLabels;
+}
+
+/// \brief
+/// Computes the distance from every source to every target
+///
+/// \param sources vector<unsigned int>* - the identifiers of the source vertices, one per row
+/// \param targets vector<unsigned int>* - the identifiers of the target vertices, one per column
+///
+void DistanceTable::compute(vector<unsigned int>* sources, vector<unsigned int>* targets) {
+    this->numRows = sources->size();
+    this->numColumns = targets->size();
+    this->distances.assign((size_t) this->numRows * this->numColumns, numeric_limits<float>::infinity());
+    this->numSettled = 0;
+    if (this->numRows == 0 || this->numColumns == 0) {
+        return;
+    }
+    if (this->hubLabels != NULL) {
+        computeFromLabels(sources, targets);
+        return;
+    }
+
+    // Link the columns of each target vertex so a target's distances fill all of its columns at once
+    vector<int> firstColumn(this->graph->getNumVertices(), -1);
+    vector<int> nextColumn(this->numColumns, -1);
+    vector<unsigned int> targetIds;
+    for (unsigned int column = 0; column < this->numColumns; column++) {
+        unsigned int targetId = (*targets)[column];
+        if (firstColumn[targetId] == -1) {
+            targetIds.push_back(targetId);
+        }
+        nextColumn[column] = firstColumn[targetId];
+        firstColumn[targetId] = column;
+    }
+
+    // With a component index a sweep only waits for the targets each of its sources can reach
+    ComponentIndex* components = this->graph->getComponentIndex();
+    vector<unsigned int> rowTargets(this->numRows, targetIds.size());
+    if (components != NULL) {
+        map<unsigned int, unsigned int> componentTargets;
+        for (unsigned int i = 0; i < targetIds.size(); i++) {
+            componentTargets[components->getComponent(targetIds[i])]++;
+        }
+        for (unsigned int row = 0; row < this->numRows; row++) {
+            map<unsigned int, unsigned int>::const_iterator found = componentTargets.find(components->getComponent((*sources)[row]));
+            rowTargets[row] = found == componentTargets.end() ? 0 : found->second;
+        }
+    }
+
+    // Sources are only worth sweeping together if they are close, so each batch is the next unbatched source
+    // and the unbatched sources found first by a breadth first search from it
+    vector<unsigned int> batchRows;
+    batchRows.reserve(this->numRows);
+    groupSources(sources, &batchRows);
+
+    // Each worker sweeps every batch a stride apart with the same search state
+    unsigned int numBatches = (this->numRows + BATCH_SOURCES - 1) / BATCH_SOURCES;
+    unsigned int numStates = this->pool->getNumWorkers() < numBatches ? this->pool->getNumWorkers() : numBatches;
+    numStates = numStates > 0 ? numStates : 1;
+    vector<SweepState> states(numStates);
+    this->pool->parallelFor(numStates, [&](unsigned int worker) {
+        SweepState* state = &states[worker];
+        state->distances.resize((size_t) this->graph->getNumVertices() * BATCH_SOURCES);
+        state->improved.assign(this->graph->getNumVertices(), 0);
+        state->touchedGeneration.assign(this->graph->getNumVertices(), 0);
+        state->generation = 0;
+        state->numScanned = 0;
+
+        for (unsigned int batch = worker; batch < numBatches; batch += numStates) {
+            unsigned int first = batch * BATCH_SOURCES;
+            unsigned int numLanes = this->numRows - first < BATCH_SOURCES ? this->numRows - first : BATCH_SOURCES;
+            sweep(state, sources, &batchRows[first], numLanes, &targetIds, &firstColumn, &nextColumn, &rowTargets);
+        }
+    });
+
+    for (unsigned int i = 0; i < numStates; i++) {
+        this->numSettled += states[i].numScanned;
+    }
+}
+
+/// \brief
+/// Returns the number of rows, one per source
+///
+/// \return unsigned int - the number of rows in the table
+///
+unsigned int DistanceTable::getNumRows() {
+    return this->numRows;
+}
+
+/// \brief
+/// Returns the number of columns, one per target
+///
+/// \return unsigned int - the number of columns in the table
+///
+unsigned int DistanceTable::getNumColumns() {
+    return this->numColumns;
+}
+
+/// \brief
+/// Returns the distance from a source to a target
+///
+/// \param row unsigned int - the position of the source in the sources given to compute
+/// \param column unsigned int - the position of the target in the targets given to compute
+/// \return float - the distance, or infinity if the target cannot be reached
+///
+float DistanceTable::getDistance(unsigned int row, unsigned int column) {
+    return this->distances[(size_t) row * this->numColumns + column];
+}
+
+/// \brief
+/// Returns the number of times a vertex passed on distances in the sweeps of the last compute, or the
+/// number of bucket entries read when it used hub labels
+///
+/// \return unsigned long - the number of vertex scans or bucket entries
+///
+unsigned long DistanceTable::getNumSettled() {
+    return this->numSettled;
+}
+
+/// \brief
+/// Writes the table as text, one row per line with unreachable targets shown as -
+///
+/// \param out ostream& - the output the table is written to
+///
+void DistanceTable::write(ostream& out) {
+    out << fixed << setprecision(2);
+
+    for (unsigned int row = 0; row < this->numRows; row++) {
+        for (unsigned int column = 0; column < this->numColumns; column++) {
+            float distance = getDistance(row, column);
+            out << " " << setw(8);
+
+            if (distance != numeric_limits<float>::infinity()) {
+                out << distance;
+            }
+            else {
+                out << "-";
+            }
+        }
+        out << endl;
+    }
+}
+
+/// \brief
+/// Writes the number of rows and columns followed by the distances in row major order as raw binary
+///
+/// \param out ostream& - the output the table is written to
+///
+void DistanceTable::writeBinary(ostream& out) {
+    out.write((const char*) &this->numRows, sizeof(this->numRows));
+    out.write((const char*) &this->numColumns, sizeof(this->numColumns));
+    out.write((const char*) this->distances.data(), this->distances.size() * sizeof(float));
+}
+
+/// \brief
+/// Orders the rows so that every run of eight holds sources close to one another, taking the first source not
+/// yet placed and then the other unplaced sources in the order a breadth first search from it reaches them
+///
+/// \param sources vector<unsigned int>* - the identifiers of the source vertices, one per row
+/// \param batchRows vector<unsigned int>* - filled with every row, eight to a batch
+///
+void DistanceTable::groupSources(vector<unsigned int>* sources, vector<unsigned int>* batchRows) {
+
+    // Link the rows of each source vertex so reaching a vertex places all of its unplaced rows
+    vector<int> firstRow(this->graph->getNumVertices(), -1);
+    vector<int> nextRow(this->numRows, -1);
+    for (unsigned int row = this->numRows; row > 0; row--) {
+        nextRow[row - 1] = firstRow[(*sources)[row - 1]];
+        firstRow[(*sources)[row - 1]] = row - 1;
+    }
+
+    vector<bool> placed(this->numRows, false);
+    vector<unsigned int> visitedGeneration(this->graph->getNumVertices(), 0);
+    vector<unsigned int> frontier;
+    unsigned int generation = 0;
+    for (unsigned int seed = 0; seed < this->numRows; seed++) {
+        if (placed[seed]) {
+            continue;
+        }
+
+        // Search outwards until the batch is full or nothing else can be reached
+        generation++;
+        unsigned int batchEnd = batchRows->size() + BATCH_SOURCES;
+        frontier.assign(1, (*sources)[seed]);
+        visitedGeneration[(*sources)[seed]] = generation;
+        for (unsigned int next = 0; next < frontier.size() && batchRows->size() < batchEnd; next++) {
+            unsigned int uId = frontier[next];
+            for (int row = firstRow[uId]; row != -1 && batchRows->size() < batchEnd; row = nextRow[row]) {
+                if (!placed[row]) {
+                    placed[row] = true;
+                    batchRows->push_back(row);
+                }
+            }
+            vector<unsigned int>* neighbours = this->graph->getNeighbours(uId);
+            for (unsigned int i = 0; i < neighbours->size(); i++) {
+                if (visitedGeneration[(*neighbours)[i]] != generation) {
+                    visitedGeneration[(*neighbours)[i]] = generation;
+                    frontier.push_back((*neighbours)[i]);
+                }
+            }
+        }
+    }
+}
+
+/// \brief
+/// Fills the rows of a batch of sources with one sweep
+///
+/// \param state SweepState* - the search state of the worker doing the sweep
+/// \param sources vector<unsigned int>* - the identifiers of the source vertices, one per row
+/// \param rows const unsigned int* - the rows of the sources of the batch, one per lane
+/// \param numLanes unsigned int - the number of sources in the batch, no more than eight
+/// \param targetIds vector<unsigned int>* - the identifiers of the distinct target vertices
+/// \param firstColumn vector<int>* - the first column of each vertex, or -1 if it is not a target
+/// \param nextColumn vector<int>* - the next column with the same target as each column, or -1
+/// \param rowTargets vector<unsigned int>* - the number of distinct targets the source of each row can reach
+///
+void DistanceTable::sweep(SweepState* state, vector<unsigned int>* sources, const unsigned int* rows, unsigned int numLanes,
+                          vector<unsigned int>* targetIds, vector<int>* firstColumn, vector<int>* nextColumn, vector<unsigned int>* rowTargets) {
+
+    // Moving to a new generation makes every vertex untouched without visiting them
+    state->generation++;
+    if (state->generation == 0) {
+        state->touchedGeneration.assign(state->touchedGeneration.size(), 0);
+        state->generation = 1;
+    }
+    while (!state->queue.empty()) {
+        state->queue.pop();
+    }
+
+    // The distances of a vertex are only reset the first time the batch touches it
+    auto touch = [&](unsigned int identifier) {
+        if (state->touchedGeneration[identifier] != state->generation) {
+            state->touchedGeneration[identifier] = state->generation;
+            state->improved[identifier] = 0;
+            fill(&state->distances[(size_t) identifier * BATCH_SOURCES], &state->distances[(size_t) identifier * BATCH_SOURCES] + BATCH_SOURCES,
+                 ShortestPathTree::UNREACHABLE);
+        }
+    };
+
+    // Count down the target and source pairs still unreached; once all are reached the largest of their
+    // distances bounds the sweep, since no distance passed on from then on can be smaller than the queue key
+    unsigned long remaining = 0;
+    for (unsigned int lane = 0; lane < numLanes; lane++) {
+        remaining += (*rowTargets)[rows[lane]];
+    }
+    double bound = ShortestPathTree::UNREACHABLE;
+    auto findBound = [&]() {
+        bound = 0;
+        for (unsigned int i = 0; i < targetIds->size(); i++) {
+            unsigned int targetId = (*targetIds)[i];
+            if (state->touchedGeneration[targetId] != state->generation) {
+                continue;
+            }
+            for (unsigned int lane = 0; lane < numLanes; lane++) {
+                double distance = state->distances[(size_t) targetId * BATCH_SOURCES + lane];
+                bound = distance != ShortestPathTree::UNREACHABLE && distance > bound ? distance : bound;
+            }
+        }
+    };
+
+    for (unsigned int lane = 0; lane < numLanes; lane++) {
+        unsigned int sourceId = (*sources)[rows[lane]];
+        touch(sourceId);
+        state->distances[(size_t) sourceId * BATCH_SOURCES + lane] = 0;
+        state->improved[sourceId] |= 1 << lane;
+        remaining -= (*firstColumn)[sourceId] != -1 ? 1 : 0;
+    }
+    for (unsigned int lane = 0; lane < numLanes; lane++) {
+        state->queue.push(QueueEntry(0.0, (*sources)[rows[lane]]));
+    }
+    if (remaining == 0) {
+        findBound();
+    }
+
+    bool allReached = false;
+    while (!state->queue.empty()) {
+        QueueEntry entry = state->queue.top();
+        state->queue.pop();
+        unsigned int uId = entry.second;
+        if (state->improved[uId] == 0) {
+            continue;
+        }
+        if (remaining == 0 && entry.first >= bound) {
+            break;
+        }
+
+        // Pass on every distance that has improved since the vertex was last taken
+        unsigned char lanes = state->improved[uId];
+        state->improved[uId] = 0;
+        state->numScanned++;
+        const double* from = &state->distances[(size_t) uId * BATCH_SOURCES];
+        vector<unsigned int>* neighbours = this->graph->getNeighbours(uId);
+        for (unsigned int i = 0; i < neighbours->size(); i++) {
+            unsigned int vId = (*neighbours)[i];
+            double weight = this->graph->getWeight(uId, vId);
+            touch(vId);
+            double* to = &state->distances[(size_t) vId * BATCH_SOURCES];
+            double smallest = ShortestPathTree::UNREACHABLE;
+            unsigned char better = 0;
+            for (unsigned int lane = 0; lane < numLanes; lane++) {
+                double distance = from[lane] + weight;
+                if ((lanes >> lane & 1) && distance < to[lane]) {
+                    if (to[lane] == ShortestPathTree::UNREACHABLE && (*firstColumn)[vId] != -1) {
+                        remaining--;
+                        allReached = remaining == 0;
+                    }
+                    to[lane] = distance;
+                    better |= 1 << lane;
+                    smallest = distance < smallest ? distance : smallest;
+                }
+            }
+            if (better != 0) {
+                state->improved[vId] |= better;
+                state->queue.push(QueueEntry(smallest, vId));
+            }
+        }
+        if (allReached) {
+            findBound();
+            allReached = false;
+        }
+    }
+
+    for (unsigned int lane = 0; lane < numLanes; lane++) {
+        float* rowDistances = &this->distances[(size_t) rows[lane] * this->numColumns];
+        for (unsigned int i = 0; i < targetIds->size(); i++) {
+            unsigned int targetId = (*targetIds)[i];
+            if (state->touchedGeneration[targetId] != state->generation) {
+                continue;
+            }
+            double distance = state->distances[(size_t) targetId * BATCH_SOURCES + lane];
+            if (distance != ShortestPathTree::UNREACHABLE) {
+                for (int column = (*firstColumn)[targetId]; column != -1; column = (*nextColumn)[column]) {
+                    rowDistances[column] = (float) distance;
+                }
+            }
+        }
+    }
+}
+
+/// \brief
+/// Fills every row from the hub labels of the sources and the targets, gathered into buckets by hub
+///
+/// \param sources vector<unsigned int>* - the identifiers of the source vertices, one per row
+/// \param targets vector<unsigned int>* - the identifiers of the target vertices, one per column
+///
+void DistanceTable::computeFromLabels(vector<unsigned int>* sources, vector<unsigned int>* targets) {
+
+    // Count the entries of each hub's bucket, then place every target label entry in its hub's bucket
+    unsigned int numHubs = this->hubLabels->getNumVertices();
+    vector<unsigned long> bucketOffsets(numHubs + 1, 0);
+    const unsigned int* hubs;
+    const double* hubDistances;
+    for (unsigned int column = 0; column < this->numColumns; column++) {
+        unsigned int size = this->hubLabels->getLabel((*targets)[column], &hubs, &hubDistances);
+        for (unsigned int i = 0; i < size; i++) {
+            bucketOffsets[hubs[i] + 1]++;
+        }
+    }
+    for (unsigned int hub = 0; hub < numHubs; hub++) {
+        bucketOffsets[hub + 1] += bucketOffsets[hub];
+    }
+    vector<unsigned long> next(bucketOffsets.begin(), bucketOffsets.end() - 1);
+    vector<unsigned int> bucketColumns(bucketOffsets[numHubs]);
+    vector<double> bucketDistances(bucketOffsets[numHubs]);
+    for (unsigned int column = 0; column < this->numColumns; column++) {
+        unsigned int size = this->hubLabels->getLabel((*targets)[column], &hubs, &hubDistances);
+        for (unsigned int i = 0; i < size; i++) {
+            bucketColumns[next[hubs[i]]] = column;
+            bucketDistances[next[hubs[i]]++] = hubDistances[i];
+        }
+    }
+
+    unsigned int numChunks = this->pool->getNumWorkers() * CHUNKS_PER_WORKER;
+    if (numChunks > this->numRows) {
+        numChunks = this->numRows;
+    }
+
+    atomic<unsigned long> entriesRead(0);
+    this->pool->parallelFor(numChunks, [&](unsigned int chunk) {
+        unsigned int firstRow = (unsigned long) chunk * this->numRows / numChunks;
+        unsigned int lastRow = (unsigned long) (chunk + 1) * this->numRows / numChunks;
+        vector<double> best(this->numColumns);
+        unsigned long read = 0;
+
+        for (unsigned int row = firstRow; row < lastRow; row++) {
+            const unsigned int* sourceHubs;
+            const double* sourceDistances;
+            unsigned int size = this->hubLabels->getLabel((*sources)[row], &sourceHubs, &sourceDistances);
+            best.assign(this->numColumns, ShortestPathTree::UNREACHABLE);
+            for (unsigned int i = 0; i < size; i++) {
+                unsigned long last = bucketOffsets[sourceHubs[i] + 1];
+                for (unsigned long entry = bucketOffsets[sourceHubs[i]]; entry < last; entry++) {
+                    double distance = sourceDistances[i] + bucketDistances[entry];
+                    best[bucketColumns[entry]] = distance < best[bucketColumns[entry]] ? distance : best[bucketColumns[entry]];
+                }
+                read += last - bucketOffsets[sourceHubs[i]];
+            }
+
+            float* rowDistances = &this->distances[(size_t) row * this->numColumns];
+            for (unsigned int column = 0; column < this->numColumns; column++) {
+                rowDistances[column] = (float) best[column];
+            }
+        }
+        entriesRead += read;
+    });
+    this->numSettled = entriesRead;
+}
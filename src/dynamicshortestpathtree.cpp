@@ -0,0 +1,190 @@
+#include "dynamicshortestpathtree.h"
+
+/// This class keeps the shortest path tree of a source up to date as edges of the graph are added, removed
+/// or change weight. Only the vertices whose distance can change are visited: a new or cheaper edge spreads
+/// shorter distances outwards from its ends, and a removed or dearer tree edge re-attaches the subtree
+/// below it using the distances of the vertices around it.
+///
+
+/// \brief
+/// Computes the tree for the source and starts observing the graph for changes
+///
+/// \param graph Graph* - the graph the tree is kept for
+/// \param sourceId unsigned int - the identifier of the source vertex
+///
+DynamicShortestPathTree::DynamicShortestPathTree(Graph* graph, unsigned int sourceId) {
+    this->graph = graph;
+    this->numTouched = 0;
+    graph->shortestPathTree(sourceId, &this->tree);
+
+    // Build the lists of children from the predecessors
+    this->children.resize(graph->getNumVertices());
+    for (unsigned int i = 0; i < graph->getNumVertices(); i++) {
+        if (i != sourceId && this->tree.isReachable(i)) {
+            this->children[this->tree.getPredecessorId(i)].push_back(i);
+        }
+    }
+
+    graph->addObserver(this);
+}
+
+/// \brief
+/// Stops observing the graph
+///
+DynamicShortestPathTree::~DynamicShortestPathTree() {
+    this->graph->removeObserver(this);
+}
+
+/// \brief
+/// Returns the tree, which is always up to date with the graph
+///
+/// \return ShortestPathTree* - a pointer to the tree
+///
+ShortestPathTree* DynamicShortestPathTree::getTree() {
+    return &this->tree;
+}
+
+/// \brief
+/// Returns the number of vertices whose distance was looked at by the last repair
+///
+/// \return unsigned int - the number of vertices touched
+///
+unsigned int DynamicShortestPathTree::getNumTouched() {
+    return this->numTouched;
+}
+
+/// \brief
+/// Repairs the tree after an edge has been added, removed or had its weight changed
+///
+/// \param sourceId unsigned int - the identifier of the first vertex of the edge
+/// \param destinationId unsigned int - the identifier of the second vertex of the edge
+/// \param oldWeight double - the weight before the change, or NO_EDGE if the edge is new
+/// \param newWeight double - the weight after the change, or NO_EDGE if the edge was removed
+///
+void DynamicShortestPathTree::edgeChanged(unsigned int sourceId, unsigned int destinationId, double oldWeight, double newWeight) {
+    RepairQueue queue;
+    this->numTouched = 0;
+
+    if (sourceId == destinationId) {
+        return;
+    }
+
+    // A new or cheaper edge can only shorten paths, starting from one of its ends
+    if (newWeight <= oldWeight) {
+        relax(destinationId, sourceId, &queue);
+        relax(sourceId, destinationId, &queue);
+        propagate(&queue);
+        return;
+    }
+
+    // A removed or dearer edge only matters if the tree uses it
+    unsigned int childId;
+    if (this->tree.isReachable(destinationId) && destinationId != this->tree.getSourceId()
+        && this->tree.getPredecessorId(destinationId) == sourceId) {
+        childId = destinationId;
+    }
+    else if (this->tree.isReachable(sourceId) && sourceId != this->tree.getSourceId()
+             && this->tree.getPredecessorId(sourceId) == destinationId) {
+        childId = sourceId;
+    }
+    else {
+        return;
+    }
+
+    // Collect the subtree hanging from the edge; only these vertices can get further away
+    vector<unsigned int> affected;
+    affected.push_back(childId);
+    for (unsigned int i = 0; i < affected.size(); i++) {
+        vector<unsigned int>& below = this->children[affected[i]];
+        for (unsigned int j = 0; j < below.size(); j++) {
+            affected.push_back(below[j]);
+        }
+    }
+
+    // Detach the subtree so each vertex can find its way back through any neighbour
+    for (unsigned int i = 0; i < affected.size(); i++) {
+        setPredecessorId(affected[i], affected[i]);
+        this->tree.setDistance(affected[i], ShortestPathTree::UNREACHABLE);
+    }
+
+    // Give each detached vertex the best distance offered by its neighbours outside the subtree
+    for (unsigned int i = 0; i < affected.size(); i++) {
+        vector<unsigned int>* adjacent = this->graph->getNeighbours(affected[i]);
+        for (unsigned int j = 0; j < adjacent->size(); j++) {
+            relax(affected[i], (*adjacent)[j], &queue);
+        }
+    }
+    this->numTouched += affected.size();
+    propagate(&queue);
+}
+
+/// \brief
+/// Changes the predecessor of a vertex, keeping the lists of children in step
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \param predecessorId unsigned int - the identifier of the new predecessor, or the vertex itself to detach it
+///
+void DynamicShortestPathTree::setPredecessorId(unsigned int identifier, unsigned int predecessorId) {
+    unsigned int oldPredecessorId = this->tree.getPredecessorId(identifier);
+
+    // Remove the vertex from the children of its old predecessor
+    if (oldPredecessorId != identifier) {
+        vector<unsigned int>& siblings = this->children[oldPredecessorId];
+        for (unsigned int i = 0; i < siblings.size(); i++) {
+            if (siblings[i] == identifier) {
+                siblings[i] = siblings.back();
+                siblings.pop_back();
+                break;
+            }
+        }
+    }
+
+    if (predecessorId != identifier) {
+        this->children[predecessorId].push_back(identifier);
+    }
+    this->tree.setPredecessorId(identifier, predecessorId);
+}
+
+/// \brief
+/// Lowers the distance of a vertex if the path through a neighbour is shorter, queueing it to spread further
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \param predecessorId unsigned int - the identifier of the neighbour
+/// \param queue RepairQueue* - the queue of vertices whose distance has been lowered
+///
+void DynamicShortestPathTree::relax(unsigned int identifier, unsigned int predecessorId, RepairQueue* queue) {
+    if (identifier == this->tree.getSourceId() || !this->tree.isReachable(predecessorId)
+        || !this->graph->hasEdge(predecessorId, identifier)) {
+        return;
+    }
+
+    double distance = this->tree.getDistance(predecessorId) + this->graph->getWeight(predecessorId, identifier);
+    if (distance < this->tree.getDistance(identifier)) {
+        this->tree.setDistance(identifier, distance);
+        setPredecessorId(identifier, predecessorId);
+        queue->push(QueueEntry(distance, identifier));
+    }
+}
+
+/// \brief
+/// Spreads lowered distances outwards in order of distance until nothing else improves
+///
+/// \param queue RepairQueue* - the queue of vertices whose distance has been lowered
+///
+void DynamicShortestPathTree::propagate(RepairQueue* queue) {
+    while (!queue->empty()) {
+        QueueEntry entry = queue->top();
+        queue->pop();
+
+        // Skip entries whose distance has been lowered again since they were queued
+        if (entry.first != this->tree.getDistance(entry.second)) {
+            continue;
+        }
+        this->numTouched++;
+
+        vector<unsigned int>* adjacent = this->graph->getNeighbours(entry.second);
+        for (unsigned int i = 0; i < adjacent->size(); i++) {
+            relax((*adjacent)[i], entry.second, queue);
+        }
+    }
+}
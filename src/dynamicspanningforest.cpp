@@ -0,0 +1,523 @@
+#include "dynamicspanningforest.h"
+#include <algorithm>
+#include <limits>
+#include "disjointset.h"
+
+/// This class keeps a minimum spanning forest of the graph and its cost up to date as edges are added,
+/// removed or change weight, with one tree for each connected part of the graph. The forest is held in a
+/// link-cut tree where every tree edge is a node of its own, so the heaviest edge on the path between any
+/// two vertices is found in amortised logarithmic time. A new or cheaper edge joins two trees, or replaces
+/// the heaviest edge on the path between its ends if it is lighter, without looking at any other edge.
+///
+/// Removing a tree edge, or making one dearer, splits its tree in two and needs the lightest edge joining the
+/// halves. The halves are walked together one vertex at a time until the smaller is finished, and only the
+/// edges of the smaller half are looked at, so the work is proportional to the smaller half rather than to
+/// the graph. Changes to edges outside the forest that do not make them cheaper need no work at all.
+///
+
+/// \brief
+/// Computes the minimum spanning forest with Kruskal's algorithm and starts observing the graph for changes
+///
+/// \param graph Graph* - the graph the forest is kept for
+///
+DynamicSpanningForest::DynamicSpanningForest(Graph* graph) {
+    this->graph = graph;
+    this->generation = 0;
+    this->cost = 0;
+    this->numScanned = 0;
+
+    // Vertex nodes weigh less than any edge so the heaviest node on a path is always an edge
+    unsigned int numVertices = graph->getNumVertices();
+    this->nodes.resize(numVertices);
+    for (unsigned int i = 0; i < numVertices; i++) {
+        LinkCutNode& node = this->nodes[i];
+        node.children[0] = NO_NODE;
+        node.children[1] = NO_NODE;
+        node.parent = NO_NODE;
+        node.reversed = false;
+        node.weight = -numeric_limits<double>::infinity();
+        node.heaviest = i;
+        node.sourceId = i;
+        node.destinationId = i;
+    }
+    this->treeNeighbours.resize(numVertices);
+    this->visitedGeneration.assign(numVertices, 0);
+    this->visitedSide.assign(numVertices, 0);
+
+    // Kruskal's algorithm over every edge, taking each once from its lower numbered end
+    vector< pair<double, pair<unsigned int, unsigned int> > > edges;
+    for (unsigned int uId = 0; uId < numVertices; uId++) {
+        vector<unsigned int>* neighbours = graph->getNeighbours(uId);
+        for (unsigned int i = 0; i < neighbours->size(); i++) {
+            if ((*neighbours)[i] > uId) {
+                edges.push_back(make_pair(graph->getWeight(uId, (*neighbours)[i]), make_pair(uId, (*neighbours)[i])));
+            }
+        }
+    }
+    sort(edges.begin(), edges.end());
+    DisjointSet components(numVertices);
+    for (unsigned int i = 0; i < edges.size(); i++) {
+        unsigned int uId = edges[i].second.first;
+        unsigned int vId = edges[i].second.second;
+        if (!components.sameComponent(uId, vId)) {
+            components.join(uId, vId);
+            addTreeEdge(uId, vId, edges[i].first);
+        }
+    }
+
+    graph->addObserver(this);
+}
+
+/// \brief
+/// Stops observing the graph
+///
+DynamicSpanningForest::~DynamicSpanningForest() {
+    this->graph->removeObserver(this);
+}
+
+/// \brief
+/// Returns the total weight of the edges of the forest
+///
+/// \return double - the cost of the forest
+///
+double DynamicSpanningForest::getCost() {
+    return this->cost;
+}
+
+/// \brief
+/// Returns the number of edges in the forest
+///
+/// \return unsigned int - the number of tree edges
+///
+unsigned int DynamicSpanningForest::getNumTreeEdges() {
+    return this->treeEdges.size();
+}
+
+/// \brief
+/// Returns the number of trees in the forest, which is the number of connected parts of the graph
+///
+/// \return unsigned int - the number of trees
+///
+unsigned int DynamicSpanningForest::getNumTrees() {
+    return this->graph->getNumVertices() - this->treeEdges.size();
+}
+
+/// \brief
+/// Returns whether an edge is in the forest
+///
+/// \param sourceId unsigned int - the identifier of the first vertex of the edge
+/// \param destinationId unsigned int - the identifier of the second vertex of the edge
+/// \return bool - true if the edge is a tree edge
+///
+bool DynamicSpanningForest::isTreeEdge(unsigned int sourceId, unsigned int destinationId) {
+    return this->treeEdges.count(edgeKey(sourceId, destinationId)) > 0;
+}
+
+/// \brief
+/// Returns whether two vertices are in the same tree of the forest
+///
+/// \param sourceId unsigned int - the identifier of the first vertex
+/// \param destinationId unsigned int - the identifier of the second vertex
+/// \return bool - true if a path joins the vertices
+///
+bool DynamicSpanningForest::connected(unsigned int sourceId, unsigned int destinationId) {
+    return sourceId == destinationId || findRoot(sourceId) == findRoot(destinationId);
+}
+
+/// \brief
+/// Returns the number of vertices and edges looked at to find a replacement for a tree edge by the last change
+///
+/// \return unsigned long - the number of vertices and edges looked at, zero if no replacement was needed
+///
+unsigned long DynamicSpanningForest::getNumScanned() {
+    return this->numScanned;
+}
+
+/// \brief
+/// Updates the forest after an edge has been added, removed or had its weight changed
+///
+/// \param sourceId unsigned int - the identifier of the first vertex of the edge
+/// \param destinationId unsigned int - the identifier of the second vertex of the edge
+/// \param oldWeight double - the weight before the change, or NO_EDGE if the edge is new
+/// \param newWeight double - the weight after the change, or NO_EDGE if the edge was removed
+///
+void DynamicSpanningForest::edgeChanged(unsigned int sourceId, unsigned int destinationId, double oldWeight, double newWeight) {
+    this->numScanned = 0;
+
+    if (sourceId == destinationId) {
+        return;
+    }
+
+    // An edge outside the forest only matters if it becomes cheaper, a new edge counting as cheaper
+    unordered_map<unsigned long long, unsigned int>::iterator found = this->treeEdges.find(edgeKey(sourceId, destinationId));
+    if (found == this->treeEdges.end()) {
+        if (newWeight < oldWeight) {
+            offerEdge(sourceId, destinationId, newWeight);
+        }
+        return;
+    }
+
+    // A cheaper tree edge stays in the forest, so only its weight changes; it is the root of its splay tree
+    // once accessed, so nothing above it needs updating
+    unsigned int edgeNode = found->second;
+    if (newWeight <= oldWeight) {
+        access(edgeNode);
+        this->nodes[edgeNode].weight = newWeight;
+        update(edgeNode);
+        this->cost += newWeight - oldWeight;
+        return;
+    }
+
+    // A removed or dearer tree edge splits its tree, and the lightest edge joining the halves, which may be
+    // the same edge at its new weight, takes its place
+    removeTreeEdge(edgeNode);
+    replaceTreeEdge(sourceId, destinationId);
+}
+
+/// \brief
+/// Returns the key a tree edge is found by, the same whichever way round its ends are given
+///
+/// \param sourceId unsigned int - the identifier of the first vertex of the edge
+/// \param destinationId unsigned int - the identifier of the second vertex of the edge
+/// \return unsigned long long - the key of the edge
+///
+unsigned long long DynamicSpanningForest::edgeKey(unsigned int sourceId, unsigned int destinationId) {
+    return sourceId < destinationId ? (unsigned long long) sourceId << 32 | destinationId
+                                    : (unsigned long long) destinationId << 32 | sourceId;
+}
+
+/// \brief
+/// Adds an edge to the forest, joining two trees
+///
+/// \param sourceId unsigned int - the identifier of the first vertex of the edge
+/// \param destinationId unsigned int - the identifier of the second vertex of the edge
+/// \param weight double - the weight of the edge
+///
+void DynamicSpanningForest::addTreeEdge(unsigned int sourceId, unsigned int destinationId, double weight) {
+    unsigned int edgeNode;
+    if (this->freeNodes.empty()) {
+        edgeNode = this->nodes.size();
+        this->nodes.push_back(LinkCutNode());
+    }
+    else {
+        edgeNode = this->freeNodes.back();
+        this->freeNodes.pop_back();
+    }
+
+    LinkCutNode& node = this->nodes[edgeNode];
+    node.children[0] = NO_NODE;
+    node.children[1] = NO_NODE;
+    node.parent = NO_NODE;
+    node.reversed = false;
+    node.weight = weight;
+    node.heaviest = edgeNode;
+    node.sourceId = sourceId;
+    node.destinationId = destinationId;
+
+    link(edgeNode, sourceId);
+    link(destinationId, edgeNode);
+    this->treeEdges[edgeKey(sourceId, destinationId)] = edgeNode;
+    this->treeNeighbours[sourceId].push_back(destinationId);
+    this->treeNeighbours[destinationId].push_back(sourceId);
+    this->cost += weight;
+}
+
+/// \brief
+/// Removes an edge from the forest, splitting its tree in two
+///
+/// \param edgeNode unsigned int - the node of the edge
+///
+void DynamicSpanningForest::removeTreeEdge(unsigned int edgeNode) {
+    unsigned int sourceId = this->nodes[edgeNode].sourceId;
+    unsigned int destinationId = this->nodes[edgeNode].destinationId;
+    cut(sourceId, edgeNode);
+    cut(edgeNode, destinationId);
+
+    this->treeEdges.erase(edgeKey(sourceId, destinationId));
+    for (unsigned int end = 0; end < 2; end++) {
+        vector<unsigned int>& adjacent = this->treeNeighbours[end == 0 ? sourceId : destinationId];
+        unsigned int otherId = end == 0 ? destinationId : sourceId;
+        for (unsigned int i = 0; i < adjacent.size(); i++) {
+            if (adjacent[i] == otherId) {
+                adjacent[i] = adjacent.back();
+                adjacent.pop_back();
+                break;
+            }
+        }
+    }
+    this->cost -= this->nodes[edgeNode].weight;
+    this->freeNodes.push_back(edgeNode);
+}
+
+/// \brief
+/// Adds an edge to the forest if it joins two trees or is lighter than the heaviest edge on the path between its ends
+///
+/// \param sourceId unsigned int - the identifier of the first vertex of the edge
+/// \param destinationId unsigned int - the identifier of the second vertex of the edge
+/// \param weight double - the weight of the edge
+///
+void DynamicSpanningForest::offerEdge(unsigned int sourceId, unsigned int destinationId, double weight) {
+    if (!connected(sourceId, destinationId)) {
+        addTreeEdge(sourceId, destinationId, weight);
+        return;
+    }
+
+    // With the source as root, accessing the destination leaves the path between them in one splay tree
+    makeRoot(sourceId);
+    access(destinationId);
+    unsigned int heaviest = this->nodes[destinationId].heaviest;
+    if (this->nodes[heaviest].weight > weight) {
+        removeTreeEdge(heaviest);
+        addTreeEdge(sourceId, destinationId, weight);
+    }
+}
+
+/// \brief
+/// Joins the two trees holding the ends of a removed tree edge with the lightest edge of the graph between them
+///
+/// \param sourceId unsigned int - the identifier of the first vertex of the removed edge
+/// \param destinationId unsigned int - the identifier of the second vertex of the removed edge
+///
+void DynamicSpanningForest::replaceTreeEdge(unsigned int sourceId, unsigned int destinationId) {
+
+    // Moving to a new generation forgets the last walk without visiting every vertex
+    this->generation++;
+    if (this->generation == 0) {
+        this->visitedGeneration.assign(this->visitedGeneration.size(), 0);
+        this->generation = 1;
+    }
+
+    // Walk both halves one vertex at a time; the first to run out is the smaller, found in time
+    // proportional to its own size
+    vector<unsigned int> halves[2];
+    unsigned int next[2] = { 0, 0 };
+    for (unsigned char side = 0; side < 2; side++) {
+        unsigned int startId = side == 0 ? sourceId : destinationId;
+        this->visitedGeneration[startId] = this->generation;
+        this->visitedSide[startId] = side;
+        halves[side].push_back(startId);
+    }
+    unsigned char smaller = 0;
+    while (true) {
+        if (next[0] == halves[0].size()) {
+            smaller = 0;
+            break;
+        }
+        if (next[1] == halves[1].size()) {
+            smaller = 1;
+            break;
+        }
+        for (unsigned char side = 0; side < 2; side++) {
+            unsigned int uId = halves[side][next[side]++];
+            vector<unsigned int>& adjacent = this->treeNeighbours[uId];
+            for (unsigned int i = 0; i < adjacent.size(); i++) {
+                if (this->visitedGeneration[adjacent[i]] != this->generation) {
+                    this->visitedGeneration[adjacent[i]] = this->generation;
+                    this->visitedSide[adjacent[i]] = side;
+                    halves[side].push_back(adjacent[i]);
+                }
+            }
+        }
+    }
+
+    // Every edge leaving the smaller half goes to the other half, since the forest spanned the whole
+    // connected part before the split
+    vector<unsigned int>& half = halves[smaller];
+    double lightest = GraphObserver::NO_EDGE;
+    unsigned int lightestSourceId = 0;
+    unsigned int lightestDestinationId = 0;
+    this->numScanned += half.size();
+    for (unsigned int i = 0; i < half.size(); i++) {
+        vector<unsigned int>* neighbours = this->graph->getNeighbours(half[i]);
+        this->numScanned += neighbours->size();
+        for (unsigned int j = 0; j < neighbours->size(); j++) {
+            unsigned int vId = (*neighbours)[j];
+            if (this->visitedGeneration[vId] == this->generation && this->visitedSide[vId] == smaller) {
+                continue;
+            }
+            double weight = this->graph->getWeight(half[i], vId);
+            if (weight < lightest) {
+                lightest = weight;
+                lightestSourceId = half[i];
+                lightestDestinationId = vId;
+            }
+        }
+    }
+
+    if (lightest != GraphObserver::NO_EDGE) {
+        addTreeEdge(lightestSourceId, lightestDestinationId, lightest);
+    }
+}
+
+/// \brief
+/// Returns whether a node is the root of its splay tree
+///
+/// \param node unsigned int - the node
+/// \return bool - true if the node has no parent in its splay tree
+///
+bool DynamicSpanningForest::isSplayRoot(unsigned int node) {
+    unsigned int parent = this->nodes[node].parent;
+    return parent == NO_NODE || (this->nodes[parent].children[0] != node && this->nodes[parent].children[1] != node);
+}
+
+/// \brief
+/// Recomputes the heaviest node of the splay subtree below a node from its children
+///
+/// \param node unsigned int - the node
+///
+void DynamicSpanningForest::update(unsigned int node) {
+    LinkCutNode& current = this->nodes[node];
+    current.heaviest = node;
+    for (unsigned int side = 0; side < 2; side++) {
+        unsigned int child = current.children[side];
+        if (child != NO_NODE && this->nodes[this->nodes[child].heaviest].weight > this->nodes[current.heaviest].weight) {
+            current.heaviest = this->nodes[child].heaviest;
+        }
+    }
+}
+
+/// \brief
+/// Passes a pending reversal of a splay subtree down to the children of its root
+///
+/// \param node unsigned int - the root of the subtree
+///
+void DynamicSpanningForest::pushDown(unsigned int node) {
+    LinkCutNode& current = this->nodes[node];
+    if (current.reversed) {
+        swap(current.children[0], current.children[1]);
+        for (unsigned int side = 0; side < 2; side++) {
+            if (current.children[side] != NO_NODE) {
+                this->nodes[current.children[side]].reversed = !this->nodes[current.children[side]].reversed;
+            }
+        }
+        current.reversed = false;
+    }
+}
+
+/// \brief
+/// Rotates a node above its parent in their splay tree
+///
+/// \param node unsigned int - the node
+///
+void DynamicSpanningForest::rotate(unsigned int node) {
+    unsigned int parent = this->nodes[node].parent;
+    unsigned int grandparent = this->nodes[parent].parent;
+    unsigned int side = this->nodes[parent].children[1] == node ? 1 : 0;
+    unsigned int moved = this->nodes[node].children[1 - side];
+
+    // The grandparent keeps its path parent pointer if the parent was the root of the splay tree
+    if (!isSplayRoot(parent)) {
+        this->nodes[grandparent].children[this->nodes[grandparent].children[1] == parent ? 1 : 0] = node;
+    }
+    this->nodes[node].parent = grandparent;
+    this->nodes[node].children[1 - side] = parent;
+    this->nodes[parent].parent = node;
+    this->nodes[parent].children[side] = moved;
+    if (moved != NO_NODE) {
+        this->nodes[moved].parent = parent;
+    }
+    update(parent);
+    update(node);
+}
+
+/// \brief
+/// Moves a node to the root of its splay tree
+///
+/// \param node unsigned int - the node
+///
+void DynamicSpanningForest::splay(unsigned int node) {
+
+    // Pending reversals are passed down from the root of the splay tree before any rotation
+    this->splayPath.assign(1, node);
+    while (!isSplayRoot(this->splayPath.back())) {
+        this->splayPath.push_back(this->nodes[this->splayPath.back()].parent);
+    }
+    for (unsigned int i = this->splayPath.size(); i > 0; i--) {
+        pushDown(this->splayPath[i - 1]);
+    }
+
+    while (!isSplayRoot(node)) {
+        unsigned int parent = this->nodes[node].parent;
+        if (!isSplayRoot(parent)) {
+            unsigned int grandparent = this->nodes[parent].parent;
+            bool zigZig = (this->nodes[grandparent].children[1] == parent) == (this->nodes[parent].children[1] == node);
+            rotate(zigZig ? parent : node);
+        }
+        rotate(node);
+    }
+}
+
+/// \brief
+/// Makes the path from the root of a node's tree down to the node preferred, leaving the node at the root
+/// of its splay tree with nothing below it on the path
+///
+/// \param node unsigned int - the node
+///
+void DynamicSpanningForest::access(unsigned int node) {
+    unsigned int below = NO_NODE;
+    for (unsigned int current = node; current != NO_NODE; current = this->nodes[current].parent) {
+        splay(current);
+        this->nodes[current].children[1] = below;
+        update(current);
+        below = current;
+    }
+    splay(node);
+}
+
+/// \brief
+/// Makes a node the root of its tree
+///
+/// \param node unsigned int - the node
+///
+void DynamicSpanningForest::makeRoot(unsigned int node) {
+    access(node);
+    this->nodes[node].reversed = !this->nodes[node].reversed;
+}
+
+/// \brief
+/// Returns the root of the tree holding a node
+///
+/// \param node unsigned int - the node
+/// \return unsigned int - the root of its tree
+///
+unsigned int DynamicSpanningForest::findRoot(unsigned int node) {
+    access(node);
+    unsigned int current = node;
+    pushDown(current);
+    while (this->nodes[current].children[0] != NO_NODE) {
+        current = this->nodes[current].children[0];
+        pushDown(current);
+    }
+
+    // Splaying the root keeps repeated calls from walking the same long path
+    splay(current);
+    return current;
+}
+
+/// \brief
+/// Joins two nodes of different trees with a link-cut tree edge
+///
+/// \param child unsigned int - the node that becomes a child, made the root of its tree first
+/// \param parent unsigned int - the node that becomes its parent
+///
+void DynamicSpanningForest::link(unsigned int child, unsigned int parent) {
+    makeRoot(child);
+    this->nodes[child].parent = parent;
+}
+
+/// \brief
+/// Removes the link-cut tree edge between two adjacent nodes
+///
+/// \param nodeOne unsigned int - the first node
+/// \param nodeTwo unsigned int - the second node
+///
+void DynamicSpanningForest::cut(unsigned int nodeOne, unsigned int nodeTwo) {
+
+    // With the first node as root, the second is its only successor on the path, so the first is the
+    // whole left subtree of the second once it is accessed
+    makeRoot(nodeOne);
+    access(nodeTwo);
+    this->nodes[nodeTwo].children[0] = NO_NODE;
+    this->nodes[nodeOne].parent = NO_NODE;
+    update(nodeTwo);
+}
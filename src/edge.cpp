@@ -56,6 +56,15 @@ double Edge::getWeight() {
     return this->weight;
 }
 
+/// \brief
+/// Sets the edge's weight, which must not change once the edge has been added to a graph
+///
+/// \param weight double - the new weight of the edge
+///
+void Edge::setWeight(double weight) {
+    this->weight = weight;
+}
+
 /// \brief
 /// Compares two edges and returns true if the first's weight
 ///
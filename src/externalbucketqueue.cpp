@@ -0,0 +1,139 @@
+#include "externalbucketqueue.h"
+
+/// This class is the frontier of a search too large to keep in memory. Vertices are kept in buckets of
+/// equal distance width and taken out a whole bucket at a time, closest first. When the buckets hold more
+/// entries than the memory allowed, the buckets furthest away are appended to temporary files in large
+/// sequential writes and read back in one pass when their turn comes.
+///
+
+/// \brief
+/// Creates an empty queue
+///
+/// \param bucketWidth double - the range of distances that share a bucket
+/// \param memoryBytes unsigned long - the most memory the buckets may hold before spilling, in bytes
+///
+ExternalBucketQueue::ExternalBucketQueue(double bucketWidth, unsigned long memoryBytes) {
+    this->bucketWidth = bucketWidth;
+    this->maxEntries = memoryBytes / sizeof(unsigned int) > 1 ? memoryBytes / sizeof(unsigned int) : 1;
+    this->numInMemory = 0;
+    this->totalSpilled = 0;
+}
+
+/// \brief
+/// Closes the files of any buckets that were spilled and never taken out
+///
+ExternalBucketQueue::~ExternalBucketQueue() {
+    for (map<unsigned long, Bucket>::iterator it = this->buckets.begin(); it != this->buckets.end(); it++) {
+        if (it->second.spillFile != NULL) {
+            fclose(it->second.spillFile);
+        }
+    }
+}
+
+/// \brief
+/// Returns the bucket a distance falls in
+///
+/// \param distance double - the distance
+/// \return unsigned long - the number of the bucket
+///
+unsigned long ExternalBucketQueue::getBucket(double distance) {
+    return (unsigned long) (distance / this->bucketWidth);
+}
+
+/// \brief
+/// Adds a vertex to the bucket for its distance
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \param distance double - the tentative distance of the vertex
+/// \return bool - false if a bucket could not be spilled to disk
+///
+bool ExternalBucketQueue::push(unsigned int identifier, double distance) {
+    unsigned long index = getBucket(distance);
+    map<unsigned long, Bucket>::iterator found = this->buckets.find(index);
+
+    if (found == this->buckets.end()) {
+        Bucket bucket;
+        bucket.spillFile = NULL;
+        bucket.numSpilled = 0;
+        found = this->buckets.insert(make_pair(index, bucket)).first;
+    }
+    found->second.entries.push_back(identifier);
+    this->numInMemory++;
+
+    return this->numInMemory <= this->maxEntries || spill();
+}
+
+/// \brief
+/// Takes every vertex out of the closest bucket. Vertices may appear more than once or have since
+/// moved to a closer bucket, so callers check each against its current distance
+///
+/// \param vertices vector<unsigned int>* - filled with the vertices of the bucket
+/// \param bucket unsigned long* - set to the number of the bucket
+/// \return bool - false if the queue is empty or a spilled bucket could not be read back
+///
+bool ExternalBucketQueue::popBucket(vector<unsigned int>* vertices, unsigned long* bucket) {
+    if (this->buckets.empty()) {
+        return false;
+    }
+
+    Bucket& closest = this->buckets.begin()->second;
+    *bucket = this->buckets.begin()->first;
+    vertices->swap(closest.entries);
+    this->numInMemory -= vertices->size();
+
+    // Read the spilled part back in one sequential pass
+    bool complete = true;
+    if (closest.spillFile != NULL) {
+        unsigned long inMemory = vertices->size();
+        vertices->resize(inMemory + closest.numSpilled);
+        rewind(closest.spillFile);
+        complete = fread(&(*vertices)[inMemory], sizeof(unsigned int), closest.numSpilled, closest.spillFile) == closest.numSpilled;
+        fclose(closest.spillFile);
+    }
+
+    this->buckets.erase(this->buckets.begin());
+    return complete;
+}
+
+/// \brief
+/// Returns the number of entries written to disk so far
+///
+/// \return unsigned long - the number of spilled entries
+///
+unsigned long ExternalBucketQueue::getNumSpilled() {
+    return this->totalSpilled;
+}
+
+/// \brief
+/// Writes the buckets furthest away to disk until the entries in memory are back within bounds
+///
+/// \return bool - false if a bucket could not be written
+///
+bool ExternalBucketQueue::spill() {
+
+    // The closest bucket is about to be taken out so it is left in memory
+    map<unsigned long, Bucket>::reverse_iterator it = this->buckets.rbegin();
+    while (this->numInMemory > this->maxEntries / 2 && it != this->buckets.rend() && it->first != this->buckets.begin()->first) {
+        Bucket& bucket = it->second;
+        it++;
+        if (bucket.entries.empty()) {
+            continue;
+        }
+
+        if (bucket.spillFile == NULL) {
+            bucket.spillFile = tmpfile();
+            if (bucket.spillFile == NULL) {
+                return false;
+            }
+        }
+        if (fwrite(&bucket.entries[0], sizeof(unsigned int), bucket.entries.size(), bucket.spillFile) != bucket.entries.size()) {
+            return false;
+        }
+
+        bucket.numSpilled += bucket.entries.size();
+        this->totalSpilled += bucket.entries.size();
+        this->numInMemory -= bucket.entries.size();
+        vector<unsigned int>().swap(bucket.entries);
+    }
+    return true;
+}
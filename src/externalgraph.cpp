@@ -0,0 +1,308 @@
+#include <cstring>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include "externalgraph.h"
+#include "shortestpathtree.h"
+
+/// This class searches a graph whose edges are too many to keep in memory. The edges stay in an external
+/// graph file, sorted by source, and only the offset and distance of each vertex are held in memory.
+/// Searches advance a bucketed frontier a whole bucket at a time: the vertices of the bucket are sorted
+/// and their edges read in a few large reads that cover neighbouring vertices together, so the file is
+/// swept forwards instead of being read one vertex at a time. Half of the memory allowed buffers the edges
+/// read and a quarter holds the frontier, which spills to disk when it grows beyond that.
+///
+
+const unsigned int ExternalGraph::UNREACHED = 0xFFFFFFFF;
+
+/// Edges between two frontier vertices are read rather than skipped when there are no more than this many bytes of them
+const unsigned long EXTERNAL_READ_GAP = 65536;
+
+/// \brief
+/// Creates a graph with no file open
+///
+ExternalGraph::ExternalGraph() {
+    this->descriptor = -1;
+    this->numVertices = 0;
+    this->numEdges = 0;
+    this->totalWeight = 0;
+    this->memoryBytes = 0;
+    this->bytesRead = 0;
+    this->numReads = 0;
+    this->numSpilled = 0;
+}
+
+/// \brief
+/// Closes the file if one is open
+///
+ExternalGraph::~ExternalGraph() {
+    if (this->descriptor >= 0) {
+        ::close(this->descriptor);
+    }
+}
+
+/// \brief
+/// Opens an external graph file and reads the offset of every vertex's edges
+///
+/// \param path const string& - the path of the file written by ExternalGraphWriter
+/// \param memoryBytes unsigned long - the most memory used for edges and the frontier, in bytes
+/// \return bool - false if the file could not be read or is not an external graph file
+///
+bool ExternalGraph::open(const string& path, unsigned long memoryBytes) {
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+
+    ExternalGraphHeader header;
+    if (pread(descriptor, &header, sizeof(header), 0) != sizeof(header)
+        || memcmp(header.magic, ExternalGraphWriter::MAGIC, sizeof(header.magic)) != 0) {
+        ::close(descriptor);
+        return false;
+    }
+
+    vector<unsigned long long> offsets(header.numVertices + 1);
+    ssize_t offsetBytes = offsets.size() * sizeof(unsigned long long);
+    if (pread(descriptor, &offsets[0], offsetBytes, sizeof(header)) != offsetBytes || offsets.back() != header.numEdges) {
+        ::close(descriptor);
+        return false;
+    }
+
+    if (this->descriptor >= 0) {
+        ::close(this->descriptor);
+    }
+    this->descriptor = descriptor;
+    this->numVertices = header.numVertices;
+    this->numEdges = header.numEdges;
+    this->totalWeight = header.totalWeight;
+    this->memoryBytes = memoryBytes;
+    this->offsets.swap(offsets);
+
+    // Sequential access lets the kernel read ahead of the sweep through the file
+    posix_fadvise(descriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    unsigned long bufferEdges = memoryBytes / 2 / sizeof(ExternalEdge);
+    this->buffer.resize(bufferEdges > 0 ? bufferEdges : 1);
+    return true;
+}
+
+/// \brief
+/// Returns the number of vertices within the graph
+///
+/// \return unsigned int - the number of vertices
+///
+unsigned int ExternalGraph::getNumVertices() {
+    return this->numVertices;
+}
+
+/// \brief
+/// Returns the number of edges in the file, counting each direction of an edge once
+///
+/// \return unsigned long long - the number of stored edges
+///
+unsigned long long ExternalGraph::getNumEdges() {
+    return this->numEdges;
+}
+
+/// \brief
+/// Finds the shortest distance from a source to every vertex
+///
+/// \param sourceId unsigned int - the identifier of the source
+/// \param distances vector<double>* - filled with the distance to each vertex, or
+/// ShortestPathTree::UNREACHABLE if there is no path
+/// \return bool - false if the source is not a vertex or the file or frontier could not be read
+///
+bool ExternalGraph::shortestDistances(unsigned int sourceId, vector<double>* distances) {
+    if (sourceId >= this->numVertices) {
+        return false;
+    }
+
+    // Buckets as wide as the average edge keep most relaxations out of the bucket being scanned
+    double bucketWidth = this->numEdges > 0 ? this->totalWeight / this->numEdges : 1.0;
+    ExternalBucketQueue frontier(bucketWidth > 0 ? bucketWidth : 1.0, this->memoryBytes / 4);
+    distances->assign(this->numVertices, ShortestPathTree::UNREACHABLE);
+    vector<double> scannedAt(this->numVertices, ShortestPathTree::UNREACHABLE);
+    (*distances)[sourceId] = 0;
+
+    bool pushed = frontier.push(sourceId, 0);
+    vector<unsigned int> vertices;
+    unsigned long bucket;
+    vector<double>& distance = *distances;
+    function<void(unsigned int, const ExternalEdge&)> relax = [&](unsigned int uId, const ExternalEdge& edge) {
+        double through = distance[uId] + edge.weight;
+        if (through < distance[edge.target]) {
+            distance[edge.target] = through;
+            pushed = frontier.push(edge.target, through) && pushed;
+        }
+    };
+
+    // Edges shorter than a bucket put vertices back into the bucket being scanned, which then comes out
+    // again until none of its vertices improve
+    while (pushed && frontier.popBucket(&vertices, &bucket)) {
+        sort(vertices.begin(), vertices.end());
+        vertices.erase(unique(vertices.begin(), vertices.end()), vertices.end());
+
+        unsigned int kept = 0;
+        for (unsigned int i = 0; i < vertices.size(); i++) {
+            unsigned int uId = vertices[i];
+            if (frontier.getBucket(distance[uId]) == bucket && scannedAt[uId] != distance[uId]) {
+                scannedAt[uId] = distance[uId];
+                vertices[kept++] = uId;
+            }
+        }
+        vertices.resize(kept);
+
+        if (!scanNeighbours(vertices, relax)) {
+            return false;
+        }
+    }
+
+    this->numSpilled += frontier.getNumSpilled();
+    return pushed;
+}
+
+/// \brief
+/// Finds the fewest edges from a source to every vertex
+///
+/// \param sourceId unsigned int - the identifier of the source
+/// \param hops vector<unsigned int>* - filled with the number of edges to each vertex, or UNREACHED
+/// \return bool - false if the source is not a vertex or the file or frontier could not be read
+///
+bool ExternalGraph::hopDistances(unsigned int sourceId, vector<unsigned int>* hops) {
+    if (sourceId >= this->numVertices) {
+        return false;
+    }
+
+    // Each level of the search is one bucket, so the next level can spill while it is being gathered
+    ExternalBucketQueue frontier(1.0, this->memoryBytes / 4);
+    hops->assign(this->numVertices, UNREACHED);
+    (*hops)[sourceId] = 0;
+
+    bool pushed = frontier.push(sourceId, 0);
+    vector<unsigned int> vertices;
+    unsigned long level;
+    vector<unsigned int>& hop = *hops;
+    function<void(unsigned int, const ExternalEdge&)> reach = [&](unsigned int uId, const ExternalEdge& edge) {
+        if (hop[edge.target] == UNREACHED) {
+            hop[edge.target] = hop[uId] + 1;
+            pushed = frontier.push(edge.target, hop[edge.target]) && pushed;
+        }
+    };
+
+    while (pushed && frontier.popBucket(&vertices, &level)) {
+        sort(vertices.begin(), vertices.end());
+        if (!scanNeighbours(vertices, reach)) {
+            return false;
+        }
+    }
+
+    this->numSpilled += frontier.getNumSpilled();
+    return pushed;
+}
+
+/// \brief
+/// Returns the number of bytes of edges read from the file since it was opened
+///
+/// \return unsigned long long - the number of bytes read
+///
+unsigned long long ExternalGraph::getBytesRead() {
+    return this->bytesRead;
+}
+
+/// \brief
+/// Returns the number of reads made from the file since it was opened
+///
+/// \return unsigned long - the number of reads
+///
+unsigned long ExternalGraph::getNumReads() {
+    return this->numReads;
+}
+
+/// \brief
+/// Returns the number of frontier entries the searches have spilled to disk
+///
+/// \return unsigned long - the number of spilled entries
+///
+unsigned long ExternalGraph::getNumSpilled() {
+    return this->numSpilled;
+}
+
+/// \brief
+/// Reads a run of consecutive edges from the file
+///
+/// \param first unsigned long long - the index of the first edge
+/// \param count unsigned long - the number of edges
+/// \return bool - false if the edges could not be read
+///
+bool ExternalGraph::readEdges(unsigned long long first, unsigned long count) {
+    char* into = (char*) &this->buffer[0];
+    unsigned long remaining = count * sizeof(ExternalEdge);
+    off_t position = sizeof(ExternalGraphHeader) + (this->numVertices + 1) * sizeof(unsigned long long)
+        + first * sizeof(ExternalEdge);
+
+    // A read may return less than was asked for, so keep reading until the run is complete
+    while (remaining > 0) {
+        ssize_t numRead = pread(this->descriptor, into, remaining, position);
+        if (numRead <= 0) {
+            return false;
+        }
+        into += numRead;
+        remaining -= numRead;
+        position += numRead;
+        this->bytesRead += numRead;
+        this->numReads++;
+    }
+    return true;
+}
+
+/// \brief
+/// Visits the edges of every vertex of a sorted frontier, reading vertices whose edges lie close
+/// together in the file in a single read
+///
+/// \param frontier const vector<unsigned int>& - the vertices whose edges are visited, sorted and unique
+/// \param visit const function<void(unsigned int, const ExternalEdge&)>& - called with each vertex and edge
+/// \return bool - false if the edges could not be read
+///
+bool ExternalGraph::scanNeighbours(const vector<unsigned int>& frontier, const function<void(unsigned int, const ExternalEdge&)>& visit) {
+    unsigned long capacity = this->buffer.size();
+    unsigned long long gapEdges = min(EXTERNAL_READ_GAP / sizeof(ExternalEdge), capacity / 8);
+    unsigned int i = 0;
+
+    while (i < frontier.size()) {
+        unsigned long long begin = this->offsets[frontier[i]];
+        unsigned long long end = this->offsets[frontier[i] + 1];
+
+        // A vertex with more edges than fit in the buffer is read a piece at a time
+        if (end - begin > capacity) {
+            for (unsigned long long piece = begin; piece < end; piece += capacity) {
+                unsigned long count = end - piece < capacity ? end - piece : capacity;
+                if (!readEdges(piece, count)) {
+                    return false;
+                }
+                for (unsigned long e = 0; e < count; e++) {
+                    visit(frontier[i], this->buffer[e]);
+                }
+            }
+            i++;
+            continue;
+        }
+
+        // Take in the following vertices while the gap before them is small and the read still fits
+        unsigned int j = i + 1;
+        while (j < frontier.size() && this->offsets[frontier[j] + 1] - begin <= capacity
+               && this->offsets[frontier[j]] - end <= gapEdges) {
+            end = this->offsets[frontier[j] + 1];
+            j++;
+        }
+
+        if (end > begin && !readEdges(begin, end - begin)) {
+            return false;
+        }
+        for (; i < j; i++) {
+            for (unsigned long long e = this->offsets[frontier[i]]; e < this->offsets[frontier[i] + 1]; e++) {
+                visit(frontier[i], this->buffer[e - begin]);
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,177 @@
+#include <cstring>
+#include <algorithm>
+#include <queue>
+#include <functional>
+#include "externalgraphwriter.h"
+
+/// This class writes a graph to an external graph file without ever holding all of its edges in memory.
+/// Edges are gathered in a buffer of bounded size, sorted by source and written out as a run whenever
+/// the buffer fills, then the runs are merged into the file in one sequential pass. Only the per vertex
+/// offsets are kept in memory for the whole graph.
+///
+
+const char ExternalGraphWriter::MAGIC[8] = { 'R', 'O', 'A', 'D', 'E', 'D', 'G', 'E' };
+
+/// \brief
+/// Prepares to write a graph with the given number of vertices
+///
+/// \param path const string& - the path of the file to be written
+/// \param numVertices unsigned int - the number of vertices within the graph
+/// \param memoryBytes unsigned long - the most memory used to buffer edges, in bytes
+///
+ExternalGraphWriter::ExternalGraphWriter(const string& path, unsigned int numVertices, unsigned long memoryBytes) {
+    this->path = path;
+    this->numVertices = numVertices;
+    this->bufferCapacity = memoryBytes / sizeof(PendingEdge) > 2 ? memoryBytes / sizeof(PendingEdge) : 2;
+    this->numRuns = 0;
+    this->failed = false;
+}
+
+/// \brief
+/// Closes any runs left behind if finish was not called
+///
+ExternalGraphWriter::~ExternalGraphWriter() {
+    for (unsigned int i = 0; i < this->runs.size(); i++) {
+        fclose(this->runs[i]);
+    }
+}
+
+/// \brief
+/// Adds an undirected edge, which is stored once in each direction
+///
+/// \param sourceId unsigned int - the identifier of one end of the edge
+/// \param destinationId unsigned int - the identifier of the other end of the edge
+/// \param weight double - the weight of the edge
+/// \return bool - false if either end is not a vertex of the graph or a run could not be written
+///
+bool ExternalGraphWriter::addEdge(unsigned int sourceId, unsigned int destinationId, double weight) {
+    if (sourceId >= this->numVertices || destinationId >= this->numVertices) {
+        return false;
+    }
+    PendingEdge forward = { sourceId, destinationId, weight };
+    PendingEdge backward = { destinationId, sourceId, weight };
+
+    if (this->buffer.size() + 2 > this->bufferCapacity && !writeRun()) {
+        return false;
+    }
+    this->buffer.push_back(forward);
+    this->buffer.push_back(backward);
+    return true;
+}
+
+/// \brief
+/// Merges the sorted runs into the graph file
+///
+/// \return bool - false if the file could not be written
+///
+bool ExternalGraphWriter::finish() {
+    if (!this->buffer.empty() && !writeRun()) {
+        return false;
+    }
+    vector<PendingEdge>().swap(this->buffer);
+
+    FILE* file = fopen(this->path.c_str(), "wb");
+    if (file == NULL) {
+        return false;
+    }
+
+    // The header and offsets are written last, once they are known, so leave room for them
+    ExternalGraphHeader header;
+    memset(&header, 0, sizeof(header));
+    vector<unsigned long long> offsets(this->numVertices + 1, 0);
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1
+        && fwrite(&offsets[0], sizeof(unsigned long long), offsets.size(), file) == offsets.size();
+
+    // Each run is read back through its own buffer, sharing the memory allowed between them
+    unsigned long runBufferSize = this->bufferCapacity / (this->runs.size() + 1);
+    runBufferSize = runBufferSize > 0 ? runBufferSize : 1;
+    vector< vector<PendingEdge> > runBuffers(this->runs.size());
+    vector<unsigned long> positions(this->runs.size(), 0);
+    typedef pair<PendingEdge, unsigned int> MergeEntry;
+    priority_queue< MergeEntry, vector<MergeEntry>, greater<MergeEntry> > heads;
+
+    for (unsigned int i = 0; i < this->runs.size(); i++) {
+        rewind(this->runs[i]);
+        runBuffers[i].resize(runBufferSize);
+        runBuffers[i].resize(fread(&runBuffers[i][0], sizeof(PendingEdge), runBufferSize, this->runs[i]));
+        if (!runBuffers[i].empty()) {
+            heads.push(MergeEntry(runBuffers[i][0], i));
+        }
+    }
+
+    // Take the smallest edge from the front of every run until they are all used up
+    unsigned long long numEdges = 0;
+    double totalWeight = 0;
+    while (!heads.empty() && written) {
+        PendingEdge edge = heads.top().first;
+        unsigned int run = heads.top().second;
+        heads.pop();
+
+        ExternalEdge stored = { edge.target, 0, edge.weight };
+        written = fwrite(&stored, sizeof(stored), 1, file) == 1;
+        offsets[edge.source + 1]++;
+        numEdges++;
+        totalWeight += edge.weight;
+
+        if (++positions[run] == runBuffers[run].size()) {
+            runBuffers[run].resize(runBufferSize);
+            runBuffers[run].resize(fread(&runBuffers[run][0], sizeof(PendingEdge), runBufferSize, this->runs[run]));
+            positions[run] = 0;
+        }
+        if (positions[run] < runBuffers[run].size()) {
+            heads.push(MergeEntry(runBuffers[run][positions[run]], run));
+        }
+    }
+
+    for (unsigned int i = 0; i < this->runs.size(); i++) {
+        fclose(this->runs[i]);
+    }
+    this->runs.clear();
+
+    // Turn the edge counts into the index of each vertex's first edge
+    for (unsigned int i = 0; i < this->numVertices; i++) {
+        offsets[i + 1] += offsets[i];
+    }
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.numVertices = this->numVertices;
+    header.numEdges = numEdges;
+    header.totalWeight = totalWeight;
+
+    written = written && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1
+        && fwrite(&offsets[0], sizeof(unsigned long long), offsets.size(), file) == offsets.size();
+    written = fclose(file) == 0 && written && !this->failed;
+    return written;
+}
+
+/// \brief
+/// Returns the number of sorted runs the edges were split into
+///
+/// \return unsigned int - the number of runs
+///
+unsigned int ExternalGraphWriter::getNumRuns() {
+    return this->numRuns;
+}
+
+/// \brief
+/// Sorts the buffered edges and writes them to a new run
+///
+/// \return bool - false if the run could not be written
+///
+bool ExternalGraphWriter::writeRun() {
+    FILE* run = tmpfile();
+    if (run == NULL) {
+        this->failed = true;
+        return false;
+    }
+
+    sort(this->buffer.begin(), this->buffer.end());
+    if (fwrite(&this->buffer[0], sizeof(PendingEdge), this->buffer.size(), run) != this->buffer.size()) {
+        fclose(run);
+        this->failed = true;
+        return false;
+    }
+    this->runs.push_back(run);
+    this->numRuns++;
+    this->buffer.clear();
+    return true;
+}
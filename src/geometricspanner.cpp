@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include "geometricspanner.h"
+#include "searchspace.h"
+
+/// This class thins out a graph whose edges are weighted by the distance between their ends, keeping
+/// only enough edges that every path is at most a stretch factor longer than before. It is the greedy
+/// spanner: the candidate edges are taken shortest first and an edge is only kept when the edges kept
+/// so far offer no path between its ends within the stretch factor of its length. Only edges of the
+/// given graph are ever kept, so roads that are not allowed stay out. Points spread over the plane keep
+/// a number of edges proportional to the number of vertices however many candidates there were, and the
+/// minimum spanning tree of the graph is always kept whole. Most candidates are turned down without a
+/// search by keeping an upper bound on the spanner distance between every pair of vertices, a float per
+/// pair, so building takes memory of the same order as the weights of the graph.
+///
+
+/// \brief
+/// Returns the smallest float that is at least a distance, so bounds kept as floats are never too short
+///
+/// \param distance double - the distance
+/// \return float - the distance rounded up to a float
+///
+static float roundUp(double distance) {
+    float bound = (float) distance;
+    return bound < distance ? nextafterf(bound, numeric_limits<float>::infinity()) : bound;
+}
+
+/// \brief
+/// Creates a spanner builder for the stretch factor given
+///
+/// \param stretch double - how many times longer than in the graph any path in the spanner may be
+///
+GeometricSpanner::GeometricSpanner(double stretch) {
+    this->stretch = stretch < 1.0 ? 1.0 : stretch;
+    this->numCandidateEdges = 0;
+    this->numEdges = 0;
+    this->maxStretch = 1.0;
+}
+
+/// \brief
+/// There was no dynamically created items in this class so there is no need for a destructor method body
+///
+GeometricSpanner::~GeometricSpanner() {
+}
+
+/// \brief
+/// Builds the spanner of a graph as a new graph with vertices of its own
+///
+/// \param graph Graph* - the graph whose edges are the candidates
+/// \return Graph* - the spanner, which the caller must delete
+///
+Graph* GeometricSpanner::build(Graph* graph) {
+    unsigned int numVertices = graph->getNumVertices();
+    Graph* spanner = new Graph(numVertices);
+    for (unsigned int i = 0; i < numVertices; i++) {
+        spanner->addVertex(new Vertex(i));
+    }
+
+    // Every candidate once, shortest first
+    vector< pair<double, pair<unsigned int, unsigned int> > > candidates;
+    for (unsigned int uId = 0; uId < numVertices; uId++) {
+        vector<unsigned int>* adjacent = graph->getNeighbours(uId);
+        for (unsigned int i = 0; i < adjacent->size(); i++) {
+            if ((*adjacent)[i] > uId) {
+                candidates.push_back(make_pair(graph->getWeight(uId, (*adjacent)[i]), make_pair(uId, (*adjacent)[i])));
+            }
+        }
+    }
+    sort(candidates.begin(), candidates.end());
+
+    this->numCandidateEdges = candidates.size();
+    this->numEdges = 0;
+    this->maxStretch = 1.0;
+
+    // Upper bounds on the distance between every pair of vertices in the spanner. They only ever need
+    // lowering as edges are kept, so a candidate whose bound is already short enough needs no search
+    vector<float> bounds((size_t) numVertices * numVertices, numeric_limits<float>::infinity());
+    SearchSpace space(numVertices);
+    unsigned int xId;
+    for (unsigned long i = 0; i < candidates.size(); i++) {
+        double weight = candidates[i].first;
+        unsigned int uId = candidates[i].second.first;
+        unsigned int vId = candidates[i].second.second;
+        double limit = weight * this->stretch;
+        double distance = bounds[(size_t) uId * numVertices + vId];
+
+        // Otherwise search the whole of the spanner from one end, refreshing every bound of that end
+        if (distance > limit) {
+            space.start(uId);
+            while (space.settleNext(spanner, &xId)) {
+                float bound = roundUp(space.getDistance(xId));
+                bounds[(size_t) uId * numVertices + xId] = bound;
+                bounds[(size_t) xId * numVertices + uId] = bound;
+            }
+            distance = space.getDistance(vId);
+        }
+
+        if (distance <= limit) {
+            if (weight > 0 && distance / weight > this->maxStretch) {
+                this->maxStretch = distance / weight;
+            }
+        }
+        else {
+            spanner->addEdge(new Edge(spanner->getVertex(uId), spanner->getVertex(vId), weight));
+            bounds[(size_t) uId * numVertices + vId] = roundUp(weight);
+            bounds[(size_t) vId * numVertices + uId] = roundUp(weight);
+            this->numEdges++;
+        }
+    }
+    return spanner;
+}
+
+/// \brief
+/// Returns the stretch factor the spanner is built for
+///
+/// \return double - the stretch factor
+///
+double GeometricSpanner::getStretch() {
+    return this->stretch;
+}
+
+/// \brief
+/// Returns the number of edges of the graph the last spanner was built from
+///
+/// \return unsigned long - the number of candidate edges
+///
+unsigned long GeometricSpanner::getNumCandidateEdges() {
+    return this->numCandidateEdges;
+}
+
+/// \brief
+/// Returns the number of edges kept in the last spanner built
+///
+/// \return unsigned long - the number of spanner edges
+///
+unsigned long GeometricSpanner::getNumEdges() {
+    return this->numEdges;
+}
+
+/// \brief
+/// Returns the largest ratio between a path of the spanner and the candidate edge it replaced, measured
+/// when the edge was left out. Paths only get shorter as later edges are kept, so no candidate edge is
+/// stretched by more than this in the finished spanner, nor is any path of the graph
+///
+/// \return double - the largest stretch seen, which is never more than the stretch factor
+///
+double GeometricSpanner::getMaxStretch() {
+    return this->maxStretch;
+}
@@ -1,12 +1,25 @@
 #include "graph.h"
 #include "disjointset.h"
+#include "componentindex.h"
+#include "dialqueue.h"
+#include "radixheap.h"
 #include <iomanip>
+#include <functional>
+#include <algorithm>
+#include <climits>
 
 /// This class creates a graph containing all vertex and the edges connecting them
 ///
 
 const double INFINITY = 1000.0;
 
+/// The largest weight, in quanta, searched with Dial's buckets rather than a radix heap; beyond it the
+/// empty buckets scanned outweigh the comparisons saved
+const unsigned long long DIAL_MAX_WEIGHT = 65536;
+
+/// The position in ownedEdges given to pairs of vertices with no edge between them
+const unsigned int NO_EDGE_SLOT = 0xFFFFFFFF;
+
 /// \brief
 /// Creates a graph with the number of vertices specified
 ///
@@ -14,15 +27,28 @@ const double INFINITY = 1000.0;
 ///
 Graph::Graph(unsigned int numVertices) {
     this->numVertices = numVertices;
+    this->neighbours.resize(numVertices);
+    this->components = NULL;
+    this->hasSpanningTree = false;
+    this->spanningTreeCost = 0;
+    this->quantum = 0;
+    this->maxQuantisedWeight = 0;
+    this->maxQuantisationError = 0;
+    this->maxRelativeQuantisationError = 0;
+    this->searchQueue = SEARCH_QUEUE_AUTOMATIC;
 
     // Initializes the size of the second dimension of the array to the number of vertices
     weights = new double*[numVertices];
+    edgeSlots = new unsigned int*[numVertices];
 
     // Initializes the size of the first dimension of the array to the number of vertices
     for (unsigned int x = 0; x < numVertices; x++) {
         weights[x] = new double[numVertices];
+        edgeSlots[x] = new unsigned int[numVertices];
 
         for (unsigned int y = 0; y < numVertices; y++) {
+            edgeSlots[x][y] = NO_EDGE_SLOT;
+
             // Set the diagonal weights of the array to 0
             if (x == y) {
                 weights[x][y] = 0;
@@ -36,7 +62,7 @@ Graph::Graph(unsigned int numVertices) {
 }
 
 /// \brief
-/// Deletes the weights in the 2 dimensional array
+/// Deletes the weights in the 2 dimensional array and the vertices and edges added to the graph
 ///
 /// \param numVertices unsigned int - the number of vertices within the graph
 ///
@@ -44,14 +70,24 @@ Graph::~Graph() {
 
     // Deletes two dimensional array
     for (unsigned int x = 0; x < numVertices; x++) {
-        delete weights[x];
+        delete[] weights[x];
+        delete[] edgeSlots[x];
     }
 
-    delete weights;
+    delete[] weights;
+    delete[] edgeSlots;
+
+    for (unsigned int i = 0; i < this->vertices.size(); i++) {
+        delete this->vertices[i];
+    }
+    for (unsigned int i = 0; i < this->ownedEdges.size(); i++) {
+        delete this->ownedEdges[i];
+    }
 }
 
 /// \brief
-/// Adds a vertex to the vector containing all the vertices of the graph
+/// Adds a vertex to the vector containing all the vertices of the graph. The graph takes ownership
+/// of the vertex and deletes it when the graph is deleted
 ///
 /// \param vertex Vertex* - the vertex to add to the vector
 ///
@@ -83,28 +119,282 @@ Vertex* Graph::getVertex(int identifier) {
 }
 
 /// \brief
-/// Adds an edge connecting two vertices to the graph
+/// Returns the number of vertices within the graph
+///
+/// \return unsigned int - the number of vertices within the graph
+///
+unsigned int Graph::getNumVertices() {
+    return this->numVertices;
+}
+
+/// \brief
+/// Returns whether or not two vertices are connected by an edge
+///
+/// \param sourceId unsigned int - the identifier of the first vertex
+/// \param destinationId unsigned int - the identifier of the second vertex
+/// \return bool - true if an edge connects the two vertices
+///
+bool Graph::hasEdge(unsigned int sourceId, unsigned int destinationId) {
+    return sourceId != destinationId && this->weights[sourceId][destinationId] != INFINITY;
+}
+
+/// \brief
+/// Returns the weight of the edge connecting two vertices
+///
+/// \param sourceId unsigned int - the identifier of the first vertex
+/// \param destinationId unsigned int - the identifier of the second vertex
+/// \return double - the weight of the edge, only meaningful when hasEdge is true
+///
+double Graph::getWeight(unsigned int sourceId, unsigned int destinationId) {
+    return this->weights[sourceId][destinationId];
+}
+
+/// \brief
+/// Returns the identifiers of all vertices connected to a vertex by an edge
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \return vector<unsigned int>* - a pointer to the identifiers of the neighbouring vertices
+///
+vector<unsigned int>* Graph::getNeighbours(unsigned int identifier) {
+    return &this->neighbours[identifier];
+}
+
+/// \brief
+/// Adds an edge connecting two vertices to the graph, replacing any edge already between them. The
+/// graph takes ownership of the edge and deletes it when it is replaced or removed, or when the graph is deleted
 ///
 /// \param edge *Edge - a pointer to the edge object to be added
 ///
 void Graph::addEdge(Edge* edge) {
 
-    // Add edge to priority queue
-    this->edges.push(edge);
+    // Round the weight before the edge is stored
+    if (this->quantum > 0) {
+        double quanta = (double) (unsigned long long) (edge->getWeight() / this->quantum + 0.5);
+        double error = quanta * this->quantum > edge->getWeight() ? quanta * this->quantum - edge->getWeight()
+                                                                  : edge->getWeight() - quanta * this->quantum;
+        this->maxQuantisationError = error > this->maxQuantisationError ? error : this->maxQuantisationError;
+        if (edge->getWeight() > 0 && error / edge->getWeight() > this->maxRelativeQuantisationError) {
+            this->maxRelativeQuantisationError = error / edge->getWeight();
+        }
+        if ((unsigned long long) quanta > this->maxQuantisedWeight) {
+            this->maxQuantisedWeight = (unsigned long long) quanta;
+        }
+        edge->setWeight(quanta * this->quantum);
+    }
+
+    // Keep hold of the edge in the place of any edge it replaces, so only edges in use are kept
     unsigned int sourceId = edge->getSource()->getId();
     unsigned int destinationId = edge->getDestination()->getId();
+    unsigned int slot = this->edgeSlots[sourceId][destinationId];
+    if (slot == NO_EDGE_SLOT) {
+        this->edgeSlots[sourceId][destinationId] = this->ownedEdges.size();
+        this->edgeSlots[destinationId][sourceId] = this->ownedEdges.size();
+        this->ownedEdges.push_back(edge);
+    }
+    else if (this->ownedEdges[slot] != edge) {
+        delete this->ownedEdges[slot];
+        this->ownedEdges[slot] = edge;
+    }
+
+    double oldWeight = GraphObserver::NO_EDGE;
+
+    // Record the vertices as neighbours the first time they are connected
+    if (hasEdge(sourceId, destinationId)) {
+        oldWeight = this->weights[sourceId][destinationId];
+    }
+    else if (sourceId != destinationId) {
+        this->neighbours[sourceId].push_back(destinationId);
+        this->neighbours[destinationId].push_back(sourceId);
+    }
 
     // Sets weight in both x,y and y,x coordinate positions for edge
     this->weights[sourceId][destinationId] = edge->getWeight();
     this->weights[destinationId][sourceId] = edge->getWeight();
+
+    // Tell everything holding results derived from the graph about the change
+    forgetMinimumSpanningTree();
+    for (unsigned int i = 0; i < this->observers.size(); i++) {
+        this->observers[i]->edgeChanged(sourceId, destinationId, oldWeight, edge->getWeight());
+    }
+}
+
+/// \brief
+/// Removes the edge connecting two vertices from the graph and deletes it
+///
+/// \param sourceId unsigned int - the identifier of the first vertex
+/// \param destinationId unsigned int - the identifier of the second vertex
+///
+void Graph::removeEdge(unsigned int sourceId, unsigned int destinationId) {
+
+    // Nothing to do if the vertices are not connected
+    if (!hasEdge(sourceId, destinationId)) {
+        return;
+    }
+
+    double oldWeight = this->weights[sourceId][destinationId];
+    this->weights[sourceId][destinationId] = INFINITY;
+    this->weights[destinationId][sourceId] = INFINITY;
+
+    // Remove each vertex from the other's neighbours
+    for (unsigned int end = 0; end < 2; end++) {
+        unsigned int fromId = end == 0 ? sourceId : destinationId;
+        unsigned int toId = end == 0 ? destinationId : sourceId;
+        vector<unsigned int>& adjacent = this->neighbours[fromId];
+
+        for (unsigned int i = 0; i < adjacent.size(); i++) {
+            if (adjacent[i] == toId) {
+                adjacent[i] = adjacent.back();
+                adjacent.pop_back();
+                break;
+            }
+        }
+    }
+
+    // Delete the edge and move the last edge kept into its place
+    unsigned int slot = this->edgeSlots[sourceId][destinationId];
+    Edge* removed = this->ownedEdges[slot];
+    this->ownedEdges[slot] = this->ownedEdges.back();
+    this->ownedEdges.pop_back();
+    if (slot < this->ownedEdges.size()) {
+        Edge* moved = this->ownedEdges[slot];
+        this->edgeSlots[moved->getSource()->getId()][moved->getDestination()->getId()] = slot;
+        this->edgeSlots[moved->getDestination()->getId()][moved->getSource()->getId()] = slot;
+    }
+    this->edgeSlots[sourceId][destinationId] = NO_EDGE_SLOT;
+    this->edgeSlots[destinationId][sourceId] = NO_EDGE_SLOT;
+    delete removed;
+
+    forgetMinimumSpanningTree();
+    for (unsigned int i = 0; i < this->observers.size(); i++) {
+        this->observers[i]->edgeChanged(sourceId, destinationId, oldWeight, GraphObserver::NO_EDGE);
+    }
+}
+
+/// \brief
+/// Registers an observer to be told about every change made to the edges of the graph
+///
+/// \param observer GraphObserver* - a pointer to the observer to be told about changes
+///
+void Graph::addObserver(GraphObserver* observer) {
+    this->observers.push_back(observer);
+}
+
+/// \brief
+/// Stops an observer from being told about changes made to the edges of the graph
+///
+/// \param observer GraphObserver* - a pointer to the observer to be removed
+///
+void Graph::removeObserver(GraphObserver* observer) {
+    for (unsigned int i = 0; i < this->observers.size(); i++) {
+        if (this->observers[i] == observer) {
+            this->observers.erase(this->observers.begin() + i);
+            return;
+        }
+    }
+}
+
+/// \brief
+/// Sets the component index searches use to skip the vertices a source cannot reach
+///
+/// \param components ComponentIndex* - a pointer to the index, or NULL to search without one
+///
+void Graph::setComponentIndex(ComponentIndex* components) {
+    this->components = components;
+}
+
+/// \brief
+/// Returns the component index of the graph, so query engines can answer unreachable pairs at once
+///
+/// \return ComponentIndex* - a pointer to the index, or NULL if there is none
+///
+ComponentIndex* Graph::getComponentIndex() {
+    return this->components;
+}
+
+/// \brief
+/// Rounds the weight of every edge added from now on to a whole number of quanta, so searches can use
+/// the integer queues. The rounding error of each edge is recorded
+///
+/// \param quantum double - the amount weights are rounded to multiples of, such as a metre
+/// \return bool - false if edges have already been added or the quantum is not positive
+///
+bool Graph::setQuantum(double quantum) {
+    if (!this->ownedEdges.empty() || quantum <= 0) {
+        return false;
+    }
+    this->quantum = quantum;
+    return true;
+}
+
+/// \brief
+/// Returns the amount weights are rounded to multiples of
+///
+/// \return double - the quantum, or zero if weights are not quantised
+///
+double Graph::getQuantum() {
+    return this->quantum;
+}
+
+/// \brief
+/// Returns the largest amount by which rounding changed the weight of an edge
+///
+/// \return double - the largest absolute error, at most half a quantum
+///
+double Graph::getMaxQuantisationError() {
+    return this->maxQuantisationError;
+}
+
+/// \brief
+/// Returns the largest rounding error of an edge as a share of its weight
+///
+/// \return double - the largest relative error
+///
+double Graph::getMaxRelativeQuantisationError() {
+    return this->maxRelativeQuantisationError;
+}
+
+/// \brief
+/// Chooses the priority queue shortestPathTree searches with
+///
+/// \param queue SearchQueue - the queue, or SEARCH_QUEUE_AUTOMATIC to choose by the weights
+///
+void Graph::setSearchQueue(SearchQueue queue) {
+    this->searchQueue = queue;
+}
+
+/// \brief
+/// Returns the priority queue shortestPathTree will search with: the binary heap when weights are not
+/// quantised, otherwise Dial's buckets when the largest weight is small enough and a radix heap when not
+///
+/// \return SearchQueue - the queue used
+///
+SearchQueue Graph::getSearchQueue() {
+    if (this->quantum == 0) {
+        return SEARCH_QUEUE_BINARY_HEAP;
+    }
+    if (this->searchQueue != SEARCH_QUEUE_AUTOMATIC) {
+        return this->searchQueue;
+    }
+    return this->maxQuantisedWeight <= DIAL_MAX_WEIGHT ? SEARCH_QUEUE_DIAL : SEARCH_QUEUE_RADIX_HEAP;
 }
 
 /// \brief
 /// Uses Kruskals algorithm to find the minimum spanning tree of the graph
+/// the first time it is called after the edges last changed; later calls return the cost found then.
+/// Any number of threads may call it at once as long as the edges are not being changed
 ///
 /// \return double - the cost of the minimum spanning tree of the graph
 ///
 double Graph::minimumSpanningTreeCost() {
+    unique_lock<mutex> lock(this->spanningTreeMutex);
+
+    if (this->hasSpanningTree) {
+        return this->spanningTreeCost;
+    }
+
+    // Take the edges lightest first; the graph only keeps the edge in use between each pair of vertices
+    vector<Edge*> liveEdges(this->ownedEdges);
+    stable_sort(liveEdges.begin(), liveEdges.end(), [](Edge* a, Edge* b) { return a->getWeight() < b->getWeight(); });
 
     // Minimum cost to be accumulated througout method
     double minimumCost = 0;
@@ -118,15 +408,13 @@ double Graph::minimumSpanningTreeCost() {
     Vertex* currentEdgeDestination;
 
     // Iterate through all edges and checks if the vertices are not in the same set, joins them
-    while (edges.size() > 0 && edgeCount < this->vertices.size() - 1) {
+    for (unsigned int i = 0; i < liveEdges.size() && edgeCount + 1 < this->vertices.size(); i++) {
 
         // Creates method variables for the edge and it's source and destination vertices
-        currentEdge = this->edges.top();
+        currentEdge = liveEdges[i];
         currentEdgeSource = currentEdge->getSource();
         currentEdgeDestination = currentEdge->getDestination();
 
-        edges.pop();
-
         // Checks if the vertices are not already in the same set
         if (!dSet->sameComponent(currentEdgeSource->getId(), currentEdgeDestination->getId())) {
             edgeCount++;
@@ -136,6 +424,8 @@ double Graph::minimumSpanningTreeCost() {
 
             currentEdgeDestination->addAdjacency(currentEdgeSource->getId());
             currentEdgeSource->addAdjacency(currentEdgeDestination->getId());
+            this->spanningTreeEdges.push_back(currentEdgeSource->getId());
+            this->spanningTreeEdges.push_back(currentEdgeDestination->getId());
 
             // Add edge weight to minimum cost value
             minimumCost += currentEdge->getWeight();
@@ -145,9 +435,104 @@ double Graph::minimumSpanningTreeCost() {
     // Deletes dynamically create disjointSet
     delete dSet;
 
+    this->hasSpanningTree = true;
+    this->spanningTreeCost = minimumCost;
     return minimumCost;
 }
 
+/// \brief
+/// Forgets the minimum spanning tree after an edge has changed, so that it is found again when next needed
+///
+void Graph::forgetMinimumSpanningTree() {
+    if (!this->hasSpanningTree) {
+        return;
+    }
+
+    // The adjacencies of the vertices hold only the edges of the tree
+    for (unsigned int i = 0; i < this->spanningTreeEdges.size(); i++) {
+        this->vertices[this->spanningTreeEdges[i]]->getAdjacencies()->clear();
+    }
+    this->spanningTreeEdges.clear();
+    this->hasSpanningTree = false;
+    this->spanningTreeCost = 0;
+}
+
+/// \brief
+/// Adds the minimum spanning tree to the sections of a snapshot, finding it again first if the edges
+/// have changed since it was last found. The graph must outlive the writing of the snapshot
+///
+/// \param types vector<SnapshotSectionType>* - the kind of each section, added to
+/// \param contents vector< pair<const void*, unsigned long> >* - the address and length of each section, added to
+///
+void Graph::saveMinimumSpanningTree(vector<SnapshotSectionType>* types, vector< pair<const void*, unsigned long> >* contents) {
+    minimumSpanningTreeCost();
+    types->push_back(SNAPSHOT_MST_COST);
+    contents->push_back(make_pair((const void*) &this->spanningTreeCost, (unsigned long) sizeof(double)));
+    types->push_back(SNAPSHOT_MST_EDGES);
+    contents->push_back(make_pair((const void*) this->spanningTreeEdges.data(), (unsigned long) (this->spanningTreeEdges.size() * sizeof(unsigned int))));
+}
+
+/// \brief
+/// Takes the minimum spanning tree from a snapshot instead of running Kruskal's algorithm
+///
+/// \param snapshot Snapshot* - an open snapshot taken from this graph
+/// \return bool - false if the snapshot holds no valid minimum spanning tree
+///
+bool Graph::loadMinimumSpanningTree(Snapshot* snapshot) {
+    unsigned long costLength;
+    unsigned long edgesLength;
+    const double* cost = (const double*) snapshot->getSection(SNAPSHOT_MST_COST, &costLength);
+    const unsigned int* endpoints = (const unsigned int*) snapshot->getSection(SNAPSHOT_MST_EDGES, &edgesLength);
+
+    if (cost == NULL || endpoints == NULL || costLength != sizeof(double) || edgesLength % (2 * sizeof(unsigned int)) != 0) {
+        return false;
+    }
+    unsigned long numEndpoints = edgesLength / sizeof(unsigned int);
+    for (unsigned long i = 0; i < numEndpoints; i++) {
+        if (endpoints[i] >= this->vertices.size()) {
+            return false;
+        }
+    }
+
+    // The adjacencies of the vertices are what the searches over the tree follow
+    unique_lock<mutex> lock(this->spanningTreeMutex);
+    forgetMinimumSpanningTree();
+    this->spanningTreeEdges.assign(endpoints, endpoints + numEndpoints);
+    for (unsigned long i = 0; i < numEndpoints; i += 2) {
+        this->vertices[endpoints[i]]->addAdjacency(endpoints[i + 1]);
+        this->vertices[endpoints[i + 1]]->addAdjacency(endpoints[i]);
+    }
+    this->hasSpanningTree = true;
+    this->spanningTreeCost = *cost;
+    return true;
+}
+
+/// \brief
+/// Returns a fingerprint of the vertices, edges and weights of the graph, so that precomputed
+/// structures can be matched to the graph they were computed from
+///
+/// \return unsigned long long - the fingerprint
+///
+unsigned long long Graph::fingerprint() {
+    unsigned long long hash = Snapshot::checksum(&this->numVertices, sizeof(this->numVertices), 0);
+    vector<unsigned int> adjacent;
+
+    // Neighbours are sorted so the order edges were added in makes no difference
+    for (unsigned int uId = 0; uId < this->numVertices; uId++) {
+        adjacent = this->neighbours[uId];
+        sort(adjacent.begin(), adjacent.end());
+
+        for (unsigned int i = 0; i < adjacent.size(); i++) {
+            if (adjacent[i] > uId) {
+                unsigned int endpoints[2] = { uId, adjacent[i] };
+                hash = Snapshot::checksum(endpoints, sizeof(endpoints), hash);
+                hash = Snapshot::checksum(&this->weights[uId][adjacent[i]], sizeof(double), hash);
+            }
+        }
+    }
+    return hash;
+}
+
 /// \brief
 /// Uses Dijkstra's algorithm to find the shortest path between the source vertex
 /// and all other vertices
@@ -156,6 +541,19 @@ double Graph::minimumSpanningTreeCost() {
 ///
 void Graph::dijkstra(unsigned int sourceId) {
 
+    // Quantised weights are searched with an integer queue and the tree copied onto the vertices
+    if (getSearchQueue() != SEARCH_QUEUE_BINARY_HEAP) {
+        ShortestPathTree tree;
+        shortestPathTree(sourceId, &tree);
+        for (unsigned int i = 0; i < vertices.size(); i++) {
+            vertices[i]->setDiscovered(true);
+            vertices[i]->setMinDistance(tree.isReachable(i) ? tree.getDistance(i) : INFINITY);
+            vertices[i]->setPredecessorId(tree.isReachable(i) ? tree.getPredecessorId(i) : sourceId);
+        }
+        outputPaths(sourceId);
+        return;
+    }
+
     // Queue of vertices not yet visited by algorithim
     priority_queue<Vertex*, vector<Vertex*>, Vertex> unvisitedVerticesQueue;
 
@@ -168,6 +566,12 @@ void Graph::dijkstra(unsigned int sourceId) {
         vertices[i]->setPredecessorId(sourceId);
         vertices[i]->setMinDistance(weights[sourceId][i]);
 
+        // Vertices in other components keep their infinite distance and are never queued
+        if (this->components != NULL && !this->components->isReachable(sourceId, i)) {
+            vertices[i]->setDiscovered(true);
+            continue;
+        }
+
         // Add to queue
         unvisitedVerticesQueue.push(vertices[i]);
     }
@@ -261,6 +665,133 @@ void Graph::bfs(unsigned int sourceId) {
     outputPaths(sourceId);
 }
 
+/// \brief
+/// Uses Dijkstra's algorithm to find the shortest path between the source vertex and all other
+/// vertices without printing them or changing the vertices, so that several searches may run at once
+///
+/// \param sourceId unsigned int - the identifier of the source vertex
+/// \param tree ShortestPathTree* - the tree to be filled with the distances and predecessors found
+///
+void Graph::shortestPathTree(unsigned int sourceId, ShortestPathTree* tree) {
+    SearchQueue queue = getSearchQueue();
+    if (queue == SEARCH_QUEUE_DIAL) {
+        DialQueue buckets(this->maxQuantisedWeight);
+        quantisedShortestPathTree(sourceId, tree, &buckets);
+        return;
+    }
+    if (queue == SEARCH_QUEUE_RADIX_HEAP) {
+        RadixHeap heap;
+        quantisedShortestPathTree(sourceId, tree, &heap);
+        return;
+    }
+    tree->reset(sourceId, this->numVertices);
+
+    // Queue of distance and identifier pairs, closest first; stale entries are skipped when popped
+    priority_queue< pair<double, unsigned int>, vector< pair<double, unsigned int> >,
+                    greater< pair<double, unsigned int> > > unvisitedVerticesQueue;
+    vector<bool> visited(this->numVertices, false);
+
+    unvisitedVerticesQueue.push(make_pair(0.0, sourceId));
+
+    while (unvisitedVerticesQueue.size() > 0) {
+        unsigned int uId = unvisitedVerticesQueue.top().second;
+        unvisitedVerticesQueue.pop();
+
+        if (visited[uId]) {
+            continue;
+        }
+        visited[uId] = true;
+
+        // Relax every edge leaving the popped vertex
+        vector<unsigned int>& adjacent = this->neighbours[uId];
+        for (unsigned int i = 0; i < adjacent.size(); i++) {
+            unsigned int vId = adjacent[i];
+            double distance = tree->getDistance(uId) + this->weights[uId][vId];
+
+            if (!visited[vId] && distance < tree->getDistance(vId)) {
+                tree->setDistance(vId, distance);
+                tree->setPredecessorId(vId, uId);
+                unvisitedVerticesQueue.push(make_pair(distance, vId));
+            }
+        }
+    }
+}
+
+/// \brief
+/// Finds the shortest path tree with a monotone integer queue over the quantised weights
+///
+/// \param sourceId unsigned int - the identifier of the source vertex
+/// \param tree ShortestPathTree* - the tree to be filled with the distances and predecessors found
+/// \param queue Queue* - an empty queue with push, pop and empty
+///
+template<class Queue>
+void Graph::quantisedShortestPathTree(unsigned int sourceId, ShortestPathTree* tree, Queue* queue) {
+    tree->reset(sourceId, this->numVertices);
+
+    // Distances are counted in whole quanta, so the queue never compares two doubles
+    vector<unsigned long long> quanta(this->numVertices, ULLONG_MAX);
+    vector<bool> visited(this->numVertices, false);
+    quanta[sourceId] = 0;
+    queue->push(0, sourceId);
+
+    while (!queue->empty()) {
+        unsigned long long key;
+        unsigned int uId;
+        queue->pop(&key, &uId);
+
+        if (visited[uId] || key != quanta[uId]) {
+            continue;
+        }
+        visited[uId] = true;
+
+        vector<unsigned int>& adjacent = this->neighbours[uId];
+        for (unsigned int i = 0; i < adjacent.size(); i++) {
+            unsigned int vId = adjacent[i];
+            unsigned long long distance = key + (unsigned long long) (this->weights[uId][vId] / this->quantum + 0.5);
+
+            if (!visited[vId] && distance < quanta[vId]) {
+                quanta[vId] = distance;
+                tree->setDistance(vId, distance * this->quantum);
+                tree->setPredecessorId(vId, uId);
+                queue->push(distance, vId);
+            }
+        }
+    }
+}
+
+/// \brief
+/// Uses Breadth First Search algorithm to find the path between the source vertex and all other vertices
+/// using only the edges of the minimum spanning tree, without printing them or changing the vertices.
+/// The tree is found first if the edges have changed since it was last found
+///
+/// \param sourceId unsigned int - the identifier of the source vertex
+/// \param tree ShortestPathTree* - the tree to be filled with the distances and predecessors found
+///
+void Graph::minimumSpanningTreePathTree(unsigned int sourceId, ShortestPathTree* tree) {
+    minimumSpanningTreeCost();
+    tree->reset(sourceId, this->numVertices);
+
+    queue<unsigned int> unvisitedVerticesQueue;
+    unvisitedVerticesQueue.push(sourceId);
+
+    while (unvisitedVerticesQueue.size() > 0) {
+        unsigned int currentId = unvisitedVerticesQueue.front();
+        unvisitedVerticesQueue.pop();
+
+        // The tree has a single path to each vertex so the first discovery is final
+        set<unsigned int>* adjSet = this->vertices[currentId]->getAdjacencies();
+        for (set<unsigned int>::iterator Iterator = adjSet->begin(); Iterator != adjSet->end(); Iterator++) {
+            unsigned int vId = *Iterator;
+
+            if (!tree->isReachable(vId)) {
+                tree->setDistance(vId, tree->getDistance(currentId) + this->weights[currentId][vId]);
+                tree->setPredecessorId(vId, currentId);
+                unvisitedVerticesQueue.push(vId);
+            }
+        }
+    }
+}
+
 /// \brief
 /// Returns output containing a string representation of the graph in a dimensional array of weights
 ///
@@ -314,8 +845,8 @@ void Graph::outputPaths(unsigned int sourceId) {
         // Check that the vertex is not the source
         if (u->getId() != sourceId) {
 
-            // The destination vertex does not connect to any other vertex
-            if (u->getMinDistance() == INFINITY) {
+            // The destination vertex is in another component or does not connect to any other vertex
+            if ((this->components != NULL && !this->components->isReachable(sourceId, u->getId())) || u->getMinDistance() == INFINITY) {
                 cout << "NO PATH  from " << sourceId << " to " << u->getId() << endl;
             }
 
@@ -0,0 +1,10 @@
+#include <limits>
+#include "graphobserver.h"
+
+using namespace std;
+
+/// This class is implemented by anything holding results derived from a graph, so that the graph can
+/// tell it whenever the weight of an edge changes
+///
+
+const double GraphObserver::NO_EDGE = numeric_limits<double>::infinity();
@@ -0,0 +1,393 @@
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <queue>
+#include <functional>
+#include "hublabels.h"
+
+/// This class is a distance oracle built with pruned landmark labelling. Every vertex is given a label of
+/// hubs and their distances such that any shortest path passes through a hub shared by the labels of its
+/// two ends, so a distance query is a merge of two short sorted lists and never searches the graph.
+///
+/// Hubs are stored by rank in one array and their distances in another, with every label ending in a
+/// sentinel rank larger than any real one, so the merge runs over plain integer arrays without bounds checks.
+/// The arrays are read through pointers so labels taken from a snapshot are used in place without copying.
+///
+
+const unsigned int HubLabels::SENTINEL = numeric_limits<unsigned int>::max();
+
+const unsigned int ORDER_SAMPLE_SOURCES = 32;
+const unsigned int SEQUENTIAL_ROOTS = 64;
+const unsigned int ROOTS_PER_WORKER = 2;
+
+/// The working state of one worker's pruned searches, allocated once per build
+struct PrunedSearch {
+    vector<double> rootDistances;
+    vector<double> distances;
+    vector<unsigned int> reachedGeneration;
+    unsigned int generation;
+    priority_queue< pair<double, unsigned int>, vector< pair<double, unsigned int> >,
+                    greater< pair<double, unsigned int> > > unvisitedVerticesQueue;
+};
+
+/// \brief
+/// Creates an empty set of labels
+///
+HubLabels::HubLabels() {
+    this->numVertices = 0;
+    this->offsetData = NULL;
+    this->hubData = NULL;
+    this->distanceData = NULL;
+    this->numEntries = 0;
+    this->buildSeconds = 0;
+}
+
+/// \brief
+/// There was no dynamically created items in this class so there is no need for a destructor method body
+///
+HubLabels::~HubLabels() {}
+
+/// \brief
+/// Builds the labels for every vertex of the graph. Vertices that lie on many shortest paths are
+/// ranked first, then roots are searched in rank order in batches shared between the workers
+///
+/// \param graph Graph* - the graph the labels are built for
+/// \param pool WorkerPool* - the workers the searches are shared between
+///
+void HubLabels::build(Graph* graph, WorkerPool* pool) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    this->numVertices = graph->getNumVertices();
+
+    vector<unsigned int> order;
+    orderVertices(graph, pool, &order);
+
+    // Labels hold rank and distance pairs, kept in rank order as roots are searched in rank order
+    vector< vector< pair<unsigned int, double> > > labels(this->numVertices);
+
+    unsigned int numLanes = pool->getNumWorkers() + 1;
+    vector<PrunedSearch> searches(numLanes);
+    for (unsigned int lane = 0; lane < numLanes; lane++) {
+        searches[lane].rootDistances.assign(this->numVertices, ShortestPathTree::UNREACHABLE);
+        searches[lane].distances.resize(this->numVertices);
+        searches[lane].reachedGeneration.assign(this->numVertices, 0);
+        searches[lane].generation = 0;
+    }
+
+    unsigned int rank = 0;
+    while (rank < this->numVertices) {
+
+        // The highest ranked roots prune the most so they are searched one at a time
+        unsigned int batchSize = rank < SEQUENTIAL_ROOTS ? 1 : numLanes * ROOTS_PER_WORKER;
+        if (rank + batchSize > this->numVertices) {
+            batchSize = this->numVertices - rank;
+        }
+        unsigned int batchLanes = batchSize < numLanes ? batchSize : numLanes;
+        vector< vector< pair<unsigned int, double> > > found(batchSize);
+        unsigned int firstRank = rank;
+
+        // Roots in a batch only prune against labels from earlier batches, which are not changed until the
+        // batch ends; this gives up a little pruning but the labels still cover every shortest path
+        pool->parallelFor(batchLanes, [&](unsigned int lane) {
+            PrunedSearch& search = searches[lane];
+
+            for (unsigned int i = lane; i < batchSize; i += batchLanes) {
+                unsigned int rootId = order[firstRank + i];
+                vector< pair<unsigned int, double> >& rootLabel = labels[rootId];
+
+                for (unsigned int j = 0; j < rootLabel.size(); j++) {
+                    search.rootDistances[rootLabel[j].first] = rootLabel[j].second;
+                }
+
+                search.generation++;
+                search.reachedGeneration[rootId] = search.generation;
+                search.distances[rootId] = 0;
+                search.unvisitedVerticesQueue.push(make_pair(0.0, rootId));
+
+                while (!search.unvisitedVerticesQueue.empty()) {
+                    double uDistance = search.unvisitedVerticesQueue.top().first;
+                    unsigned int uId = search.unvisitedVerticesQueue.top().second;
+                    search.unvisitedVerticesQueue.pop();
+
+                    if (uDistance > search.distances[uId]) {
+                        continue;
+                    }
+
+                    // Prune when hubs already labelled give a path at least as short
+                    vector< pair<unsigned int, double> >& uLabel = labels[uId];
+                    bool covered = false;
+                    for (unsigned int j = 0; j < uLabel.size() && !covered; j++) {
+                        covered = search.rootDistances[uLabel[j].first] + uLabel[j].second <= uDistance;
+                    }
+                    if (covered) {
+                        continue;
+                    }
+                    found[i].push_back(make_pair(uId, uDistance));
+
+                    vector<unsigned int>* adjacent = graph->getNeighbours(uId);
+                    for (unsigned int j = 0; j < adjacent->size(); j++) {
+                        unsigned int vId = (*adjacent)[j];
+                        double distance = uDistance + graph->getWeight(uId, vId);
+
+                        if (search.reachedGeneration[vId] != search.generation || distance < search.distances[vId]) {
+                            search.reachedGeneration[vId] = search.generation;
+                            search.distances[vId] = distance;
+                            search.unvisitedVerticesQueue.push(make_pair(distance, vId));
+                        }
+                    }
+                }
+
+                for (unsigned int j = 0; j < rootLabel.size(); j++) {
+                    search.rootDistances[rootLabel[j].first] = ShortestPathTree::UNREACHABLE;
+                }
+            }
+        });
+
+        // Add the batch's hubs to the labels in rank order
+        for (unsigned int i = 0; i < batchSize; i++) {
+            for (unsigned int j = 0; j < found[i].size(); j++) {
+                labels[found[i][j].first].push_back(make_pair(firstRank + i, found[i][j].second));
+            }
+        }
+        rank += batchSize;
+    }
+
+    // Flatten the labels into contiguous arrays, each label ending with the sentinel
+    this->offsets.resize(this->numVertices + 1);
+    this->hubs.clear();
+    this->distances.clear();
+    for (unsigned int i = 0; i < this->numVertices; i++) {
+        this->offsets[i] = this->hubs.size();
+        for (unsigned int j = 0; j < labels[i].size(); j++) {
+            this->hubs.push_back(labels[i][j].first);
+            this->distances.push_back(labels[i][j].second);
+        }
+        this->hubs.push_back(SENTINEL);
+        this->distances.push_back(ShortestPathTree::UNREACHABLE);
+    }
+    this->offsets[this->numVertices] = this->hubs.size();
+    this->offsetData = this->offsets.data();
+    this->hubData = this->hubs.data();
+    this->distanceData = this->distances.data();
+    this->numEntries = this->hubs.size();
+
+    this->buildSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/// \brief
+/// Adds the labels to the sections of a snapshot. The labels must outlive the writing of the snapshot
+///
+/// \param types vector<SnapshotSectionType>* - the kind of each section, added to
+/// \param contents vector< pair<const void*, unsigned long> >* - the address and length of each section, added to
+///
+void HubLabels::save(vector<SnapshotSectionType>* types, vector< pair<const void*, unsigned long> >* contents) {
+    types->push_back(SNAPSHOT_HUB_OFFSETS);
+    contents->push_back(make_pair((const void*) this->offsetData, (unsigned long) ((this->numVertices + 1) * sizeof(unsigned long))));
+    types->push_back(SNAPSHOT_HUB_HUBS);
+    contents->push_back(make_pair((const void*) this->hubData, (unsigned long) (this->numEntries * sizeof(unsigned int))));
+    types->push_back(SNAPSHOT_HUB_DISTANCES);
+    contents->push_back(make_pair((const void*) this->distanceData, (unsigned long) (this->numEntries * sizeof(double))));
+}
+
+/// \brief
+/// Uses the labels held in a snapshot in place. The snapshot must stay open for as long as the labels are used
+///
+/// \param snapshot Snapshot* - an open snapshot taken from the graph the labels are wanted for
+/// \param numVertices unsigned int - the number of vertices within the graph
+/// \return bool - false if the snapshot holds no valid labels for that many vertices
+///
+bool HubLabels::load(Snapshot* snapshot, unsigned int numVertices) {
+    unsigned long offsetsLength;
+    unsigned long hubsLength;
+    unsigned long distancesLength;
+    const unsigned long* offsetData = (const unsigned long*) snapshot->getSection(SNAPSHOT_HUB_OFFSETS, &offsetsLength);
+    const unsigned int* hubData = (const unsigned int*) snapshot->getSection(SNAPSHOT_HUB_HUBS, &hubsLength);
+    const double* distanceData = (const double*) snapshot->getSection(SNAPSHOT_HUB_DISTANCES, &distancesLength);
+
+    if (offsetData == NULL || hubData == NULL || distanceData == NULL
+        || offsetsLength != (numVertices + 1) * sizeof(unsigned long) || hubsLength % sizeof(unsigned int) != 0) {
+        return false;
+    }
+    unsigned long numEntries = hubsLength / sizeof(unsigned int);
+    if (distancesLength != numEntries * sizeof(double) || offsetData[numVertices] != numEntries) {
+        return false;
+    }
+
+    // Every label must lie inside the arrays and end in the sentinel, or a query could run off the end
+    for (unsigned int i = 0; i < numVertices; i++) {
+        if (offsetData[i] >= offsetData[i + 1] || hubData[offsetData[i + 1] - 1] != SENTINEL) {
+            return false;
+        }
+    }
+
+    // Any labels built earlier are no longer needed
+    vector<unsigned long>().swap(this->offsets);
+    vector<unsigned int>().swap(this->hubs);
+    vector<double>().swap(this->distances);
+    this->numVertices = numVertices;
+    this->offsetData = offsetData;
+    this->hubData = hubData;
+    this->distanceData = distanceData;
+    this->numEntries = numEntries;
+    this->buildSeconds = 0;
+    return true;
+}
+
+/// \brief
+/// Returns the shortest path distance between two vertices
+///
+/// \param sourceId unsigned int - the identifier of the first vertex
+/// \param destinationId unsigned int - the identifier of the second vertex
+/// \return double - the distance, or ShortestPathTree::UNREACHABLE if there is no path
+///
+double HubLabels::distance(unsigned int sourceId, unsigned int destinationId) {
+    const unsigned int* sourceHubs = this->hubData + this->offsetData[sourceId];
+    const unsigned int* destinationHubs = this->hubData + this->offsetData[destinationId];
+    const double* sourceDistances = this->distanceData + this->offsetData[sourceId];
+    const double* destinationDistances = this->distanceData + this->offsetData[destinationId];
+    double best = ShortestPathTree::UNREACHABLE;
+
+    // Merge the two sorted labels; both end in the sentinel so only equal ranks need checking for the end
+    while (true) {
+        unsigned int sourceHub = *sourceHubs;
+        unsigned int destinationHub = *destinationHubs;
+
+        if (sourceHub == destinationHub) {
+            if (sourceHub == SENTINEL) {
+                break;
+            }
+            double distance = *sourceDistances + *destinationDistances;
+            best = distance < best ? distance : best;
+        }
+
+        // Advance whichever label is behind, or both when they match
+        bool advanceSource = sourceHub <= destinationHub;
+        bool advanceDestination = destinationHub <= sourceHub;
+        sourceHubs += advanceSource;
+        sourceDistances += advanceSource;
+        destinationHubs += advanceDestination;
+        destinationDistances += advanceDestination;
+    }
+    return best;
+}
+
+/// \brief
+/// Returns the hubs of a vertex's label, sorted by rank, and their distances from the vertex
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \param hubs const unsigned int** - set to the ranks of the hubs, followed by the sentinel
+/// \param distances const double** - set to the distances of the hubs
+/// \return unsigned int - the number of hubs, not counting the sentinel
+///
+unsigned int HubLabels::getLabel(unsigned int identifier, const unsigned int** hubs, const double** distances) {
+    *hubs = this->hubData + this->offsetData[identifier];
+    *distances = this->distanceData + this->offsetData[identifier];
+    return this->offsetData[identifier + 1] - this->offsetData[identifier] - 1;
+}
+
+/// \brief
+/// Returns the number of vertices labelled
+///
+/// \return unsigned int - the number of vertices
+///
+unsigned int HubLabels::getNumVertices() {
+    return this->numVertices;
+}
+
+/// \brief
+/// Returns the average number of hubs in a label
+///
+/// \return double - the average label size
+///
+double HubLabels::getAverageLabelSize() {
+    if (this->numVertices == 0) {
+        return 0;
+    }
+    return (double) (this->numEntries - this->numVertices) / this->numVertices;
+}
+
+/// \brief
+/// Returns the number of hubs in the largest label
+///
+/// \return unsigned int - the largest label size
+///
+unsigned int HubLabels::getMaximumLabelSize() {
+    unsigned int largest = 0;
+    for (unsigned int i = 0; i < this->numVertices; i++) {
+        unsigned int size = this->offsetData[i + 1] - this->offsetData[i] - 1;
+        largest = size > largest ? size : largest;
+    }
+    return largest;
+}
+
+/// \brief
+/// Returns the number of seconds the last build took
+///
+/// \return double - the build time in seconds
+///
+double HubLabels::getBuildSeconds() {
+    return this->buildSeconds;
+}
+
+/// \brief
+/// Returns the number of bytes used by the labels
+///
+/// \return unsigned long - the memory used in bytes
+///
+unsigned long HubLabels::memoryUsage() {
+    if (this->offsetData == NULL) {
+        return 0;
+    }
+    return (this->numVertices + 1) * sizeof(unsigned long) + this->numEntries * (sizeof(unsigned int) + sizeof(double));
+}
+
+/// \brief
+/// Ranks the vertices so those covering the most shortest paths come first, judged by the size of
+/// the subtrees below each vertex in shortest path trees from a sample of sources
+///
+/// \param graph Graph* - the graph being labelled
+/// \param pool WorkerPool* - the workers the sample searches are shared between
+/// \param order vector<unsigned int>* - filled with the identifiers of the vertices, highest rank first
+///
+void HubLabels::orderVertices(Graph* graph, WorkerPool* pool, vector<unsigned int>* order) {
+    unsigned int numSamples = ORDER_SAMPLE_SOURCES < this->numVertices ? ORDER_SAMPLE_SOURCES : this->numVertices;
+    vector< vector<unsigned long> > subtreeSizes(numSamples);
+
+    pool->parallelFor(numSamples, [&](unsigned int sample) {
+        ShortestPathTree tree;
+        vector< pair<double, unsigned int> > byDistance;
+        vector<unsigned long>& sizes = subtreeSizes[sample];
+
+        graph->shortestPathTree((unsigned long) sample * this->numVertices / numSamples, &tree);
+        sizes.assign(this->numVertices, 1);
+
+        // Add each vertex's subtree to its predecessor, furthest vertices first
+        for (unsigned int i = 0; i < this->numVertices; i++) {
+            if (tree.isReachable(i)) {
+                byDistance.push_back(make_pair(tree.getDistance(i), i));
+            }
+        }
+        sort(byDistance.begin(), byDistance.end());
+        for (unsigned int i = byDistance.size(); i > 0; i--) {
+            unsigned int vId = byDistance[i - 1].second;
+            if (vId != tree.getSourceId()) {
+                sizes[tree.getPredecessorId(vId)] += sizes[vId];
+            }
+        }
+    });
+
+    // Score by total subtree size with degree breaking ties
+    vector< pair< pair<unsigned long, unsigned int>, unsigned int> > scores(this->numVertices);
+    for (unsigned int i = 0; i < this->numVertices; i++) {
+        unsigned long total = 0;
+        for (unsigned int sample = 0; sample < numSamples; sample++) {
+            total += subtreeSizes[sample][i];
+        }
+        scores[i] = make_pair(make_pair(total, (unsigned int) graph->getNeighbours(i)->size()), i);
+    }
+    sort(scores.begin(), scores.end(), greater< pair< pair<unsigned long, unsigned int>, unsigned int> >());
+
+    order->resize(this->numVertices);
+    for (unsigned int i = 0; i < this->numVertices; i++) {
+        (*order)[i] = scores[i].second;
+    }
+}
@@ -0,0 +1,321 @@
+#include "kshortestpaths.h"
+#include <set>
+#include <algorithm>
+
+/// This class finds the k shortest simple paths between two vertices with Yen's algorithm, for offering
+/// alternative routes. Each path found is deviated from at every vertex along it: the path up to that vertex
+/// is kept as a root, the root vertices and the next edge of every path found with the same root are removed,
+/// and the shortest spur from that vertex to the destination completes a candidate. The shortest candidate
+/// becomes the next path.
+///
+/// A search backwards from the destination, stopped once it settles the source, is shared by every spur. Its
+/// distances are lower bounds on the distance to the destination however many vertices and edges are removed,
+/// so spurs are searched with A* instead of Dijkstra, and a spur whose first step joins a path of the backwards
+/// search that avoids the root is complete without any search. Spurs whose lower bound cannot beat the
+/// candidates already held are not searched at all. The spurs of a path are independent of one another and
+/// are shared out between the worker pool, each lane having its own search state.
+///
+
+/// \brief
+/// Creates the working state for finding paths on the graph
+///
+/// \param graph Graph* - the graph to be searched, which must not change while paths are being found
+/// \param pool WorkerPool* - the worker threads spur searches are shared out between
+///
+KShortestPaths::KShortestPaths(Graph* graph, WorkerPool* pool) {
+    this->graph = graph;
+    this->pool = pool;
+    this->backwards = new SearchSpace(graph->getNumVertices());
+    this->destinationId = 0;
+    this->sourceDistance = 0;
+    this->numSettled = 0;
+    this->numShortcuts = 0;
+    this->numPruned = 0;
+
+    unsigned int numLanes = pool->getNumWorkers() > 0 ? pool->getNumWorkers() : 1;
+    this->lanes.resize(numLanes);
+    for (unsigned int i = 0; i < numLanes; i++) {
+        this->lanes[i].distances.resize(graph->getNumVertices());
+        this->lanes[i].predecessors.resize(graph->getNumVertices());
+        this->lanes[i].reachedGeneration.assign(graph->getNumVertices(), 0);
+        this->lanes[i].removedGeneration.assign(graph->getNumVertices(), 0);
+        this->lanes[i].generation = 0;
+    }
+}
+
+/// \brief
+/// Deletes the backwards search
+///
+KShortestPaths::~KShortestPaths() {
+    delete this->backwards;
+}
+
+/// \brief
+/// Finds up to k shortest simple paths from the source to the destination
+///
+/// \param sourceId unsigned int - the identifier of the source vertex
+/// \param destinationId unsigned int - the identifier of the destination vertex
+/// \param count unsigned int - the number of paths wanted
+/// \param paths vector< pair<double, vector<unsigned int> > >* - filled with length and vertex list pairs,
+///        shortest first; fewer than k when the graph has fewer simple paths between the vertices
+///
+void KShortestPaths::find(unsigned int sourceId, unsigned int destinationId, unsigned int count, vector< pair<double, vector<unsigned int> > >* paths) {
+    paths->clear();
+    this->numSettled = 0;
+    this->numShortcuts = 0;
+    this->numPruned = 0;
+    for (unsigned int i = 0; i < this->lanes.size(); i++) {
+        this->lanes[i].numSettled = 0;
+        this->lanes[i].numShortcuts = 0;
+        this->lanes[i].numPruned = 0;
+    }
+    if (count == 0) {
+        return;
+    }
+
+    // The graph is undirected, so searching from the destination gives distances to it, and stopping at the
+    // source costs no more than a point to point query
+    this->destinationId = destinationId;
+    this->backwards->start(destinationId);
+    unsigned int uId;
+    while (this->backwards->settleNext(this->graph, &uId)) {
+        this->numSettled++;
+        if (uId == sourceId) {
+            break;
+        }
+    }
+    if (!this->backwards->isSettled(sourceId)) {
+        return;
+    }
+    this->sourceDistance = this->backwards->getDistance(sourceId);
+
+    // The first path follows the predecessors of the backwards search, which point towards the destination
+    vector< vector<unsigned int> > found(1);
+    found[0].push_back(sourceId);
+    while (found[0].back() != destinationId) {
+        found[0].push_back(this->backwards->getPredecessorId(found[0].back()));
+    }
+    paths->push_back(make_pair(this->sourceDistance, found[0]));
+
+    set< pair<double, vector<unsigned int> > > candidates;
+    set< vector<unsigned int> > seen;
+    seen.insert(found[0]);
+    vector<double> rootLengths;
+    vector< pair<double, vector<unsigned int> > > spurCandidates;
+    vector<char> spurFound;
+    while (paths->size() < count) {
+        vector<unsigned int>& path = found.back();
+        rootLengths.assign(1, 0.0);
+        for (unsigned int i = 1; i < path.size(); i++) {
+            rootLengths.push_back(rootLengths.back() + this->graph->getWeight(path[i - 1], path[i]));
+        }
+
+        // Only the candidates that could still be among the k shortest are kept, so once there are enough of
+        // them the longest is a bound every spur must beat
+        double bound = candidates.size() >= count - paths->size() ? candidates.rbegin()->first : ShortestPathTree::UNREACHABLE;
+
+        // Every vertex but the destination is deviated from, with the spurs shared out between the lanes
+        unsigned int numSpurs = path.size() - 1;
+        spurCandidates.assign(numSpurs, pair<double, vector<unsigned int> >());
+        spurFound.assign(numSpurs, 0);
+        this->pool->parallelFor(this->lanes.size(), [&](unsigned int lane) {
+            for (unsigned int i = lane; i < numSpurs; i += this->lanes.size()) {
+                spurFound[i] = spur(&this->lanes[lane], &path, &rootLengths, i, &found, bound, &spurCandidates[i]) ? 1 : 0;
+            }
+        });
+
+        for (unsigned int i = 0; i < numSpurs; i++) {
+            if (spurFound[i] && seen.insert(spurCandidates[i].second).second) {
+                candidates.insert(spurCandidates[i]);
+            }
+        }
+        if (candidates.empty()) {
+            break;
+        }
+
+        found.push_back(candidates.begin()->second);
+        paths->push_back(*candidates.begin());
+        candidates.erase(candidates.begin());
+        while (candidates.size() > count - paths->size()) {
+            candidates.erase(--candidates.end());
+        }
+    }
+
+    for (unsigned int i = 0; i < this->lanes.size(); i++) {
+        this->numSettled += this->lanes[i].numSettled;
+        this->numShortcuts += this->lanes[i].numShortcuts;
+        this->numPruned += this->lanes[i].numPruned;
+    }
+}
+
+/// \brief
+/// Returns the number of vertices settled by the backwards search and the spur searches of the last call to find
+///
+/// \return unsigned long - the number of settled vertices
+///
+unsigned long KShortestPaths::getNumSettled() {
+    return this->numSettled;
+}
+
+/// \brief
+/// Returns the number of spurs of the last call to find that were completed along the backwards search
+/// without searching
+///
+/// \return unsigned int - the number of spurs completed without searching
+///
+unsigned int KShortestPaths::getNumShortcuts() {
+    return this->numShortcuts;
+}
+
+/// \brief
+/// Returns the number of spurs of the last call to find that were skipped because they could not beat
+/// the candidates already held
+///
+/// \return unsigned int - the number of spurs skipped
+///
+unsigned int KShortestPaths::getNumPruned() {
+    return this->numPruned;
+}
+
+/// \brief
+/// Returns a lower bound on the distance from a vertex to the destination, exact for vertices settled
+/// by the backwards search and the distance of the source for the rest, which no unsettled vertex can beat
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \return double - the lower bound
+///
+double KShortestPaths::remaining(unsigned int identifier) {
+    return this->backwards->isSettled(identifier) ? this->backwards->getDistance(identifier) : this->sourceDistance;
+}
+
+/// \brief
+/// Finds the shortest spur that leaves a vertex of a path, avoiding the root before it and the edges
+/// already used by paths with the same root
+///
+/// \param lane SpurLane* - the search state of the lane doing the search
+/// \param path vector<unsigned int>* - the path being deviated from
+/// \param rootLengths vector<double>* - the length of the path up to each of its vertices
+/// \param spurIndex unsigned int - the position in the path of the vertex the spur leaves
+/// \param found vector< vector<unsigned int> >* - every path found so far
+/// \param bound double - the length a candidate must be shorter than to be of use
+/// \param candidate pair<double, vector<unsigned int> >* - set to the root and spur when one is found
+/// \return bool - true if a spur shorter than the bound was found
+///
+bool KShortestPaths::spur(SpurLane* lane, vector<unsigned int>* path, vector<double>* rootLengths, unsigned int spurIndex,
+                          vector< vector<unsigned int> >* found, double bound, pair<double, vector<unsigned int> >* candidate) {
+
+    // Moving to a new generation restores every vertex removed for the last spur without visiting them
+    lane->generation++;
+    if (lane->generation == 0) {
+        lane->reachedGeneration.assign(lane->reachedGeneration.size(), 0);
+        lane->removedGeneration.assign(lane->removedGeneration.size(), 0);
+        lane->generation = 1;
+    }
+    for (unsigned int i = 0; i <= spurIndex; i++) {
+        lane->removedGeneration[(*path)[i]] = lane->generation;
+    }
+
+    // The next edge of every path found with the same root is removed; all of them leave the spur vertex
+    unsigned int spurId = (*path)[spurIndex];
+    vector<unsigned int> removedNext;
+    for (unsigned int i = 0; i < found->size(); i++) {
+        vector<unsigned int>& other = (*found)[i];
+        if (other.size() > spurIndex + 1 && equal(other.begin(), other.begin() + spurIndex + 1, path->begin())) {
+            removedNext.push_back(other[spurIndex + 1]);
+        }
+    }
+
+    // The cheapest first step by its lower bound decides whether the spur is worth searching, and if the
+    // backwards search continues from it without touching the root it is the spur
+    double rootLength = (*rootLengths)[spurIndex];
+    vector<unsigned int>* neighbours = this->graph->getNeighbours(spurId);
+    double bestKey = ShortestPathTree::UNREACHABLE;
+    unsigned int bestId = spurId;
+    for (unsigned int i = 0; i < neighbours->size(); i++) {
+        unsigned int vId = (*neighbours)[i];
+        if (lane->removedGeneration[vId] == lane->generation || std::find(removedNext.begin(), removedNext.end(), vId) != removedNext.end()) {
+            continue;
+        }
+        double key = this->graph->getWeight(spurId, vId) + remaining(vId);
+        if (key < bestKey) {
+            bestKey = key;
+            bestId = vId;
+        }
+    }
+    if (bestId == spurId || rootLength + bestKey >= bound) {
+        lane->numPruned++;
+        return false;
+    }
+    if (this->backwards->isSettled(bestId)) {
+        unsigned int current = bestId;
+        while (current != this->destinationId && lane->removedGeneration[current] != lane->generation) {
+            current = this->backwards->getPredecessorId(current);
+        }
+        if (current == this->destinationId) {
+            candidate->first = rootLength + bestKey;
+            candidate->second.assign(path->begin(), path->begin() + spurIndex + 1);
+            for (current = bestId; current != this->destinationId; current = this->backwards->getPredecessorId(current)) {
+                candidate->second.push_back(current);
+            }
+            candidate->second.push_back(this->destinationId);
+            lane->numShortcuts++;
+            return true;
+        }
+    }
+
+    // A* from the spur vertex; settled vertices are marked removed so stale queue entries are skipped
+    while (!lane->queue.empty()) {
+        lane->queue.pop();
+    }
+    lane->distances[spurId] = 0;
+    lane->predecessors[spurId] = spurId;
+    for (unsigned int i = 0; i < neighbours->size(); i++) {
+        unsigned int vId = (*neighbours)[i];
+        if (lane->removedGeneration[vId] != lane->generation && std::find(removedNext.begin(), removedNext.end(), vId) == removedNext.end()) {
+            lane->reachedGeneration[vId] = lane->generation;
+            lane->distances[vId] = this->graph->getWeight(spurId, vId);
+            lane->predecessors[vId] = spurId;
+            lane->queue.push(QueueEntry(lane->distances[vId] + remaining(vId), vId));
+        }
+    }
+    while (!lane->queue.empty()) {
+        QueueEntry entry = lane->queue.top();
+        lane->queue.pop();
+        unsigned int uId = entry.second;
+        if (lane->removedGeneration[uId] == lane->generation) {
+            continue;
+        }
+        if (rootLength + entry.first >= bound) {
+            return false;
+        }
+        lane->removedGeneration[uId] = lane->generation;
+        lane->numSettled++;
+
+        if (uId == this->destinationId) {
+            candidate->first = rootLength + lane->distances[uId];
+            candidate->second.clear();
+            for (unsigned int current = uId; current != spurId; current = lane->predecessors[current]) {
+                candidate->second.push_back(current);
+            }
+            candidate->second.insert(candidate->second.end(), path->rend() - spurIndex - 1, path->rend());
+            reverse(candidate->second.begin(), candidate->second.end());
+            return true;
+        }
+
+        vector<unsigned int>* uNeighbours = this->graph->getNeighbours(uId);
+        for (unsigned int i = 0; i < uNeighbours->size(); i++) {
+            unsigned int vId = (*uNeighbours)[i];
+            if (lane->removedGeneration[vId] == lane->generation) {
+                continue;
+            }
+            double distance = lane->distances[uId] + this->graph->getWeight(uId, vId);
+            if (lane->reachedGeneration[vId] != lane->generation || distance < lane->distances[vId]) {
+                lane->reachedGeneration[vId] = lane->generation;
+                lane->distances[vId] = distance;
+                lane->predecessors[vId] = uId;
+                lane->queue.push(QueueEntry(distance + remaining(vId), vId));
+            }
+        }
+    }
+    return false;
+}
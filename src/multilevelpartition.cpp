@@ -0,0 +1,205 @@
+#include <queue>
+#include <climits>
+#include "multilevelpartition.h"
+
+/// This class splits the vertices of a graph into nested cells over several levels, so that every cell
+/// at one level is made up of whole cells of the level below. Cells are found by repeatedly cutting a
+/// set of vertices in two along a breadth first order, which keeps each half close together on road graphs.
+///
+
+/// \brief
+/// Creates an empty partition
+///
+MultilevelPartition::MultilevelPartition() {
+    this->generation = 0;
+}
+
+/// \brief
+/// There was no dynamically created items in this class so there is no need for a destructor method body
+///
+MultilevelPartition::~MultilevelPartition() {}
+
+/// \brief
+/// Partitions the vertices of the graph. Cells at level zero hold at most baseCellSize vertices and
+/// each level up allows fanout times as many. A cell size or fanout of zero is taken as one, since no
+/// vertex could fit in a cell of size zero
+///
+/// \param graph Graph* - the graph to be partitioned
+/// \param numLevels unsigned int - the number of levels of cells
+/// \param baseCellSize unsigned int - the most vertices in a cell at level zero
+/// \param fanout unsigned int - how many times larger cells may be at each level up
+///
+void MultilevelPartition::build(Graph* graph, unsigned int numLevels, unsigned int baseCellSize, unsigned int fanout) {
+    unsigned int numVertices = graph->getNumVertices();
+
+    this->cells.assign(numLevels, vector<unsigned int>(numVertices, 0));
+    this->numCells.assign(numLevels, 0);
+    this->maxCellSizes.resize(numLevels);
+    this->memberGeneration.assign(numVertices, 0);
+    this->visitedGeneration.assign(numVertices, 0);
+    this->generation = 0;
+
+    // Sizes stop growing at the largest unsigned int rather than wrapping round to something smaller
+    baseCellSize = baseCellSize > 0 ? baseCellSize : 1;
+    fanout = fanout > 0 ? fanout : 1;
+    for (unsigned int level = 0; level < numLevels; level++) {
+        unsigned long long size = level == 0 ? baseCellSize : (unsigned long long) this->maxCellSizes[level - 1] * fanout;
+        this->maxCellSizes[level] = size < UINT_MAX ? (unsigned int) size : UINT_MAX;
+    }
+
+    // Start from the whole graph at the top level and work down
+    vector<unsigned int> members(numVertices);
+    for (unsigned int i = 0; i < numVertices; i++) {
+        members[i] = i;
+    }
+    if (numLevels > 0) {
+        partition(graph, &members, numLevels - 1);
+    }
+}
+
+/// \brief
+/// Returns the number of levels of cells
+///
+/// \return unsigned int - the number of levels
+///
+unsigned int MultilevelPartition::getNumLevels() {
+    return this->cells.size();
+}
+
+/// \brief
+/// Returns the number of cells at a level
+///
+/// \param level unsigned int - the level, with zero the smallest cells
+/// \return unsigned int - the number of cells at the level
+///
+unsigned int MultilevelPartition::getNumCells(unsigned int level) {
+    return this->numCells[level];
+}
+
+/// \brief
+/// Returns the cell a vertex is in at a level
+///
+/// \param level unsigned int - the level, with zero the smallest cells
+/// \param identifier unsigned int - the identifier of the vertex
+/// \return unsigned int - the number of the cell at that level
+///
+unsigned int MultilevelPartition::getCell(unsigned int level, unsigned int identifier) {
+    return this->cells[level][identifier];
+}
+
+/// \brief
+/// Cuts a set of vertices into cells for a level and then partitions each of those cells for the levels below
+///
+/// \param graph Graph* - the graph being partitioned
+/// \param members vector<unsigned int>* - the identifiers of the vertices in the set
+/// \param level unsigned int - the level the cells are being found for
+///
+void MultilevelPartition::partition(Graph* graph, vector<unsigned int>* members, unsigned int level) {
+    vector< vector<unsigned int> > pieces;
+    split(graph, members, this->maxCellSizes[level], &pieces);
+
+    for (unsigned int i = 0; i < pieces.size(); i++) {
+        unsigned int cell = this->numCells[level]++;
+        for (unsigned int j = 0; j < pieces[i].size(); j++) {
+            this->cells[level][pieces[i][j]] = cell;
+        }
+
+        // Cells below are cut from this cell alone so the levels nest
+        if (level > 0) {
+            partition(graph, &pieces[i], level - 1);
+        }
+    }
+}
+
+/// \brief
+/// Cuts a set of vertices in half repeatedly until every piece is small enough
+///
+/// \param graph Graph* - the graph being partitioned
+/// \param members vector<unsigned int>* - the identifiers of the vertices in the set
+/// \param maxSize unsigned int - the most vertices allowed in a piece
+/// \param pieces vector< vector<unsigned int> >* - the pieces found are added to this
+///
+void MultilevelPartition::split(Graph* graph, vector<unsigned int>* members, unsigned int maxSize, vector< vector<unsigned int> >* pieces) {
+    if (members->size() <= maxSize) {
+        pieces->push_back(*members);
+        return;
+    }
+
+    // The first half of the sweep becomes one piece and the rest the other
+    vector<unsigned int> order;
+    sweepOrder(graph, members, &order);
+
+    unsigned int half = order.size() / 2;
+    vector<unsigned int> firstHalf(order.begin(), order.begin() + half);
+    vector<unsigned int> secondHalf(order.begin() + half, order.end());
+
+    split(graph, &firstHalf, maxSize, pieces);
+    split(graph, &secondHalf, maxSize, pieces);
+}
+
+/// \brief
+/// Orders a set of vertices breadth first, using only edges inside the set, from the vertex furthest from
+/// the first member so the order sweeps across the set
+///
+/// \param graph Graph* - the graph being partitioned
+/// \param members vector<unsigned int>* - the identifiers of the vertices in the set
+/// \param order vector<unsigned int>* - filled with the members in breadth first order
+///
+void MultilevelPartition::sweepOrder(Graph* graph, vector<unsigned int>* members, vector<unsigned int>* order) {
+    vector<unsigned int> firstOrder;
+
+    // The last vertex reached from any member is far from it, so start the real sweep there
+    breadthFirstOrder(graph, members, (*members)[0], &firstOrder);
+    breadthFirstOrder(graph, members, firstOrder.back(), order);
+}
+
+/// \brief
+/// Visits the members of the set breadth first from a start vertex, restarting from unvisited members
+/// so every member ends up in the order
+///
+/// \param graph Graph* - the graph being partitioned
+/// \param members vector<unsigned int>* - the identifiers of the vertices in the set
+/// \param startId unsigned int - the identifier of the vertex to start from
+/// \param order vector<unsigned int>* - filled with the members in the order visited
+///
+void MultilevelPartition::breadthFirstOrder(Graph* graph, vector<unsigned int>* members, unsigned int startId, vector<unsigned int>* order) {
+
+    // Mark the members of the set for this pass only
+    this->generation++;
+    for (unsigned int i = 0; i < members->size(); i++) {
+        this->memberGeneration[(*members)[i]] = this->generation;
+    }
+
+    order->clear();
+    queue<unsigned int> unvisitedVerticesQueue;
+    unsigned int nextMember = 0;
+    unsigned int currentStart = startId;
+
+    while (order->size() < members->size()) {
+        this->visitedGeneration[currentStart] = this->generation;
+        unvisitedVerticesQueue.push(currentStart);
+
+        while (!unvisitedVerticesQueue.empty()) {
+            unsigned int uId = unvisitedVerticesQueue.front();
+            unvisitedVerticesQueue.pop();
+            order->push_back(uId);
+
+            vector<unsigned int>* adjacent = graph->getNeighbours(uId);
+            for (unsigned int i = 0; i < adjacent->size(); i++) {
+                unsigned int vId = (*adjacent)[i];
+                if (this->memberGeneration[vId] == this->generation && this->visitedGeneration[vId] != this->generation) {
+                    this->visitedGeneration[vId] = this->generation;
+                    unvisitedVerticesQueue.push(vId);
+                }
+            }
+        }
+
+        // Carry on from the next member not yet reached when the set is not connected
+        while (nextMember < members->size() && this->visitedGeneration[(*members)[nextMember]] == this->generation) {
+            nextMember++;
+        }
+        if (nextMember < members->size()) {
+            currentStart = (*members)[nextMember];
+        }
+    }
+}
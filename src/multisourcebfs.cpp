@@ -0,0 +1,241 @@
+#include <set>
+#include <queue>
+#include "multisourcebfs.h"
+
+/// This class finds the number of hops from many sources to every vertex at once. Up to 512 sources are
+/// searched together with one bit per source in the visited and frontier sets of each vertex, so a vertex
+/// reached by several sources at the same depth has its edges followed once for all of them and the sets
+/// are combined a whole machine word (or vector register) at a time.
+///
+/// Hops are held in 16 bits to halve the memory the depths are written to, so they can be at most MAX_HOPS
+/// (65534). A search that reaches any vertex further than that from a source stops and reports failure
+/// rather than giving wrong hops.
+///
+
+const unsigned short MultiSourceBfs::UNREACHED = 0xFFFF;
+const unsigned short MultiSourceBfs::MAX_HOPS = 0xFFFE;
+const unsigned int MultiSourceBfs::MAX_BATCH_WIDTH = 512;
+
+/// \brief
+/// Copies the edges to be followed into flat arrays, finding the minimum spanning tree first if its edges
+/// are to be followed and the graph has changed since it was last found
+///
+/// \param graph Graph* - the graph to be searched
+/// \param useMinimumSpanningTree bool - true to follow only the edges of the minimum spanning tree
+///
+MultiSourceBfs::MultiSourceBfs(Graph* graph, bool useMinimumSpanningTree) {
+    this->numVertices = graph->getNumVertices();
+    this->offsets.resize(this->numVertices + 1);
+    if (useMinimumSpanningTree) {
+        graph->minimumSpanningTreeCost();
+    }
+
+    for (unsigned int uId = 0; uId < this->numVertices; uId++) {
+        this->offsets[uId] = this->targets.size();
+
+        if (useMinimumSpanningTree) {
+            set<unsigned int>* adjSet = graph->getVertex(uId)->getAdjacencies();
+            this->targets.insert(this->targets.end(), adjSet->begin(), adjSet->end());
+        }
+        else {
+            vector<unsigned int>* adjacent = graph->getNeighbours(uId);
+            this->targets.insert(this->targets.end(), adjacent->begin(), adjacent->end());
+        }
+    }
+    this->offsets[this->numVertices] = this->targets.size();
+}
+
+/// \brief
+/// There was no dynamically created items in this class so there is no need for a destructor method body
+///
+MultiSourceBfs::~MultiSourceBfs() {}
+
+/// \brief
+/// Finds the hops from every source to every vertex, searching the sources in batches of batchWidth
+///
+/// \param sources vector<unsigned int>* - the identifiers of the source vertices
+/// \param batchWidth unsigned int - the number of sources searched together, from 1 to MAX_BATCH_WIDTH
+/// \param hops vector<unsigned short>* - filled with one row per source holding the hops to each vertex,
+///                                       or UNREACHED if the vertex cannot be reached
+/// \return bool - false if the batch width is out of range, or if a vertex is more than MAX_HOPS hops from
+///        a source, leaving the hops incomplete
+///
+bool MultiSourceBfs::run(vector<unsigned int>* sources, unsigned int batchWidth, vector<unsigned short>* hops) {
+    if (batchWidth == 0 || batchWidth > MAX_BATCH_WIDTH) {
+        return false;
+    }
+    hops->assign((size_t) sources->size() * this->numVertices, UNREACHED);
+
+    for (unsigned int first = 0; first < sources->size(); first += batchWidth) {
+        unsigned int numSources = sources->size() - first < batchWidth ? sources->size() - first : batchWidth;
+        unsigned short* rows = &(*hops)[(size_t) first * this->numVertices];
+
+        // A fixed number of words per vertex lets the compiler vectorise the set operations
+        bool searched;
+        if (batchWidth <= 64) {
+            searched = runBatch<1>(&(*sources)[first], numSources, rows);
+        }
+        else if (batchWidth <= 256) {
+            searched = runBatch<4>(&(*sources)[first], numSources, rows);
+        }
+        else {
+            searched = runBatch<8>(&(*sources)[first], numSources, rows);
+        }
+        if (!searched) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// \brief
+/// Finds the hops from a single source to every vertex with an ordinary breadth first search, for comparison
+///
+/// \param sourceId unsigned int - the identifier of the source vertex
+/// \param hops unsigned short* - filled with the hops to each vertex, or UNREACHED
+/// \return bool - false if a vertex is more than MAX_HOPS hops from the source, leaving the hops incomplete
+///
+bool MultiSourceBfs::runSingle(unsigned int sourceId, unsigned short* hops) {
+    for (unsigned int i = 0; i < this->numVertices; i++) {
+        hops[i] = UNREACHED;
+    }
+
+    queue<unsigned int> unvisitedVerticesQueue;
+    hops[sourceId] = 0;
+    unvisitedVerticesQueue.push(sourceId);
+
+    while (!unvisitedVerticesQueue.empty()) {
+        unsigned int uId = unvisitedVerticesQueue.front();
+        unvisitedVerticesQueue.pop();
+
+        for (unsigned int i = this->offsets[uId]; i < this->offsets[uId + 1]; i++) {
+            unsigned int vId = this->targets[i];
+            if (hops[vId] == UNREACHED) {
+                // A vertex this deep would have a depth that cannot be told apart from UNREACHED
+                if (hops[uId] == MAX_HOPS) {
+                    return false;
+                }
+                hops[vId] = hops[uId] + 1;
+                unvisitedVerticesQueue.push(vId);
+            }
+        }
+    }
+    return true;
+}
+
+/// \brief
+/// Searches one batch of sources with WORDS 64 bit words of state per vertex
+///
+/// \param sources const unsigned int* - the identifiers of the source vertices in the batch
+/// \param numSources unsigned int - the number of sources in the batch, at most 64 times WORDS
+/// \param hops unsigned short* - filled with one row per source of the batch
+/// \return bool - false if a vertex is more than MAX_HOPS hops from a source of the batch
+///
+template <unsigned int WORDS>
+bool MultiSourceBfs::runBatch(const unsigned int* sources, unsigned int numSources, unsigned short* hops) {
+    size_t numWords = (size_t) this->numVertices * WORDS;
+
+    // One bit per source for every vertex: reached at all, in this frontier, and in the next frontier.
+    // The sets are kept between batches so their memory is only claimed once
+    this->seen.assign(numWords, 0);
+    this->visit.assign(numWords, 0);
+    this->visitNext.assign(numWords, 0);
+    Word* seen = &this->seen[0];
+    Word* visit = &this->visit[0];
+    Word* visitNext = &this->visitNext[0];
+
+    // Depths are first written next to each other for every vertex, as they are found, then copied into
+    // the rows for each source at the end, rather than scattering each write across the rows
+    this->vertexHops.assign(numWords * 64, UNREACHED);
+    unsigned short* vertexHops = &this->vertexHops[0];
+
+    for (unsigned int i = 0; i < numSources; i++) {
+        Word bit = (Word) 1 << (i % 64);
+        seen[(size_t) sources[i] * WORDS + i / 64] |= bit;
+        visit[(size_t) sources[i] * WORDS + i / 64] |= bit;
+        vertexHops[(size_t) sources[i] * WORDS * 64 + i] = 0;
+    }
+
+    // The vertices with a source in this frontier, and those reached for the next one
+    vector<unsigned int> frontier;
+    vector<unsigned int> reached;
+    vector<bool> isReached(this->numVertices, false);
+    for (unsigned int i = 0; i < numSources; i++) {
+        if (!isReached[sources[i]]) {
+            isReached[sources[i]] = true;
+            frontier.push_back(sources[i]);
+        }
+    }
+    isReached.assign(this->numVertices, false);
+    unsigned short depth = 0;
+
+    while (!frontier.empty()) {
+        depth++;
+
+        // Every vertex in the frontier passes on its sources to its neighbours in one go
+        reached.clear();
+        for (unsigned int f = 0; f < frontier.size(); f++) {
+            unsigned int uId = frontier[f];
+            const Word* uVisit = &visit[(size_t) uId * WORDS];
+
+            for (unsigned int i = this->offsets[uId]; i < this->offsets[uId + 1]; i++) {
+                unsigned int vId = this->targets[i];
+                Word* vNext = &visitNext[(size_t) vId * WORDS];
+                for (unsigned int w = 0; w < WORDS; w++) {
+                    vNext[w] |= uVisit[w];
+                }
+                if (!isReached[vId]) {
+                    isReached[vId] = true;
+                    reached.push_back(vId);
+                }
+            }
+        }
+
+        // Keep only the sources reaching each vertex for the first time, which form the next frontier
+        frontier.clear();
+        for (unsigned int r = 0; r < reached.size(); r++) {
+            unsigned int vId = reached[r];
+            Word* vSeen = &seen[(size_t) vId * WORDS];
+            Word* vVisit = &visit[(size_t) vId * WORDS];
+            Word* vNext = &visitNext[(size_t) vId * WORDS];
+            Word any = 0;
+            isReached[vId] = false;
+
+            for (unsigned int w = 0; w < WORDS; w++) {
+                Word newSources = vNext[w] & ~vSeen[w];
+                vSeen[w] |= newSources;
+                vVisit[w] = newSources;
+                vNext[w] = 0;
+                any |= newSources;
+
+                // Record the depth for each source that has just arrived
+                while (newSources != 0) {
+                    unsigned int source = w * 64 + __builtin_ctzll(newSources);
+                    vertexHops[(size_t) vId * WORDS * 64 + source] = depth;
+                    newSources &= newSources - 1;
+                }
+            }
+            if (any != 0) {
+
+                // A vertex this deep would have a depth that cannot be told apart from UNREACHED
+                if (depth > MAX_HOPS) {
+                    return false;
+                }
+                frontier.push_back(vId);
+            }
+        }
+    }
+
+    // Copy a block of vertices at a time so both sides stay in the cache
+    const unsigned int BLOCK = 64;
+    for (unsigned int firstId = 0; firstId < this->numVertices; firstId += BLOCK) {
+        unsigned int lastId = firstId + BLOCK < this->numVertices ? firstId + BLOCK : this->numVertices;
+        for (unsigned int source = 0; source < numSources; source++) {
+            unsigned short* row = &hops[(size_t) source * this->numVertices];
+            for (unsigned int vId = firstId; vId < lastId; vId++) {
+                row[vId] = vertexHops[(size_t) vId * WORDS * 64 + source];
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,87 @@
+#include "nearestsearch.h"
+
+/// This class answers the queries that only need the part of the graph close to the source: every vertex
+/// within a distance, or the nearest few of a set of targets. The search stops as soon as the bound is
+/// reached so the work done is proportional to the region explored rather than the size of the graph.
+///
+
+/// \brief
+/// Creates the working state for searches on the graph
+///
+/// \param graph Graph* - the graph to be searched
+///
+NearestSearch::NearestSearch(Graph* graph) {
+    this->graph = graph;
+    this->space = new SearchSpace(graph->getNumVertices());
+    this->generation = 0;
+    this->targetGeneration.assign(graph->getNumVertices(), 0);
+    this->numSettled = 0;
+}
+
+/// \brief
+/// Deletes the search space
+///
+NearestSearch::~NearestSearch() {
+    delete this->space;
+}
+
+/// \brief
+/// Finds every vertex whose distance from the source is no more than the radius
+///
+/// \param sourceId unsigned int - the identifier of the source vertex
+/// \param radius double - the largest distance from the source to be included
+/// \param results vector< pair<double, unsigned int> >* - filled with distance and identifier pairs, closest first
+///
+void NearestSearch::withinRadius(unsigned int sourceId, double radius, vector< pair<double, unsigned int> >* results) {
+    unsigned int uId;
+    results->clear();
+    this->numSettled = 0;
+
+    // Vertices are settled in order of distance so the first one beyond the radius ends the search
+    this->space->start(sourceId);
+    while (this->space->nextDistance() <= radius && this->space->settleNext(this->graph, &uId)) {
+        this->numSettled++;
+        results->push_back(make_pair(this->space->getDistance(uId), uId));
+    }
+}
+
+/// \brief
+/// Finds the targets closest to the source
+///
+/// \param sourceId unsigned int - the identifier of the source vertex
+/// \param count unsigned int - the number of targets wanted
+/// \param targets vector<unsigned int>* - the identifiers of the vertices that may be returned
+/// \param results vector< pair<double, unsigned int> >* - filled with distance and identifier pairs, closest first
+///
+void NearestSearch::nearestTargets(unsigned int sourceId, unsigned int count, vector<unsigned int>* targets, vector< pair<double, unsigned int> >* results) {
+    unsigned int uId;
+    results->clear();
+    this->numSettled = 0;
+
+    // Mark the targets for this search only, without clearing the marks of the last one
+    this->generation++;
+    if (this->generation == 0) {
+        this->targetGeneration.assign(this->targetGeneration.size(), 0);
+        this->generation = 1;
+    }
+    for (unsigned int i = 0; i < targets->size(); i++) {
+        this->targetGeneration[(*targets)[i]] = this->generation;
+    }
+
+    this->space->start(sourceId);
+    while (results->size() < count && this->space->settleNext(this->graph, &uId)) {
+        this->numSettled++;
+        if (this->targetGeneration[uId] == this->generation) {
+            results->push_back(make_pair(this->space->getDistance(uId), uId));
+        }
+    }
+}
+
+/// \brief
+/// Returns the number of vertices settled by the last search
+///
+/// \return unsigned int - the number of settled vertices
+///
+unsigned int NearestSearch::getNumSettled() {
+    return this->numSettled;
+}
@@ -30,6 +30,24 @@ double Point::distanceTo(Point* nextPoint) {
     return sqrt(pow(this->xCoord - nextPoint->xCoord, 2) + pow(this->yCoord - nextPoint->yCoord, 2));
 }
 
+/// \brief
+/// Returns the x coordinate of the point
+///
+/// \return double - the x coordinate
+///
+double Point::getX() {
+    return this->xCoord;
+}
+
+/// \brief
+/// Returns the y coordinate of the point
+///
+/// \return double - the y coordinate
+///
+double Point::getY() {
+    return this->yCoord;
+}
+
 /// \brief
 /// Returns output containing a string representation of the point class detailing its coordinates
 ///
@@ -0,0 +1,221 @@
+#include <cmath>
+#include "pointset.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define POINTSET_HAS_AVX2_KERNELS
+#endif
+
+/// This class holds the coordinates of many points as two arrays, one of x coordinates and one of y,
+/// rather than as separately allocated Point objects, and works out distances between them in bulk.
+/// Whole rows of distances and batches of edges are computed four at a time with AVX2 instructions
+/// when the processor has them, and one at a time otherwise; both give exactly the distances of
+/// Point::distanceTo.
+///
+
+#ifdef POINTSET_HAS_AVX2_KERNELS
+
+/// \brief
+/// Works out the distances from one point to a run of consecutive points four at a time. The kernel is
+/// compiled for AVX2 on its own, so the rest of the program runs on processors without it
+///
+/// \param x double - the x coordinate of the point distances are measured from
+/// \param y double - the y coordinate of the point distances are measured from
+/// \param xCoords const double* - the x coordinates of the points distances are measured to
+/// \param yCoords const double* - the y coordinates of the points distances are measured to
+/// \param count unsigned int - the number of points distances are measured to
+/// \param distances double* - filled with count distances
+///
+__attribute__((target("avx2")))
+static void distancesFromAvx2(double x, double y, const double* xCoords, const double* yCoords, unsigned int count, double* distances) {
+    __m256d fromX = _mm256_set1_pd(x);
+    __m256d fromY = _mm256_set1_pd(y);
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(xCoords + i), fromX);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(yCoords + i), fromY);
+        _mm256_storeu_pd(distances + i, _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy))));
+    }
+    for (; i < count; i++) {
+        double dx = xCoords[i] - x;
+        double dy = yCoords[i] - y;
+        distances[i] = sqrt(dx * dx + dy * dy);
+    }
+}
+
+/// \brief
+/// Works out the length of a batch of edges four at a time, gathering the coordinates of their ends
+///
+/// \param xCoords const double* - the x coordinate of every point
+/// \param yCoords const double* - the y coordinate of every point
+/// \param sources const unsigned int* - the position of the first end of each edge
+/// \param destinations const unsigned int* - the position of the second end of each edge
+/// \param count unsigned long - the number of edges
+/// \param distances double* - filled with the length of each edge
+///
+__attribute__((target("avx2")))
+static void edgeLengthsAvx2(const double* xCoords, const double* yCoords, const unsigned int* sources,
+                            const unsigned int* destinations, unsigned long count, double* distances) {
+    // The masked form of the gather is used so every lane starts from a defined value
+    __m256d zero = _mm256_setzero_pd();
+    __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    unsigned long i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i from = _mm_loadu_si128((const __m128i*) (sources + i));
+        __m128i to = _mm_loadu_si128((const __m128i*) (destinations + i));
+        __m256d dx = _mm256_sub_pd(_mm256_mask_i32gather_pd(zero, xCoords, from, all, 8), _mm256_mask_i32gather_pd(zero, xCoords, to, all, 8));
+        __m256d dy = _mm256_sub_pd(_mm256_mask_i32gather_pd(zero, yCoords, from, all, 8), _mm256_mask_i32gather_pd(zero, yCoords, to, all, 8));
+        _mm256_storeu_pd(distances + i, _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy))));
+    }
+    for (; i < count; i++) {
+        double dx = xCoords[sources[i]] - xCoords[destinations[i]];
+        double dy = yCoords[sources[i]] - yCoords[destinations[i]];
+        distances[i] = sqrt(dx * dx + dy * dy);
+    }
+}
+
+#endif
+
+/// \brief
+/// Creates an empty set of points
+///
+PointSet::PointSet() {
+    setVectorised(true);
+}
+
+/// \brief
+/// Copies the coordinates of a list of points
+///
+/// \param points vector<Point*>* - the points to be copied
+///
+PointSet::PointSet(vector<Point*>* points) {
+    setVectorised(true);
+    this->xCoords.reserve(points->size());
+    this->yCoords.reserve(points->size());
+    for (unsigned int i = 0; i < points->size(); i++) {
+        addPoint((*points)[i]->getX(), (*points)[i]->getY());
+    }
+}
+
+/// \brief
+/// There was no dynamically created items in this class so there is no need for a destructor method body
+///
+PointSet::~PointSet() {
+}
+
+/// \brief
+/// Adds a point to the end of the set
+///
+/// \param xCoord double - value of x coordinate
+/// \param yCoord double - value of y coordinate
+///
+void PointSet::addPoint(double xCoord, double yCoord) {
+    this->xCoords.push_back(xCoord);
+    this->yCoords.push_back(yCoord);
+}
+
+/// \brief
+/// Returns the number of points within the set
+///
+/// \return unsigned int - the number of points
+///
+unsigned int PointSet::size() {
+    return this->xCoords.size();
+}
+
+/// \brief
+/// Returns the x coordinate of a point
+///
+/// \param identifier unsigned int - the position of the point within the set
+/// \return double - the x coordinate
+///
+double PointSet::getX(unsigned int identifier) {
+    return this->xCoords[identifier];
+}
+
+/// \brief
+/// Returns the y coordinate of a point
+///
+/// \param identifier unsigned int - the position of the point within the set
+/// \return double - the y coordinate
+///
+double PointSet::getY(unsigned int identifier) {
+    return this->yCoords[identifier];
+}
+
+/// \brief
+/// Works out the distances from one point to a run of consecutive points
+///
+/// \param from unsigned int - the position of the point distances are measured from
+/// \param first unsigned int - the position of the first point distances are measured to
+/// \param count unsigned int - the number of points distances are measured to
+/// \param distances double* - filled with count distances
+///
+void PointSet::distancesFrom(unsigned int from, unsigned int first, unsigned int count, double* distances) {
+    double x = this->xCoords[from];
+    double y = this->yCoords[from];
+    const double* xCoords = this->xCoords.data() + first;
+    const double* yCoords = this->yCoords.data() + first;
+
+#ifdef POINTSET_HAS_AVX2_KERNELS
+    if (this->vectorised) {
+        distancesFromAvx2(x, y, xCoords, yCoords, count, distances);
+        return;
+    }
+#endif
+
+    // Squaring by multiplication rounds exactly as pow(..., 2) does, so the distances match Point::distanceTo
+    for (unsigned int i = 0; i < count; i++) {
+        double dx = xCoords[i] - x;
+        double dy = yCoords[i] - y;
+        distances[i] = sqrt(dx * dx + dy * dy);
+    }
+}
+
+/// \brief
+/// Works out the length of a batch of edges between points
+///
+/// \param sources const unsigned int* - the position of the first end of each edge
+/// \param destinations const unsigned int* - the position of the second end of each edge
+/// \param count unsigned long - the number of edges
+/// \param distances double* - filled with the length of each edge
+///
+void PointSet::edgeLengths(const unsigned int* sources, const unsigned int* destinations, unsigned long count, double* distances) {
+    const double* xCoords = this->xCoords.data();
+    const double* yCoords = this->yCoords.data();
+
+#ifdef POINTSET_HAS_AVX2_KERNELS
+    if (this->vectorised) {
+        edgeLengthsAvx2(xCoords, yCoords, sources, destinations, count, distances);
+        return;
+    }
+#endif
+
+    for (unsigned long i = 0; i < count; i++) {
+        double dx = xCoords[sources[i]] - xCoords[destinations[i]];
+        double dy = yCoords[sources[i]] - yCoords[destinations[i]];
+        distances[i] = sqrt(dx * dx + dy * dy);
+    }
+}
+
+/// \brief
+/// Chooses whether the AVX2 kernels are used when the processor has them
+///
+/// \param vectorised bool - false to always use the scalar kernels
+///
+void PointSet::setVectorised(bool vectorised) {
+#ifdef POINTSET_HAS_AVX2_KERNELS
+    this->vectorised = vectorised && __builtin_cpu_supports("avx2");
+#else
+    this->vectorised = false;
+#endif
+}
+
+/// \brief
+/// Returns whether distances are being worked out with the AVX2 kernels
+///
+/// \return bool - true if the processor has AVX2 and it has not been turned off
+///
+bool PointSet::isVectorised() {
+    return this->vectorised;
+}
@@ -0,0 +1,452 @@
+#include <cmath>
+#include <queue>
+#include <sstream>
+#include <iomanip>
+#include <functional>
+#include "queryplanner.h"
+#include "componentindex.h"
+
+/// This class answers distance queries with whichever engine should be fastest for the graph and the pair
+/// asked about. Figures about the graph are gathered once: its size and density, the spread of degrees and
+/// weights, and, when coordinates are given, how closely the weights follow the straight line distance
+/// between the ends of each edge. Each query is then planned by estimating the cost of every engine that
+/// could answer it: the component index and the hub labels, route planner and oracle when they have been
+/// given, a breadth first search when every edge weighs the same, an A* search when the weights are never
+/// shorter than some fraction of the straight line, and a plain Dijkstra search that stops at the destination.
+/// Search costs start from estimates made from the figures and are replaced by the average work each engine
+/// has actually done as queries are answered. Only one query may run at a time.
+///
+
+/// The share of the vertices a search engine is expected to settle, compared with a Dijkstra search, before
+/// it has answered any queries
+const double PRIOR_WORK[NUM_PLAN_ENGINES] = { 0, 0, 0, 0, 0.1, 1.0, 0.5, 1.0 };
+
+/// The smallest ratio of weight to straight line distance worth guiding an A* search with
+const double MINIMUM_GEOMETRIC_SCALE = 0.1;
+
+/// \brief
+/// Gathers the figures about the graph used to plan queries on it
+///
+/// \param graph Graph* - the graph the queries are answered on
+///
+QueryPlanner::QueryPlanner(Graph* graph) : space(graph->getNumVertices()) {
+    this->graph = graph;
+    this->hubLabels = NULL;
+    this->routePlanner = NULL;
+    this->oracle = NULL;
+    this->distances.resize(graph->getNumVertices());
+    this->reachedGeneration.assign(graph->getNumVertices(), 0);
+    this->generation = 0;
+    for (unsigned int i = 0; i < NUM_PLAN_ENGINES; i++) {
+        this->totalWork[i] = 0;
+        this->totalEstimate[i] = 0;
+    }
+    refreshStatistics();
+}
+
+/// \brief
+/// There was no dynamically created items in this class so there is no need for a destructor method body
+///
+QueryPlanner::~QueryPlanner() {
+}
+
+/// \brief
+/// Gathers the figures about the graph again, after its edges have changed
+///
+void QueryPlanner::refreshStatistics() {
+    GraphStatistics& statistics = this->statistics;
+    unsigned int numVertices = this->graph->getNumVertices();
+    unsigned long degreeTotal = 0;
+
+    statistics.numVertices = numVertices;
+    statistics.minimumDegree = numVertices > 0 ? numVertices : 0;
+    statistics.maximumDegree = 0;
+    statistics.minimumWeight = ShortestPathTree::UNREACHABLE;
+    statistics.maximumWeight = 0;
+    statistics.integralWeights = true;
+    statistics.geometricScale = this->coordinates.size() == numVertices ? ShortestPathTree::UNREACHABLE : 0;
+
+    for (unsigned int uId = 0; uId < numVertices; uId++) {
+        vector<unsigned int>* adjacent = this->graph->getNeighbours(uId);
+        unsigned int degree = adjacent->size();
+        degreeTotal += degree;
+        statistics.minimumDegree = degree < statistics.minimumDegree ? degree : statistics.minimumDegree;
+        statistics.maximumDegree = degree > statistics.maximumDegree ? degree : statistics.maximumDegree;
+
+        for (unsigned int i = 0; i < degree; i++) {
+            unsigned int vId = (*adjacent)[i];
+            double weight = this->graph->getWeight(uId, vId);
+            statistics.minimumWeight = weight < statistics.minimumWeight ? weight : statistics.minimumWeight;
+            statistics.maximumWeight = weight > statistics.maximumWeight ? weight : statistics.maximumWeight;
+            if (weight != floor(weight)) {
+                statistics.integralWeights = false;
+            }
+
+            // The straight line distance times the smallest ratio seen is never more than the weight of any edge
+            if (statistics.geometricScale > 0) {
+                double dx = this->coordinates.getX(uId) - this->coordinates.getX(vId);
+                double dy = this->coordinates.getY(uId) - this->coordinates.getY(vId);
+                double straight = sqrt(dx * dx + dy * dy);
+                if (straight > 0 && weight / straight < statistics.geometricScale) {
+                    statistics.geometricScale = weight / straight;
+                }
+            }
+        }
+    }
+
+    statistics.numEdges = degreeTotal / 2;
+    statistics.averageDegree = numVertices > 0 ? (double) degreeTotal / numVertices : 0;
+    statistics.density = numVertices > 1 ? (double) degreeTotal / ((double) numVertices * (numVertices - 1)) : 0;
+    statistics.uniformWeights = statistics.numEdges > 0 && statistics.minimumWeight == statistics.maximumWeight;
+    if (statistics.numEdges == 0) {
+        statistics.minimumWeight = 0;
+    }
+    if (statistics.geometricScale == ShortestPathTree::UNREACHABLE || statistics.geometricScale < MINIMUM_GEOMETRIC_SCALE) {
+        statistics.geometricScale = 0;
+    }
+}
+
+/// \brief
+/// Returns the figures gathered about the graph
+///
+/// \return GraphStatistics - the graph statistics
+///
+GraphStatistics QueryPlanner::getStatistics() {
+    return this->statistics;
+}
+
+/// \brief
+/// Gives the coordinates of the vertices, allowing A* searches guided by the straight line distance
+///
+/// \param points vector<Point*>* - the coordinates of every vertex, in identifier order
+///
+void QueryPlanner::setCoordinates(vector<Point*>* points) {
+    this->coordinates = PointSet(points);
+    refreshStatistics();
+}
+
+/// \brief
+/// Gives hub labels built for the graph, or NULL to stop using them
+///
+/// \param hubLabels HubLabels* - a pointer to the labels
+///
+void QueryPlanner::setHubLabels(HubLabels* hubLabels) {
+    this->hubLabels = hubLabels;
+}
+
+/// \brief
+/// Gives a customised route planner for the graph, or NULL to stop using it
+///
+/// \param routePlanner CustomizableRoutePlanner* - a pointer to the route planner
+///
+void QueryPlanner::setRoutePlanner(CustomizableRoutePlanner* routePlanner) {
+    this->routePlanner = routePlanner;
+}
+
+/// \brief
+/// Gives an approximate distance oracle for the graph, used only by queries that allow approximate
+/// answers, or NULL to stop using it
+///
+/// \param oracle DistanceOracle* - a pointer to the oracle
+///
+void QueryPlanner::setDistanceOracle(DistanceOracle* oracle) {
+    this->oracle = oracle;
+}
+
+/// \brief
+/// Chooses the engine with the lowest estimated cost for a query
+///
+/// \param sourceId unsigned int - the identifier of the source vertex
+/// \param destinationId unsigned int - the identifier of the destination vertex
+/// \param approximate bool - true if an answer up to the oracle's stretch longer is good enough
+/// \return QueryPlan - the chosen engine and the estimated cost of every engine
+///
+QueryPlan QueryPlanner::plan(unsigned int sourceId, unsigned int destinationId, bool approximate) {
+    QueryPlan plan;
+    for (unsigned int i = 0; i < NUM_PLAN_ENGINES; i++) {
+        plan.costs[i] = -1;
+    }
+
+    // A search is expected to settle about half of what the source can reach before finding the destination
+    ComponentIndex* components = this->graph->getComponentIndex();
+    double reachable = components != NULL ? components->getComponentSize(sourceId) : this->statistics.numVertices;
+    double estimate = reachable / 2 + 1;
+
+    if (sourceId == destinationId) {
+        plan.costs[PLAN_SAME_VERTEX] = 0;
+    }
+    if (components != NULL && !components->isReachable(sourceId, destinationId)) {
+        plan.costs[PLAN_NO_PATH] = 1;
+    }
+    if (this->hubLabels != NULL) {
+        plan.costs[PLAN_HUB_LABELS] = 2 * this->hubLabels->getAverageLabelSize();
+    }
+    if (this->oracle != NULL && approximate) {
+        plan.costs[PLAN_DISTANCE_ORACLE] = 4 * this->oracle->getNumLevels();
+    }
+
+    // Every edge of a settled vertex is relaxed, and every vertex settled by a heap costs its logarithm
+    double degree = this->statistics.averageDegree;
+    if (this->routePlanner != NULL) {
+        double work = expectedWork(PLAN_ROUTE_PLANNER, estimate);
+        plan.costs[PLAN_ROUTE_PLANNER] = work * (degree + log2(work + 2));
+    }
+    if (this->statistics.uniformWeights) {
+        plan.costs[PLAN_BREADTH_FIRST] = expectedWork(PLAN_BREADTH_FIRST, estimate) * degree;
+    }
+    if (this->statistics.geometricScale > 0) {
+        double work = expectedWork(PLAN_ASTAR, estimate);
+        plan.costs[PLAN_ASTAR] = work * (degree + log2(work + 2));
+    }
+    double work = expectedWork(PLAN_DIJKSTRA, estimate);
+    plan.costs[PLAN_DIJKSTRA] = work * (degree + log2(work + 2));
+
+    plan.engine = PLAN_DIJKSTRA;
+    for (unsigned int i = 0; i < NUM_PLAN_ENGINES; i++) {
+        if (plan.costs[i] >= 0 && plan.costs[i] < plan.costs[plan.engine]) {
+            plan.engine = (PlanEngine) i;
+        }
+    }
+    return plan;
+}
+
+/// \brief
+/// Answers a query with the engine a plan chose
+///
+/// \param plan const QueryPlan& - the plan, whose engine must be able to answer the query
+/// \param sourceId unsigned int - the identifier of the source vertex
+/// \param destinationId unsigned int - the identifier of the destination vertex
+/// \return double - the distance, or ShortestPathTree::UNREACHABLE if there is no path
+///
+double QueryPlanner::execute(const QueryPlan& plan, unsigned int sourceId, unsigned int destinationId) {
+    double distance = ShortestPathTree::UNREACHABLE;
+    unsigned long numSettled = 0;
+    unsigned int uId;
+
+    switch (plan.engine) {
+        case PLAN_SAME_VERTEX:
+            return 0;
+        case PLAN_NO_PATH:
+            return ShortestPathTree::UNREACHABLE;
+        case PLAN_HUB_LABELS:
+            return this->hubLabels->distance(sourceId, destinationId);
+        case PLAN_DISTANCE_ORACLE:
+            return this->oracle->distance(sourceId, destinationId);
+        case PLAN_ROUTE_PLANNER:
+            distance = this->routePlanner->distance(sourceId, destinationId);
+            numSettled = this->routePlanner->getNumSettled();
+            break;
+        case PLAN_BREADTH_FIRST:
+            distance = breadthFirst(sourceId, destinationId, &numSettled);
+            break;
+        case PLAN_ASTAR:
+            distance = aStar(sourceId, destinationId, &numSettled);
+            break;
+        case PLAN_DIJKSTRA:
+            this->space.start(sourceId);
+            while (this->space.settleNext(this->graph, &uId)) {
+                numSettled++;
+                if (uId == destinationId) {
+                    distance = this->space.getDistance(uId);
+                    break;
+                }
+            }
+            break;
+    }
+
+    // Learn how far off the estimate from the figures was for this engine
+    ComponentIndex* components = this->graph->getComponentIndex();
+    double reachable = components != NULL ? components->getComponentSize(sourceId) : this->statistics.numVertices;
+    this->totalWork[plan.engine] += numSettled;
+    this->totalEstimate[plan.engine] += reachable / 2 + 1;
+    return distance;
+}
+
+/// \brief
+/// Plans and answers a query
+///
+/// \param sourceId unsigned int - the identifier of the source vertex
+/// \param destinationId unsigned int - the identifier of the destination vertex
+/// \param approximate bool - true if an answer up to the oracle's stretch longer is good enough
+/// \return double - the distance, or ShortestPathTree::UNREACHABLE if there is no path
+///
+double QueryPlanner::distance(unsigned int sourceId, unsigned int destinationId, bool approximate) {
+    return execute(plan(sourceId, destinationId, approximate), sourceId, destinationId);
+}
+
+/// \brief
+/// Describes the plan for a query without answering it, as name=value pairs giving the chosen engine,
+/// the estimated cost of every engine and the figures about the graph the costs came from
+///
+/// \param sourceId unsigned int - the identifier of the source vertex
+/// \param destinationId unsigned int - the identifier of the destination vertex
+/// \param approximate bool - true if an answer up to the oracle's stretch longer is good enough
+/// \return string - the explanation
+///
+string QueryPlanner::explain(unsigned int sourceId, unsigned int destinationId, bool approximate) {
+    QueryPlan chosen = plan(sourceId, destinationId, approximate);
+    GraphStatistics& statistics = this->statistics;
+    ostringstream out;
+
+    out << "engine=" << getEngineName(chosen.engine) << fixed << setprecision(1);
+    for (unsigned int i = 0; i < NUM_PLAN_ENGINES; i++) {
+        out << " cost_" << getEngineName((PlanEngine) i) << "=";
+        if (chosen.costs[i] < 0) {
+            out << "-";
+        }
+        else {
+            out << chosen.costs[i];
+        }
+    }
+    out << " vertices=" << statistics.numVertices << " edges=" << statistics.numEdges << setprecision(6)
+        << " density=" << statistics.density << setprecision(2) << " degree=" << statistics.minimumDegree << "/"
+        << statistics.averageDegree << "/" << statistics.maximumDegree << " weights=" << statistics.minimumWeight
+        << "/" << statistics.maximumWeight << (statistics.uniformWeights ? " uniform" : "")
+        << (statistics.integralWeights ? " integral" : "") << " geometric_scale=" << statistics.geometricScale
+        << " components=" << (this->graph->getComponentIndex() != NULL ? "indexed" : "none");
+    return out.str();
+}
+
+/// \brief
+/// Returns the name of an engine as used in explanations
+///
+/// \param engine PlanEngine - the engine
+/// \return string - the name of the engine
+///
+string QueryPlanner::getEngineName(PlanEngine engine) {
+    switch (engine) {
+        case PLAN_SAME_VERTEX:
+            return "same_vertex";
+        case PLAN_NO_PATH:
+            return "no_path";
+        case PLAN_HUB_LABELS:
+            return "hub_labels";
+        case PLAN_DISTANCE_ORACLE:
+            return "oracle";
+        case PLAN_ROUTE_PLANNER:
+            return "route_planner";
+        case PLAN_BREADTH_FIRST:
+            return "bfs";
+        case PLAN_ASTAR:
+            return "astar";
+        case PLAN_DIJKSTRA:
+            return "dijkstra";
+    }
+    return "unknown";
+}
+
+/// \brief
+/// Returns the work a search engine is expected to do, in vertices settled, scaling its estimate from
+/// the figures by how far off such estimates have been for the queries it has answered so far
+///
+/// \param engine PlanEngine - the search engine
+/// \param estimate double - the number of vertices the figures suggest it will settle
+/// \return double - the expected number of vertices settled
+///
+double QueryPlanner::expectedWork(PlanEngine engine, double estimate) {
+    if (this->totalEstimate[engine] > 0) {
+        return estimate * this->totalWork[engine] / this->totalEstimate[engine];
+    }
+    return estimate * PRIOR_WORK[engine];
+}
+
+/// \brief
+/// Moves on to a new search, so every vertex is unreached without visiting them
+///
+void QueryPlanner::startSearch() {
+    this->generation++;
+    if (this->generation == 0) {
+        this->reachedGeneration.assign(this->reachedGeneration.size(), 0);
+        this->generation = 1;
+    }
+}
+
+/// \brief
+/// Finds the distance with a breadth first search, counting edges and multiplying by their weight
+///
+/// \param sourceId unsigned int - the identifier of the source vertex
+/// \param destinationId unsigned int - the identifier of the destination vertex
+/// \param numSettled unsigned long* - set to the number of vertices settled
+/// \return double - the distance, or ShortestPathTree::UNREACHABLE if there is no path
+///
+double QueryPlanner::breadthFirst(unsigned int sourceId, unsigned int destinationId, unsigned long* numSettled) {
+    startSearch();
+    queue<unsigned int> unvisitedVerticesQueue;
+    this->reachedGeneration[sourceId] = this->generation;
+    this->distances[sourceId] = 0;
+    unvisitedVerticesQueue.push(sourceId);
+
+    // Every edge weighs the same, so the first time a vertex is reached is by the fewest edges
+    while (!unvisitedVerticesQueue.empty()) {
+        unsigned int uId = unvisitedVerticesQueue.front();
+        unvisitedVerticesQueue.pop();
+        (*numSettled)++;
+        if (uId == destinationId) {
+            return this->distances[uId] * this->statistics.minimumWeight;
+        }
+
+        vector<unsigned int>* adjacent = this->graph->getNeighbours(uId);
+        for (unsigned int i = 0; i < adjacent->size(); i++) {
+            unsigned int vId = (*adjacent)[i];
+            if (this->reachedGeneration[vId] != this->generation) {
+                this->reachedGeneration[vId] = this->generation;
+                this->distances[vId] = this->distances[uId] + 1;
+                unvisitedVerticesQueue.push(vId);
+            }
+        }
+    }
+    return ShortestPathTree::UNREACHABLE;
+}
+
+/// \brief
+/// Finds the distance with an A* search, guided by the straight line distance to the destination
+///
+/// \param sourceId unsigned int - the identifier of the source vertex
+/// \param destinationId unsigned int - the identifier of the destination vertex
+/// \param numSettled unsigned long* - set to the number of vertices settled
+/// \return double - the distance, or ShortestPathTree::UNREACHABLE if there is no path
+///
+double QueryPlanner::aStar(unsigned int sourceId, unsigned int destinationId, unsigned long* numSettled) {
+    double scale = this->statistics.geometricScale;
+    double targetX = this->coordinates.getX(destinationId);
+    double targetY = this->coordinates.getY(destinationId);
+
+    // Queue of estimated total length and identifier pairs; the straight line scaled by the smallest ratio of
+    // weight to straight line never overestimates what is left, and never drops by more than an edge weighs
+    priority_queue< pair<double, unsigned int>, vector< pair<double, unsigned int> >,
+                    greater< pair<double, unsigned int> > > unvisitedVerticesQueue;
+    startSearch();
+    this->reachedGeneration[sourceId] = this->generation;
+    this->distances[sourceId] = 0;
+    unvisitedVerticesQueue.push(make_pair(0.0, sourceId));
+
+    while (!unvisitedVerticesQueue.empty()) {
+        double estimate = unvisitedVerticesQueue.top().first;
+        unsigned int uId = unvisitedVerticesQueue.top().second;
+        unvisitedVerticesQueue.pop();
+
+        double dx = this->coordinates.getX(uId) - targetX;
+        double dy = this->coordinates.getY(uId) - targetY;
+        if (estimate > this->distances[uId] + scale * sqrt(dx * dx + dy * dy)) {
+            continue;
+        }
+        (*numSettled)++;
+        if (uId == destinationId) {
+            return this->distances[uId];
+        }
+
+        vector<unsigned int>* adjacent = this->graph->getNeighbours(uId);
+        for (unsigned int i = 0; i < adjacent->size(); i++) {
+            unsigned int vId = (*adjacent)[i];
+            double distance = this->distances[uId] + this->graph->getWeight(uId, vId);
+            if (this->reachedGeneration[vId] != this->generation || distance < this->distances[vId]) {
+                this->reachedGeneration[vId] = this->generation;
+                this->distances[vId] = distance;
+                double vx = this->coordinates.getX(vId) - targetX;
+                double vy = this->coordinates.getY(vId) - targetY;
+                unvisitedVerticesQueue.push(make_pair(distance + scale * sqrt(vx * vx + vy * vy), vId));
+            }
+        }
+    }
+    return ShortestPathTree::UNREACHABLE;
+}
@@ -0,0 +1,522 @@
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <map>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "queryserver.h"
+#include "componentindex.h"
+
+/// This class keeps a graph loaded and answers queries sent to it one per line, either over
+/// standard input and output or over a Unix domain socket. Requests are read in batches and the
+/// searches needed by a batch are shared out between a pool of worker threads, with one search
+/// per distinct source in the batch. Shortest path trees are kept in a cache so that popular sources
+/// are only searched again after an edge change affects them.
+///
+
+const unsigned int READ_BUFFER_SIZE = 65536;
+
+/// The kinds of request understood by the server
+enum QueryType { QUERY_DISTANCE, QUERY_PATH, QUERY_MST, QUERY_RADIUS, QUERY_NEAREST, QUERY_MST_COST, QUERY_STATS, QUERY_QUIT, QUERY_INVALID };
+
+/// A single parsed request line
+struct Query {
+    QueryType type;
+    unsigned int sourceId;
+    unsigned int destinationId;
+    double radius;
+    unsigned int count;
+    vector<unsigned int> targets;
+    string error;
+    int treeIndex;
+    string response;
+};
+
+/// \brief
+/// Parses a request line into a query, recording the reason when the line is not valid
+///
+/// \param line const string& - the request line
+/// \param numVertices unsigned int - the number of vertices within the graph
+/// \param query Query* - the query to be filled in
+///
+static void parseQuery(const string& line, unsigned int numVertices, Query* query) {
+    istringstream in(line);
+    string command;
+    string extra;
+
+    query->type = QUERY_INVALID;
+    query->sourceId = 0;
+    query->destinationId = 0;
+    query->radius = 0;
+    query->count = 0;
+    query->treeIndex = -1;
+
+    in >> command;
+    if (command == "MSTCOST" || command == "STATS" || command == "QUIT") {
+        if (in >> extra) {
+            query->error = "unexpected arguments";
+        }
+        else {
+            query->type = command == "MSTCOST" ? QUERY_MST_COST : command == "STATS" ? QUERY_STATS : QUERY_QUIT;
+        }
+        return;
+    }
+
+    if (command == "RADIUS" || command == "NEAREST") {
+        long sourceId;
+        if (!(in >> sourceId) || sourceId < 0 || sourceId >= (long) numVertices) {
+            query->error = "expected source";
+            return;
+        }
+        query->sourceId = (unsigned int) sourceId;
+
+        if (command == "RADIUS") {
+            if (!(in >> query->radius) || (in >> extra)) {
+                query->error = "expected source and radius";
+                return;
+            }
+            query->type = QUERY_RADIUS;
+            return;
+        }
+
+        long count;
+        long targetId;
+        if (!(in >> count) || count < 0) {
+            query->error = "expected source, count and targets";
+            return;
+        }
+        while (in >> targetId) {
+            if (targetId < 0 || targetId >= (long) numVertices) {
+                query->error = "vertex out of range";
+                return;
+            }
+            query->targets.push_back((unsigned int) targetId);
+        }
+        if (!in.eof()) {
+            query->error = "expected source, count and targets";
+            return;
+        }
+        query->count = (unsigned int) count;
+        query->type = QUERY_NEAREST;
+        return;
+    }
+
+    if (command != "DIST" && command != "PATH" && command != "MST") {
+        query->error = "unknown request";
+        return;
+    }
+
+    long sourceId;
+    long destinationId;
+    if (!(in >> sourceId >> destinationId) || (in >> extra)) {
+        query->error = "expected source and destination";
+        return;
+    }
+    if (sourceId < 0 || destinationId < 0 || sourceId >= (long) numVertices || destinationId >= (long) numVertices) {
+        query->error = "vertex out of range";
+        return;
+    }
+
+    query->sourceId = (unsigned int) sourceId;
+    query->destinationId = (unsigned int) destinationId;
+    query->type = command == "DIST" ? QUERY_DISTANCE : command == "PATH" ? QUERY_PATH : QUERY_MST;
+}
+
+/// \brief
+/// Writes all of a string to a file descriptor, retrying after partial writes
+///
+/// \param descriptor int - the file descriptor to write to
+/// \param text const string& - the text to be written
+/// \return bool - false if the descriptor could not be written to
+///
+static bool writeAll(int descriptor, const string& text) {
+    size_t written = 0;
+    while (written < text.size()) {
+        ssize_t result = write(descriptor, text.data() + written, text.size() - written);
+        if (result <= 0) {
+            return false;
+        }
+        written += result;
+    }
+    return true;
+}
+
+/// \brief
+/// Creates a server for the graph, computing its minimum spanning tree up front so the first batch does not wait for it
+///
+/// \param graph Graph* - the graph to answer queries on, which must already hold all of its edges
+/// \param numWorkers unsigned int - the number of worker threads, or zero for one per hardware thread
+/// \param maxBatchSize unsigned int - the largest number of requests answered together
+/// \param cacheBytes unsigned long - the most memory cached shortest path trees may use, in bytes
+///
+QueryServer::QueryServer(Graph* graph, unsigned int numWorkers, unsigned int maxBatchSize, unsigned long cacheBytes) {
+    this->graph = graph;
+    this->pool = new WorkerPool(numWorkers);
+    this->cache = new ShortestPathTreeCache(cacheBytes);
+    graph->addObserver(this->cache);
+    this->hubLabels = NULL;
+    this->maxBatchSize = maxBatchSize > 0 ? maxBatchSize : 1;
+    graph->minimumSpanningTreeCost();
+    this->numQueries = 0;
+    this->numBatches = 0;
+    this->numSearches = 0;
+    this->numErrors = 0;
+    this->numLabelLookups = 0;
+    this->numUnreachable = 0;
+}
+
+/// \brief
+/// Deletes the worker pool and the cache, which stops observing the graph
+///
+QueryServer::~QueryServer() {
+    this->graph->removeObserver(this->cache);
+    delete this->cache;
+    delete this->pool;
+
+    for (unsigned int i = 0; i < this->nearestSearches.size(); i++) {
+        delete this->nearestSearches[i];
+    }
+}
+
+/// \brief
+/// Answers requests read from one file descriptor, writing responses to another in the same order,
+/// until QUIT is received or the input is closed
+///
+/// \param inputDescriptor int - the file descriptor requests are read from
+/// \param outputDescriptor int - the file descriptor responses are written to
+///
+void QueryServer::serve(int inputDescriptor, int outputDescriptor) {
+    char buffer[READ_BUFFER_SIZE];
+    string pending;
+    vector<string> requests;
+    vector<string> responses;
+    bool quit = false;
+    bool endOfInput = false;
+
+    while (!quit && !endOfInput) {
+
+        // Everything the client has already sent arrives in one read and becomes one batch
+        ssize_t bytesRead = read(inputDescriptor, buffer, READ_BUFFER_SIZE);
+        if (bytesRead <= 0) {
+            endOfInput = true;
+        }
+        else {
+            pending.append(buffer, bytesRead);
+        }
+
+        // Split off every complete line, and the last partial line once the input is closed
+        requests.clear();
+        size_t start = 0;
+        size_t end;
+        while ((end = pending.find('\n', start)) != string::npos) {
+            requests.push_back(pending.substr(start, end - start));
+            start = end + 1;
+        }
+        pending.erase(0, start);
+        if (endOfInput && pending.size() > 0) {
+            requests.push_back(pending);
+            pending.clear();
+        }
+
+        // Stop reading requests at the first QUIT, parsed the same way as every other request
+        Query query;
+        for (unsigned int i = 0; i < requests.size(); i++) {
+            parseQuery(requests[i], this->graph->getNumVertices(), &query);
+            if (query.type == QUERY_QUIT) {
+                requests.resize(i);
+                quit = true;
+                break;
+            }
+        }
+
+        // Answer the requests in batches no larger than the maximum batch size
+        for (unsigned int first = 0; first < requests.size(); first += this->maxBatchSize) {
+            unsigned int last = first + this->maxBatchSize < requests.size() ? first + this->maxBatchSize : requests.size();
+            vector<string> batch(requests.begin() + first, requests.begin() + last);
+
+            answerBatch(&batch, &responses);
+
+            string output;
+            for (unsigned int i = 0; i < responses.size(); i++) {
+                output += responses[i];
+                output += '\n';
+            }
+            if (!writeAll(outputDescriptor, output)) {
+                return;
+            }
+        }
+    }
+}
+
+/// \brief
+/// Listens on a Unix domain socket and answers each connection on its own thread. Only returns
+/// if the socket could not be set up
+///
+/// \param socketPath const string& - the file system path of the socket
+/// \return bool - false if the socket could not be created
+///
+bool QueryServer::serveSocket(const string& socketPath) {
+    struct sockaddr_un address;
+
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        cerr << "Error: Socket path is too long" << endl;
+        return false;
+    }
+
+    int listenDescriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenDescriptor < 0) {
+        cerr << "Error: Could not create socket" << endl;
+        return false;
+    }
+
+    // Replace any socket left behind by an earlier server
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socketPath.c_str());
+    unlink(socketPath.c_str());
+
+    if (bind(listenDescriptor, (struct sockaddr*) &address, sizeof(address)) < 0 || listen(listenDescriptor, SOMAXCONN) < 0) {
+        cerr << "Error: Could not listen on " << socketPath << endl;
+        close(listenDescriptor);
+        return false;
+    }
+
+    while (true) {
+        int clientDescriptor = accept(listenDescriptor, NULL, NULL);
+        if (clientDescriptor < 0) {
+            continue;
+        }
+
+        // Each connection reads its own requests while sharing the worker pool with the others
+        thread([this, clientDescriptor]() {
+            this->serve(clientDescriptor, clientDescriptor);
+            close(clientDescriptor);
+        }).detach();
+    }
+}
+
+/// \brief
+/// Answers a batch of requests, running the searches they need on the worker pool. A QUIT in the batch
+/// is answered with OK, since closing the connection is left to the caller
+///
+/// \param requests vector<string>* - the request lines
+/// \param responses vector<string>* - filled with one response line per request
+///
+void QueryServer::answerBatch(vector<string>* requests, vector<string>* responses) {
+    vector<Query> queries(requests->size());
+    map< pair<bool, unsigned int>, int > treeIndices;
+    vector< pair<bool, unsigned int> > treeSources;
+
+    // The labels are read once so that setHubLabels from another connection cannot change them part way
+    HubLabels* hubLabels = this->hubLabels;
+
+    this->numBatches++;
+    this->numQueries += requests->size();
+
+    // Parse the requests and find the distinct searches they need
+    ComponentIndex* components = this->graph->getComponentIndex();
+    for (unsigned int i = 0; i < requests->size(); i++) {
+        parseQuery((*requests)[i], this->graph->getNumVertices(), &queries[i]);
+
+        // Pairs in different components are answered without a search or a label lookup
+        if ((queries[i].type == QUERY_DISTANCE || queries[i].type == QUERY_PATH || queries[i].type == QUERY_MST)
+            && components != NULL && !components->isReachable(queries[i].sourceId, queries[i].destinationId)) {
+            queries[i].response = "NO PATH";
+            this->numUnreachable++;
+            continue;
+        }
+
+        // Distances come straight from the hub labels when there are some
+        if (queries[i].type == QUERY_DISTANCE && hubLabels != NULL) {
+            continue;
+        }
+
+        if (queries[i].type == QUERY_DISTANCE || queries[i].type == QUERY_PATH || queries[i].type == QUERY_MST) {
+            pair<bool, unsigned int> key(queries[i].type == QUERY_MST, queries[i].sourceId);
+            map< pair<bool, unsigned int>, int >::iterator found = treeIndices.find(key);
+
+            if (found == treeIndices.end()) {
+                queries[i].treeIndex = treeSources.size();
+                treeIndices[key] = treeSources.size();
+                treeSources.push_back(key);
+            }
+            else {
+                queries[i].treeIndex = found->second;
+            }
+        }
+    }
+
+    // Take what trees we can from the cache and list the sources still to be searched
+    vector< shared_ptr<ShortestPathTree> > trees(treeSources.size());
+    vector<unsigned int> missing;
+    for (unsigned int i = 0; i < treeSources.size(); i++) {
+        if (!treeSources[i].first) {
+            trees[i] = this->cache->find(treeSources[i].second);
+        }
+        if (!trees[i]) {
+            trees[i] = shared_ptr<ShortestPathTree>(new ShortestPathTree());
+            missing.push_back(i);
+        }
+    }
+
+    // Find the minimum spanning tree again if the edges have changed, before the workers walk it
+    double minimumSpanningTreeCost = this->graph->minimumSpanningTreeCost();
+
+    // Grow one tree per distinct uncached source in parallel
+    Graph* graph = this->graph;
+    this->pool->parallelFor(missing.size(), [&trees, &treeSources, &missing, graph](unsigned int i) {
+        unsigned int treeIndex = missing[i];
+        if (treeSources[treeIndex].first) {
+            graph->minimumSpanningTreePathTree(treeSources[treeIndex].second, trees[treeIndex].get());
+        }
+        else {
+            graph->shortestPathTree(treeSources[treeIndex].second, trees[treeIndex].get());
+        }
+    });
+    this->numSearches += missing.size();
+
+    for (unsigned int i = 0; i < missing.size(); i++) {
+        if (!treeSources[missing[i]].first) {
+            this->cache->insert(trees[missing[i]]);
+        }
+    }
+
+    // Queries bounded by distance or count each run their own search, stopping early
+    vector<unsigned int> nearbyQueries;
+    for (unsigned int i = 0; i < queries.size(); i++) {
+        if (queries[i].type == QUERY_RADIUS || queries[i].type == QUERY_NEAREST) {
+            nearbyQueries.push_back(i);
+        }
+    }
+    this->pool->parallelFor(nearbyQueries.size(), [this, &queries, &nearbyQueries](unsigned int i) {
+        answerNearbyQuery(&queries[nearbyQueries[i]]);
+    });
+    this->numSearches += nearbyQueries.size();
+
+    // Format a response for every request in the order they were received
+    responses->resize(queries.size());
+    vector<unsigned int> path;
+    for (unsigned int i = 0; i < queries.size(); i++) {
+        Query& query = queries[i];
+        ostringstream out;
+        out << fixed << setprecision(6);
+
+        if (query.type == QUERY_INVALID) {
+            this->numErrors++;
+            out << "ERROR " << query.error;
+        }
+        else if (query.type == QUERY_MST_COST) {
+            out << "OK " << minimumSpanningTreeCost;
+        }
+        else if (query.type == QUERY_STATS) {
+            out << "OK " << getStats();
+        }
+        else if (query.type == QUERY_RADIUS || query.type == QUERY_NEAREST || !query.response.empty()) {
+            out << query.response;
+        }
+        else if (query.type == QUERY_QUIT) {
+            out << "OK";
+        }
+        else if (query.treeIndex == -1 && hubLabels == NULL) {
+            this->numErrors++;
+            out << "ERROR no search for request";
+        }
+        else if (query.treeIndex == -1) {
+            double distance = hubLabels->distance(query.sourceId, query.destinationId);
+            this->numLabelLookups++;
+
+            if (distance == ShortestPathTree::UNREACHABLE) {
+                out << "NO PATH";
+            }
+            else {
+                out << "OK " << distance;
+            }
+        }
+        else {
+            ShortestPathTree& tree = *trees[query.treeIndex];
+
+            if (!tree.isReachable(query.destinationId)) {
+                out << "NO PATH";
+            }
+            else {
+                out << "OK " << tree.getDistance(query.destinationId);
+
+                if (query.type == QUERY_PATH) {
+                    tree.getPath(query.destinationId, &path);
+                    for (unsigned int j = 0; j < path.size(); j++) {
+                        out << " " << path[j];
+                    }
+                }
+            }
+        }
+        (*responses)[i] = out.str();
+    }
+}
+
+/// \brief
+/// Answers distance requests from hub labels instead of searching. The labels must have been built
+/// for the graph and are not updated when its edges change
+///
+/// \param hubLabels HubLabels* - a pointer to the labels, or NULL to go back to searching
+///
+void QueryServer::setHubLabels(HubLabels* hubLabels) {
+    this->hubLabels = hubLabels;
+}
+
+/// \brief
+/// Answers a radius or nearest targets query with a search that stops once its bound is reached
+///
+/// \param query Query* - the query to be answered, whose response is filled in
+///
+void QueryServer::answerNearbyQuery(Query* query) {
+    NearestSearch* search = NULL;
+    vector< pair<double, unsigned int> > results;
+
+    // Reuse an idle search so its working state is not allocated again
+    {
+        unique_lock<mutex> lock(this->nearestSearchesMutex);
+        if (this->idleNearestSearches.size() > 0) {
+            search = this->idleNearestSearches.back();
+            this->idleNearestSearches.pop_back();
+        }
+    }
+    if (search == NULL) {
+        search = new NearestSearch(this->graph);
+        unique_lock<mutex> lock(this->nearestSearchesMutex);
+        this->nearestSearches.push_back(search);
+    }
+
+    if (query->type == QUERY_RADIUS) {
+        search->withinRadius(query->sourceId, query->radius, &results);
+    }
+    else {
+        search->nearestTargets(query->sourceId, query->count, &query->targets, &results);
+    }
+
+    {
+        unique_lock<mutex> lock(this->nearestSearchesMutex);
+        this->idleNearestSearches.push_back(search);
+    }
+
+    ostringstream out;
+    out << fixed << setprecision(6) << "OK " << results.size();
+    for (unsigned int i = 0; i < results.size(); i++) {
+        out << " " << results[i].second << ":" << results[i].first;
+    }
+    query->response = out.str();
+}
+
+/// \brief
+/// Returns the counters kept by the server as name=value pairs
+///
+/// \return string - the server statistics
+///
+string QueryServer::getStats() {
+    ostringstream out;
+    out << "queries=" << this->numQueries << " batches=" << this->numBatches << " searches=" << this->numSearches
+        << " errors=" << this->numErrors << " label_lookups=" << this->numLabelLookups
+        << " unreachable=" << this->numUnreachable << " workers=" << this->pool->getNumWorkers() << " " << this->cache->getStats();
+    return out.str();
+}
@@ -0,0 +1,97 @@
+#include "radixheap.h"
+
+/// This class is a radix heap, a monotone priority queue of whole number keys. Entries are kept in 65
+/// buckets by the highest bit in which their key differs from the last key taken out, so bucket zero
+/// holds keys equal to it and bucket i keys that first differ at bit i - 1. Taking out from an empty
+/// bucket zero finds the first bucket in use, makes its smallest key the last key and spreads its
+/// entries over the lower buckets. Each entry only ever moves down, at most 64 times, so the cost per
+/// entry is bounded by the width of the key rather than the logarithm of the queue size, and no
+/// comparisons between entries are needed. Keys added must never be smaller than the last key taken out.
+///
+
+/// \brief
+/// Creates an empty heap
+///
+RadixHeap::RadixHeap() {
+    this->last = 0;
+    this->size = 0;
+}
+
+/// \brief
+/// There was no dynamically created items in this class so there is no need for a destructor method body
+///
+RadixHeap::~RadixHeap() {}
+
+/// \brief
+/// Adds a vertex with a key
+///
+/// \param key unsigned long long - the key, at least the last key taken out
+/// \param identifier unsigned int - the identifier of the vertex
+///
+void RadixHeap::push(unsigned long long key, unsigned int identifier) {
+    this->buckets[bucketOf(key)].push_back(HeapEntry(key, identifier));
+    this->size++;
+}
+
+/// \brief
+/// Takes out a vertex with the smallest key; the heap must not be empty
+///
+/// \param key unsigned long long* - set to the key
+/// \param identifier unsigned int* - set to the identifier of the vertex
+///
+void RadixHeap::pop(unsigned long long* key, unsigned int* identifier) {
+    if (this->buckets[0].empty()) {
+        unsigned int i = 1;
+        while (this->buckets[i].empty()) {
+            i++;
+        }
+
+        // The smallest key of the first bucket in use becomes the last key, and every entry of that
+        // bucket then differs from it in a lower bit, so moves to a lower bucket
+        vector<HeapEntry>& from = this->buckets[i];
+        unsigned long long smallest = from[0].first;
+        for (unsigned int j = 1; j < from.size(); j++) {
+            smallest = from[j].first < smallest ? from[j].first : smallest;
+        }
+        this->last = smallest;
+        for (unsigned int j = 0; j < from.size(); j++) {
+            this->buckets[bucketOf(from[j].first)].push_back(from[j]);
+        }
+        from.clear();
+    }
+
+    *key = this->buckets[0].back().first;
+    *identifier = this->buckets[0].back().second;
+    this->buckets[0].pop_back();
+    this->size--;
+}
+
+/// \brief
+/// Returns whether the heap is empty
+///
+/// \return bool - true if there are no entries
+///
+bool RadixHeap::empty() {
+    return this->size == 0;
+}
+
+/// \brief
+/// Empties the heap so it can be used for another search
+///
+void RadixHeap::clear() {
+    for (unsigned int i = 0; i < NUM_BUCKETS; i++) {
+        this->buckets[i].clear();
+    }
+    this->last = 0;
+    this->size = 0;
+}
+
+/// \brief
+/// Returns the bucket a key belongs in given the last key taken out
+///
+/// \param key unsigned long long - the key
+/// \return unsigned int - the bucket, zero when the key equals the last key
+///
+unsigned int RadixHeap::bucketOf(unsigned long long key) {
+    return key == this->last ? 0 : 64 - __builtin_clzll(key ^ this->last);
+}
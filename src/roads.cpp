@@ -8,16 +8,43 @@
 ///
 /// The points are required to compute the edge weights between the vertices.
 ///
+/// Options:
+///   --serve              keep the graph loaded and answer queries over standard input and output
+///   --socket <path>      keep the graph loaded and answer queries over a Unix domain socket
+///   --workers <n>        number of worker threads used to answer queries (default: one per core)
+///   --batch <n>          largest number of queries answered together (default: 1024)
+///   --cache <megabytes>  memory kept for cached shortest path trees (default: 256)
+///   --hub-labels         build hub labels up front and answer distance queries from them
+///   --snapshot <path>    take the minimum spanning tree and hub labels from a snapshot file when it
+///                        matches the graph, writing a new snapshot when they had to be computed
+///   --spanner <stretch>  keep only enough edges that no path is more than stretch times longer
+///   --quantum <q>        round every edge weight to a whole number of q, so searches use integer queues
+///   --all-pairs <dir>    write the distances between every pair of cities to <dir>/all-pairs.bin, sharing
+///                        the sources between worker processes and keeping shards left by an earlier run
+///   --processes <n>      number of worker processes for --all-pairs (default: one per core)
+///   --benchmark <n>      report timings of the query engines on a generated road graph of n cities
+///
 /// NOTES: The given code uses pointers to objects in most places.
 ///
 
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <string>
+#include <cstdlib>
+#include <unistd.h>
 
 #include "random.h"
 #include "point.h"
+#include "pointset.h"
 #include "graph.h"
+#include "componentindex.h"
+#include "geometricspanner.h"
+#include "queryserver.h"
+#include "benchmark.h"
+#include "snapshot.h"
+#include "externalgraphwriter.h"
+#include "batchcoordinator.h"
 
 using namespace std;
 
@@ -26,20 +53,82 @@ const int MAXIMUM_COORDINATE = 100;
 const int NUM_CITIES = 10;
 const int SOURCE = 0;
 const double EDGE_PROBABILITY = 0.45;
+const int DEFAULT_BATCH_SIZE = 1024;
+const int DEFAULT_CACHE_MEGABYTES = 256;
+const int ALL_PAIRS_SHARD_SOURCES = 256;
 
 int main(int argc, char *argv[]) {
 
-   bool readFromFile = (argc == 2);
+   bool readFromFile = false;
+   bool serve = false;
+   string fileName;
+   string socketPath;
+   string snapshotPath;
+   string allPairsDirectory;
+   int numWorkers = 0;
+   int numProcesses = 0;
+   int batchSize = DEFAULT_BATCH_SIZE;
+   int cacheMegabytes = DEFAULT_CACHE_MEGABYTES;
+   int benchmarkCities = 0;
+   double spannerStretch = 0;
+   double quantum = 0;
+   bool useHubLabels = false;
    bool includeEdge;
    ifstream infile;
    int numCities = NUM_CITIES;
    Random* random = new Random();
    Point** cities;
 
+   // read the options, any other argument is the file to test from
+   for (int arg = 1; arg < argc; arg++) {
+      string option = argv[arg];
+      if (option == "--serve") {
+         serve = true;
+      } else if (option == "--socket" && arg + 1 < argc) {
+         serve = true;
+         socketPath = argv[++arg];
+      } else if (option == "--workers" && arg + 1 < argc) {
+         numWorkers = atoi(argv[++arg]);
+      } else if (option == "--batch" && arg + 1 < argc) {
+         batchSize = atoi(argv[++arg]);
+      } else if (option == "--cache" && arg + 1 < argc) {
+         cacheMegabytes = atoi(argv[++arg]);
+      } else if (option == "--hub-labels") {
+         useHubLabels = true;
+      } else if (option == "--snapshot" && arg + 1 < argc) {
+         snapshotPath = argv[++arg];
+      } else if (option == "--spanner" && arg + 1 < argc) {
+         spannerStretch = atof(argv[++arg]);
+      } else if (option == "--quantum" && arg + 1 < argc) {
+         quantum = atof(argv[++arg]);
+      } else if (option == "--all-pairs" && arg + 1 < argc) {
+         allPairsDirectory = argv[++arg];
+      } else if (option == "--processes" && arg + 1 < argc) {
+         numProcesses = atoi(argv[++arg]);
+      } else if (option == "--benchmark" && arg + 1 < argc) {
+         benchmarkCities = atoi(argv[++arg]);
+      } else if (option.compare(0, 2, "--") != 0 && !readFromFile) {
+         readFromFile = true;
+         fileName = option;
+      } else {
+         cerr << "Error: Unknown option " << option << endl;
+         return 1;
+      }
+   }
+
+   // report timings on a generated graph instead of the usual output
+   if (benchmarkCities > 0) {
+      Benchmark* benchmark = new Benchmark(benchmarkCities, numWorkers);
+      benchmark->run(cout);
+      delete benchmark;
+      delete random;
+      return 0;
+   }
+
    // allow for testing from file
    if (readFromFile) {
       // open the file and check it exists
-      infile.open(argv[1]);
+      infile.open(fileName.c_str());
       if (infile.fail()) {
          cerr <<  "Error: Could not find file" << endl;
          return 1;
@@ -52,7 +141,9 @@ int main(int argc, char *argv[]) {
       for (int city = 0; city < numCities; city++) {
          infile >> xCoordinate >> yCoordinate;
          cities[city] = new Point(xCoordinate, yCoordinate);
-         cout << "City " << setw(2) << city << " co-ordinates : " << *cities[city] << endl;
+         if (!serve) {
+            cout << "City " << setw(2) << city << " co-ordinates : " << *cities[city] << endl;
+         }
       }
 
    } else {
@@ -62,20 +153,28 @@ int main(int argc, char *argv[]) {
       for (int city = 0; city < numCities; city++) {
          cities[city] = new Point(random->randomInteger(MINIMUM_COORDINATE, MAXIMUM_COORDINATE),
                                   random->randomInteger(MINIMUM_COORDINATE, MAXIMUM_COORDINATE));
-         cout << "City " << setw(2) << city << " co-ordinates : " << *cities[city] << endl;
+         if (!serve) {
+            cout << "City " << setw(2) << city << " co-ordinates : " << *cities[city] << endl;
+         }
       }
    }
-   cout << endl;
 
    // create the graph and add vertices for all cities
    Graph* graph = new Graph(numCities);
+   if (quantum > 0) {
+      graph->setQuantum(quantum);
+   }
    for (int i = 0; i < numCities; i++) {
       Vertex* v = new Vertex(i);
       graph->addVertex(v);
    }
 
-   // add edges to graph
+   // add edges to graph, working out the distances from each city to those after it in one pass
+   vector<Point*> cityList(cities, cities + numCities);
+   PointSet points(&cityList);
+   vector<double> row(numCities);
    for (int i = 0; i < numCities - 1; i++) {
+      points.distancesFrom(i, i + 1, numCities - i - 1, &row[0]);
       for (int j = i + 1; j < numCities; j++) {
          if (readFromFile) {
             infile >> includeEdge;
@@ -83,7 +182,7 @@ int main(int argc, char *argv[]) {
             includeEdge = random->randomChance(EDGE_PROBABILITY);
          }
          if (includeEdge) {
-            Edge* edge = new Edge(graph->getVertex(i), graph->getVertex(j), cities[i]->distanceTo(cities[j]));
+            Edge* edge = new Edge(graph->getVertex(i), graph->getVertex(j), row[j - i - 1]);
             graph->addEdge(edge);
          }
       }
@@ -93,7 +192,125 @@ int main(int argc, char *argv[]) {
    if (readFromFile) {
       infile.close();
    }
+   if (quantum > 0) {
+      cerr << "Weights rounded to multiples of " << quantum << ", largest error " << graph->getMaxQuantisationError()
+           << " (" << graph->getMaxRelativeQuantisationError() * 100 << "% of the edge)" << endl;
+   }
+
+   // replace the graph with a spanner of it, so later searches run over far fewer edges
+   if (spannerStretch > 0) {
+      GeometricSpanner spanner(spannerStretch);
+      Graph* sparse = spanner.build(graph);
+      delete graph;
+      graph = sparse;
+      cerr << "Spanner kept " << spanner.getNumEdges() << " of " << spanner.getNumCandidateEdges()
+           << " edges, largest stretch " << fixed << setprecision(3) << spanner.getMaxStretch() << endl;
+   }
+
+   // write every distance with worker processes sharing a file of the graph, then merge their shards
+   if (!allPairsDirectory.empty()) {
+      string graphPath = allPairsDirectory + "/graph.edges";
+      ExternalGraphWriter* writer = new ExternalGraphWriter(graphPath, numCities, (unsigned long) numCities * 16 * sizeof(ExternalEdge));
+      bool written = true;
+      for (int i = 0; i < numCities && written; i++) {
+         vector<unsigned int>* neighbours = graph->getNeighbours(i);
+         for (unsigned int j = 0; j < neighbours->size() && written; j++) {
+            if ((int) (*neighbours)[j] > i) {
+               written = writer->addEdge(i, (*neighbours)[j], graph->getWeight(i, (*neighbours)[j]));
+            }
+         }
+      }
+      written = written && writer->finish();
+      delete writer;
+
+      string error = written ? "" : "could not write " + graphPath;
+      BatchCoordinator* coordinator = new BatchCoordinator(graphPath, allPairsDirectory,
+                                                           numProcesses > 0 ? numProcesses : sysconf(_SC_NPROCESSORS_ONLN),
+                                                           ALL_PAIRS_SHARD_SOURCES);
+      if (written && coordinator->run(&error) && coordinator->merge(allPairsDirectory + "/all-pairs.bin", &error)) {
+         cerr << "All pairs written in " << coordinator->getNumShards() << " shards, " << coordinator->getNumKept()
+              << " kept from an earlier run, " << coordinator->getNumRestarts() << " restarted" << endl;
+      } else {
+         cerr << "Error: " << error << endl;
+      }
+      delete coordinator;
+
+      delete random;
+      for (int i = 0; i < numCities; i++) {
+         delete cities[i];
+      }
+      delete[] cities;
+      delete graph;
+      return error.empty() ? 0 : 1;
+   }
+
+   // label the components so pairs with no path between them are answered without searching
+   WorkerPool* labellingPool = new WorkerPool(numWorkers);
+   ComponentIndex* components = new ComponentIndex(graph, labellingPool);
+   delete labellingPool;
+
+   // keep the graph loaded and answer queries until the input is closed
+   if (serve) {
+
+      // take what was precomputed from the snapshot, as long as it was taken from this graph
+      Snapshot* snapshot = NULL;
+      bool computed = false;
+      if (!snapshotPath.empty()) {
+         string error;
+         snapshot = new Snapshot();
+         if (!snapshot->open(snapshotPath, graph->fingerprint(), &error) || !graph->loadMinimumSpanningTree(snapshot)) {
+            cerr << "Snapshot not used: " << (error.empty() ? "no minimum spanning tree" : error) << endl;
+            delete snapshot;
+            snapshot = NULL;
+            computed = true;
+         }
+      }
+
+      QueryServer* server = new QueryServer(graph, numWorkers, batchSize, (unsigned long) cacheMegabytes * 1024 * 1024);
+      HubLabels* hubLabels = NULL;
+      if (useHubLabels) {
+         hubLabels = new HubLabels();
+         if (snapshot == NULL || !hubLabels->load(snapshot, numCities)) {
+            WorkerPool* pool = new WorkerPool(numWorkers);
+            hubLabels->build(graph, pool);
+            delete pool;
+            computed = true;
+         }
+         server->setHubLabels(hubLabels);
+      }
+
+      // save anything that had to be computed so the next start can skip it
+      if (!snapshotPath.empty() && computed) {
+         vector<SnapshotSectionType> types;
+         vector< pair<const void*, unsigned long> > contents;
+         graph->saveMinimumSpanningTree(&types, &contents);
+         if (hubLabels != NULL) {
+            hubLabels->save(&types, &contents);
+         }
+         if (!Snapshot::write(snapshotPath, graph->fingerprint(), types, contents)) {
+            cerr << "Error: Could not write snapshot " << snapshotPath << endl;
+         }
+      }
+      if (socketPath.empty()) {
+         server->serve(STDIN_FILENO, STDOUT_FILENO);
+      } else if (!server->serveSocket(socketPath)) {
+         return 1;
+      }
+      delete server;
+      delete hubLabels;
+      delete snapshot;
+      delete components;
+
+      delete random;
+      for (int i = 0; i < numCities; i++) {
+         delete cities[i];
+      }
+      delete[] cities;
+      delete graph;
+      return 0;
+   }
 
+   cout << endl;
    cout << "Edge Weights" << endl;
    cout << "============" << endl;
    cout << *graph << endl << endl;
@@ -113,6 +330,7 @@ int main(int argc, char *argv[]) {
    graph->bfs(SOURCE);
    cout << endl;
 
+   delete components;
    delete random;
    for (int i = 0; i < numCities; i++) {
       delete cities[i];
@@ -0,0 +1,150 @@
+#include "searchspace.h"
+
+/// This class holds the working state of a Dijkstra search that is settled one vertex at a time, so that
+/// callers can stop as soon as they have what they need. It is meant to be reused for many searches;
+/// starting a new search only forgets the vertices touched by the last one rather than every vertex.
+///
+
+/// \brief
+/// Creates the working state for searches over a graph with the given number of vertices
+///
+/// \param numVertices unsigned int - the number of vertices within the graph
+///
+SearchSpace::SearchSpace(unsigned int numVertices) {
+    this->generation = 0;
+    this->reachedGeneration.assign(numVertices, 0);
+    this->settledGeneration.assign(numVertices, 0);
+    this->distances.resize(numVertices);
+    this->predecessors.resize(numVertices);
+}
+
+/// \brief
+/// There was no dynamically created items in this class so there is no need for a destructor method body
+///
+SearchSpace::~SearchSpace() {}
+
+/// \brief
+/// Forgets the last search and starts a new one from the source vertex
+///
+/// \param sourceId unsigned int - the identifier of the source vertex
+///
+void SearchSpace::start(unsigned int sourceId) {
+
+    // Moving to a new generation makes every vertex unreached without visiting them
+    this->generation++;
+    if (this->generation == 0) {
+        this->reachedGeneration.assign(this->reachedGeneration.size(), 0);
+        this->settledGeneration.assign(this->settledGeneration.size(), 0);
+        this->generation = 1;
+    }
+
+    this->touched.clear();
+    while (!this->unvisitedVerticesQueue.empty()) {
+        this->unvisitedVerticesQueue.pop();
+    }
+
+    this->reachedGeneration[sourceId] = this->generation;
+    this->distances[sourceId] = 0;
+    this->predecessors[sourceId] = sourceId;
+    this->touched.push_back(sourceId);
+    this->unvisitedVerticesQueue.push(QueueEntry(0.0, sourceId));
+}
+
+/// \brief
+/// Returns the distance of the next vertex to be settled, discarding queue entries that are out of date
+///
+/// \return double - the distance of the next vertex, or ShortestPathTree::UNREACHABLE if the search is finished
+///
+double SearchSpace::nextDistance() {
+    while (!this->unvisitedVerticesQueue.empty()) {
+        if (!isSettled(this->unvisitedVerticesQueue.top().second)) {
+            return this->unvisitedVerticesQueue.top().first;
+        }
+        this->unvisitedVerticesQueue.pop();
+    }
+    return ShortestPathTree::UNREACHABLE;
+}
+
+/// \brief
+/// Settles the closest unsettled vertex and relaxes the edges leaving it
+///
+/// \param graph Graph* - the graph being searched
+/// \param identifier unsigned int* - set to the identifier of the settled vertex
+/// \return bool - false if there are no vertices left to settle
+///
+bool SearchSpace::settleNext(Graph* graph, unsigned int* identifier) {
+    if (nextDistance() == ShortestPathTree::UNREACHABLE) {
+        return false;
+    }
+
+    unsigned int uId = this->unvisitedVerticesQueue.top().second;
+    this->unvisitedVerticesQueue.pop();
+    this->settledGeneration[uId] = this->generation;
+
+    // Relax every edge leaving the settled vertex
+    vector<unsigned int>* adjacent = graph->getNeighbours(uId);
+    for (unsigned int i = 0; i < adjacent->size(); i++) {
+        unsigned int vId = (*adjacent)[i];
+        double distance = this->distances[uId] + graph->getWeight(uId, vId);
+
+        if (this->reachedGeneration[vId] != this->generation) {
+            this->reachedGeneration[vId] = this->generation;
+            this->touched.push_back(vId);
+        }
+        else if (this->settledGeneration[vId] == this->generation || distance >= this->distances[vId]) {
+            continue;
+        }
+
+        this->distances[vId] = distance;
+        this->predecessors[vId] = uId;
+        this->unvisitedVerticesQueue.push(QueueEntry(distance, vId));
+    }
+
+    *identifier = uId;
+    return true;
+}
+
+/// \brief
+/// Returns the tentative distance from the source to a vertex, which is final once it is settled
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \return double - the distance, or ShortestPathTree::UNREACHABLE if the vertex has not been reached
+///
+double SearchSpace::getDistance(unsigned int identifier) {
+    if (this->reachedGeneration[identifier] != this->generation) {
+        return ShortestPathTree::UNREACHABLE;
+    }
+    return this->distances[identifier];
+}
+
+/// \brief
+/// Returns the predecessor of a reached vertex on its path back to the source
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \return unsigned int - the identifier of the predecessor vertex
+///
+unsigned int SearchSpace::getPredecessorId(unsigned int identifier) {
+    if (this->reachedGeneration[identifier] != this->generation) {
+        return identifier;
+    }
+    return this->predecessors[identifier];
+}
+
+/// \brief
+/// Returns whether or not the search has settled a vertex
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \return bool - true if the distance to the vertex is final
+///
+bool SearchSpace::isSettled(unsigned int identifier) {
+    return this->settledGeneration[identifier] == this->generation;
+}
+
+/// \brief
+/// Returns the vertices reached by the current search in the order they were first reached
+///
+/// \return vector<unsigned int>* - a pointer to the identifiers of the reached vertices
+///
+vector<unsigned int>* SearchSpace::getTouched() {
+    return &this->touched;
+}
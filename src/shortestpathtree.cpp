@@ -0,0 +1,151 @@
+#include <limits>
+#include "shortestpathtree.h"
+
+/// This class holds the result of a single source shortest path search; the distance from the source
+/// and the predecessor on the path back to the source for every vertex in the graph
+///
+
+const double ShortestPathTree::UNREACHABLE = numeric_limits<double>::infinity();
+
+/// \brief
+/// Creates an empty tree that holds no vertices until reset is called
+///
+ShortestPathTree::ShortestPathTree() {
+    this->sourceId = 0;
+}
+
+/// \brief
+/// There was no dynamically created items in this class so there is no need for a destructor method body
+///
+ShortestPathTree::~ShortestPathTree() {}
+
+/// \brief
+/// Clears the tree so every vertex is unreachable and is its own predecessor, except for the source
+/// which is given a distance of zero
+///
+/// \param sourceId unsigned int - the identifier of the source vertex
+/// \param numVertices unsigned int - the number of vertices within the graph
+///
+void ShortestPathTree::reset(unsigned int sourceId, unsigned int numVertices) {
+    this->sourceId = sourceId;
+    this->distances.assign(numVertices, UNREACHABLE);
+    this->predecessors.resize(numVertices);
+
+    // Every vertex starts as its own predecessor so paths stop at unreachable vertices
+    for (unsigned int i = 0; i < numVertices; i++) {
+        this->predecessors[i] = i;
+    }
+
+    if (sourceId < numVertices) {
+        this->distances[sourceId] = 0;
+    }
+}
+
+/// \brief
+/// Returns the identifier of the source vertex the tree was grown from
+///
+/// \return unsigned int - the identifier of the source vertex
+///
+unsigned int ShortestPathTree::getSourceId() {
+    return this->sourceId;
+}
+
+/// \brief
+/// Returns the number of vertices held in the tree
+///
+/// \return unsigned int - the number of vertices held in the tree
+///
+unsigned int ShortestPathTree::getNumVertices() {
+    return this->distances.size();
+}
+
+/// \brief
+/// Sets the distance from the source to a vertex
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \param distance double - the distance from the source to the vertex
+///
+void ShortestPathTree::setDistance(unsigned int identifier, double distance) {
+    this->distances[identifier] = distance;
+}
+
+/// \brief
+/// Returns the distance from the source to a vertex
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \return double - the distance from the source, or UNREACHABLE if there is no path
+///
+double ShortestPathTree::getDistance(unsigned int identifier) {
+    return this->distances[identifier];
+}
+
+/// \brief
+/// Sets the predecessor of a vertex on its path back to the source
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \param predecessorId unsigned int - the identifier of the predecessor vertex
+///
+void ShortestPathTree::setPredecessorId(unsigned int identifier, unsigned int predecessorId) {
+    this->predecessors[identifier] = predecessorId;
+}
+
+/// \brief
+/// Returns the predecessor of a vertex on its path back to the source
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \return unsigned int - the identifier of the predecessor vertex
+///
+unsigned int ShortestPathTree::getPredecessorId(unsigned int identifier) {
+    return this->predecessors[identifier];
+}
+
+/// \brief
+/// Returns whether or not a vertex can be reached from the source
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \return bool - true if there is a path from the source to the vertex
+///
+bool ShortestPathTree::isReachable(unsigned int identifier) {
+    return identifier < this->distances.size() && this->distances[identifier] != UNREACHABLE;
+}
+
+/// \brief
+/// Follows the predecessors back from a vertex to build the path from the source to that vertex
+///
+/// \param destinationId unsigned int - the identifier of the vertex at the end of the path
+/// \param path vector<unsigned int>* - filled with the identifiers on the path, starting with the source
+/// \return bool - false if the destination cannot be reached from the source
+///
+bool ShortestPathTree::getPath(unsigned int destinationId, vector<unsigned int>* path) {
+    path->clear();
+
+    if (!isReachable(destinationId)) {
+        return false;
+    }
+
+    // Walk back through the predecessors until the source is found
+    unsigned int current = destinationId;
+    path->push_back(current);
+    while (current != this->sourceId) {
+        current = this->predecessors[current];
+        path->push_back(current);
+    }
+
+    // Reverse the path so it runs from the source to the destination
+    for (unsigned int i = 0; i < path->size() / 2; i++) {
+        unsigned int swapped = (*path)[i];
+        (*path)[i] = (*path)[path->size() - 1 - i];
+        (*path)[path->size() - 1 - i] = swapped;
+    }
+    return true;
+}
+
+/// \brief
+/// Returns the number of bytes used to hold the distances and predecessors of the tree
+///
+/// \return unsigned long - the memory used by the tree in bytes
+///
+unsigned long ShortestPathTree::memoryUsage() {
+    return sizeof(ShortestPathTree) + this->distances.capacity() * sizeof(double)
+        + this->predecessors.capacity() * sizeof(unsigned int);
+}
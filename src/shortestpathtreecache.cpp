@@ -0,0 +1,160 @@
+#include <sstream>
+#include <iomanip>
+#include "shortestpathtreecache.h"
+
+/// This class keeps the most recently used shortest path trees, keyed by their source, within a memory
+/// budget. When an edge of the graph changes only the trees that the change could make wrong are dropped.
+///
+
+/// \brief
+/// Creates an empty cache that holds trees up to the given total size
+///
+/// \param maxBytes unsigned long - the most memory the cached trees may use, in bytes
+///
+ShortestPathTreeCache::ShortestPathTreeCache(unsigned long maxBytes) {
+    this->maxBytes = maxBytes;
+    this->usedBytes = 0;
+    this->numHits = 0;
+    this->numMisses = 0;
+    this->numEvictions = 0;
+    this->numInvalidations = 0;
+}
+
+/// \brief
+/// The cached trees are shared pointers so there is no need for a destructor method body
+///
+ShortestPathTreeCache::~ShortestPathTreeCache() {}
+
+/// \brief
+/// Returns the cached tree for a source and marks it as the most recently used
+///
+/// \param sourceId unsigned int - the identifier of the source vertex
+/// \return shared_ptr<ShortestPathTree> - the cached tree, or an empty pointer if there is none
+///
+shared_ptr<ShortestPathTree> ShortestPathTreeCache::find(unsigned int sourceId) {
+    unique_lock<mutex> lock(this->cacheMutex);
+
+    map<unsigned int, Entry>::iterator found = this->entries.find(sourceId);
+    if (found == this->entries.end()) {
+        this->numMisses++;
+        return shared_ptr<ShortestPathTree>();
+    }
+
+    // Move the source to the front of the recently used list
+    this->recentlyUsed.splice(this->recentlyUsed.begin(), this->recentlyUsed, found->second.recentlyUsed);
+    this->numHits++;
+    return found->second.tree;
+}
+
+/// \brief
+/// Adds a tree to the cache, dropping the least recently used trees until it fits within the budget
+///
+/// \param tree shared_ptr<ShortestPathTree> - the completed tree to be cached
+///
+void ShortestPathTreeCache::insert(shared_ptr<ShortestPathTree> tree) {
+    unsigned long bytes = tree->memoryUsage();
+    unique_lock<mutex> lock(this->cacheMutex);
+
+    // Trees larger than the whole budget are never cached
+    if (bytes > this->maxBytes) {
+        return;
+    }
+
+    // Replace any tree already cached for the same source
+    map<unsigned int, Entry>::iterator found = this->entries.find(tree->getSourceId());
+    if (found != this->entries.end()) {
+        erase(found);
+    }
+
+    while (this->usedBytes + bytes > this->maxBytes) {
+        erase(this->entries.find(this->recentlyUsed.back()));
+        this->numEvictions++;
+    }
+
+    this->recentlyUsed.push_front(tree->getSourceId());
+    Entry& entry = this->entries[tree->getSourceId()];
+    entry.tree = tree;
+    entry.recentlyUsed = this->recentlyUsed.begin();
+    entry.bytes = bytes;
+    this->usedBytes += bytes;
+}
+
+/// \brief
+/// Drops every cached tree
+///
+void ShortestPathTreeCache::clear() {
+    unique_lock<mutex> lock(this->cacheMutex);
+    this->entries.clear();
+    this->recentlyUsed.clear();
+    this->usedBytes = 0;
+}
+
+/// \brief
+/// Drops the cached trees whose distances or paths may be changed by the edge change
+///
+/// \param sourceId unsigned int - the identifier of the first vertex of the edge
+/// \param destinationId unsigned int - the identifier of the second vertex of the edge
+/// \param oldWeight double - the weight before the change, or NO_EDGE if the edge is new
+/// \param newWeight double - the weight after the change, or NO_EDGE if the edge was removed
+///
+void ShortestPathTreeCache::edgeChanged(unsigned int sourceId, unsigned int destinationId, double oldWeight, double newWeight) {
+    unique_lock<mutex> lock(this->cacheMutex);
+
+    map<unsigned int, Entry>::iterator entry = this->entries.begin();
+    while (entry != this->entries.end()) {
+        ShortestPathTree* tree = entry->second.tree.get();
+        double sourceDistance = tree->getDistance(sourceId);
+        double destinationDistance = tree->getDistance(destinationId);
+        bool stale;
+
+        if (newWeight <= oldWeight) {
+            // A new or cheaper edge only matters if it gives a shorter way to either end
+            stale = sourceDistance + newWeight < destinationDistance || destinationDistance + newWeight < sourceDistance;
+        }
+        else {
+            // A removed or dearer edge only matters if the tree uses it
+            stale = (tree->isReachable(destinationId) && tree->getPredecessorId(destinationId) == sourceId && destinationId != tree->getSourceId())
+                 || (tree->isReachable(sourceId) && tree->getPredecessorId(sourceId) == destinationId && sourceId != tree->getSourceId());
+        }
+
+        if (stale) {
+            map<unsigned int, Entry>::iterator next = entry;
+            next++;
+            erase(entry);
+            this->numInvalidations++;
+            entry = next;
+        }
+        else {
+            entry++;
+        }
+    }
+}
+
+/// \brief
+/// Returns the counters kept by the cache as name=value pairs
+///
+/// \return string - the cache statistics
+///
+string ShortestPathTreeCache::getStats() {
+    unique_lock<mutex> lock(this->cacheMutex);
+    ostringstream out;
+    unsigned long lookups = this->numHits + this->numMisses;
+
+    out << "cache_entries=" << this->entries.size() << " cache_bytes=" << this->usedBytes
+        << " cache_max_bytes=" << this->maxBytes << " cache_hits=" << this->numHits
+        << " cache_misses=" << this->numMisses << " cache_hit_rate=" << fixed << setprecision(4)
+        << (lookups > 0 ? (double) this->numHits / lookups : 0.0) << " cache_evictions=" << this->numEvictions
+        << " cache_invalidations=" << this->numInvalidations;
+    return out.str();
+}
+
+/// \brief
+/// Removes a cached tree and returns its memory to the budget
+///
+/// \param entry map<unsigned int, Entry>::iterator - the cached tree to be removed
+///
+void ShortestPathTreeCache::erase(map<unsigned int, Entry>::iterator entry) {
+    this->usedBytes -= entry->second.bytes;
+    this->recentlyUsed.erase(entry->second.recentlyUsed);
+    this->entries.erase(entry);
+}
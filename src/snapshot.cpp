@@ -0,0 +1,237 @@
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "snapshot.h"
+
+/// This class maps a snapshot file of precomputed structures back into memory. A snapshot starts with a
+/// page holding a header and a table of sections, followed by each section starting on a page boundary
+/// so its contents can be used in place without being copied or decoded. Opening checks the version,
+/// the fingerprint of the graph the snapshot was taken from and the checksum of every section, so a
+/// snapshot of a different graph or a damaged file is refused rather than giving wrong answers.
+///
+
+const unsigned int Snapshot::VERSION = 1;
+
+const char SNAPSHOT_MAGIC[8] = { 'R', 'O', 'A', 'D', 'S', 'N', 'A', 'P' };
+const unsigned long SNAPSHOT_PAGE_SIZE = 4096;
+
+/// The start of a snapshot file
+struct SnapshotHeader {
+    char magic[8];
+    unsigned int version;
+    unsigned int numSections;
+    unsigned long long fingerprint;
+    unsigned long long tableChecksum;
+};
+
+/// Where one section lies in a snapshot file
+struct SnapshotSection {
+    unsigned int type;
+    unsigned int reserved;
+    unsigned long long offset;
+    unsigned long long length;
+    unsigned long long checksum;
+};
+
+const unsigned int MAX_SNAPSHOT_SECTIONS = (SNAPSHOT_PAGE_SIZE - sizeof(SnapshotHeader)) / sizeof(SnapshotSection);
+
+/// \brief
+/// Creates a snapshot with no file mapped
+///
+Snapshot::Snapshot() {
+    this->mapping = NULL;
+    this->mappingLength = 0;
+}
+
+/// \brief
+/// Unmaps the file, after which pointers to its sections must no longer be used
+///
+Snapshot::~Snapshot() {
+    if (this->mapping != NULL) {
+        munmap(this->mapping, this->mappingLength);
+    }
+}
+
+/// \brief
+/// Maps a snapshot file and checks that it belongs to the graph with the given fingerprint
+///
+/// \param path const string& - the path of the snapshot file
+/// \param fingerprint unsigned long long - the fingerprint of the graph the snapshot is wanted for
+/// \param error string* - set to the reason when the snapshot cannot be used
+/// \return bool - true if the snapshot was mapped and is valid
+///
+bool Snapshot::open(const string& path, unsigned long long fingerprint, string* error) {
+    error->clear();
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        *error = "could not open " + path;
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(descriptor, &status) < 0 || (unsigned long) status.st_size < SNAPSHOT_PAGE_SIZE) {
+        ::close(descriptor);
+        *error = "file is too short";
+        return false;
+    }
+
+    // The mapping stays valid once the descriptor is closed
+    void* mapping = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    if (mapping == MAP_FAILED) {
+        *error = "could not map file";
+        return false;
+    }
+
+    const SnapshotHeader* header = (const SnapshotHeader*) mapping;
+    const SnapshotSection* sections = (const SnapshotSection*) (header + 1);
+
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        *error = "not a snapshot file";
+    }
+    else if (header->version != VERSION) {
+        *error = "snapshot was written by a different version";
+    }
+    else if (header->fingerprint != fingerprint) {
+        *error = "snapshot was taken from a different graph";
+    }
+    else if (header->numSections > MAX_SNAPSHOT_SECTIONS
+             || header->tableChecksum != checksum(sections, header->numSections * sizeof(SnapshotSection), 0)) {
+        *error = "section table is damaged";
+    }
+    else {
+        for (unsigned int i = 0; i < header->numSections && error->empty(); i++) {
+            if (sections[i].offset > (unsigned long) status.st_size || sections[i].length > status.st_size - sections[i].offset) {
+                *error = "section lies outside the file";
+            }
+            else if (sections[i].checksum != checksum((const char*) mapping + sections[i].offset, sections[i].length, 0)) {
+                *error = "section checksum does not match";
+            }
+        }
+    }
+
+    if (!error->empty()) {
+        munmap(mapping, status.st_size);
+        return false;
+    }
+
+    if (this->mapping != NULL) {
+        munmap(this->mapping, this->mappingLength);
+    }
+    this->mapping = mapping;
+    this->mappingLength = status.st_size;
+    return true;
+}
+
+/// \brief
+/// Returns the contents of a section, which stay in place for as long as the snapshot is open
+///
+/// \param type SnapshotSectionType - the kind of section
+/// \param length unsigned long* - set to the length of the section in bytes
+/// \return const void* - a pointer to the contents, or NULL if the snapshot has no such section
+///
+const void* Snapshot::getSection(SnapshotSectionType type, unsigned long* length) {
+    if (this->mapping == NULL) {
+        return NULL;
+    }
+
+    const SnapshotHeader* header = (const SnapshotHeader*) this->mapping;
+    const SnapshotSection* sections = (const SnapshotSection*) (header + 1);
+    for (unsigned int i = 0; i < header->numSections; i++) {
+        if (sections[i].type == (unsigned int) type) {
+            *length = sections[i].length;
+            return (const char*) this->mapping + sections[i].offset;
+        }
+    }
+    return NULL;
+}
+
+/// \brief
+/// Writes the sections given to a new snapshot file. The file is written under a temporary name and
+/// renamed into place, so a reader never sees a partly written snapshot
+///
+/// \param path const string& - the path of the snapshot file
+/// \param fingerprint unsigned long long - the fingerprint of the graph the sections were computed from
+/// \param types const vector<SnapshotSectionType>& - the kind of each section
+/// \param contents const vector< pair<const void*, unsigned long> >& - the address and length of each section
+/// \return bool - false if the file could not be written
+///
+bool Snapshot::write(const string& path, unsigned long long fingerprint, const vector<SnapshotSectionType>& types,
+                     const vector< pair<const void*, unsigned long> >& contents) {
+    if (types.size() > MAX_SNAPSHOT_SECTIONS || types.size() != contents.size()) {
+        return false;
+    }
+
+    // Lay the sections out one after another, each starting on a page boundary
+    vector<char> headerPage(SNAPSHOT_PAGE_SIZE, 0);
+    SnapshotHeader* header = (SnapshotHeader*) &headerPage[0];
+    SnapshotSection* sections = (SnapshotSection*) (header + 1);
+    unsigned long long offset = SNAPSHOT_PAGE_SIZE;
+
+    for (unsigned int i = 0; i < types.size(); i++) {
+        sections[i].type = types[i];
+        sections[i].offset = offset;
+        sections[i].length = contents[i].second;
+        sections[i].checksum = checksum(contents[i].first, contents[i].second, 0);
+        offset += (contents[i].second + SNAPSHOT_PAGE_SIZE - 1) / SNAPSHOT_PAGE_SIZE * SNAPSHOT_PAGE_SIZE;
+    }
+
+    memcpy(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header->version = VERSION;
+    header->numSections = types.size();
+    header->fingerprint = fingerprint;
+    header->tableChecksum = checksum(sections, types.size() * sizeof(SnapshotSection), 0);
+
+    string temporaryPath = path + ".tmp";
+    FILE* file = fopen(temporaryPath.c_str(), "wb");
+    if (file == NULL) {
+        return false;
+    }
+
+    bool written = fwrite(&headerPage[0], 1, SNAPSHOT_PAGE_SIZE, file) == SNAPSHOT_PAGE_SIZE;
+    vector<char> padding(SNAPSHOT_PAGE_SIZE, 0);
+    for (unsigned int i = 0; i < types.size() && written; i++) {
+        unsigned long paddingLength = (SNAPSHOT_PAGE_SIZE - contents[i].second % SNAPSHOT_PAGE_SIZE) % SNAPSHOT_PAGE_SIZE;
+        written = fwrite(contents[i].first, 1, contents[i].second, file) == contents[i].second
+            && fwrite(&padding[0], 1, paddingLength, file) == paddingLength;
+    }
+
+    // Make sure the contents reach the disk before the new file replaces the old one
+    written = fflush(file) == 0 && fsync(fileno(file)) == 0 && written;
+    written = fclose(file) == 0 && written;
+    if (!written || rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        unlink(temporaryPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+/// \brief
+/// Returns a 64 bit checksum of a block of memory
+///
+/// \param data const void* - the start of the block
+/// \param length unsigned long - the length of the block in bytes
+/// \param seed unsigned long long - the checksum of any data before this block, or zero
+/// \return unsigned long long - the checksum
+///
+unsigned long long Snapshot::checksum(const void* data, unsigned long length, unsigned long long seed) {
+    const unsigned long long PRIME = 0x100000001b3ULL;
+    const unsigned char* bytes = (const unsigned char*) data;
+    unsigned long long hash = seed ^ 0xcbf29ce484222325ULL;
+
+    // Mix in eight bytes at a time, which is fast enough to check large sections on every start
+    unsigned long i = 0;
+    for (; i + 8 <= length; i += 8) {
+        unsigned long long word;
+        memcpy(&word, bytes + i, 8);
+        hash = (hash ^ word) * PRIME;
+        hash ^= hash >> 29;
+    }
+    for (; i < length; i++) {
+        hash = (hash ^ bytes[i]) * PRIME;
+    }
+    return hash;
+}
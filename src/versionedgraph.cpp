@@ -0,0 +1,348 @@
+#include <queue>
+#include <functional>
+#include "versionedgraph.h"
+#include "graphobserver.h"
+
+/// This class lets queries run while the graph is being updated. The graph is copied once into rows of
+/// neighbours grouped into chunks, and a version is a table of chunks. An update copies the table, the
+/// chunks it touches and the rows it changes, shares everything else with the version before it, and
+/// publishes the new version with a single atomic store, so a reader always searches a whole version and
+/// never waits for a writer.
+///
+/// Replaced versions, chunks and rows are freed by epoch: a reader announces the epoch it started in
+/// before picking up the current version, everything a writer replaces is tagged with the epoch it was
+/// replaced in, and it is freed once no reader announced an epoch that early. Writers are applied one
+/// at a time; readers each keep to their own slot.
+///
+
+/// The number of rows in a chunk, so an update copies a table of about n / 256 chunks and one chunk
+const unsigned int VERSION_CHUNK_ROWS = 256;
+
+/// The epoch of a reader slot that is not reading
+const unsigned long IDLE = 0;
+
+/// \brief
+/// Returns the number of the version, counting up from zero for the graph it was copied from
+///
+/// \return unsigned long - the version number
+///
+unsigned long GraphVersion::getNumber() const {
+    return this->number;
+}
+
+/// \brief
+/// Returns the number of vertices within the graph
+///
+/// \return unsigned int - the number of vertices
+///
+unsigned int GraphVersion::getNumVertices() const {
+    return this->numVertices;
+}
+
+/// \brief
+/// Returns the neighbours of a vertex and the weight of the edge to each
+///
+/// \param identifier unsigned int - the identifier of the vertex
+/// \return const VersionRow& - the neighbours and weights
+///
+const VersionRow& GraphVersion::getNeighbours(unsigned int identifier) const {
+    return *this->chunks[identifier / VERSION_CHUNK_ROWS]->rows[identifier % VERSION_CHUNK_ROWS];
+}
+
+/// \brief
+/// Returns the weight of an edge
+///
+/// \param sourceId unsigned int - the identifier of the first vertex
+/// \param destinationId unsigned int - the identifier of the second vertex
+/// \return double - the weight, or NO_EDGE if there is no such edge
+///
+double GraphVersion::getWeight(unsigned int sourceId, unsigned int destinationId) const {
+    const VersionRow& row = getNeighbours(sourceId);
+    for (unsigned int i = 0; i < row.size(); i++) {
+        if (row[i].first == destinationId) {
+            return row[i].second;
+        }
+    }
+    return GraphObserver::NO_EDGE;
+}
+
+/// \brief
+/// Returns the sum of the weights of every edge, counting each edge once
+///
+/// \return double - the total weight
+///
+double GraphVersion::getTotalWeight() const {
+    return this->totalWeight;
+}
+
+/// \brief
+/// Returns the shortest path distance between two vertices with a Dijkstra search that stops at the destination
+///
+/// \param sourceId unsigned int - the identifier of the source vertex
+/// \param destinationId unsigned int - the identifier of the destination vertex
+/// \param distances vector<double>* - working space for the distance of every vertex, reused between searches
+/// \return double - the distance, or ShortestPathTree::UNREACHABLE if there is no path
+///
+double GraphVersion::distance(unsigned int sourceId, unsigned int destinationId, vector<double>* distances) const {
+    distances->assign(this->numVertices, ShortestPathTree::UNREACHABLE);
+    priority_queue< pair<double, unsigned int>, vector< pair<double, unsigned int> >,
+                    greater< pair<double, unsigned int> > > unvisitedVerticesQueue;
+    (*distances)[sourceId] = 0;
+    unvisitedVerticesQueue.push(make_pair(0.0, sourceId));
+
+    while (!unvisitedVerticesQueue.empty()) {
+        double distance = unvisitedVerticesQueue.top().first;
+        unsigned int uId = unvisitedVerticesQueue.top().second;
+        unvisitedVerticesQueue.pop();
+        if (distance > (*distances)[uId]) {
+            continue;
+        }
+        if (uId == destinationId) {
+            return distance;
+        }
+
+        const VersionRow& row = getNeighbours(uId);
+        for (unsigned int i = 0; i < row.size(); i++) {
+            if (distance + row[i].second < (*distances)[row[i].first]) {
+                (*distances)[row[i].first] = distance + row[i].second;
+                unvisitedVerticesQueue.push(make_pair(distance + row[i].second, row[i].first));
+            }
+        }
+    }
+    return ShortestPathTree::UNREACHABLE;
+}
+
+/// \brief
+/// Copies the edges of a graph into the first version
+///
+/// \param graph Graph* - the graph copied
+/// \param maxReaders unsigned int - the number of reader slots
+///
+VersionedGraph::VersionedGraph(Graph* graph, unsigned int maxReaders) {
+    unsigned int numVertices = graph->getNumVertices();
+    GraphVersion* version = new GraphVersion();
+    version->number = 0;
+    version->numVertices = numVertices;
+    version->totalWeight = 0;
+
+    for (unsigned int uId = 0; uId < numVertices; uId++) {
+        if (uId % VERSION_CHUNK_ROWS == 0) {
+            version->chunks.push_back(new VersionChunk());
+        }
+        VersionRow* row = new VersionRow();
+        vector<unsigned int>* adjacent = graph->getNeighbours(uId);
+        for (unsigned int i = 0; i < adjacent->size(); i++) {
+            double weight = graph->getWeight(uId, (*adjacent)[i]);
+            row->push_back(make_pair((*adjacent)[i], weight));
+            version->totalWeight += (*adjacent)[i] > uId ? weight : 0;
+        }
+        version->chunks.back()->rows.push_back(row);
+    }
+
+    this->current.store(version);
+    this->epoch.store(IDLE + 1);
+    this->maxReaders = maxReaders;
+    this->numReaders.store(0);
+    this->readers = new ReaderSlot[maxReaders];
+    for (unsigned int i = 0; i < maxReaders; i++) {
+        this->readers[i].epoch.store(IDLE);
+    }
+    this->chunkStamps.assign(version->chunks.size(), 0);
+    this->rowStamps.assign(numVertices, 0);
+}
+
+/// \brief
+/// Frees every version, which no reader may still be using
+///
+VersionedGraph::~VersionedGraph() {
+    for (unsigned int i = 0; i < this->retired.size(); i++) {
+        freeRetired(this->retired[i]);
+    }
+
+    // Everything still in the current version has not been replaced, so is freed exactly once here
+    GraphVersion* version = this->current.load();
+    for (unsigned int c = 0; c < version->chunks.size(); c++) {
+        for (unsigned int r = 0; r < version->chunks[c]->rows.size(); r++) {
+            delete version->chunks[c]->rows[r];
+        }
+        delete version->chunks[c];
+    }
+    delete version;
+    delete[] this->readers;
+}
+
+/// \brief
+/// Claims a reader slot, to be used by one thread at a time
+///
+/// \return unsigned int - the slot, or maxReaders if every slot has been claimed
+///
+unsigned int VersionedGraph::addReader() {
+    unsigned int reader = this->numReaders.fetch_add(1);
+    return reader < this->maxReaders ? reader : this->maxReaders;
+}
+
+/// \brief
+/// Announces a reader and returns the current version, which stays valid until the reader releases it
+///
+/// \param reader unsigned int - the reader's slot
+/// \return const GraphVersion* - the current version
+///
+const GraphVersion* VersionedGraph::acquire(unsigned int reader) {
+
+    // The epoch is announced before the version is loaded, so a writer that replaces the version after
+    // this load will see the announcement before deciding what to free
+    this->readers[reader].epoch.store(this->epoch.load());
+    return this->current.load();
+}
+
+/// \brief
+/// Tells the writers a reader has finished with the version it acquired
+///
+/// \param reader unsigned int - the reader's slot
+///
+void VersionedGraph::release(unsigned int reader) {
+    this->readers[reader].epoch.store(IDLE);
+}
+
+/// \brief
+/// Applies a batch of edge changes as one new version and frees what no reader can still see
+///
+/// \param updates const vector<EdgeUpdate>& - the changes, applied in order
+/// \return unsigned long - the number of the published version
+///
+unsigned long VersionedGraph::apply(const vector<EdgeUpdate>& updates) {
+    lock_guard<mutex> lock(this->writerMutex);
+    GraphVersion* old = this->current.load();
+    GraphVersion* version = new GraphVersion(*old);
+    version->number = old->number + 1;
+
+    Retired replaced;
+    replaced.version = old;
+    for (unsigned int i = 0; i < updates.size(); i++) {
+        const EdgeUpdate& update = updates[i];
+        if (update.sourceId == update.destinationId) {
+            continue;
+        }
+        double oldWeight = setWeight(version, update.sourceId, update.destinationId, update.weight, &replaced);
+        setWeight(version, update.destinationId, update.sourceId, update.weight, &replaced);
+        version->totalWeight += (update.weight != GraphObserver::NO_EDGE ? update.weight : 0)
+                              - (oldWeight != GraphObserver::NO_EDGE ? oldWeight : 0);
+    }
+
+    // Readers that loaded the old version announced an epoch no later than the one it is tagged with
+    this->current.store(version);
+    replaced.epoch = this->epoch.fetch_add(1);
+    this->retired.push_back(replaced);
+    reclaim();
+    return version->number;
+}
+
+/// \brief
+/// Returns the number of replaced versions not yet freed
+///
+/// \return unsigned long - the number of retired versions
+///
+unsigned long VersionedGraph::getNumRetired() {
+    lock_guard<mutex> lock(this->writerMutex);
+    return this->retired.size();
+}
+
+/// \brief
+/// Returns the number of bytes used by the current version, counting shared rows and chunks once
+///
+/// \return unsigned long - the memory used in bytes
+///
+unsigned long VersionedGraph::memoryUsage() {
+    lock_guard<mutex> lock(this->writerMutex);
+    GraphVersion* version = this->current.load();
+    unsigned long bytes = sizeof(GraphVersion) + version->chunks.capacity() * sizeof(VersionChunk*);
+    for (unsigned int c = 0; c < version->chunks.size(); c++) {
+        VersionChunk* chunk = version->chunks[c];
+        bytes += sizeof(VersionChunk) + chunk->rows.capacity() * sizeof(VersionRow*);
+        for (unsigned int r = 0; r < chunk->rows.size(); r++) {
+            bytes += sizeof(VersionRow) + chunk->rows[r]->capacity() * sizeof(pair<unsigned int, double>);
+        }
+    }
+    return bytes;
+}
+
+/// \brief
+/// Sets the weight of an edge in one direction within a version being made, copying its chunk and
+/// row the first time the update touches them
+///
+/// \param version GraphVersion* - the version being made
+/// \param sourceId unsigned int - the vertex whose row changes
+/// \param destinationId unsigned int - the neighbour whose weight changes
+/// \param weight double - the new weight, or NO_EDGE to remove the edge
+/// \param replaced Retired* - collects the chunks and rows the update replaced
+/// \return double - the old weight, or NO_EDGE if there was no such edge
+///
+double VersionedGraph::setWeight(GraphVersion* version, unsigned int sourceId, unsigned int destinationId, double weight, Retired* replaced) {
+    unsigned int c = sourceId / VERSION_CHUNK_ROWS;
+    if (this->chunkStamps[c] != version->number) {
+        this->chunkStamps[c] = version->number;
+        replaced->chunks.push_back(version->chunks[c]);
+        version->chunks[c] = new VersionChunk(*version->chunks[c]);
+    }
+
+    const VersionRow*& slot = version->chunks[c]->rows[sourceId % VERSION_CHUNK_ROWS];
+    if (this->rowStamps[sourceId] != version->number) {
+        this->rowStamps[sourceId] = version->number;
+        replaced->rows.push_back(slot);
+        slot = new VersionRow(*slot);
+    }
+
+    // Only rows copied for this version are ever written, so the cast never touches a published row
+    VersionRow* row = const_cast<VersionRow*>(slot);
+    for (unsigned int i = 0; i < row->size(); i++) {
+        if ((*row)[i].first == destinationId) {
+            double oldWeight = (*row)[i].second;
+            if (weight == GraphObserver::NO_EDGE) {
+                (*row)[i] = row->back();
+                row->pop_back();
+            }
+            else {
+                (*row)[i].second = weight;
+            }
+            return oldWeight;
+        }
+    }
+    if (weight != GraphObserver::NO_EDGE) {
+        row->push_back(make_pair(destinationId, weight));
+    }
+    return GraphObserver::NO_EDGE;
+}
+
+/// \brief
+/// Frees everything replaced before the earliest epoch a reader is still in
+///
+void VersionedGraph::reclaim() {
+    unsigned long earliest = this->epoch.load();
+    unsigned int numReaders = this->numReaders.load() < this->maxReaders ? this->numReaders.load() : this->maxReaders;
+    for (unsigned int i = 0; i < numReaders; i++) {
+        unsigned long announced = this->readers[i].epoch.load();
+        if (announced != IDLE && announced < earliest) {
+            earliest = announced;
+        }
+    }
+
+    while (!this->retired.empty() && this->retired.front().epoch < earliest) {
+        freeRetired(this->retired.front());
+        this->retired.pop_front();
+    }
+}
+
+/// \brief
+/// Frees what an update replaced
+///
+/// \param replaced Retired& - the replaced version, chunks and rows
+///
+void VersionedGraph::freeRetired(Retired& replaced) {
+    for (unsigned int i = 0; i < replaced.chunks.size(); i++) {
+        delete replaced.chunks[i];
+    }
+    for (unsigned int i = 0; i < replaced.rows.size(); i++) {
+        delete replaced.rows[i];
+    }
+    delete replaced.version;
+}
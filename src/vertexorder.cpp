@@ -0,0 +1,230 @@
+#include <algorithm>
+#include "vertexorder.h"
+
+/// This class renumbers the vertices of a graph so that vertices close together in the graph are close
+/// together in memory. Storage built in the new order reads fewer cache lines per search, and the order
+/// maps identifiers between the numbering callers use and the numbering of the storage.
+///
+/// A Hilbert curve over the coordinates of the points puts nearby places next to each other, reverse
+/// Cuthill-McKee keeps the identifiers at each end of every edge close, and a breadth first order puts
+/// each vertex near the vertex it was reached from.
+///
+
+/// The number of cells along each side of the grid the Hilbert curve passes through
+const unsigned int HILBERT_GRID_SIZE = 1 << 16;
+
+/// \brief
+/// Returns the position of a cell along a Hilbert curve filling a square grid
+///
+/// \param x unsigned int - the column of the cell
+/// \param y unsigned int - the row of the cell
+/// \return unsigned long long - the number of cells the curve passes through before this one
+///
+static unsigned long long hilbertIndex(unsigned int x, unsigned int y) {
+    unsigned long long index = 0;
+    for (unsigned int side = HILBERT_GRID_SIZE / 2; side > 0; side /= 2) {
+        unsigned int right = (x & side) > 0;
+        unsigned int top = (y & side) > 0;
+        index += (unsigned long long) side * side * ((3 * right) ^ top);
+
+        // Rotate the quadrant so the curve within it starts and ends next to its neighbours
+        if (top == 0) {
+            if (right == 1) {
+                x = side - 1 - (x & (side - 1));
+                y = side - 1 - (y & (side - 1));
+            }
+            swap(x, y);
+        }
+    }
+    return index;
+}
+
+/// \brief
+/// Creates an order that leaves every identifier as it is
+///
+/// \param numVertices unsigned int - the number of vertices within the graph
+///
+VertexOrder::VertexOrder(unsigned int numVertices) {
+    vector<unsigned int> identity(numVertices);
+    for (unsigned int i = 0; i < numVertices; i++) {
+        identity[i] = i;
+    }
+    setOrder(identity);
+}
+
+/// \brief
+/// There was no dynamically created items in this class so there is no need for a destructor method body
+///
+VertexOrder::~VertexOrder() {
+}
+
+/// \brief
+/// Orders the vertices along a Hilbert curve through the points they stand for
+///
+/// \param points vector<Point*>* - the point of each vertex
+///
+void VertexOrder::byHilbertCurve(vector<Point*>* points) {
+    if (points->empty()) {
+        return;
+    }
+
+    // Scale the bounding box of the points onto the grid
+    double minX = (*points)[0]->getX();
+    double maxX = minX;
+    double minY = (*points)[0]->getY();
+    double maxY = minY;
+    for (unsigned int i = 1; i < points->size(); i++) {
+        minX = min(minX, (*points)[i]->getX());
+        maxX = max(maxX, (*points)[i]->getX());
+        minY = min(minY, (*points)[i]->getY());
+        maxY = max(maxY, (*points)[i]->getY());
+    }
+    double scale = (HILBERT_GRID_SIZE - 1) / max(max(maxX - minX, maxY - minY), 1e-9);
+
+    vector< pair<unsigned long long, unsigned int> > byCurve(points->size());
+    for (unsigned int i = 0; i < points->size(); i++) {
+        unsigned int x = (unsigned int) (((*points)[i]->getX() - minX) * scale);
+        unsigned int y = (unsigned int) (((*points)[i]->getY() - minY) * scale);
+        byCurve[i] = make_pair(hilbertIndex(x, y), i);
+    }
+    sort(byCurve.begin(), byCurve.end());
+
+    vector<unsigned int> order(points->size());
+    for (unsigned int i = 0; i < points->size(); i++) {
+        order[i] = byCurve[i].second;
+    }
+    setOrder(order);
+}
+
+/// \brief
+/// Orders the vertices by reverse Cuthill-McKee: a breadth first search of each component from a
+/// vertex of least degree that visits neighbours in order of degree, numbered backwards
+///
+/// \param graph Graph* - the graph whose vertices are ordered
+///
+void VertexOrder::byReverseCuthillMcKee(Graph* graph) {
+    vector<unsigned int> order;
+    breadthFirstOrder(graph, true, &order);
+    reverse(order.begin(), order.end());
+    setOrder(order);
+}
+
+/// \brief
+/// Orders the vertices in the order a breadth first search of each component reaches them
+///
+/// \param graph Graph* - the graph whose vertices are ordered
+///
+void VertexOrder::byBreadthFirst(Graph* graph) {
+    vector<unsigned int> order;
+    breadthFirstOrder(graph, false, &order);
+    setOrder(order);
+}
+
+/// \brief
+/// Returns the number of vertices within the order
+///
+/// \return unsigned int - the number of vertices
+///
+unsigned int VertexOrder::getNumVertices() {
+    return this->internalIds.size();
+}
+
+/// \brief
+/// Returns the position in storage of the vertex with the given identifier
+///
+/// \param identifier unsigned int - the identifier callers use for the vertex
+/// \return unsigned int - the identifier of the vertex within storage
+///
+unsigned int VertexOrder::toInternal(unsigned int identifier) {
+    return this->internalIds[identifier];
+}
+
+/// \brief
+/// Returns the identifier callers use for the vertex at a position in storage
+///
+/// \param internalId unsigned int - the identifier of the vertex within storage
+/// \return unsigned int - the identifier callers use for the vertex
+///
+unsigned int VertexOrder::toExternal(unsigned int internalId) {
+    return this->externalIds[internalId];
+}
+
+/// \brief
+/// Returns the average distance in storage between the two ends of an edge, which is smaller the
+/// more of a vertex's neighbours share its cache lines
+///
+/// \param graph Graph* - the graph whose edges are measured
+/// \return double - the average gap between the internal identifiers of the ends of each edge
+///
+double VertexOrder::averageEdgeGap(Graph* graph) {
+    double totalGap = 0;
+    unsigned long numEdges = 0;
+    for (unsigned int uId = 0; uId < getNumVertices(); uId++) {
+        vector<unsigned int>* neighbours = graph->getNeighbours(uId);
+        for (unsigned int i = 0; i < neighbours->size(); i++) {
+            unsigned int from = toInternal(uId);
+            unsigned int to = toInternal((*neighbours)[i]);
+            totalGap += from > to ? from - to : to - from;
+            numEdges++;
+        }
+    }
+    return numEdges > 0 ? totalGap / numEdges : 0;
+}
+
+/// \brief
+/// Sets the order from the identifiers callers use, listed in storage order
+///
+/// \param externalIds const vector<unsigned int>& - the identifier of the vertex at each position
+///
+void VertexOrder::setOrder(const vector<unsigned int>& externalIds) {
+    this->externalIds = externalIds;
+    this->internalIds.resize(externalIds.size());
+    for (unsigned int i = 0; i < externalIds.size(); i++) {
+        this->internalIds[externalIds[i]] = i;
+    }
+}
+
+/// \brief
+/// Lists the vertices in the order breadth first searches of each component reach them
+///
+/// \param graph Graph* - the graph whose vertices are listed
+/// \param byDegree bool - whether each search starts from a vertex of least degree and visits
+/// neighbours in order of degree, as Cuthill-McKee does
+/// \param order vector<unsigned int>* - filled with the vertices in the order they are reached
+///
+void VertexOrder::breadthFirstOrder(Graph* graph, bool byDegree, vector<unsigned int>* order) {
+    unsigned int numVertices = graph->getNumVertices();
+    vector< pair<unsigned int, unsigned int> > starts(numVertices);
+    for (unsigned int i = 0; i < numVertices; i++) {
+        starts[i] = make_pair(byDegree ? (unsigned int) graph->getNeighbours(i)->size() : 0, i);
+    }
+    sort(starts.begin(), starts.end());
+
+    vector<bool> reached(numVertices, false);
+    vector< pair<unsigned int, unsigned int> > next;
+    order->clear();
+
+    for (unsigned int s = 0; s < numVertices; s++) {
+        if (reached[starts[s].second]) {
+            continue;
+        }
+
+        // The order doubles as the queue, read from where this component starts
+        reached[starts[s].second] = true;
+        order->push_back(starts[s].second);
+        for (unsigned int head = order->size() - 1; head < order->size(); head++) {
+            vector<unsigned int>* neighbours = graph->getNeighbours((*order)[head]);
+            next.clear();
+            for (unsigned int i = 0; i < neighbours->size(); i++) {
+                if (!reached[(*neighbours)[i]]) {
+                    reached[(*neighbours)[i]] = true;
+                    next.push_back(make_pair(byDegree ? (unsigned int) graph->getNeighbours((*neighbours)[i])->size() : 0, (*neighbours)[i]));
+                }
+            }
+            sort(next.begin(), next.end());
+            for (unsigned int i = 0; i < next.size(); i++) {
+                order->push_back(next[i].second);
+            }
+        }
+    }
+}
@@ -0,0 +1,158 @@
+#include <atomic>
+#include <memory>
+#include "workerpool.h"
+
+/// This class keeps a fixed number of worker threads alive so that queries can be run in parallel
+/// without paying the cost of starting a thread for each one
+///
+
+/// Progress shared between the caller of parallelFor and the workers helping it; kept alive by
+/// whichever of them finishes last
+struct ParallelForState {
+    function<void(unsigned int)> body;
+    unsigned int count;
+    atomic<unsigned int> nextIndex;
+    unsigned int completed;
+    mutex completedMutex;
+    condition_variable allCompleted;
+};
+
+/// \brief
+/// Takes indices from the shared state and runs them until none are left
+///
+/// \param state ParallelForState* - the progress of the parallelFor call being helped
+///
+static void runParallelForIndices(ParallelForState* state) {
+    unsigned int finished = 0;
+    unsigned int index;
+
+    while ((index = state->nextIndex.fetch_add(1)) < state->count) {
+        state->body(index);
+        finished++;
+    }
+
+    // Report the finished indices and wake the caller once all have been run
+    if (finished > 0) {
+        unique_lock<mutex> lock(state->completedMutex);
+        state->completed += finished;
+        if (state->completed == state->count) {
+            state->allCompleted.notify_all();
+        }
+    }
+}
+
+/// \brief
+/// Starts the worker threads, using one per hardware thread when zero is given
+///
+/// \param numWorkers unsigned int - the number of worker threads to start
+///
+WorkerPool::WorkerPool(unsigned int numWorkers) {
+    this->stopping = false;
+
+    if (numWorkers == 0) {
+        numWorkers = thread::hardware_concurrency();
+    }
+    if (numWorkers == 0) {
+        numWorkers = 1;
+    }
+
+    for (unsigned int i = 0; i < numWorkers; i++) {
+        this->workers.push_back(thread(&WorkerPool::run, this));
+    }
+}
+
+/// \brief
+/// Lets the workers finish the tasks already submitted and then joins them
+///
+WorkerPool::~WorkerPool() {
+    {
+        unique_lock<mutex> lock(this->tasksMutex);
+        this->stopping = true;
+    }
+    this->taskAvailable.notify_all();
+
+    for (unsigned int i = 0; i < this->workers.size(); i++) {
+        this->workers[i].join();
+    }
+}
+
+/// \brief
+/// Returns the number of worker threads in the pool
+///
+/// \return unsigned int - the number of worker threads
+///
+unsigned int WorkerPool::getNumWorkers() {
+    return this->workers.size();
+}
+
+/// \brief
+/// Adds a task to the queue to be run by the next free worker
+///
+/// \param task function<void()> - the task to be run
+///
+void WorkerPool::submit(function<void()> task) {
+    {
+        unique_lock<mutex> lock(this->tasksMutex);
+        this->tasks.push(task);
+    }
+    this->taskAvailable.notify_one();
+}
+
+/// \brief
+/// Runs body for every index from zero up to count, sharing the indices between the workers and the
+/// calling thread, and returns once every index has been run
+///
+/// \param count unsigned int - the number of indices to run
+/// \param body function<void(unsigned int)> - the work to run for a single index
+///
+void WorkerPool::parallelFor(unsigned int count, function<void(unsigned int)> body) {
+    if (count == 0) {
+        return;
+    }
+
+    shared_ptr<ParallelForState> state(new ParallelForState());
+    state->body = body;
+    state->count = count;
+    state->nextIndex = 0;
+    state->completed = 0;
+
+    // Ask for help from at most one worker per remaining index
+    unsigned int helpers = this->workers.size();
+    if (helpers > count - 1) {
+        helpers = count - 1;
+    }
+    for (unsigned int i = 0; i < helpers; i++) {
+        submit([state]() { runParallelForIndices(state.get()); });
+    }
+
+    // The caller works too, so a busy pool or a nested call can never stall
+    runParallelForIndices(state.get());
+
+    unique_lock<mutex> lock(state->completedMutex);
+    while (state->completed < state->count) {
+        state->allCompleted.wait(lock);
+    }
+}
+
+/// \brief
+/// Loop run by each worker thread taking tasks from the queue until the pool is destroyed
+///
+void WorkerPool::run() {
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<mutex> lock(this->tasksMutex);
+            while (!this->stopping && this->tasks.empty()) {
+                this->taskAvailable.wait(lock);
+            }
+
+            // Only stop once every submitted task has been run
+            if (this->tasks.empty()) {
+                return;
+            }
+            task = this->tasks.front();
+            this->tasks.pop();
+        }
+        task();
+    }
+}